@@ -0,0 +1,359 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   AccelBenchmarks.cpp
+ * 
+ * Build and traversal benchmarks for the BVH
+ * Primitives are random boxes so that the numbers do not depend on a primitive
+ * type; one operation is one primitive for builds, one ray for traversal and
+ * one shading point for light picks.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "Benchmark.hpp"
+#include "accel/AABB.hpp"
+#include "accel/BVH.hpp"
+#include "accel/LightBVH.hpp"
+#include "accel/TriangleBVH.hpp"
+#include "accel/TrianglePacket8.hpp"
+#include "parallel/TaskPool.hpp"
+#include "utility/Ray.hpp"
+#include "utility/RayPacket8.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const std::size_t boxCount = 1 << 17;
+        const std::size_t rayCount = 1024;
+        const std::size_t lightCount = 1 << 14;
+
+        // Seeded boxes, triangles and rays shared by every accel case
+        struct AccelData {
+            std::vector<AABB> boxes;
+            std::vector<AABB> movedBoxes;
+            std::vector<Point> vertices;
+            std::vector<Point> movedVertices;
+            std::vector<std::uint32_t> indices;
+            std::vector<Ray> rays;
+            std::vector<Point> coherentOrigins;
+            std::vector<Vector> coherentDirections;
+            BVH bvh;
+            BVH refitBVH;
+            TriangleBVH triangleBVH;
+            TriangleBVH refitTriangleBVH;
+            TrianglePacket8 packet;
+            std::vector<Light> lights;
+            LightBVH lightBVH;
+            TaskPool pool;
+
+            explicit AccelData(std::uint32_t seed) {
+                std::mt19937 generator(seed);
+                std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+                std::uniform_real_distribution<float> size(0.01f, 0.2f);
+                for(std::size_t i = 0; i < boxCount; i++) {
+                    Point corner(position(generator), position(generator), position(generator));
+                    boxes.push_back(AABB(corner, corner + Vector(size(generator), size(generator),
+                                                                 size(generator))));
+                }
+                for(std::size_t i = 0; i < rayCount; i++)
+                    rays.push_back(Ray(Point(position(generator), position(generator), position(generator)),
+                                       Vector(position(generator), position(generator), position(generator))));
+                bvh.Build(boxes, &pool);
+
+                // one small triangle inside every box
+                for(std::size_t i = 0; i < boxCount; i++) {
+                    const Point& minimum = boxes[i].GetMinimum();
+                    const Point& maximum = boxes[i].GetMaximum();
+                    vertices.push_back(minimum);
+                    vertices.push_back(Point(maximum.GetX(), minimum.GetY(), maximum.GetZ()));
+                    vertices.push_back(Point(minimum.GetX(), maximum.GetY(), maximum.GetZ()));
+                    for(int k = 0; k < 3; k++)
+                        indices.push_back((std::uint32_t)(3 * i + k));
+                }
+                triangleBVH.Build(vertices, indices, &pool);
+
+                // the same primitives a frame later, each nudged by a fraction of its size
+                std::uniform_real_distribution<float> nudge(-0.05f, 0.05f);
+                for(std::size_t i = 0; i < boxCount; i++) {
+                    Vector offset(nudge(generator), nudge(generator), nudge(generator));
+                    movedBoxes.push_back(AABB(boxes[i].GetMinimum() + offset, boxes[i].GetMaximum() + offset));
+                    for(int k = 0; k < 3; k++)
+                        movedVertices.push_back(vertices[3 * i + k] + offset);
+                }
+                refitBVH = bvh;
+                refitTriangleBVH = triangleBVH;
+
+                // a 32 by 32 pinhole view of the boxes, each run of eight a 4 by 2 pixel block
+                for(std::size_t i = 0; i < rayCount; i++) {
+                    std::size_t block = i / 8, lane = i % 8;
+                    float x = (float)(block % 8 * 4 + lane % 4) / 32.0f - 0.5f;
+                    float y = (float)(block / 8 * 2 + lane / 4) / 32.0f - 0.5f;
+                    coherentOrigins.push_back(Point(0.0f, 0.0f, -15.0f));
+                    coherentDirections.push_back(Vector(x, y, 1.0f));
+                }
+
+                // eight triangles facing the first ray, as a busy leaf would
+                for(int lane = 0; lane < TrianglePacket8::width; lane++) {
+                    Point centre = rays[0].PointAt(1.0f + lane);
+                    packet.SetTriangle(lane, centre + Vector(-1.0f, -1.0f, 0.3f),
+                                       centre + Vector(1.0f, -1.0f, -0.2f),
+                                       centre + Vector(0.0f, 1.0f, 0.1f), (std::uint32_t)lane);
+                }
+
+                // a lamp in each of the first boxes, every other one a spot aimed down
+                std::uniform_real_distribution<float> brightness(0.1f, 2.0f);
+                for(std::size_t i = 0; i < lightCount; i++) {
+                    Color intensity(brightness(generator));
+                    if(i % 2 == 0)
+                        lights.push_back(Light(boxes[i].GetCentroid(), intensity));
+                    else
+                        lights.push_back(Light(boxes[i].GetCentroid(), Normal(0.0f, -1.0f, 0.0f), 0.6f, intensity));
+                }
+                lightBVH.Build(lights);
+            }
+        };
+
+        // Scalar Moller-Trumbore, the per triangle baseline for the packet kernel
+        bool IntersectTriangle(const Point& p0, const Point& p1, const Point& p2,
+                               const Ray& ray, float& tMax) {
+            Vector edge1 = p1 - p0;
+            Vector edge2 = p2 - p0;
+            Vector p = ray.GetDirection() ^ edge2;
+            float determinant = edge1 * p;
+            if(determinant == 0.0f)
+                return false;
+            float inverse = 1.0f / determinant;
+            Vector toOrigin = ray.GetOrigin() - p0;
+            float u = (toOrigin * p) * inverse;
+            if(u < 0.0f || u > 1.0f)
+                return false;
+            Vector q = toOrigin ^ edge1;
+            float v = (ray.GetDirection() * q) * inverse;
+            if(v < 0.0f || u + v > 1.0f)
+                return false;
+            float t = (edge2 * q) * inverse;
+            if(t <= 0.0f || t >= tMax)
+                return false;
+            tMax = t;
+            return true;
+        }
+
+        // Closest hit against the bounding boxes themselves
+        struct BoxIntersector {
+            const std::vector<AABB>* boxes;
+
+            bool operator()(std::uint32_t index, const Ray& ray, float& tMax) const {
+                const Vector& direction = ray.GetDirection();
+                Vector inverseDirection(1.0f / direction.GetX(), 1.0f / direction.GetY(),
+                                        1.0f / direction.GetZ());
+                float tNear;
+                if(!(*boxes)[index].Intersect(ray, inverseDirection, tMax, tNear) || tNear >= tMax)
+                    return false;
+                tMax = tNear;
+                return true;
+            }
+        };
+    }
+
+    void RegisterAccelBenchmarks(BenchmarkRunner& runner) {
+        // allocated aligned, AccelData holds SIMD registers
+        std::shared_ptr<AccelData> data = std::allocate_shared<AccelData>(
+            Eigen::aligned_allocator<AccelData>(), runner.GetOptions().seed);
+
+        runner.Add("bvh/build/serial", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++) {
+                BVH bvh;
+                bvh.Build(data->boxes);
+                DoNotOptimize(bvh.GetNodeCount());
+            }
+        }, boxCount);
+        runner.Add("bvh/build/parallel", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++) {
+                BVH bvh;
+                bvh.Build(data->boxes, &data->pool);
+                DoNotOptimize(bvh.GetNodeCount());
+            }
+        }, boxCount);
+        // refits alternate between the two frames so every call moves every node
+        runner.Add("bvh/refit/serial", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++) {
+                data->refitBVH.Refit(it % 2 ? data->boxes : data->movedBoxes);
+                DoNotOptimize(data->refitBVH.GetCost());
+            }
+        }, boxCount);
+        runner.Add("bvh/refit/parallel", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++) {
+                data->refitBVH.Refit(it % 2 ? data->boxes : data->movedBoxes, &data->pool);
+                DoNotOptimize(data->refitBVH.GetCost());
+            }
+        }, boxCount);
+        runner.Add("bvh/intersect/closest", [data](std::size_t iterations) {
+            BoxIntersector intersector = { &data->boxes };
+            for(std::size_t it = 0; it < iterations; it++)
+                for(std::size_t i = 0; i < rayCount; i++) {
+                    float tMax = std::numeric_limits<float>::infinity();
+                    DoNotOptimize(data->bvh.Intersect(data->rays[i], tMax, intersector));
+                }
+        }, rayCount);
+        runner.Add("bvh/intersect/any", [data](std::size_t iterations) {
+            BoxIntersector intersector = { &data->boxes };
+            for(std::size_t it = 0; it < iterations; it++)
+                for(std::size_t i = 0; i < rayCount; i++)
+                    DoNotOptimize(data->bvh.IntersectAny(data->rays[i],
+                                  std::numeric_limits<float>::infinity(), intersector));
+        }, rayCount);
+
+        // one operation is one ray against eight triangles
+        runner.Add("triangle/scalar8", [data](std::size_t iterations) {
+            Point p0[8], p1[8], p2[8];
+            for(int lane = 0; lane < 8; lane++) {
+                Point centre = data->rays[0].PointAt(1.0f + lane);
+                p0[lane] = centre + Vector(-1.0f, -1.0f, 0.3f);
+                p1[lane] = centre + Vector(1.0f, -1.0f, -0.2f);
+                p2[lane] = centre + Vector(0.0f, 1.0f, 0.1f);
+            }
+            for(std::size_t it = 0; it < iterations; it++) {
+                float tMax = std::numeric_limits<float>::infinity();
+                bool hit = false;
+                for(int lane = 0; lane < 8; lane++)
+                    hit |= IntersectTriangle(p0[lane], p1[lane], p2[lane], data->rays[0], tMax);
+                DoNotOptimize(hit);
+                DoNotOptimize(tMax);
+            }
+        }, 1);
+        runner.Add("triangle/packet8", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++) {
+                float tMax = std::numeric_limits<float>::infinity();
+                TriangleHit hit;
+                DoNotOptimize(data->packet.IntersectClosest(data->rays[0], tMax, hit));
+                DoNotOptimize(tMax);
+            }
+        }, 1);
+        runner.Add("trianglebvh/build", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++) {
+                TriangleBVH bvh;
+                bvh.Build(it % 2 ? data->vertices : data->movedVertices, data->indices, &data->pool);
+                DoNotOptimize(bvh.GetPacketCount());
+            }
+        }, boxCount);
+        runner.Add("trianglebvh/update", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                DoNotOptimize(data->refitTriangleBVH.Update(it % 2 ? data->vertices : data->movedVertices,
+                                                            data->indices, &data->pool));
+        }, boxCount);
+        runner.Add("trianglebvh/intersect/closest", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                for(std::size_t i = 0; i < rayCount; i++) {
+                    float tMax = std::numeric_limits<float>::infinity();
+                    TriangleHit hit;
+                    DoNotOptimize(data->triangleBVH.Intersect(data->rays[i], tMax, hit));
+                }
+        }, rayCount);
+        runner.Add("trianglebvh/intersect/any", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                for(std::size_t i = 0; i < rayCount; i++)
+                    DoNotOptimize(data->triangleBVH.IntersectAny(data->rays[i],
+                                  std::numeric_limits<float>::infinity()));
+        }, rayCount);
+
+        // coherent rays one at a time against the same rays eight at a time
+        runner.Add("trianglebvh/coherent/closest", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                for(std::size_t i = 0; i < rayCount; i++) {
+                    float tMax = std::numeric_limits<float>::infinity();
+                    TriangleHit hit;
+                    DoNotOptimize(data->triangleBVH.Intersect(Ray(data->coherentOrigins[i],
+                                                                  data->coherentDirections[i]), tMax, hit));
+                }
+        }, rayCount);
+        runner.Add("trianglebvh/coherent/packet_closest", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                for(std::size_t i = 0; i < rayCount; i += 8) {
+                    Float8 tMax(std::numeric_limits<float>::infinity());
+                    TriangleHit hits[8];
+                    RayPacket8 rays = RayPacket8::Gather(&data->coherentOrigins[i], &data->coherentDirections[i]);
+                    DoNotOptimize(data->triangleBVH.IntersectPacket(rays, Mask8(true), tMax, hits).GetBits());
+                }
+        }, rayCount);
+        runner.Add("trianglebvh/coherent/any", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                for(std::size_t i = 0; i < rayCount; i++)
+                    DoNotOptimize(data->triangleBVH.IntersectAny(Ray(data->coherentOrigins[i],
+                                                                     data->coherentDirections[i]),
+                                  std::numeric_limits<float>::infinity()));
+        }, rayCount);
+        runner.Add("trianglebvh/coherent/packet_any", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                for(std::size_t i = 0; i < rayCount; i += 8) {
+                    RayPacket8 rays = RayPacket8::Gather(&data->coherentOrigins[i], &data->coherentDirections[i]);
+                    DoNotOptimize(data->triangleBVH.IntersectAnyPacket(rays, Mask8(true),
+                                  Float8(std::numeric_limits<float>::infinity())).GetBits());
+                }
+        }, rayCount);
+
+        // many lights: one pick through the hierarchy against visiting every light at a shading point
+        runner.Add("lightbvh/build", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++) {
+                LightBVH lights;
+                lights.Build(data->lights);
+                DoNotOptimize(lights.GetNodes().size());
+            }
+        }, lightCount);
+        runner.Add("lightbvh/sample", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                for(std::size_t i = 0; i < rayCount; i++) {
+                    std::uint32_t light = 0;
+                    float probability = 0.0f;
+                    data->lightBVH.Sample(data->rays[i].GetOrigin(), Normal(0.0f, 1.0f, 0.0f),
+                                          (float)i / rayCount, light, probability);
+                    DoNotOptimize(light);
+                }
+        }, rayCount);
+        runner.Add("lights/every_light", [data](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                for(std::size_t i = 0; i < rayCount; i += 64) {
+                    const Point& point = data->rays[i].GetOrigin();
+                    float total = 0.0f;
+                    for(std::size_t l = 0; l < lightCount; l++) {
+                        const Light& light = data->lights[l];
+                        Vector toLight = light.position - point;
+                        float squaredDistance = toLight.GetSquaredMagnitude();
+                        float cosine = toLight.GetY() / std::sqrt(squaredDistance);
+                        if(cosine > 0.0f)
+                            total += light.GetIntensity(-toLight / std::sqrt(squaredDistance)).GetLuminance() *
+                                     cosine / squaredDistance;
+                    }
+                    DoNotOptimize(total);
+                }
+        }, rayCount / 64);
+    }
+}
@@ -0,0 +1,185 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Benchmark.cpp
+ * 
+ * Microbenchmark harness with cycle counts and JSON output
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <x86intrin.h>
+#define SCPPR_HAS_RDTSC 1
+#endif
+
+#include "Benchmark.hpp"
+#include "utility/Float8.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        // Median of a set of samples, the set is reordered
+        double Median(std::vector<double>& samples) {
+            std::sort(samples.begin(), samples.end());
+            return samples[samples.size() / 2];
+        }
+
+        const char* SimdBackend() {
+#if defined(SCPPR_SIMD_AVX)
+            return "avx";
+#elif defined(SCPPR_SIMD_SSE)
+            return "sse2";
+#else
+            return "scalar";
+#endif
+        }
+
+        // Writes a string with the characters JSON requires escaped
+        void WriteJsonString(std::ostream& output, const std::string& text) {
+            output << '"';
+            for(std::size_t i = 0; i < text.size(); i++) {
+                if(text[i] == '"' || text[i] == '\\')
+                    output << '\\';
+                output << text[i];
+            }
+            output << '"';
+        }
+    }
+
+    std::uint64_t ReadCycleCounter() {
+#if defined(SCPPR_HAS_RDTSC)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    BenchmarkOptions::BenchmarkOptions() :
+        seed(1), repetitions(7), minimumSeconds(0.01) {
+
+    }
+
+    BenchmarkRunner::BenchmarkRunner(const BenchmarkOptions& optionsArg) :
+        options(optionsArg) {
+        if(options.repetitions < 1)
+            options.repetitions = 1;
+    }
+
+    const BenchmarkOptions& BenchmarkRunner::GetOptions() const {
+        return options;
+    }
+
+    void BenchmarkRunner::Add(const std::string& name, const Body& body,
+                              std::size_t operationsPerIteration) {
+        Case newCase = { name, body, operationsPerIteration };
+        cases.push_back(newCase);
+    }
+
+    void BenchmarkRunner::Run() {
+        typedef std::chrono::steady_clock Clock;
+
+        results.clear();
+        for(std::size_t c = 0; c < cases.size(); c++) {
+            const Case& current = cases[c];
+            if(current.name.find(options.filter) == std::string::npos)
+                continue;
+
+            // calibrate, doubling the iteration count until a run is long enough
+            std::size_t iterations = 1;
+            for(;;) {
+                Clock::time_point start = Clock::now();
+                current.body(iterations);
+                double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                if(seconds >= options.minimumSeconds || iterations >= (std::size_t(1) << 30))
+                    break;
+                iterations *= 2;
+            }
+
+            // warm up once at the calibrated count, then time the repetitions
+            current.body(iterations);
+            std::vector<double> seconds, cycles;
+            for(int r = 0; r < options.repetitions; r++) {
+                Clock::time_point start = Clock::now();
+                std::uint64_t startCycles = ReadCycleCounter();
+                current.body(iterations);
+                std::uint64_t endCycles = ReadCycleCounter();
+                seconds.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+                cycles.push_back(double(endCycles - startCycles));
+            }
+
+            BenchmarkResult result;
+            result.name = current.name;
+            result.operations = iterations * current.operationsPerIteration;
+            result.nanosecondsPerOp = Median(seconds) * 1e9 / result.operations;
+            result.operationsPerNanosecond = 1.0 / result.nanosecondsPerOp;
+            result.cyclesPerOp = Median(cycles) / result.operations;
+            results.push_back(result);
+        }
+    }
+
+    const std::vector<BenchmarkResult>& BenchmarkRunner::GetResults() const {
+        return results;
+    }
+
+    void BenchmarkRunner::DisplayContents() const {
+        std::printf("%-44s %12s %12s %12s\n", "case", "ns/op", "ops/ns", "cycles/op");
+        for(std::size_t i = 0; i < results.size(); i++)
+            std::printf("%-44s %12.3f %12.3f %12.2f\n", results[i].name.c_str(),
+                        results[i].nanosecondsPerOp, results[i].operationsPerNanosecond,
+                        results[i].cyclesPerOp);
+        std::fflush(stdout);
+    }
+
+    void BenchmarkRunner::WriteJson(std::ostream& output) const {
+        char number[64];
+        output << "{\n";
+        output << "  \"seed\": " << options.seed << ",\n";
+        output << "  \"repetitions\": " << options.repetitions << ",\n";
+        output << "  \"simd\": \"" << SimdBackend() << "\",\n";
+#if defined(__VERSION__)
+        output << "  \"compiler\": ";
+        WriteJsonString(output, __VERSION__);
+        output << ",\n";
+#endif
+        output << "  \"results\": [\n";
+        for(std::size_t i = 0; i < results.size(); i++) {
+            output << "    {\"name\": ";
+            WriteJsonString(output, results[i].name);
+            std::snprintf(number, sizeof(number), "%.4f", results[i].nanosecondsPerOp);
+            output << ", \"ns_per_op\": " << number;
+            std::snprintf(number, sizeof(number), "%.4f", results[i].operationsPerNanosecond);
+            output << ", \"ops_per_ns\": " << number;
+            std::snprintf(number, sizeof(number), "%.3f", results[i].cyclesPerOp);
+            output << ", \"cycles_per_op\": " << number;
+            output << ", \"operations\": " << results[i].operations << "}";
+            output << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        output << "  ]\n";
+        output << "}\n";
+    }
+}
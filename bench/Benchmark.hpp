@@ -0,0 +1,172 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Benchmark.hpp
+ * 
+ * Microbenchmark harness with cycle counts and JSON output
+ * Class and method definitions
+ */
+
+/*!
+ \file Benchmark.hpp
+ Header definition for the BenchmarkRunner microbenchmark harness
+ */
+
+#ifndef BENCHMARK_HPP
+#define	BENCHMARK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace SCPPR {
+
+    //! Keeps the compiler from discarding a computed value
+    template <typename T>
+    inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        volatile const T* sink = &value;
+        (void)sink;
+#endif
+    }
+
+    //! Returns the processor time stamp counter, or 0 where unavailable
+    /*!
+     On x86 this counts reference cycles, which only match core cycles when
+     frequency scaling is disabled.
+     */
+    std::uint64_t ReadCycleCounter();
+
+    //! Settings shared by every case of a run
+    struct BenchmarkOptions {
+        std::string filter;       //!< Only cases whose name contains this run
+        std::string jsonPath;     //!< Results are written here when not empty
+        std::uint32_t seed;       //!< Seed for every input generator
+        int repetitions;          //!< Timed repetitions per case
+        double minimumSeconds;    //!< Minimum length of one repetition
+
+        //! Default options, seed 1, 7 repetitions of at least 10ms
+        BenchmarkOptions();
+    };
+
+    //! Timing of one benchmark case
+    struct BenchmarkResult {
+        std::string name;               //!< Case name
+        std::size_t operations;         //!< Operations timed per repetition
+        double nanosecondsPerOp;        //!< Median time per operation
+        double operationsPerNanosecond; //!< Throughput, inverse of the above
+        double cyclesPerOp;             //!< Median reference cycles per operation
+    };
+
+    //! Registers and times microbenchmark cases
+    /*!
+     Each case is a function that performs a given number of iterations. The
+     runner calibrates the iteration count so one repetition takes at least
+     the minimum time, warms up once, then reports the median of the timed
+     repetitions. Cases run in registration order so that JSON output from
+     two builds can be diffed line by line.
+     */
+    class BenchmarkRunner {
+
+    public:
+
+        //! A benchmark body, runs the measured loop iterations times
+        typedef std::function<void(std::size_t iterations)> Body;
+
+        //! Constructs a runner with the given options
+        explicit BenchmarkRunner(const BenchmarkOptions& optionsArg);
+
+        //! Returns the options of this runner
+        const BenchmarkOptions& GetOptions() const;
+
+        //! Registers a case performing operationsPerIteration operations per call
+        void Add(const std::string& name, const Body& body,
+                 std::size_t operationsPerIteration);
+
+        //! Registers a case applying operation to every index below count
+        /*!
+         The result of each call is kept alive with DoNotOptimize, so one
+         operation is one call of operation.
+         */
+        template <typename Operation>
+        void AddElementwise(const std::string& name, std::size_t count,
+                            Operation operation);
+
+        //! Runs every case matching the filter option
+        void Run();
+
+        //! Returns the results of the last Run
+        const std::vector<BenchmarkResult>& GetResults() const;
+
+        //! Prints the results of the last Run as a table
+        void DisplayContents() const;
+
+        //! Writes the results of the last Run and the build setup as JSON
+        void WriteJson(std::ostream& output) const;
+
+    protected:
+
+        //! A registered case
+        struct Case {
+            std::string name;
+            Body body;
+            std::size_t operationsPerIteration;
+        };
+
+        BenchmarkOptions options;             //!< Run settings
+        std::vector<Case> cases;              //!< Registered cases
+        std::vector<BenchmarkResult> results; //!< Results of the last Run
+    };
+
+    template <typename Operation>
+    inline void BenchmarkRunner::AddElementwise(const std::string& name, std::size_t count,
+                                                Operation operation) {
+        Add(name, [count, operation](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                for(std::size_t i = 0; i < count; i++)
+                    DoNotOptimize(operation(i));
+        }, count);
+    }
+
+    //! Registers wrapper versus raw Eigen comparisons for the math core
+    void RegisterCoreBenchmarks(BenchmarkRunner& runner);
+
+    //! Registers the Vector, Point, Normal, Matrix and Transform operators
+    void RegisterUtilityBenchmarks(BenchmarkRunner& runner);
+
+    //! Registers BVH build and traversal cases
+    void RegisterAccelBenchmarks(BenchmarkRunner& runner);
+
+    //! Registers heap, arena and pool allocation cases
+    void RegisterMemoryBenchmarks(BenchmarkRunner& runner);
+
+    //! Registers per number and per tile sample generation cases
+    void RegisterSamplerBenchmarks(BenchmarkRunner& runner);
+}
+
+#endif	/* BENCHMARK_HPP */
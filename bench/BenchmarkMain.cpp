@@ -0,0 +1,89 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   BenchmarkMain.cpp
+ * 
+ * Entry point of the microbenchmark executable
+ * Usage: scppraytracer-bench [--filter text] [--json file] [--seed n]
+ *                             [--repetitions n] [--min-time seconds]
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Benchmark.hpp"
+
+using namespace SCPPR;
+
+namespace {
+
+    void PrintUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [--filter text] [--json file]"
+                  << " [--seed n] [--repetitions n] [--min-time seconds]" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+
+    for(int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if(std::strcmp(argv[i], "--filter") == 0 && hasValue)
+            options.filter = argv[++i];
+        else if(std::strcmp(argv[i], "--json") == 0 && hasValue)
+            options.jsonPath = argv[++i];
+        else if(std::strcmp(argv[i], "--seed") == 0 && hasValue)
+            options.seed = (std::uint32_t)std::strtoul(argv[++i], NULL, 10);
+        else if(std::strcmp(argv[i], "--repetitions") == 0 && hasValue)
+            options.repetitions = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "--min-time") == 0 && hasValue)
+            options.minimumSeconds = std::atof(argv[++i]);
+        else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    BenchmarkRunner runner(options);
+    RegisterCoreBenchmarks(runner);
+    RegisterUtilityBenchmarks(runner);
+    RegisterAccelBenchmarks(runner);
+    RegisterMemoryBenchmarks(runner);
+    RegisterSamplerBenchmarks(runner);
+
+    runner.Run();
+    runner.DisplayContents();
+
+    if(!options.jsonPath.empty()) {
+        std::ofstream json(options.jsonPath.c_str());
+        if(!json) {
+            std::cerr << "Could not open " << options.jsonPath << std::endl;
+            return 1;
+        }
+        runner.WriteJson(json);
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   CoreBenchmarks.cpp
+ * 
+ * Wrapper versus raw Eigen benchmarks for Vector and Normal
+ * Both sides of each pair run the same loop over the same data, so equal
+ * timings show the wrappers add no overhead over Eigen::Vector4f.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/Dense>
+#include <Eigen/StdVector>
+
+#include "Benchmark.hpp"
+#include "utility/Normal.hpp"
+#include "utility/Vector.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const std::size_t elementCount = 1024; // fits comfortably in L1
+
+        typedef std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > EigenArray;
+
+        // Shared inputs, the same values in wrapper and Eigen form
+        struct CoreData {
+            std::vector<Vector> a, b;
+            std::vector<Normal> n;
+            EigenArray ea, eb;
+
+            explicit CoreData(std::uint32_t seed) {
+                std::mt19937 generator(seed);
+                std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+                for(std::size_t i = 0; i < elementCount; i++) {
+                    float v[6];
+                    for(int k = 0; k < 6; k++)
+                        v[k] = distribution(generator);
+                    a.push_back(Vector(v[0], v[1], v[2]));
+                    b.push_back(Vector(v[3], v[4], v[5]));
+                    n.push_back(Normal(v[0], v[1], v[2]));
+                    ea.push_back(Eigen::Vector4f(v[0], v[1], v[2], 0));
+                    eb.push_back(Eigen::Vector4f(v[3], v[4], v[5], 0));
+                }
+            }
+        };
+    }
+
+    void RegisterCoreBenchmarks(BenchmarkRunner& runner) {
+        std::shared_ptr<const CoreData> data = std::make_shared<const CoreData>(runner.GetOptions().seed);
+
+        runner.Add("core/dot/wrapper", [data](std::size_t iterations) {
+            const CoreData& d = *data;
+            for(std::size_t it = 0; it < iterations; it++) {
+                float sum = 0;
+                for(std::size_t i = 0; i < elementCount; i++)
+                    sum += d.a[i] * d.b[i];
+                DoNotOptimize(sum);
+            }
+        }, elementCount);
+
+        runner.Add("core/dot/eigen", [data](std::size_t iterations) {
+            const CoreData& d = *data;
+            for(std::size_t it = 0; it < iterations; it++) {
+                float sum = 0;
+                for(std::size_t i = 0; i < elementCount; i++)
+                    sum += d.ea[i].dot(d.eb[i]);
+                DoNotOptimize(sum);
+            }
+        }, elementCount);
+
+        runner.Add("core/cross/wrapper", [data](std::size_t iterations) {
+            const CoreData& d = *data;
+            for(std::size_t it = 0; it < iterations; it++) {
+                Vector sum;
+                for(std::size_t i = 0; i < elementCount; i++)
+                    sum += d.a[i] ^ d.b[i];
+                DoNotOptimize(sum);
+            }
+        }, elementCount);
+
+        runner.Add("core/cross/eigen", [data](std::size_t iterations) {
+            const CoreData& d = *data;
+            for(std::size_t it = 0; it < iterations; it++) {
+                Eigen::Vector4f sum = Eigen::Vector4f::Zero();
+                for(std::size_t i = 0; i < elementCount; i++)
+                    sum += d.ea[i].cross3(d.eb[i]);
+                DoNotOptimize(sum);
+            }
+        }, elementCount);
+
+        runner.Add("core/add/wrapper", [data](std::size_t iterations) {
+            const CoreData& d = *data;
+            for(std::size_t it = 0; it < iterations; it++) {
+                Vector sum;
+                for(std::size_t i = 0; i < elementCount; i++)
+                    sum += d.a[i] + d.b[i] * 0.5f;
+                DoNotOptimize(sum);
+            }
+        }, elementCount);
+
+        runner.Add("core/add/eigen", [data](std::size_t iterations) {
+            const CoreData& d = *data;
+            for(std::size_t it = 0; it < iterations; it++) {
+                Eigen::Vector4f sum = Eigen::Vector4f::Zero();
+                for(std::size_t i = 0; i < elementCount; i++)
+                    sum += d.ea[i] + d.eb[i] * 0.5f;
+                DoNotOptimize(sum);
+            }
+        }, elementCount);
+
+        runner.Add("core/normalize/wrapper", [data](std::size_t iterations) {
+            const CoreData& d = *data;
+            for(std::size_t it = 0; it < iterations; it++) {
+                float sum = 0;
+                for(std::size_t i = 0; i < elementCount; i++) {
+                    Normal unit = d.n[i];
+                    unit.Normalize();
+                    sum += unit.GetX();
+                }
+                DoNotOptimize(sum);
+            }
+        }, elementCount);
+
+        runner.Add("core/normalize/eigen", [data](std::size_t iterations) {
+            const CoreData& d = *data;
+            for(std::size_t it = 0; it < iterations; it++) {
+                float sum = 0;
+                for(std::size_t i = 0; i < elementCount; i++) {
+                    Eigen::Vector4f unit = d.ea[i];
+                    unit.normalize();
+                    sum += unit.x();
+                }
+                DoNotOptimize(sum);
+            }
+        }, elementCount);
+    }
+}
@@ -0,0 +1,184 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   MemoryBenchmarks.cpp
+ * 
+ * Scratch allocation benchmarks
+ * Compares the heap with the arena and pool allocators on small short lived
+ * allocations; one operation is one allocation. The texture cases time one
+ * filtered texture lookup per operation.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "memory/MemoryArena.hpp"
+#include "memory/ObjectPool.hpp"
+#include "io/TextureFile.hpp"
+#include "parallel/TaskPool.hpp"
+#include "render/TextureCache.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const std::size_t allocationCount = 1024; // allocations per iteration
+        const std::size_t recordSize = 48;        // bytes, about one hit record
+
+        // Fixed size record for the pool cases
+        struct Record {
+            float values[recordSize / sizeof(float)];
+        };
+
+        // Allocates and frees records through the heap
+        void HeapRecords() {
+            Record* records[allocationCount];
+            for(std::size_t i = 0; i < allocationCount; i++) {
+                records[i] = new Record();
+                DoNotOptimize(records[i]);
+            }
+            for(std::size_t i = 0; i < allocationCount; i++)
+                delete records[i];
+        }
+
+        // Allocates records from the thread's arena, then rewinds it
+        void ArenaRecords() {
+            MemoryArena& arena = MemoryArena::GetThreadArena();
+            MemoryArena::Scope scratch(arena);
+            for(std::size_t i = 0; i < allocationCount; i++)
+                DoNotOptimize(arena.Allocate<Record>());
+        }
+
+        const int textureSize = 2048;           // texels along each side of the test texture
+        const std::size_t lookupCount = 4096;   // lookups per iteration
+
+        // Writes a checkered test texture to the temporary directory and returns its path
+        std::string WriteTestTexture() {
+            std::vector<Color> pixels((std::size_t)textureSize * textureSize);
+            for(int y = 0; y < textureSize; y++)
+                for(int x = 0; x < textureSize; x++)
+                    pixels[(std::size_t)y * textureSize + x] = Color(((x ^ y) & 32) ? 0.8f : 0.2f,
+                                                                     (float)x / textureSize,
+                                                                     (float)y / textureSize);
+            const char* directory = std::getenv("TMPDIR");
+            std::string path = std::string(directory ? directory : "/tmp") + "/scppr-bench-texture.tex";
+            TextureFile::Write(pixels, textureSize, textureSize, path);
+            return path;
+        }
+
+        // Lookup positions, a scanline walk over a patch or scattered over the texture
+        std::vector<float> MakeLookups(bool coherent) {
+            std::mt19937 generator(5);
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            std::vector<float> uvs(2 * lookupCount);
+            for(std::size_t i = 0; i < lookupCount; i++) {
+                uvs[2 * i] = coherent ? 0.25f + (i % 64) / (float)textureSize : unit(generator);
+                uvs[2 * i + 1] = coherent ? 0.25f + (i / 64) / (float)textureSize : unit(generator);
+            }
+            return uvs;
+        }
+
+        // Samples every lookup position once at a footprint of about a texel
+        void SampleTexture(const TextureCache& cache, int texture, const std::vector<float>& uvs) {
+            for(std::size_t i = 0; i < lookupCount; i++)
+                DoNotOptimize(cache.Sample(texture, uvs[2 * i], uvs[2 * i + 1], 1.5f / textureSize));
+        }
+    }
+
+    void RegisterMemoryBenchmarks(BenchmarkRunner& runner) {
+        runner.Add("memory/heap", [](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                HeapRecords();
+        }, allocationCount);
+        runner.Add("memory/arena", [](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                ArenaRecords();
+        }, allocationCount);
+
+        std::shared_ptr<ObjectPool<Record> > pool = std::make_shared<ObjectPool<Record> >();
+        runner.Add("memory/pool", [pool](std::size_t iterations) {
+            Record* records[allocationCount];
+            for(std::size_t it = 0; it < iterations; it++) {
+                for(std::size_t i = 0; i < allocationCount; i++) {
+                    records[i] = pool->Acquire();
+                    DoNotOptimize(records[i]);
+                }
+                for(std::size_t i = 0; i < allocationCount; i++)
+                    pool->Release(records[i]);
+            }
+        }, allocationCount);
+
+        // every worker allocating at once, where a shared heap lock would show
+        std::shared_ptr<TaskPool> tasks = std::make_shared<TaskPool>();
+        const std::size_t batches = tasks->GetThreadCount() * 4;
+        runner.Add("memory/parallel/heap", [tasks, batches](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                tasks->ParallelFor(batches, 1, [](std::size_t begin, std::size_t end) {
+                    for(std::size_t batch = begin; batch < end; batch++)
+                        HeapRecords();
+                });
+        }, allocationCount * batches);
+        runner.Add("memory/parallel/arena", [tasks, batches](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                tasks->ParallelFor(batches, 1, [](std::size_t begin, std::size_t end) {
+                    for(std::size_t batch = begin; batch < end; batch++)
+                        ArenaRecords();
+                });
+        }, allocationCount * batches);
+
+        // a budget holding the whole texture, then one of 16 tiles that thrashes on scattered lookups
+        std::string texturePath = WriteTestTexture();
+        std::shared_ptr<TextureCache> resident = std::make_shared<TextureCache>(64u << 20);
+        std::shared_ptr<TextureCache> small = std::make_shared<TextureCache>(256u << 10);
+        const int residentTexture = resident->Add(texturePath);
+        const int smallTexture = small->Add(texturePath);
+        if(residentTexture < 0 || smallTexture < 0)
+            return;
+        std::shared_ptr<const std::vector<float> > coherent = std::make_shared<std::vector<float> >(MakeLookups(true));
+        std::shared_ptr<const std::vector<float> > scattered = std::make_shared<std::vector<float> >(MakeLookups(false));
+        runner.Add("texture/sample/coherent", [resident, residentTexture, coherent](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                SampleTexture(*resident, residentTexture, *coherent);
+        }, lookupCount);
+        runner.Add("texture/sample/scattered", [resident, residentTexture, scattered](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                SampleTexture(*resident, residentTexture, *scattered);
+        }, lookupCount);
+        runner.Add("texture/sample/scattered/small-budget", [small, smallTexture, scattered](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                SampleTexture(*small, smallTexture, *scattered);
+        }, lookupCount);
+        // every worker missing its own cache at once, where a single cache lock would show
+        runner.Add("texture/parallel/scattered", [tasks, batches, resident, residentTexture, scattered](std::size_t iterations) {
+            for(std::size_t it = 0; it < iterations; it++)
+                tasks->ParallelFor(batches, 1, [&](std::size_t begin, std::size_t end) {
+                    for(std::size_t batch = begin; batch < end; batch++)
+                        SampleTexture(*resident, residentTexture, *scattered);
+                });
+        }, lookupCount * batches);
+    }
+}
@@ -0,0 +1,78 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   SamplerBenchmarks.cpp
+ * 
+ * Sample generation benchmarks
+ * One operation is one sample number. The get cases ask for each number
+ * on its own, the tile cases fill a whole tile's SampleBlock at once.
+ */
+
+#include <cstdint>
+#include <string>
+
+#include "Benchmark.hpp"
+#include "memory/MemoryArena.hpp"
+#include "render/Sampler.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const int tileSize = 32;           // pixels along a tile edge
+        const int samplesPerPixel = 16;    // samples per pixel and iteration
+        const int dimensionCount = 4;      // lens, pixel and one bounce
+    }
+
+    void RegisterSamplerBenchmarks(BenchmarkRunner& runner) {
+        const std::size_t numbers = (std::size_t)tileSize * tileSize * samplesPerPixel * dimensionCount;
+        static const SamplerType types[] = { SamplerType::independent, SamplerType::halton, SamplerType::sobol,
+                                             SamplerType::blueNoise };
+        for(SamplerType type : types) {
+            Sampler sampler(type, runner.GetOptions().seed);
+            // builds the tables before timing starts
+            sampler.Get(0, 0, 0, 0);
+            const std::string name = std::string("sampler/") + Sampler::GetName(type);
+
+            runner.Add(name + "/get", [sampler](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++)
+                    for(int y = 0; y < tileSize; y++)
+                        for(int x = 0; x < tileSize; x++)
+                            for(int s = 0; s < samplesPerPixel; s++)
+                                for(int d = 0; d < dimensionCount; d++)
+                                    DoNotOptimize(sampler.Get(x, y, (std::uint32_t)s, d));
+            }, numbers);
+
+            runner.Add(name + "/tile", [sampler, numbers](std::size_t iterations) {
+                MemoryArena& arena = MemoryArena::GetThreadArena();
+                Tile tile = { 0, 0, tileSize, tileSize };
+                for(std::size_t it = 0; it < iterations; it++) {
+                    MemoryArena::Scope scratch(arena);
+                    SampleBlock block(arena, numbers / dimensionCount, dimensionCount);
+                    sampler.GenerateTile(tile, 0, samplesPerPixel, 0, block);
+                    DoNotOptimize(block.GetColumn(dimensionCount - 1)[block.GetSize() - 1]);
+                }
+            }, numbers);
+        }
+    }
+}
@@ -0,0 +1,378 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   UtilityBenchmarks.cpp
+ * 
+ * Throughput benchmarks for every operator of the utility math classes
+ * Scalar cases report one operation per element; batched and packet cases
+ * also count elements, so scalar and batched numbers compare directly.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "utility/Matrix.hpp"
+#include "utility/Normal.hpp"
+#include "utility/NormalPacket8.hpp"
+#include "utility/OctahedralNormal.hpp"
+#include "utility/Point.hpp"
+#include "utility/PointPacket8.hpp"
+#include "utility/Ray.hpp"
+#include "utility/RayPacket8.hpp"
+#include "utility/Transform.hpp"
+#include "utility/Vector.hpp"
+#include "utility/VectorPacket8.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const std::size_t elementCount = 1024; // multiple of 8, fits in L1
+
+        // Seeded inputs shared by every utility case
+        struct UtilityData {
+            std::vector<Vector> vectors, otherVectors;
+            std::vector<Point> points;
+            std::vector<Normal> normals;
+            std::vector<Ray> rays;
+            std::vector<float> scalars;
+            std::vector<float> x, y, z;
+            Matrix matrix;
+            Transform transform;
+
+            explicit UtilityData(std::uint32_t seed) {
+                std::mt19937 generator(seed);
+                std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+                for(std::size_t i = 0; i < elementCount; i++) {
+                    float v[9];
+                    for(int k = 0; k < 9; k++)
+                        v[k] = distribution(generator);
+                    vectors.push_back(Vector(v[0], v[1], v[2]));
+                    otherVectors.push_back(Vector(v[3], v[4], v[5]));
+                    points.push_back(Point(v[6], v[7], v[8]));
+                    normals.push_back(Normal(v[3], v[4], v[5]));
+                    rays.push_back(Ray(points.back(), vectors.back()));
+                    scalars.push_back(v[0] + 2.0f);
+                    x.push_back(v[6]);
+                    y.push_back(v[7]);
+                    z.push_back(v[8]);
+                }
+
+                transform = Transform::Translate(1.0f, -2.0f, 0.5f) *
+                            Transform::Rotate(0.7f, Vector(1.0f, 1.0f, 0.0f)) *
+                            Transform::Scale(1.0f, 2.0f, 3.0f);
+                transform.Prepare();
+                matrix = transform.GetMatrix();
+            }
+        };
+
+        // Scratch arrays written by the batched cases
+        struct UtilityOutput {
+            std::vector<Point> points;
+            std::vector<Vector> vectors;
+            std::vector<Normal> normals;
+            std::vector<float> x, y, z;
+
+            UtilityOutput() :
+                points(elementCount), vectors(elementCount), normals(elementCount),
+                x(elementCount), y(elementCount), z(elementCount) {
+
+            }
+        };
+
+        void RegisterVectorBenchmarks(BenchmarkRunner& runner, std::shared_ptr<const UtilityData> data) {
+            runner.AddElementwise("vector/add", elementCount, [data](std::size_t i) {
+                return data->vectors[i] + data->otherVectors[i];
+            });
+            runner.AddElementwise("vector/subtract", elementCount, [data](std::size_t i) {
+                return data->vectors[i] - data->otherVectors[i];
+            });
+            runner.AddElementwise("vector/add_assign", elementCount, [data](std::size_t i) {
+                Vector sum = data->vectors[i];
+                return sum += data->otherVectors[i];
+            });
+            runner.AddElementwise("vector/subtract_assign", elementCount, [data](std::size_t i) {
+                Vector difference = data->vectors[i];
+                return difference -= data->otherVectors[i];
+            });
+            runner.AddElementwise("vector/scale", elementCount, [data](std::size_t i) {
+                return data->vectors[i] * data->scalars[i];
+            });
+            runner.AddElementwise("vector/divide", elementCount, [data](std::size_t i) {
+                return data->vectors[i] / data->scalars[i];
+            });
+            runner.AddElementwise("vector/negate", elementCount, [data](std::size_t i) {
+                return -data->vectors[i];
+            });
+            runner.AddElementwise("vector/dot", elementCount, [data](std::size_t i) {
+                return data->vectors[i] * data->otherVectors[i];
+            });
+            runner.AddElementwise("vector/cross", elementCount, [data](std::size_t i) {
+                return data->vectors[i] ^ data->otherVectors[i];
+            });
+            runner.AddElementwise("vector/dot_normal", elementCount, [data](std::size_t i) {
+                return data->vectors[i] * data->normals[i];
+            });
+            runner.AddElementwise("vector/add_normal", elementCount, [data](std::size_t i) {
+                return data->vectors[i] + data->normals[i];
+            });
+            runner.AddElementwise("vector/magnitude", elementCount, [data](std::size_t i) {
+                return data->vectors[i].GetMagnitude();
+            });
+            runner.AddElementwise("vector/squared_magnitude", elementCount, [data](std::size_t i) {
+                return data->vectors[i].GetSquaredMagnitude();
+            });
+            runner.AddElementwise("vector/normalize", elementCount, [data](std::size_t i) {
+                Vector unit = data->vectors[i];
+                unit.Normalize();
+                return unit;
+            });
+        }
+
+        void RegisterPointBenchmarks(BenchmarkRunner& runner, std::shared_ptr<const UtilityData> data) {
+            runner.AddElementwise("point/add_vector", elementCount, [data](std::size_t i) {
+                return data->points[i] + data->vectors[i];
+            });
+            runner.AddElementwise("point/subtract_vector", elementCount, [data](std::size_t i) {
+                return data->points[i] - data->vectors[i];
+            });
+            runner.AddElementwise("point/subtract_point", elementCount, [data](std::size_t i) {
+                return data->points[i] - data->points[elementCount - 1 - i];
+            });
+            runner.AddElementwise("point/scale", elementCount, [data](std::size_t i) {
+                return data->points[i] * data->scalars[i];
+            });
+        }
+
+        void RegisterNormalBenchmarks(BenchmarkRunner& runner, std::shared_ptr<const UtilityData> data) {
+            runner.AddElementwise("normal/negate", elementCount, [data](std::size_t i) {
+                return -data->normals[i];
+            });
+            runner.AddElementwise("normal/add", elementCount, [data](std::size_t i) {
+                return data->normals[i] + data->normals[elementCount - 1 - i];
+            });
+            runner.AddElementwise("normal/add_assign", elementCount, [data](std::size_t i) {
+                Normal sum = data->normals[i];
+                return sum += data->normals[elementCount - 1 - i];
+            });
+            runner.AddElementwise("normal/scale", elementCount, [data](std::size_t i) {
+                return data->normals[i] * data->scalars[i];
+            });
+            runner.AddElementwise("normal/dot_vector", elementCount, [data](std::size_t i) {
+                return data->normals[i] * data->vectors[i];
+            });
+            runner.AddElementwise("normal/add_vector", elementCount, [data](std::size_t i) {
+                return data->normals[i] + data->vectors[i];
+            });
+            runner.AddElementwise("normal/magnitude", elementCount, [data](std::size_t i) {
+                return data->normals[i].GetMagnitude();
+            });
+            runner.AddElementwise("normal/normalize", elementCount, [data](std::size_t i) {
+                Normal unit = data->normals[i];
+                unit.Normalize();
+                return unit;
+            });
+
+            std::shared_ptr<std::vector<OctahedralNormal32> > encoded =
+                std::make_shared<std::vector<OctahedralNormal32> >(elementCount);
+            std::shared_ptr<UtilityOutput> output = std::make_shared<UtilityOutput>();
+            OctahedralNormal32::Encode(&data->normals[0], &(*encoded)[0], elementCount);
+            runner.AddElementwise("normal/octahedral32/encode", elementCount, [data](std::size_t i) {
+                return OctahedralNormal32(data->normals[i]);
+            });
+            runner.AddElementwise("normal/octahedral32/decode", elementCount, [encoded](std::size_t i) {
+                return Normal((*encoded)[i]);
+            });
+            runner.Add("normal/octahedral32/batch_encode", [data, encoded](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++) {
+                    OctahedralNormal32::Encode(&data->normals[0], &(*encoded)[0], elementCount);
+                    DoNotOptimize((*encoded)[0]);
+                }
+            }, elementCount);
+            runner.Add("normal/octahedral32/batch_decode", [encoded, output](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++) {
+                    OctahedralNormal32::Decode(&(*encoded)[0], &output->normals[0], elementCount);
+                    DoNotOptimize(output->normals[0]);
+                }
+            }, elementCount);
+        }
+
+        void RegisterMatrixBenchmarks(BenchmarkRunner& runner, std::shared_ptr<const UtilityData> data) {
+            std::shared_ptr<UtilityOutput> output = std::make_shared<UtilityOutput>();
+
+            runner.AddElementwise("matrix/point", elementCount, [data](std::size_t i) {
+                return data->matrix * data->points[i];
+            });
+            runner.AddElementwise("matrix/vector", elementCount, [data](std::size_t i) {
+                return data->matrix * data->vectors[i];
+            });
+            runner.AddElementwise("matrix/normal", elementCount, [data](std::size_t i) {
+                return data->matrix * data->normals[i];
+            });
+            runner.Add("matrix/multiply", [data](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++) {
+                    Matrix product = data->matrix * data->matrix;
+                    DoNotOptimize(product);
+                }
+            }, 1);
+
+            runner.Add("matrix/batch/points", [data, output](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++) {
+                    data->matrix.TransformPoints(&data->points[0], &output->points[0], elementCount);
+                    DoNotOptimize(output->points[0]);
+                }
+            }, elementCount);
+            runner.Add("matrix/batch/vectors", [data, output](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++) {
+                    data->matrix.TransformVectors(&data->vectors[0], &output->vectors[0], elementCount);
+                    DoNotOptimize(output->vectors[0]);
+                }
+            }, elementCount);
+            runner.Add("matrix/batch/normals", [data, output](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++) {
+                    data->matrix.TransformNormals(&data->normals[0], &output->normals[0], elementCount);
+                    DoNotOptimize(output->normals[0]);
+                }
+            }, elementCount);
+            runner.Add("matrix/batch_soa/points", [data, output](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++) {
+                    data->matrix.TransformPoints(&data->x[0], &data->y[0], &data->z[0],
+                                             &output->x[0], &output->y[0], &output->z[0], elementCount);
+                    DoNotOptimize(output->x[0]);
+                }
+            }, elementCount);
+            runner.Add("matrix/batch_soa/vectors", [data, output](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++) {
+                    data->matrix.TransformVectors(&data->x[0], &data->y[0], &data->z[0],
+                                              &output->x[0], &output->y[0], &output->z[0], elementCount);
+                    DoNotOptimize(output->x[0]);
+                }
+            }, elementCount);
+            runner.Add("matrix/batch_soa/normals", [data, output](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++) {
+                    data->matrix.TransformNormals(&data->x[0], &data->y[0], &data->z[0],
+                                              &output->x[0], &output->y[0], &output->z[0], elementCount);
+                    DoNotOptimize(output->x[0]);
+                }
+            }, elementCount);
+        }
+
+        void RegisterTransformBenchmarks(BenchmarkRunner& runner, std::shared_ptr<const UtilityData> data) {
+            runner.AddElementwise("transform/point", elementCount, [data](std::size_t i) {
+                return data->transform * data->points[i];
+            });
+            runner.AddElementwise("transform/vector", elementCount, [data](std::size_t i) {
+                return data->transform * data->vectors[i];
+            });
+            runner.AddElementwise("transform/normal", elementCount, [data](std::size_t i) {
+                return data->transform * data->normals[i];
+            });
+            runner.AddElementwise("transform/ray", elementCount, [data](std::size_t i) {
+                return data->transform * data->rays[i];
+            });
+            runner.AddElementwise("transform/inverse_point", elementCount, [data](std::size_t i) {
+                return data->transform.ApplyInverse(data->points[i]);
+            });
+            runner.AddElementwise("transform/inverse_ray", elementCount, [data](std::size_t i) {
+                return data->transform.ApplyInverse(data->rays[i]);
+            });
+            runner.Add("transform/compose", [data](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++) {
+                    Transform composed = data->transform * data->transform;
+                    DoNotOptimize(composed);
+                }
+            }, 1);
+        }
+
+        void RegisterPacketBenchmarks(BenchmarkRunner& runner, std::shared_ptr<const UtilityData> data) {
+            const std::size_t packetCount = elementCount / 8;
+
+            // every packet case counts eight operations per call
+            runner.Add("packet/gather_vectors", [data, packetCount](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++)
+                    for(std::size_t p = 0; p < packetCount; p++)
+                        DoNotOptimize(VectorPacket8::Gather(&data->vectors[p * 8]));
+            }, elementCount);
+            runner.Add("packet/vector/dot", [data, packetCount](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++)
+                    for(std::size_t p = 0; p < packetCount; p++) {
+                        VectorPacket8 a = VectorPacket8::Gather(&data->vectors[p * 8]);
+                        VectorPacket8 b = VectorPacket8::Gather(&data->otherVectors[p * 8]);
+                        DoNotOptimize(a * b);
+                    }
+            }, elementCount);
+            runner.Add("packet/vector/cross", [data, packetCount](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++)
+                    for(std::size_t p = 0; p < packetCount; p++) {
+                        VectorPacket8 a = VectorPacket8::Gather(&data->vectors[p * 8]);
+                        VectorPacket8 b = VectorPacket8::Gather(&data->otherVectors[p * 8]);
+                        DoNotOptimize(a ^ b);
+                    }
+            }, elementCount);
+            runner.Add("packet/vector/normalize", [data, packetCount](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++)
+                    for(std::size_t p = 0; p < packetCount; p++) {
+                        VectorPacket8 a = VectorPacket8::Gather(&data->vectors[p * 8]);
+                        a.Normalize();
+                        DoNotOptimize(a);
+                    }
+            }, elementCount);
+            runner.Add("packet/normal/dot_vector", [data, packetCount](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++)
+                    for(std::size_t p = 0; p < packetCount; p++) {
+                        NormalPacket8 n = NormalPacket8::Gather(&data->normals[p * 8]);
+                        VectorPacket8 v = VectorPacket8::Gather(&data->vectors[p * 8]);
+                        DoNotOptimize(n * v);
+                    }
+            }, elementCount);
+            runner.Add("packet/point/subtract_point", [data, packetCount](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++)
+                    for(std::size_t p = 0; p < packetCount; p++) {
+                        PointPacket8 a = PointPacket8::Gather(&data->points[p * 8]);
+                        PointPacket8 b = PointPacket8::Gather(&data->points[elementCount - 8 - p * 8]);
+                        DoNotOptimize(a - b);
+                    }
+            }, elementCount);
+            runner.Add("packet/ray/point_at", [data, packetCount](std::size_t iterations) {
+                for(std::size_t it = 0; it < iterations; it++)
+                    for(std::size_t p = 0; p < packetCount; p++) {
+                        RayPacket8 rays = RayPacket8::Gather(&data->rays[p * 8]);
+                        DoNotOptimize(rays.PointAt(Float8::LoadUnaligned(&data->scalars[p * 8])));
+                    }
+            }, elementCount);
+        }
+    }
+
+    void RegisterUtilityBenchmarks(BenchmarkRunner& runner) {
+        std::shared_ptr<const UtilityData> data = std::make_shared<const UtilityData>(runner.GetOptions().seed);
+        RegisterVectorBenchmarks(runner, data);
+        RegisterPointBenchmarks(runner, data);
+        RegisterNormalBenchmarks(runner, data);
+        RegisterMatrixBenchmarks(runner, data);
+        RegisterTransformBenchmarks(runner, data);
+        RegisterPacketBenchmarks(runner, data);
+    }
+}
@@ -35,10 +35,47 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 
 # Object Files
 OBJECTFILES= \
+	${OBJECTDIR}/src/accel/AABB.o \
+	${OBJECTDIR}/src/accel/BVH.o \
+	${OBJECTDIR}/src/accel/InstanceBVH.o \
+	${OBJECTDIR}/src/accel/LightBVH.o \
+	${OBJECTDIR}/src/accel/TriangleBVH.o \
+	${OBJECTDIR}/src/accel/TrianglePacket8.o \
+	${OBJECTDIR}/src/geometry/TriangleMesh.o \
+	${OBJECTDIR}/src/io/BVHCache.o \
+	${OBJECTDIR}/src/io/ImageWriter.o \
+	${OBJECTDIR}/src/io/MappedFile.o \
+	${OBJECTDIR}/src/io/MeshFile.o \
+	${OBJECTDIR}/src/io/MeshImporter.o \
+	${OBJECTDIR}/src/io/ObjImporter.o \
+	${OBJECTDIR}/src/io/PlyImporter.o \
+	${OBJECTDIR}/src/io/TextureFile.o \
 	${OBJECTDIR}/src/main.o \
+	${OBJECTDIR}/src/memory/MemoryArena.o \
+	${OBJECTDIR}/src/parallel/RenderCounters.o \
+	${OBJECTDIR}/src/parallel/TaskPool.o \
+	${OBJECTDIR}/src/parallel/TraceRecorder.o \
+	${OBJECTDIR}/src/render/Camera.o \
+	${OBJECTDIR}/src/render/Framebuffer.o \
+	${OBJECTDIR}/src/render/ProgressiveRenderer.o \
+	${OBJECTDIR}/src/render/RayQueue.o \
+	${OBJECTDIR}/src/render/RenderStatistics.o \
+	${OBJECTDIR}/src/render/Sampler.o \
+	${OBJECTDIR}/src/render/TextureCache.o \
+	${OBJECTDIR}/src/render/TileRenderer.o \
+	${OBJECTDIR}/src/render/WavefrontRenderer.o \
+	${OBJECTDIR}/src/utility/Color.o \
+	${OBJECTDIR}/src/utility/Matrix.o \
 	${OBJECTDIR}/src/utility/Normal.o \
+	${OBJECTDIR}/src/utility/Normal3Packed.o \
+	${OBJECTDIR}/src/utility/NormalPacket8.o \
 	${OBJECTDIR}/src/utility/Point.o \
-	${OBJECTDIR}/src/utility/Vector.o
+	${OBJECTDIR}/src/utility/Point3Packed.o \
+	${OBJECTDIR}/src/utility/PointPacket8.o \
+	${OBJECTDIR}/src/utility/Ray.o \
+	${OBJECTDIR}/src/utility/Transform.o \
+	${OBJECTDIR}/src/utility/Vector.o \
+	${OBJECTDIR}/src/utility/VectorPacket8.o
 
 
 # C Compiler Flags
@@ -63,27 +100,212 @@ LDLIBSOPTIONS=
 
 ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/scppraytracer: ${OBJECTFILES}
 	${MKDIR} -p ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}
-	${LINK.cc} -o ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/scppraytracer ${OBJECTFILES} ${LDLIBSOPTIONS}
+	${LINK.cc} -o ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/scppraytracer ${OBJECTFILES} ${LDLIBSOPTIONS} -pthread
+
+${OBJECTDIR}/src/accel/AABB.o: src/accel/AABB.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/accel
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/accel/AABB.o src/accel/AABB.cpp
+
+${OBJECTDIR}/src/accel/BVH.o: src/accel/BVH.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/accel
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/accel/BVH.o src/accel/BVH.cpp
+
+${OBJECTDIR}/src/accel/InstanceBVH.o: src/accel/InstanceBVH.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/accel
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/accel/InstanceBVH.o src/accel/InstanceBVH.cpp
+
+${OBJECTDIR}/src/accel/LightBVH.o: src/accel/LightBVH.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/accel
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/accel/LightBVH.o src/accel/LightBVH.cpp
+
+${OBJECTDIR}/src/accel/TriangleBVH.o: src/accel/TriangleBVH.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/accel
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/accel/TriangleBVH.o src/accel/TriangleBVH.cpp
+
+${OBJECTDIR}/src/accel/TrianglePacket8.o: src/accel/TrianglePacket8.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/accel
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/accel/TrianglePacket8.o src/accel/TrianglePacket8.cpp
+
+${OBJECTDIR}/src/geometry/TriangleMesh.o: src/geometry/TriangleMesh.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/geometry
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/geometry/TriangleMesh.o src/geometry/TriangleMesh.cpp
+
+${OBJECTDIR}/src/io/BVHCache.o: src/io/BVHCache.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/io
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/io/BVHCache.o src/io/BVHCache.cpp
+
+${OBJECTDIR}/src/io/ImageWriter.o: src/io/ImageWriter.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/io
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/io/ImageWriter.o src/io/ImageWriter.cpp
+
+${OBJECTDIR}/src/io/MappedFile.o: src/io/MappedFile.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/io
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/io/MappedFile.o src/io/MappedFile.cpp
+
+${OBJECTDIR}/src/io/MeshFile.o: src/io/MeshFile.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/io
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/io/MeshFile.o src/io/MeshFile.cpp
+
+${OBJECTDIR}/src/io/MeshImporter.o: src/io/MeshImporter.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/io
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/io/MeshImporter.o src/io/MeshImporter.cpp
+
+${OBJECTDIR}/src/io/ObjImporter.o: src/io/ObjImporter.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/io
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/io/ObjImporter.o src/io/ObjImporter.cpp
+
+${OBJECTDIR}/src/io/PlyImporter.o: src/io/PlyImporter.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/io
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/io/PlyImporter.o src/io/PlyImporter.cpp
+
+${OBJECTDIR}/src/io/TextureFile.o: src/io/TextureFile.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/io
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/io/TextureFile.o src/io/TextureFile.cpp
 
 ${OBJECTDIR}/src/main.o: src/main.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
-	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/main.o src/main.cpp
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/main.o src/main.cpp
+
+${OBJECTDIR}/src/memory/MemoryArena.o: src/memory/MemoryArena.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/memory
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/memory/MemoryArena.o src/memory/MemoryArena.cpp
+
+${OBJECTDIR}/src/parallel/RenderCounters.o: src/parallel/RenderCounters.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/parallel
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/parallel/RenderCounters.o src/parallel/RenderCounters.cpp
+
+${OBJECTDIR}/src/parallel/TaskPool.o: src/parallel/TaskPool.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/parallel
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/parallel/TaskPool.o src/parallel/TaskPool.cpp
+
+${OBJECTDIR}/src/parallel/TraceRecorder.o: src/parallel/TraceRecorder.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/parallel
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/parallel/TraceRecorder.o src/parallel/TraceRecorder.cpp
+
+${OBJECTDIR}/src/render/Camera.o: src/render/Camera.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/render
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/render/Camera.o src/render/Camera.cpp
+
+${OBJECTDIR}/src/render/Framebuffer.o: src/render/Framebuffer.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/render
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/render/Framebuffer.o src/render/Framebuffer.cpp
+
+${OBJECTDIR}/src/render/ProgressiveRenderer.o: src/render/ProgressiveRenderer.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/render
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/render/ProgressiveRenderer.o src/render/ProgressiveRenderer.cpp
+
+${OBJECTDIR}/src/render/RayQueue.o: src/render/RayQueue.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/render
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/render/RayQueue.o src/render/RayQueue.cpp
+
+${OBJECTDIR}/src/render/RenderStatistics.o: src/render/RenderStatistics.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/render
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/render/RenderStatistics.o src/render/RenderStatistics.cpp
+
+${OBJECTDIR}/src/render/Sampler.o: src/render/Sampler.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/render
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/render/Sampler.o src/render/Sampler.cpp
+
+${OBJECTDIR}/src/render/TextureCache.o: src/render/TextureCache.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/render
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/render/TextureCache.o src/render/TextureCache.cpp
+
+${OBJECTDIR}/src/render/TileRenderer.o: src/render/TileRenderer.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/render
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/render/TileRenderer.o src/render/TileRenderer.cpp
+
+${OBJECTDIR}/src/render/WavefrontRenderer.o: src/render/WavefrontRenderer.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/render
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/render/WavefrontRenderer.o src/render/WavefrontRenderer.cpp
+
+${OBJECTDIR}/src/utility/Color.o: src/utility/Color.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/utility
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Color.o src/utility/Color.cpp
+
+${OBJECTDIR}/src/utility/Matrix.o: src/utility/Matrix.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/utility
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Matrix.o src/utility/Matrix.cpp
 
 ${OBJECTDIR}/src/utility/Normal.o: src/utility/Normal.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src/utility
 	${RM} "$@.d"
-	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Normal.o src/utility/Normal.cpp
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Normal.o src/utility/Normal.cpp
+
+${OBJECTDIR}/src/utility/Normal3Packed.o: src/utility/Normal3Packed.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/utility
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Normal3Packed.o src/utility/Normal3Packed.cpp
+
+${OBJECTDIR}/src/utility/NormalPacket8.o: src/utility/NormalPacket8.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/utility
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/NormalPacket8.o src/utility/NormalPacket8.cpp
 
 ${OBJECTDIR}/src/utility/Point.o: src/utility/Point.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src/utility
 	${RM} "$@.d"
-	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Point.o src/utility/Point.cpp
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Point.o src/utility/Point.cpp
+
+${OBJECTDIR}/src/utility/Point3Packed.o: src/utility/Point3Packed.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/utility
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Point3Packed.o src/utility/Point3Packed.cpp
+
+${OBJECTDIR}/src/utility/PointPacket8.o: src/utility/PointPacket8.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/utility
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/PointPacket8.o src/utility/PointPacket8.cpp
+
+${OBJECTDIR}/src/utility/Ray.o: src/utility/Ray.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/utility
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Ray.o src/utility/Ray.cpp
+
+${OBJECTDIR}/src/utility/Transform.o: src/utility/Transform.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/utility
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Transform.o src/utility/Transform.cpp
 
 ${OBJECTDIR}/src/utility/Vector.o: src/utility/Vector.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src/utility
 	${RM} "$@.d"
-	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Vector.o src/utility/Vector.cpp
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/Vector.o src/utility/Vector.cpp
+
+${OBJECTDIR}/src/utility/VectorPacket8.o: src/utility/VectorPacket8.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src/utility
+	${RM} "$@.d"
+	$(COMPILE.cc) -g -I/opt/local/include/eigen3 -std=c++14 -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/utility/VectorPacket8.o src/utility/VectorPacket8.cpp
 
 # Subprojects
 .build-subprojects:
@@ -0,0 +1,233 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   AABB.hpp
+ * 
+ * Axis aligned bounding box
+ * Class and method definitions
+ */
+
+/*!
+ \file AABB.hpp
+ Header definition for the AABB class
+ */
+
+#ifndef AABB_HPP
+#define	AABB_HPP
+
+#include <algorithm>
+#include <limits>
+
+#include "../utility/Point.hpp"
+#include "../utility/Ray.hpp"
+#include "../utility/Vector.hpp"
+
+namespace SCPPR {
+
+    //! Axis aligned bounding box
+    /*!
+     Stores the minimum and maximum corners as Points. A default constructed
+     box is empty, with its minimum at +infinity and maximum at -infinity, so
+     that expanding it by anything yields that thing's bounds.
+     */
+    class AABB {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs an empty box
+         */
+        AABB();
+
+        //! Point constructor
+        /*!
+         Constructs a box containing only point
+         */
+        explicit AABB(const Point& point);
+
+        //! Corner constructor
+        /*!
+         Constructs the smallest box containing both points
+         */
+        AABB(const Point& first, const Point& second);
+
+        // end constructor declarations-----------------------------------------
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the minimum corner
+        const Point& GetMinimum() const;
+
+        //! Returns the maximum corner
+        const Point& GetMaximum() const;
+
+        // end accessor declarations--------------------------------------------
+
+        // begin general methods declarations-----------------------------------
+
+        //! Grows the box to contain point
+        void Expand(const Point& point);
+
+        //! Grows the box to contain box
+        void Expand(const AABB& box);
+
+        //! Returns true when the box contains nothing
+        bool IsEmpty() const;
+
+        //! Returns the vector from the minimum to the maximum corner
+        Vector GetDiagonal() const;
+
+        //! Returns the centre of the box
+        Point GetCentroid() const;
+
+        //! Returns the surface area of the box, 0 when empty
+        float GetSurfaceArea() const;
+
+        //! Returns the axis with the largest extent, 0 for x, 1 for y, 2 for z
+        int GetMaximumExtent() const;
+
+        //! Returns the position of point along axis relative to the box
+        /*!
+         0 at the minimum corner and 1 at the maximum corner
+         */
+        float GetOffset(const Point& point, int axis) const;
+
+        //! Slab test of ray against the box
+        /*!
+         inverseDirection holds the reciprocal of each ray direction
+         component. On a hit within [0, tMax] returns true and stores the
+         entry distance in tNear.
+         */
+        bool Intersect(const Ray& ray, const Vector& inverseDirection,
+                       float tMax, float& tNear) const;
+
+        //! Displays the corners in the console
+        void DisplayContents() const;
+
+        // end general methods declarations-------------------------------------
+
+    protected:
+
+        Point minimum; //!< Minimum corner
+        Point maximum; //!< Maximum corner
+    };
+
+    inline AABB::AABB() :
+        minimum(std::numeric_limits<float>::infinity(),
+                std::numeric_limits<float>::infinity(),
+                std::numeric_limits<float>::infinity()),
+        maximum(-std::numeric_limits<float>::infinity(),
+                -std::numeric_limits<float>::infinity(),
+                -std::numeric_limits<float>::infinity()) {
+
+    }
+
+    inline AABB::AABB(const Point& point) :
+        minimum(point), maximum(point) {
+
+    }
+
+    inline AABB::AABB(const Point& first, const Point& second) :
+        minimum(first.GetContents().cwiseMin(second.GetContents())),
+        maximum(first.GetContents().cwiseMax(second.GetContents())) {
+
+    }
+
+    inline const Point& AABB::GetMinimum() const {
+        return minimum;
+    }
+
+    inline const Point& AABB::GetMaximum() const {
+        return maximum;
+    }
+
+    inline void AABB::Expand(const Point& point) {
+        minimum = Point(minimum.GetContents().cwiseMin(point.GetContents()));
+        maximum = Point(maximum.GetContents().cwiseMax(point.GetContents()));
+    }
+
+    inline void AABB::Expand(const AABB& box) {
+        minimum = Point(minimum.GetContents().cwiseMin(box.minimum.GetContents()));
+        maximum = Point(maximum.GetContents().cwiseMax(box.maximum.GetContents()));
+    }
+
+    inline bool AABB::IsEmpty() const {
+        return minimum.GetX() > maximum.GetX() || minimum.GetY() > maximum.GetY() ||
+               minimum.GetZ() > maximum.GetZ();
+    }
+
+    inline Vector AABB::GetDiagonal() const {
+        return maximum - minimum;
+    }
+
+    inline Point AABB::GetCentroid() const {
+        return Point(0.5f * (minimum.GetContents() + maximum.GetContents()));
+    }
+
+    inline float AABB::GetSurfaceArea() const {
+        if(IsEmpty())
+            return 0.0f;
+        Vector diagonal = GetDiagonal();
+        return 2.0f * (diagonal.GetX() * diagonal.GetY() + diagonal.GetY() * diagonal.GetZ() +
+                       diagonal.GetZ() * diagonal.GetX());
+    }
+
+    inline int AABB::GetMaximumExtent() const {
+        Vector diagonal = GetDiagonal();
+        if(diagonal.GetX() > diagonal.GetY() && diagonal.GetX() > diagonal.GetZ())
+            return 0;
+        return diagonal.GetY() > diagonal.GetZ() ? 1 : 2;
+    }
+
+    inline float AABB::GetOffset(const Point& point, int axis) const {
+        float extent = maximum.Data()[axis] - minimum.Data()[axis];
+        float offset = point.Data()[axis] - minimum.Data()[axis];
+        return extent > 0.0f ? offset / extent : 0.0f;
+    }
+
+    inline bool AABB::Intersect(const Ray& ray, const Vector& inverseDirection,
+                                float tMax, float& tNear) const {
+        const float* origin = ray.GetOrigin().Data();
+        const float* inverse = inverseDirection.Data();
+        float t0 = 0.0f;
+        float t1 = tMax;
+        for(int axis = 0; axis < 3; axis++) {
+            float tEntry = (minimum.Data()[axis] - origin[axis]) * inverse[axis];
+            float tExit = (maximum.Data()[axis] - origin[axis]) * inverse[axis];
+            if(tEntry > tExit)
+                std::swap(tEntry, tExit);
+            // written so that NaN from 0 * infinity leaves the interval alone
+            t0 = tEntry > t0 ? tEntry : t0;
+            t1 = tExit < t1 ? tExit : t1;
+            if(t0 > t1)
+                return false;
+        }
+        tNear = t0;
+        return true;
+    }
+}
+
+#endif	/* AABB_HPP */
@@ -0,0 +1,496 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   BVH.cpp
+ * 
+ * Bounding volume hierarchy built with a binned surface area heuristic
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+#include "BVH.hpp"
+#include "../memory/MemoryArena.hpp"
+#include "../memory/ObjectPool.hpp"
+#include "../parallel/TaskPool.hpp"
+#include "../parallel/TraceRecorder.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        // Relative cost of visiting a node against testing one primitive
+        const float traversalCost = 1.0f;
+
+        // Primitives per task when bounds and bins of a large node are gathered in parallel
+        const std::uint32_t parallelChunkSize = 1 << 16;
+
+        // Primitive record reordered in place while building
+        struct BuildPrimitive {
+            AABB bounds;
+            Point centroid;
+            std::uint32_t index;
+        };
+
+        // Pointer based node, flattened once the whole tree is built
+        struct BuildNode {
+            AABB bounds;
+            BuildNode* children[2];
+            std::uint32_t first;
+            std::uint32_t count;
+            int axis;
+
+            BuildNode() : first(0), count(0), axis(0) {
+                children[0] = children[1] = 0;
+            }
+        };
+
+        // One SAH bin
+        struct Bin {
+            AABB bounds;
+            std::uint32_t count;
+
+            Bin() : count(0) {
+
+            }
+        };
+
+        // State shared by every task of one build
+        struct BuildContext {
+            std::vector<BuildPrimitive>& primitives;
+            TaskPool* pool;
+            std::uint32_t maximumLeafSize;
+            std::uint32_t batchWidth;
+            std::atomic<std::uint32_t> nodeCount;
+            // one node pool per worker plus one for the calling thread, freed with the context
+            std::vector<std::unique_ptr<ObjectPool<BuildNode> > > nodePools;
+
+            BuildContext(std::vector<BuildPrimitive>& primitivesArg, TaskPool* poolArg,
+                         std::uint32_t maximumLeafSizeArg, std::uint32_t batchWidthArg) :
+                primitives(primitivesArg), pool(poolArg), maximumLeafSize(maximumLeafSizeArg),
+                batchWidth(batchWidthArg), nodeCount(0) {
+                nodePools.resize(pool ? pool->GetThreadCount() + 1 : 1);
+                for(std::size_t i = 0; i < nodePools.size(); i++)
+                    nodePools[i].reset(new ObjectPool<BuildNode>(1024));
+            }
+
+            // Allocates a node from the calling thread's pool
+            BuildNode* NewNode() {
+                nodeCount++;
+                return nodePools[pool ? pool->GetWorkerIndex() + 1 : 0]->Acquire();
+            }
+
+            // Intersection cost of count primitives, in batches
+            float Cost(std::uint32_t count) const {
+                return (float)((count + batchWidth - 1) / batchWidth);
+            }
+        };
+
+        // Number of chunks the range [begin, end) is gathered in
+        std::uint32_t ChunkCount(const BuildContext& context, std::uint32_t begin, std::uint32_t end) {
+            if(!context.pool)
+                return 1;
+            return std::max(1u, (end - begin + parallelChunkSize - 1) / parallelChunkSize);
+        }
+
+        // Calls body(chunk, first, last) for every chunk of [begin, end)
+        template <typename Body>
+        void ForEachChunk(BuildContext& context, std::uint32_t begin, std::uint32_t end, Body body) {
+            const std::uint32_t chunks = ChunkCount(context, begin, end);
+            if(chunks == 1) {
+                body(0, begin, end);
+                return;
+            }
+            context.pool->ParallelFor(chunks, 1, [&body, begin, end](std::size_t first, std::size_t last) {
+                for(std::size_t chunk = first; chunk < last; chunk++) {
+                    std::uint32_t chunkBegin = begin + (std::uint32_t)chunk * parallelChunkSize;
+                    body((std::uint32_t)chunk, chunkBegin, std::min(end, chunkBegin + parallelChunkSize));
+                }
+            });
+        }
+
+        int BinIndex(const AABB& centroidBounds, const Point& centroid, int axis) {
+            int bin = (int)(BVH::binCount * centroidBounds.GetOffset(centroid, axis));
+            return std::min(std::max(bin, 0), BVH::binCount - 1);
+        }
+
+        BuildNode* MakeLeaf(BuildContext& context, const AABB& bounds,
+                            std::uint32_t begin, std::uint32_t end) {
+            BuildNode* node = context.NewNode();
+            node->bounds = bounds;
+            node->first = begin;
+            node->count = end - begin;
+            return node;
+        }
+
+        BuildNode* BuildRecursive(BuildContext& context, std::uint32_t begin,
+                                  std::uint32_t end, int depth) {
+            std::vector<BuildPrimitive>& primitives = context.primitives;
+            const std::uint32_t count = end - begin;
+
+            // per chunk partial results are scratch of this call, taken from the thread's arena
+            MemoryArena& arena = MemoryArena::GetThreadArena();
+            MemoryArena::Scope scratch(arena);
+            const std::uint32_t chunks = ChunkCount(context, begin, end);
+            AABB* chunkBounds = arena.Allocate<AABB>(chunks);
+            AABB* chunkCentroids = arena.Allocate<AABB>(chunks);
+            ForEachChunk(context, begin, end, [&](std::uint32_t chunk, std::uint32_t first, std::uint32_t last) {
+                for(std::uint32_t i = first; i < last; i++) {
+                    chunkBounds[chunk].Expand(primitives[i].bounds);
+                    chunkCentroids[chunk].Expand(primitives[i].centroid);
+                }
+            });
+
+            AABB bounds, centroidBounds;
+            for(std::uint32_t chunk = 0; chunk < chunks; chunk++) {
+                bounds.Expand(chunkBounds[chunk]);
+                centroidBounds.Expand(chunkCentroids[chunk]);
+            }
+
+            if(count <= 1)
+                return MakeLeaf(context, bounds, begin, end);
+
+            const int axis = centroidBounds.GetMaximumExtent();
+            const float extent = centroidBounds.GetMaximum().Data()[axis] -
+                                 centroidBounds.GetMinimum().Data()[axis];
+            std::uint32_t middle = begin;
+
+            if(extent > 0.0f && depth < BVH::medianSplitDepth) {
+                Bin* chunkBins = arena.Allocate<Bin>(chunks * BVH::binCount);
+                ForEachChunk(context, begin, end, [&](std::uint32_t chunk, std::uint32_t first, std::uint32_t last) {
+                    Bin* local = &chunkBins[chunk * BVH::binCount];
+                    for(std::uint32_t i = first; i < last; i++) {
+                        Bin& bin = local[BinIndex(centroidBounds, primitives[i].centroid, axis)];
+                        bin.bounds.Expand(primitives[i].bounds);
+                        bin.count++;
+                    }
+                });
+
+                Bin bins[BVH::binCount];
+                for(std::uint32_t chunk = 0; chunk < chunks; chunk++)
+                    for(int b = 0; b < BVH::binCount; b++) {
+                        bins[b].bounds.Expand(chunkBins[chunk * BVH::binCount + b].bounds);
+                        bins[b].count += chunkBins[chunk * BVH::binCount + b].count;
+                    }
+
+                // sweep from the right to get the area and count above each split
+                float rightArea[BVH::binCount];
+                std::uint32_t rightCount[BVH::binCount];
+                AABB accumulated;
+                std::uint32_t accumulatedCount = 0;
+                for(int b = BVH::binCount - 1; b > 0; b--) {
+                    accumulated.Expand(bins[b].bounds);
+                    accumulatedCount += bins[b].count;
+                    rightArea[b] = accumulated.GetSurfaceArea();
+                    rightCount[b] = accumulatedCount;
+                }
+
+                // then from the left, splitting between bin b - 1 and b
+                float bestCost = std::numeric_limits<float>::infinity();
+                int bestSplit = -1;
+                accumulated = AABB();
+                accumulatedCount = 0;
+                for(int b = 1; b < BVH::binCount; b++) {
+                    accumulated.Expand(bins[b - 1].bounds);
+                    accumulatedCount += bins[b - 1].count;
+                    if(accumulatedCount == 0 || rightCount[b] == 0)
+                        continue;
+                    float cost = accumulated.GetSurfaceArea() * context.Cost(accumulatedCount) +
+                                 rightArea[b] * context.Cost(rightCount[b]);
+                    if(cost < bestCost) {
+                        bestCost = cost;
+                        bestSplit = b;
+                    }
+                }
+
+                const float area = bounds.GetSurfaceArea();
+                const float leafCost = context.Cost(count);
+                const float splitCost = area > 0.0f ? traversalCost + bestCost / area : leafCost;
+                if(count <= context.maximumLeafSize && (bestSplit < 0 || leafCost <= splitCost))
+                    return MakeLeaf(context, bounds, begin, end);
+
+                if(bestSplit >= 0) {
+                    BuildPrimitive* split = std::partition(&primitives[begin], &primitives[0] + end,
+                        [&centroidBounds, axis, bestSplit](const BuildPrimitive& primitive) {
+                            return BinIndex(centroidBounds, primitive.centroid, axis) < bestSplit;
+                        });
+                    middle = (std::uint32_t)(split - &primitives[0]);
+                }
+            }
+            else if(count <= context.maximumLeafSize) {
+                return MakeLeaf(context, bounds, begin, end);
+            }
+
+            // coincident centroids or a deep subtree, halve by object median
+            if(middle == begin || middle == end) {
+                middle = begin + count / 2;
+                std::nth_element(&primitives[begin], &primitives[0] + middle, &primitives[0] + end,
+                    [axis](const BuildPrimitive& first, const BuildPrimitive& second) {
+                        return first.centroid.Data()[axis] < second.centroid.Data()[axis];
+                    });
+            }
+
+            BuildNode* node = context.NewNode();
+            node->bounds = bounds;
+            node->axis = axis;
+
+            if(context.pool && count >= (std::uint32_t)BVH::parallelThreshold) {
+                TaskGroup group;
+                BuildNode* parent = node;
+                context.pool->Submit(group, [&context, parent, begin, middle, depth]() {
+                    TraceRecorder::Scope trace("bvh subtree", "build", "primitives", middle - begin);
+                    parent->children[0] = BuildRecursive(context, begin, middle, depth + 1);
+                });
+                node->children[1] = BuildRecursive(context, middle, end, depth + 1);
+                context.pool->Wait(group);
+            }
+            else {
+                node->children[0] = BuildRecursive(context, begin, middle, depth + 1);
+                node->children[1] = BuildRecursive(context, middle, end, depth + 1);
+            }
+            return node;
+        }
+
+        void SetBounds(BVHNode& node, const AABB& bounds) {
+            const float* minimum = bounds.GetMinimum().Data();
+            const float* maximum = bounds.GetMaximum().Data();
+            for(int axis = 0; axis < 3; axis++) {
+                node.minimum[axis] = minimum[axis];
+                node.maximum[axis] = maximum[axis];
+            }
+        }
+
+        // Writes node and its subtree depth first starting at index, returns the next free index
+        std::uint32_t Flatten(const BuildNode& node, std::vector<BVHNode>& nodes, std::uint32_t index) {
+            BVHNode& flat = nodes[index];
+            SetBounds(flat, node.bounds);
+            flat.axis = (std::uint8_t)node.axis;
+            flat.padding = 0;
+
+            if(!node.children[0]) {
+                flat.offset = node.first;
+                flat.count = (std::uint16_t)node.count;
+                return index + 1;
+            }
+
+            flat.count = 0;
+            std::uint32_t next = Flatten(*node.children[0], nodes, index + 1);
+            nodes[index].offset = next;
+            return Flatten(*node.children[1], nodes, next);
+        }
+
+        // State shared by every task of one refit
+        struct RefitContext {
+            BVHNode* nodes;
+            const std::uint32_t* primitiveIndices;
+            const std::vector<AABB>& primitiveBounds;
+            TaskPool* pool;
+            int batchWidth;
+        };
+
+        // Leaf cost in started batches of the intersector
+        float LeafCost(int count, int batchWidth) {
+            return (float)((count + batchWidth - 1) / batchWidth);
+        }
+
+        // Refits the subtree rooted at index, whose nodes are [index, end), and returns
+        // the sum of every node's area times its traversal or leaf cost
+        float RefitRecursive(const RefitContext& context, std::uint32_t index, std::uint32_t end) {
+            BVHNode& node = context.nodes[index];
+            AABB bounds;
+            float cost;
+            if(node.IsLeaf()) {
+                for(std::uint32_t i = node.offset; i < node.offset + node.count; i++)
+                    bounds.Expand(context.primitiveBounds[context.primitiveIndices[i]]);
+                cost = bounds.GetSurfaceArea() * LeafCost(node.count, context.batchWidth);
+            }
+            else {
+                const std::uint32_t second = node.offset;
+                float firstCost, secondCost;
+                if(context.pool && end - index >= (std::uint32_t)BVH::parallelThreshold) {
+                    TaskGroup group;
+                    context.pool->Submit(group, [&context, &firstCost, index, second]() {
+                        firstCost = RefitRecursive(context, index + 1, second);
+                    });
+                    secondCost = RefitRecursive(context, second, end);
+                    context.pool->Wait(group);
+                }
+                else {
+                    firstCost = RefitRecursive(context, index + 1, second);
+                    secondCost = RefitRecursive(context, second, end);
+                }
+                bounds = context.nodes[index + 1].GetBounds();
+                bounds.Expand(context.nodes[second].GetBounds());
+                cost = bounds.GetSurfaceArea() * traversalCost + firstCost + secondCost;
+            }
+            SetBounds(node, bounds);
+            return cost;
+        }
+    }
+
+    BVH::BVH() :
+        nodes(0), nodeCount(0), primitiveIndices(0), primitiveCount(0), batchWidth(1),
+        cost(0.0f), builtCost(0.0f) {
+
+    }
+
+    BVH::BVH(const BVH& copy) :
+        nodes(copy.nodes), nodeCount(copy.nodeCount), primitiveIndices(copy.primitiveIndices),
+        primitiveCount(copy.primitiveCount), nodeStorage(copy.nodeStorage),
+        indexStorage(copy.indexStorage), file(copy.file), batchWidth(copy.batchWidth),
+        cost(copy.cost), builtCost(copy.builtCost) {
+        if(!file)
+            UpdateViews();
+    }
+
+    BVH& BVH::operator= (const BVH& copy) {
+        if(this != &copy) {
+            nodes = copy.nodes;
+            nodeCount = copy.nodeCount;
+            primitiveIndices = copy.primitiveIndices;
+            primitiveCount = copy.primitiveCount;
+            nodeStorage = copy.nodeStorage;
+            indexStorage = copy.indexStorage;
+            file = copy.file;
+            batchWidth = copy.batchWidth;
+            cost = copy.cost;
+            builtCost = copy.builtCost;
+            if(!file)
+                UpdateViews();
+        }
+        return(*this);
+    }
+
+    void BVH::Build(const std::vector<AABB>& primitiveBounds, TaskPool* pool,
+                    int maximumLeafSize, int batchWidth) {
+        nodeStorage.clear();
+        indexStorage.clear();
+        file.reset();
+        UpdateViews();
+        cost = builtCost = 0.0f;
+        if(primitiveBounds.empty())
+            return;
+
+        TraceRecorder::Scope trace("bvh build", "build", "primitives", (std::int64_t)primitiveBounds.size());
+        std::vector<BuildPrimitive> primitives(primitiveBounds.size());
+        for(std::size_t i = 0; i < primitiveBounds.size(); i++) {
+            primitives[i].bounds = primitiveBounds[i];
+            primitives[i].centroid = primitiveBounds[i].GetCentroid();
+            primitives[i].index = (std::uint32_t)i;
+        }
+
+        // leaf counts are stored in 16 bits
+        maximumLeafSize = std::min(std::max(maximumLeafSize, 1), (int)std::numeric_limits<std::uint16_t>::max());
+        batchWidth = std::max(batchWidth, 1);
+        this->batchWidth = batchWidth;
+        BuildContext context(primitives, pool, (std::uint32_t)maximumLeafSize, (std::uint32_t)batchWidth);
+        BuildNode* root = BuildRecursive(context, 0, (std::uint32_t)primitives.size(), 0);
+
+        TraceRecorder::Scope flattenTrace("bvh flatten", "build", "nodes", context.nodeCount.load());
+        nodeStorage.resize(context.nodeCount.load());
+        Flatten(*root, nodeStorage, 0);
+
+        indexStorage.resize(primitives.size());
+        for(std::size_t i = 0; i < primitives.size(); i++)
+            indexStorage[i] = primitives[i].index;
+        UpdateViews();
+        cost = builtCost = ComputeCost();
+    }
+
+    void BVH::Borrow(const std::shared_ptr<const MappedFile>& fileArg, const BVHNode* nodeData,
+                     std::size_t nodeCountArg, const std::uint32_t* indexData,
+                     std::size_t primitiveCountArg, int batchWidthArg) {
+        nodeStorage.clear();
+        nodeStorage.shrink_to_fit();
+        indexStorage.clear();
+        indexStorage.shrink_to_fit();
+        file = fileArg;
+        nodes = nodeData;
+        nodeCount = nodeCountArg;
+        primitiveIndices = indexData;
+        primitiveCount = primitiveCountArg;
+        batchWidth = std::max(batchWidthArg, 1);
+        // costs are measured when a refit first needs them
+        cost = builtCost = -1.0f;
+    }
+
+    void BVH::Refit(const std::vector<AABB>& primitiveBounds, TaskPool* pool) {
+        if(nodeCount == 0)
+            return;
+        if(builtCost < 0.0f)
+            builtCost = ComputeCost();
+        TraceRecorder::Scope trace("bvh refit", "build", "nodes", (std::int64_t)nodeCount);
+        Detach();
+        RefitContext context = { nodeStorage.data(), primitiveIndices, primitiveBounds, pool, batchWidth };
+        float scaledCost = RefitRecursive(context, 0, (std::uint32_t)nodeCount);
+        float area = nodes[0].GetBounds().GetSurfaceArea();
+        cost = area > 0.0f ? scaledCost / area : 0.0f;
+    }
+
+    float BVH::GetCost() const {
+        return cost < 0.0f ? ComputeCost() : cost;
+    }
+
+    float BVH::GetCostRatio() const {
+        if(builtCost <= 0.0f)
+            return 1.0f;
+        return GetCost() / builtCost;
+    }
+
+    void BVH::Detach() {
+        if(!file)
+            return;
+        nodeStorage.assign(nodes, nodes + nodeCount);
+        indexStorage.assign(primitiveIndices, primitiveIndices + primitiveCount);
+        file.reset();
+        UpdateViews();
+    }
+
+    float BVH::ComputeCost() const {
+        if(nodeCount == 0)
+            return 0.0f;
+        float area = nodes[0].GetBounds().GetSurfaceArea();
+        if(area <= 0.0f)
+            return 0.0f;
+        float scaledCost = 0.0f;
+        for(std::size_t i = 0; i < nodeCount; i++)
+            scaledCost += nodes[i].GetBounds().GetSurfaceArea() *
+                          (nodes[i].IsLeaf() ? LeafCost(nodes[i].count, batchWidth) : traversalCost);
+        return scaledCost / area;
+    }
+
+    void BVH::UpdateViews() {
+        nodes = nodeStorage.data();
+        nodeCount = nodeStorage.size();
+        primitiveIndices = indexStorage.data();
+        primitiveCount = indexStorage.size();
+    }
+
+    void BVH::DisplayContents() const {
+        std::cout << "BVH: " << nodeCount << " nodes, " << primitiveCount << " primitives"
+                  << (file ? ", mapped" : "") << std::endl;
+    }
+}
@@ -0,0 +1,552 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   BVH.hpp
+ * 
+ * Bounding volume hierarchy built with a binned surface area heuristic
+ * Class and method definitions
+ */
+
+/*!
+ \file BVH.hpp
+ Header definition for the BVH class and its flattened BVHNode
+ */
+
+#ifndef BVH_HPP
+#define	BVH_HPP
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "AABB.hpp"
+#include "../parallel/RenderCounters.hpp"
+#include "../utility/Ray.hpp"
+#include "../utility/RayPacket8.hpp"
+#include "../utility/Vector.hpp"
+
+namespace SCPPR {
+
+    class MappedFile;
+    class TaskPool;
+
+    //! Node of a flattened BVH
+    /*!
+     32 bytes and 32 byte aligned, so two nodes share a 64 byte cache line
+     and a node never straddles one. Nodes are stored depth first: the first
+     child of an interior node directly follows it and offset holds the index
+     of the second child. For a leaf, offset is the first entry of the
+     primitive index array and count is the number of primitives.
+     */
+    struct alignas(32) BVHNode {
+        float minimum[3];      //!< Minimum corner of the node bounds
+        float maximum[3];      //!< Maximum corner of the node bounds
+        std::uint32_t offset;  //!< Second child or first primitive index
+        std::uint16_t count;   //!< Primitive count, 0 for interior nodes
+        std::uint8_t axis;     //!< Split axis of an interior node
+        std::uint8_t padding;  //!< Unused
+
+        //! Returns true for leaf nodes
+        bool IsLeaf() const;
+
+        //! Returns the node bounds as an AABB
+        AABB GetBounds() const;
+    };
+
+    static_assert(sizeof(BVHNode) == 32, "BVHNode must stay 32 bytes");
+
+    //! Bounding volume hierarchy over a set of primitive bounds
+    /*!
+     The hierarchy only sees the bounds of each primitive, so it serves any
+     primitive type. Build partitions primitives with a binned surface area
+     heuristic and, given a TaskPool, builds large subtrees in parallel.
+     Intersect walks the flattened nodes and hands each candidate primitive
+     to a caller supplied intersector. The packet variants walk the nodes
+     once for eight coherent rays, slab testing every node against all of
+     them in SIMD.
+
+     The nodes and primitive indices are read through views that point
+     either at owned storage or, after Borrow, at a mapped cache file.
+
+     When primitives move, Refit recomputes the node bounds in place and
+     keeps the topology. The SAH cost of the refitted tree against the
+     cost at build tells callers when the old topology has degraded enough
+     to be worth a rebuild.
+     */
+    class BVH {
+
+    public:
+
+        static const int binCount = 16;             //!< SAH bins per split
+        static const int defaultLeafSize = 4;       //!< Leaf size SAH may keep by default
+        static const int parallelThreshold = 4096;  //!< Smallest subtree built as a task
+        static const int medianSplitDepth = 48;     //!< Depth after which splits halve
+        static const int maximumDepth = 128;        //!< Bound on depth, traversal stack size
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs an empty hierarchy
+         */
+        BVH();
+
+        //! Copy constructor
+        /*!
+         Copies owned buffers and shares borrowed ones
+         */
+        BVH(const BVH& copy);
+
+        //! Assignment operator
+        BVH& operator= (const BVH& copy);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Builds the hierarchy over primitiveBounds
+        /*!
+         Primitive i of the caller is the one bounded by primitiveBounds[i].
+         When pool is not null, subtrees of at least parallelThreshold
+         primitives are built as tasks on it. Leaves hold at most
+         maximumLeafSize primitives. batchWidth is the number of primitives
+         the leaf intersector tests at once; the SAH charges a leaf per
+         started batch rather than per primitive, so SIMD kernels get full
+         leaves.
+         */
+        void Build(const std::vector<AABB>& primitiveBounds, TaskPool* pool = 0,
+                   int maximumLeafSize = defaultLeafSize, int batchWidth = 1);
+
+        //! Points the hierarchy at nodes and indices inside a mapped file
+        /*!
+         The hierarchy shares ownership of file and reads the buffers in
+         place until the next Build or Refit. batchWidth is the one the
+         buffers were built with.
+         */
+        void Borrow(const std::shared_ptr<const MappedFile>& fileArg, const BVHNode* nodeData,
+                    std::size_t nodeCountArg, const std::uint32_t* indexData,
+                    std::size_t primitiveCountArg, int batchWidthArg = 1);
+
+        //! Recomputes every node's bounds from moved primitives
+        /*!
+         primitiveBounds holds the new bounds of the primitives the
+         hierarchy was built over, in the same order. Leaves are refitted
+         and parents enclose their children again, bottom up, with subtrees
+         of at least parallelThreshold nodes run as tasks on pool when it is
+         not null. A borrowed hierarchy is copied out of its file first.
+         */
+        void Refit(const std::vector<AABB>& primitiveBounds, TaskPool* pool = 0);
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the flattened nodes, the root first
+        const BVHNode* GetNodes() const;
+
+        //! Returns the number of nodes
+        std::size_t GetNodeCount() const;
+
+        //! Returns the primitive indices referenced by the leaves
+        const std::uint32_t* GetPrimitiveIndices() const;
+
+        //! Returns the number of primitive indices
+        std::size_t GetPrimitiveCount() const;
+
+        //! Returns true when the buffers live in a mapped file
+        bool IsBorrowed() const;
+
+        //! Returns the bounds of every primitive
+        AABB GetBounds() const;
+
+        //! Returns true when the hierarchy holds no primitives
+        bool IsEmpty() const;
+
+        //! Returns the SAH cost of the hierarchy
+        /*!
+         Expected node visits and primitive batch tests of a ray that hits
+         the root bounds.
+         */
+        float GetCost() const;
+
+        //! Returns the SAH cost over the cost right after the last Build
+        /*!
+         1 for a fresh build; grows as refits stretch nodes over primitives
+         that have moved apart.
+         */
+        float GetCostRatio() const;
+
+        // end accessor declarations--------------------------------------------
+
+        //! Finds the closest primitive hit along ray
+        /*!
+         For every primitive whose leaf the ray reaches, calls
+         intersector(primitiveIndex, ray, tMax). The intersector returns true
+         on a hit closer than tMax and lowers tMax to the hit distance.
+         Returns true when any call did so.
+         */
+        template <typename Intersector>
+        bool Intersect(const Ray& ray, float& tMax, Intersector& intersector) const;
+
+        //! Returns true as soon as any primitive is hit before tMax
+        template <typename Intersector>
+        bool IntersectAny(const Ray& ray, float tMax, Intersector& intersector) const;
+
+        //! Finds the closest hit, handing whole leaves to intersector
+        /*!
+         Calls intersector(leaf, ray, tMax) for every leaf the ray reaches,
+         with the same contract as Intersect. The leaf's primitives are
+         GetPrimitiveIndices()[leaf.offset] onwards, leaf.count of them.
+         */
+        template <typename LeafIntersector>
+        bool IntersectLeaves(const Ray& ray, float& tMax, LeafIntersector& intersector) const;
+
+        //! Returns true as soon as intersector reports a hit in any leaf
+        template <typename LeafIntersector>
+        bool IntersectAnyLeaves(const Ray& ray, float tMax, LeafIntersector& intersector) const;
+
+        //! Finds the closest hit of every active ray of a packet
+        /*!
+         Visits each node once for the whole packet and skips it when no
+         active lane reaches it before its own tMax lane. Calls
+         intersector(leaf, rays, lanes, tMax) for every leaf that some lane
+         reaches, where lanes holds those lanes; the intersector lowers the
+         tMax lanes it hits and returns them as a mask. Returns the lanes
+         that hit anything. Pays off for coherent rays, such as camera rays
+         through neighbouring pixels, that share most of their nodes.
+         */
+        template <typename PacketLeafIntersector>
+        Mask8 IntersectPacketLeaves(const RayPacket8& rays, const Mask8& active, Float8& tMax,
+                                    PacketLeafIntersector& intersector) const;
+
+        //! Returns the active lanes of a packet that hit anything before tMax
+        /*!
+         Calls intersector(leaf, rays, lanes, tMax) like IntersectPacketLeaves,
+         which returns the lanes it found occluded. Occluded lanes drop out
+         of the traversal and it stops once every lane is occluded.
+         */
+        template <typename PacketLeafIntersector>
+        Mask8 IntersectAnyPacketLeaves(const RayPacket8& rays, const Mask8& active, const Float8& tMax,
+                                       PacketLeafIntersector& intersector) const;
+
+        //! Displays node and primitive counts in the console
+        void DisplayContents() const;
+
+    protected:
+
+        //! Slab tests node against eight rays, returns the lanes it reaches
+        /*!
+         Matches AABB::Intersect lane for lane, including the handling of
+         NaN from rays starting on a slab they run parallel to.
+         */
+        static Mask8 IntersectNode(const BVHNode& node, const PointPacket8& origin,
+                                   const VectorPacket8& inverseDirection, const Float8& tMax);
+
+        //! Returns the number of lanes set in the low eight bits of bits
+        static int CountLanes(int bits);
+
+        //! Points the views at the owned buffers
+        void UpdateViews();
+
+        //! Copies borrowed buffers into owned storage
+        void Detach();
+
+        //! Returns the SAH cost computed from the current node bounds
+        float ComputeCost() const;
+
+        const BVHNode* nodes;                     //!< Depth first node view
+        std::size_t nodeCount;                    //!< Number of nodes
+        const std::uint32_t* primitiveIndices;    //!< Leaf primitive list view
+        std::size_t primitiveCount;               //!< Number of primitive indices
+        std::vector<BVHNode> nodeStorage;         //!< Owned nodes
+        std::vector<std::uint32_t> indexStorage;  //!< Owned primitive indices
+        std::shared_ptr<const MappedFile> file;   //!< Mapping the views borrow from
+        int batchWidth;                           //!< Primitives tested per leaf batch
+        float cost;                               //!< SAH cost, negative until computed
+        float builtCost;                          //!< SAH cost after the last build, negative until computed
+    };
+
+    inline bool BVHNode::IsLeaf() const {
+        return count > 0;
+    }
+
+    inline AABB BVHNode::GetBounds() const {
+        return AABB(Point(minimum), Point(maximum));
+    }
+
+    inline const BVHNode* BVH::GetNodes() const {
+        return nodes;
+    }
+
+    inline std::size_t BVH::GetNodeCount() const {
+        return nodeCount;
+    }
+
+    inline const std::uint32_t* BVH::GetPrimitiveIndices() const {
+        return primitiveIndices;
+    }
+
+    inline std::size_t BVH::GetPrimitiveCount() const {
+        return primitiveCount;
+    }
+
+    inline bool BVH::IsBorrowed() const {
+        return file != 0;
+    }
+
+    inline AABB BVH::GetBounds() const {
+        return nodeCount == 0 ? AABB() : nodes[0].GetBounds();
+    }
+
+    inline bool BVH::IsEmpty() const {
+        return nodeCount == 0;
+    }
+
+    template <typename Intersector>
+    inline bool BVH::Intersect(const Ray& ray, float& tMax, Intersector& intersector) const {
+        auto leafIntersector = [this, &intersector](const BVHNode& leaf, const Ray& leafRay, float& leafMax) {
+            bool hit = false;
+            for(std::uint32_t i = 0; i < leaf.count; i++)
+                if(intersector(primitiveIndices[leaf.offset + i], leafRay, leafMax))
+                    hit = true;
+            return hit;
+        };
+        return IntersectLeaves(ray, tMax, leafIntersector);
+    }
+
+    template <typename Intersector>
+    inline bool BVH::IntersectAny(const Ray& ray, float tMax, Intersector& intersector) const {
+        auto leafIntersector = [this, &intersector](const BVHNode& leaf, const Ray& leafRay, float leafMax) {
+            for(std::uint32_t i = 0; i < leaf.count; i++) {
+                float tHit = leafMax;
+                if(intersector(primitiveIndices[leaf.offset + i], leafRay, tHit))
+                    return true;
+            }
+            return false;
+        };
+        return IntersectAnyLeaves(ray, tMax, leafIntersector);
+    }
+
+    template <typename LeafIntersector>
+    inline bool BVH::IntersectLeaves(const Ray& ray, float& tMax, LeafIntersector& intersector) const {
+        if(nodeCount == 0)
+            return false;
+
+        const Vector& direction = ray.GetDirection();
+        Vector inverseDirection(1.0f / direction.GetX(), 1.0f / direction.GetY(),
+                                1.0f / direction.GetZ());
+        const bool negative[3] = { inverseDirection.GetX() < 0.0f,
+                                   inverseDirection.GetY() < 0.0f,
+                                   inverseDirection.GetZ() < 0.0f };
+
+        std::uint32_t stack[maximumDepth];
+        int stackSize = 0;
+        std::uint32_t current = 0;
+        std::uint64_t visits = 0;
+        bool hit = false;
+
+        for(;;) {
+            const BVHNode& node = nodes[current];
+            visits++;
+            float tNear;
+            if(node.GetBounds().Intersect(ray, inverseDirection, tMax, tNear)) {
+                if(node.IsLeaf()) {
+                    if(intersector(node, ray, tMax))
+                        hit = true;
+                }
+                else {
+                    // visit the child nearer along the split axis first
+                    if(negative[node.axis]) {
+                        stack[stackSize++] = current + 1;
+                        current = node.offset;
+                    }
+                    else {
+                        stack[stackSize++] = node.offset;
+                        current = current + 1;
+                    }
+                    continue;
+                }
+            }
+            if(stackSize == 0)
+                break;
+            current = stack[--stackSize];
+        }
+        RenderCounters::Add(RenderCounters::nodeVisits, visits);
+        return hit;
+    }
+
+    template <typename LeafIntersector>
+    inline bool BVH::IntersectAnyLeaves(const Ray& ray, float tMax, LeafIntersector& intersector) const {
+        if(nodeCount == 0)
+            return false;
+
+        const Vector& direction = ray.GetDirection();
+        Vector inverseDirection(1.0f / direction.GetX(), 1.0f / direction.GetY(),
+                                1.0f / direction.GetZ());
+
+        std::uint32_t stack[maximumDepth];
+        int stackSize = 0;
+        std::uint32_t current = 0;
+        std::uint64_t visits = 0;
+        bool occluded = false;
+
+        for(;;) {
+            const BVHNode& node = nodes[current];
+            visits++;
+            float tNear;
+            if(node.GetBounds().Intersect(ray, inverseDirection, tMax, tNear)) {
+                if(node.IsLeaf()) {
+                    if(intersector(node, ray, tMax)) {
+                        occluded = true;
+                        break;
+                    }
+                }
+                else {
+                    stack[stackSize++] = node.offset;
+                    current = current + 1;
+                    continue;
+                }
+            }
+            if(stackSize == 0)
+                break;
+            current = stack[--stackSize];
+        }
+        RenderCounters::Add(RenderCounters::nodeVisits, visits);
+        return occluded;
+    }
+
+    inline Mask8 BVH::IntersectNode(const BVHNode& node, const PointPacket8& origin,
+                                    const VectorPacket8& inverseDirection, const Float8& tMax) {
+        const Float8* origins[3] = { &origin.GetX(), &origin.GetY(), &origin.GetZ() };
+        const Float8* inverses[3] = { &inverseDirection.GetX(), &inverseDirection.GetY(),
+                                      &inverseDirection.GetZ() };
+        Float8 t0(0.0f);
+        Float8 t1 = tMax;
+        for(int axis = 0; axis < 3; axis++) {
+            Float8 tEntry = (Float8(node.minimum[axis]) - *origins[axis]) * *inverses[axis];
+            Float8 tExit = (Float8(node.maximum[axis]) - *origins[axis]) * *inverses[axis];
+            Mask8 swap = tEntry > tExit;
+            Float8 tNear = Float8::Select(swap, tExit, tEntry);
+            Float8 tFar = Float8::Select(swap, tEntry, tExit);
+            // Max and Min return their second operand for NaN lanes
+            t0 = Float8::Max(tNear, t0);
+            t1 = Float8::Min(tFar, t1);
+        }
+        return t0 <= t1;
+    }
+
+    inline int BVH::CountLanes(int bits) {
+        return (int)std::bitset<8>((unsigned long)bits).count();
+    }
+
+    template <typename PacketLeafIntersector>
+    inline Mask8 BVH::IntersectPacketLeaves(const RayPacket8& rays, const Mask8& active, Float8& tMax,
+                                            PacketLeafIntersector& intersector) const {
+        Mask8 hit;
+        if(nodeCount == 0 || active.None())
+            return hit;
+
+        const VectorPacket8& direction = rays.GetDirection();
+        VectorPacket8 inverseDirection(Float8(1.0f) / direction.GetX(), Float8(1.0f) / direction.GetY(),
+                                       Float8(1.0f) / direction.GetZ());
+        const int negative[3] = { (inverseDirection.GetX() < Float8(0.0f)).GetBits(),
+                                  (inverseDirection.GetY() < Float8(0.0f)).GetBits(),
+                                  (inverseDirection.GetZ() < Float8(0.0f)).GetBits() };
+
+        std::uint32_t stack[maximumDepth];
+        int stackSize = 0;
+        std::uint32_t current = 0;
+        std::uint64_t visits = 0;
+
+        for(;;) {
+            const BVHNode& node = nodes[current];
+            visits++;
+            Mask8 lanes = IntersectNode(node, rays.GetOrigin(), inverseDirection, tMax) & active;
+            if(lanes.Any()) {
+                if(node.IsLeaf())
+                    hit |= intersector(node, rays, lanes, tMax);
+                else {
+                    // visit first the child nearer for most of the lanes that got here
+                    int bits = lanes.GetBits();
+                    if(2 * CountLanes(negative[node.axis] & bits) > CountLanes(bits)) {
+                        stack[stackSize++] = current + 1;
+                        current = node.offset;
+                    }
+                    else {
+                        stack[stackSize++] = node.offset;
+                        current = current + 1;
+                    }
+                    continue;
+                }
+            }
+            if(stackSize == 0)
+                break;
+            current = stack[--stackSize];
+        }
+        RenderCounters::Add(RenderCounters::nodeVisits, visits);
+        return hit;
+    }
+
+    template <typename PacketLeafIntersector>
+    inline Mask8 BVH::IntersectAnyPacketLeaves(const RayPacket8& rays, const Mask8& active,
+                                               const Float8& tMax,
+                                               PacketLeafIntersector& intersector) const {
+        Mask8 occluded;
+        if(nodeCount == 0 || active.None())
+            return occluded;
+
+        const VectorPacket8& direction = rays.GetDirection();
+        VectorPacket8 inverseDirection(Float8(1.0f) / direction.GetX(), Float8(1.0f) / direction.GetY(),
+                                       Float8(1.0f) / direction.GetZ());
+
+        std::uint32_t stack[maximumDepth];
+        int stackSize = 0;
+        std::uint32_t current = 0;
+        std::uint64_t visits = 0;
+        Mask8 remaining = active;
+
+        for(;;) {
+            const BVHNode& node = nodes[current];
+            visits++;
+            Mask8 lanes = IntersectNode(node, rays.GetOrigin(), inverseDirection, tMax) & remaining;
+            if(lanes.Any()) {
+                if(node.IsLeaf()) {
+                    Mask8 blocked = intersector(node, rays, lanes, tMax);
+                    occluded |= blocked;
+                    remaining = remaining.AndNot(blocked);
+                    if(remaining.None())
+                        break;
+                }
+                else {
+                    stack[stackSize++] = node.offset;
+                    current = current + 1;
+                    continue;
+                }
+            }
+            if(stackSize == 0)
+                break;
+            current = stack[--stackSize];
+        }
+        RenderCounters::Add(RenderCounters::nodeVisits, visits);
+        return occluded;
+    }
+}
+
+#endif	/* BVH_HPP */
@@ -0,0 +1,131 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   InstanceBVH.cpp
+ * 
+ * Two level hierarchy over transformed instances of shared meshes
+ */
+
+#include <iostream>
+
+#include "InstanceBVH.hpp"
+#include "../parallel/TraceRecorder.hpp"
+
+namespace SCPPR {
+
+    InstanceBVH::InstanceBVH() {
+
+    }
+
+    std::uint32_t InstanceBVH::AddInstance(const std::shared_ptr<const TriangleBVH>& object,
+                                           const Transform& transform) {
+        Instance instance;
+        instance.object = object;
+        instance.transform = transform;
+        instance.transform.Prepare();
+        instance.bounds = GetWorldBounds(*object, transform);
+        instances.push_back(instance);
+        return (std::uint32_t)(instances.size() - 1);
+    }
+
+    void InstanceBVH::SetTransform(std::uint32_t index, const Transform& transform) {
+        instances[index].transform = transform;
+        instances[index].transform.Prepare();
+        changed.push_back(index);
+    }
+
+    void InstanceBVH::ObjectChanged(const TriangleBVH* object) {
+        for(std::size_t i = 0; i < instances.size(); i++)
+            if(instances[i].object.get() == object)
+                changed.push_back((std::uint32_t)i);
+    }
+
+    void InstanceBVH::Clear() {
+        instances.clear();
+        changed.clear();
+        bvh = BVH();
+    }
+
+    void InstanceBVH::Build(TaskPool* pool) {
+        TraceRecorder::Scope trace("instance build", "build", "instances", (std::int64_t)instances.size());
+        for(std::size_t i = 0; i < changed.size(); i++) {
+            Instance& instance = instances[changed[i]];
+            instance.bounds = GetWorldBounds(*instance.object, instance.transform);
+        }
+        changed.clear();
+        bvh.Build(GatherBounds(), pool);
+    }
+
+    bool InstanceBVH::Update(TaskPool* pool, float rebuildThreshold) {
+        if(instances.size() != bvh.GetPrimitiveCount()) {
+            Build(pool);
+            return true;
+        }
+        if(changed.empty())
+            return false;
+
+        for(std::size_t i = 0; i < changed.size(); i++) {
+            Instance& instance = instances[changed[i]];
+            instance.bounds = GetWorldBounds(*instance.object, instance.transform);
+        }
+        changed.clear();
+        std::vector<AABB> bounds = GatherBounds();
+        bvh.Refit(bounds, pool);
+        if(bvh.GetCostRatio() <= rebuildThreshold)
+            return false;
+        bvh.Build(bounds, pool);
+        return true;
+    }
+
+    void InstanceBVH::Borrow(const std::shared_ptr<const MappedFile>& file, const BVHNode* nodeData,
+                             std::size_t nodeCount, const std::uint32_t* indexData, std::size_t indexCount) {
+        bvh.Borrow(file, nodeData, nodeCount, indexData, indexCount);
+    }
+
+    AABB InstanceBVH::GetWorldBounds(const TriangleBVH& object, const Transform& transform) {
+        // world bounds enclose the eight transformed corners of the object bounds
+        AABB bounds;
+        AABB objectBounds = object.GetBVH().GetBounds();
+        if(!objectBounds.IsEmpty()) {
+            const Point& low = objectBounds.GetMinimum();
+            const Point& high = objectBounds.GetMaximum();
+            for(int corner = 0; corner < 8; corner++)
+                bounds.Expand(transform * Point(corner & 1 ? high.GetX() : low.GetX(),
+                                                corner & 2 ? high.GetY() : low.GetY(),
+                                                corner & 4 ? high.GetZ() : low.GetZ()));
+        }
+        return bounds;
+    }
+
+    std::vector<AABB> InstanceBVH::GatherBounds() const {
+        std::vector<AABB> bounds(instances.size());
+        for(std::size_t i = 0; i < instances.size(); i++)
+            bounds[i] = instances[i].bounds;
+        return bounds;
+    }
+
+    void InstanceBVH::DisplayContents() const {
+        std::cout << "InstanceBVH: " << instances.size() << " instances" << std::endl;
+        bvh.DisplayContents();
+    }
+}
@@ -0,0 +1,298 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   InstanceBVH.hpp
+ * 
+ * Two level hierarchy over transformed instances of shared meshes
+ * Class and method definitions
+ */
+
+/*!
+ \file InstanceBVH.hpp
+ Header definition for the InstanceBVH class
+ */
+
+#ifndef INSTANCEBVH_HPP
+#define	INSTANCEBVH_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/StdVector>
+
+#include "AABB.hpp"
+#include "BVH.hpp"
+#include "TriangleBVH.hpp"
+#include "../utility/Ray.hpp"
+#include "../utility/RayPacket8.hpp"
+#include "../utility/Transform.hpp"
+
+namespace SCPPR {
+
+    class TaskPool;
+
+    //! Closest hit found in an instanced scene
+    struct InstanceHit {
+        TriangleHit triangle;    //!< Hit in the object space of the instance
+        std::uint32_t instance;  //!< Index of the instance that was hit
+    };
+
+    //! Placement of a shared bottom level hierarchy in the world
+    /*!
+     The transform maps object space to world space and has its inverse
+     prepared, so it can be read from many threads.
+     */
+    struct Instance {
+        std::shared_ptr<const TriangleBVH> object; //!< Shared bottom level hierarchy
+        Transform transform;                       //!< Object to world
+        AABB bounds;                               //!< World bounds
+
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    };
+
+    //! Top level bounding volume hierarchy over instances
+    /*!
+     Each instance references a TriangleBVH built once in object space, so
+     an asset placed a thousand times costs its triangles once plus one
+     Instance per copy. A ray entering an instance's world bounds is moved
+     into object space with the cached inverse transform. Directions are
+     not renormalized, so hit distances stay in world units and tMax carries
+     across instances unchanged.
+
+     For animation, SetTransform and ObjectChanged record which instances
+     moved, and Update refits the top level over their new bounds instead
+     of rebuilding it.
+     */
+    class InstanceBVH {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs an empty scene
+         */
+        InstanceBVH();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Places object in the world with transform, returns the instance index
+        /*!
+         Takes effect at the next Build.
+         */
+        std::uint32_t AddInstance(const std::shared_ptr<const TriangleBVH>& object,
+                                  const Transform& transform);
+
+        //! Moves instance number index to transform
+        /*!
+         Takes effect at the next Update or Build.
+         */
+        void SetTransform(std::uint32_t index, const Transform& transform);
+
+        //! Records that object changed shape, for example after its own Update
+        /*!
+         Every instance of object gets new bounds at the next Update.
+         */
+        void ObjectChanged(const TriangleBVH* object);
+
+        //! Removes every instance
+        void Clear();
+
+        //! Builds the top level hierarchy over the instance bounds
+        void Build(TaskPool* pool = 0);
+
+        //! Brings the top level up to date with moved instances
+        /*!
+         Recomputes the bounds of instances changed since the last Build or
+         Update and refits the top level, in parallel when pool is not null.
+         Rebuilds instead when instances were added or the refitted SAH
+         cost exceeds rebuildThreshold times the cost at the last build.
+         Returns true when it rebuilt.
+         */
+        bool Update(TaskPool* pool = 0, float rebuildThreshold = 1.5f);
+
+        //! Points the top level hierarchy at buffers inside a mapped file
+        /*!
+         Takes the place of Build once every instance has been added. The
+         buffers must be the ones GetBVH() held after building the same
+         instances in the same order.
+         */
+        void Borrow(const std::shared_ptr<const MappedFile>& file, const BVHNode* nodeData,
+                    std::size_t nodeCount, const std::uint32_t* indexData, std::size_t indexCount);
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the number of instances
+        std::size_t GetInstanceCount() const;
+
+        //! Returns instance number index
+        const Instance& GetInstance(std::size_t index) const;
+
+        //! Returns the top level hierarchy
+        const BVH& GetBVH() const;
+
+        //! Returns the bounds of every instance
+        AABB GetBounds() const;
+
+        // end accessor declarations--------------------------------------------
+
+        //! Finds the closest hit before tMax
+        /*!
+         On a hit lowers tMax, fills hit and returns true. The triangle and
+         its barycentric coordinates refer to the instance's object.
+         */
+        bool Intersect(const Ray& ray, float& tMax, InstanceHit& hit) const;
+
+        //! Returns true when any instance is hit before tMax
+        bool IntersectAny(const Ray& ray, float tMax) const;
+
+        //! Finds the closest hit of every active ray of a packet
+        /*!
+         Lane i behaves as Intersect(ray i, tMax[i], hits[i]). The packet
+         enters each instance it reaches as a whole, moved into object space
+         with one batch transform. Returns the lanes that hit.
+         */
+        Mask8 IntersectPacket(const RayPacket8& rays, const Mask8& active, Float8& tMax,
+                              InstanceHit hits[8]) const;
+
+        //! Returns the active lanes of a packet that hit any instance before tMax
+        Mask8 IntersectAnyPacket(const RayPacket8& rays, const Mask8& active, const Float8& tMax) const;
+
+        //! Displays the instance and node counts in the console
+        void DisplayContents() const;
+
+    protected:
+
+        //! Moves a packet of world space rays into the object space of instance
+        static RayPacket8 ToObject(const Instance& instance, const RayPacket8& rays);
+
+        //! Returns the world bounds of object placed with transform
+        static AABB GetWorldBounds(const TriangleBVH& object, const Transform& transform);
+
+        //! Returns the world bounds of every instance
+        std::vector<AABB> GatherBounds() const;
+
+        //! Instance array, aligned for the matrices it holds
+        typedef std::vector<Instance, Eigen::aligned_allocator<Instance> > InstanceArray;
+
+        InstanceArray instances;              //!< Every placed instance
+        BVH bvh;                              //!< Hierarchy over instance world bounds
+        std::vector<std::uint32_t> changed;   //!< Instances moved since the last Build or Update
+    };
+
+    inline std::size_t InstanceBVH::GetInstanceCount() const {
+        return instances.size();
+    }
+
+    inline const Instance& InstanceBVH::GetInstance(std::size_t index) const {
+        return instances[index];
+    }
+
+    inline const BVH& InstanceBVH::GetBVH() const {
+        return bvh;
+    }
+
+    inline AABB InstanceBVH::GetBounds() const {
+        return bvh.GetBounds();
+    }
+
+    inline bool InstanceBVH::Intersect(const Ray& ray, float& tMax, InstanceHit& hit) const {
+        auto intersector = [this, &hit](std::uint32_t index, const Ray& worldRay, float& closest) {
+            const Instance& instance = instances[index];
+            if(!instance.object->Intersect(instance.transform.ApplyInverse(worldRay), closest, hit.triangle))
+                return false;
+            hit.instance = index;
+            return true;
+        };
+        return bvh.Intersect(ray, tMax, intersector);
+    }
+
+    inline bool InstanceBVH::IntersectAny(const Ray& ray, float tMax) const {
+        auto intersector = [this](std::uint32_t index, const Ray& worldRay, float closest) {
+            const Instance& instance = instances[index];
+            return instance.object->IntersectAny(instance.transform.ApplyInverse(worldRay), closest);
+        };
+        return bvh.IntersectAny(ray, tMax, intersector);
+    }
+
+    inline RayPacket8 InstanceBVH::ToObject(const Instance& instance, const RayPacket8& rays) {
+        alignas(32) float origin[3][8];
+        alignas(32) float direction[3][8];
+        rays.GetOrigin().GetX().Store(origin[0]);
+        rays.GetOrigin().GetY().Store(origin[1]);
+        rays.GetOrigin().GetZ().Store(origin[2]);
+        rays.GetDirection().GetX().Store(direction[0]);
+        rays.GetDirection().GetY().Store(direction[1]);
+        rays.GetDirection().GetZ().Store(direction[2]);
+        const Matrix& inverse = instance.transform.GetInverseMatrix();
+        inverse.TransformPoints(origin[0], origin[1], origin[2], 8);
+        inverse.TransformVectors(direction[0], direction[1], direction[2], 8);
+        return RayPacket8(PointPacket8(Float8::Load(origin[0]), Float8::Load(origin[1]),
+                                       Float8::Load(origin[2])),
+                          VectorPacket8(Float8::Load(direction[0]), Float8::Load(direction[1]),
+                                        Float8::Load(direction[2])));
+    }
+
+    inline Mask8 InstanceBVH::IntersectPacket(const RayPacket8& rays, const Mask8& active, Float8& tMax,
+                                              InstanceHit hits[8]) const {
+        auto leafIntersector = [this, hits](const BVHNode& leaf, const RayPacket8& worldRays,
+                                            const Mask8& lanes, Float8& closest) {
+            Mask8 hit;
+            for(std::uint32_t i = 0; i < leaf.count; i++) {
+                std::uint32_t index = bvh.GetPrimitiveIndices()[leaf.offset + i];
+                const Instance& instance = instances[index];
+                TriangleHit triangleHits[8];
+                Mask8 instanceHit = instance.object->IntersectPacket(ToObject(instance, worldRays), lanes,
+                                                                     closest, triangleHits);
+                for(int bits = instanceHit.GetBits(), lane = 0; bits != 0; bits >>= 1, lane++)
+                    if(bits & 1) {
+                        hits[lane].triangle = triangleHits[lane];
+                        hits[lane].instance = index;
+                    }
+                hit |= instanceHit;
+            }
+            return hit;
+        };
+        return bvh.IntersectPacketLeaves(rays, active, tMax, leafIntersector);
+    }
+
+    inline Mask8 InstanceBVH::IntersectAnyPacket(const RayPacket8& rays, const Mask8& active,
+                                                 const Float8& tMax) const {
+        auto leafIntersector = [this](const BVHNode& leaf, const RayPacket8& worldRays,
+                                      const Mask8& lanes, const Float8& closest) {
+            Mask8 occluded;
+            for(std::uint32_t i = 0; i < leaf.count && (lanes.AndNot(occluded)).Any(); i++) {
+                const Instance& instance = instances[bvh.GetPrimitiveIndices()[leaf.offset + i]];
+                occluded |= instance.object->IntersectAnyPacket(ToObject(instance, worldRays),
+                                                                lanes.AndNot(occluded), closest);
+            }
+            return occluded;
+        };
+        return bvh.IntersectAnyPacketLeaves(rays, active, tMax, leafIntersector);
+    }
+}
+
+#endif	/* INSTANCEBVH_HPP */
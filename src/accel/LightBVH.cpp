@@ -0,0 +1,378 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   LightBVH.cpp
+ * 
+ * Hierarchy over point and spot lights for importance sampling many lights
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#include "LightBVH.hpp"
+#include "../parallel/TraceRecorder.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const float pi = 3.14159265f;
+
+        // largest float below one, keeps remapped sample numbers in [0, 1)
+        const float oneMinusEpsilon = 0.99999994f;
+
+        float SafeSqrt(float value) {
+            return std::sqrt(std::max(value, 0.0f));
+        }
+
+        float SafeAcos(float value) {
+            return std::acos(std::min(std::max(value, -1.0f), 1.0f));
+        }
+
+        // cosine of max(0, a - b) from the sines and cosines of a and b
+        float CosSubClamped(float sinA, float cosA, float sinB, float cosB) {
+            if(cosA > cosB)
+                return 1.0f;
+            return cosA * cosB + sinA * sinB;
+        }
+
+        // sine of max(0, a - b) from the sines and cosines of a and b
+        float SinSubClamped(float sinA, float cosA, float sinB, float cosB) {
+            if(cosA > cosB)
+                return 0.0f;
+            return sinA * cosB - cosA * sinB;
+        }
+
+        // turns vector about a unit axis by angle radians
+        Vector Rotate(const Vector& vector, const Vector& axis, float angle) {
+            float cosAngle = std::cos(angle), sinAngle = std::sin(angle);
+            return vector * cosAngle + (axis ^ vector) * sinAngle + axis * ((axis * vector) * (1.0f - cosAngle));
+        }
+
+        int BinIndex(const AABB& centroidBounds, const Point& centroid, int axis) {
+            int bin = (int)(LightBVH::binCount * centroidBounds.GetOffset(centroid, axis));
+            return std::min(std::max(bin, 0), LightBVH::binCount - 1);
+        }
+    }
+
+    const int LightBVH::binCount;
+    const int LightBVH::medianSplitDepth;
+
+    LightBounds::LightBounds() :
+        axis(0.0f, 0.0f, 1.0f), power(0.0f), cosOrientation(1.0f), cosEmission(1.0f) {
+
+    }
+
+    LightBounds::LightBounds(const Light& light) :
+        bounds(light.position), axis(light.axis), power(light.GetPower()) {
+        // omnidirectional lights point every way at once, spots along their axis
+        if(light.cosSpread <= -1.0f) {
+            cosOrientation = -1.0f;
+            cosEmission = 0.0f;
+        }
+        else {
+            cosOrientation = 1.0f;
+            cosEmission = light.cosSpread;
+        }
+    }
+
+    void LightBounds::Expand(const LightBounds& other) {
+        if(other.bounds.IsEmpty())
+            return;
+        if(bounds.IsEmpty()) {
+            *this = other;
+            return;
+        }
+        bounds.Expand(other.bounds);
+        power += other.power;
+        cosEmission = std::min(cosEmission, other.cosEmission);
+
+        // the smallest cone around both orientation cones
+        if(cosOrientation <= -1.0f || other.cosOrientation <= -1.0f) {
+            cosOrientation = -1.0f;
+            return;
+        }
+        float thetaA = SafeAcos(cosOrientation), thetaB = SafeAcos(other.cosOrientation);
+        float thetaD = SafeAcos(axis * other.axis);
+        if(std::min(thetaD + thetaB, pi) <= thetaA)
+            return;
+        if(std::min(thetaD + thetaA, pi) <= thetaB) {
+            axis = other.axis;
+            cosOrientation = other.cosOrientation;
+            return;
+        }
+        float thetaO = 0.5f * (thetaA + thetaD + thetaB);
+        Vector turn = axis ^ other.axis;
+        if(thetaO >= pi || turn.GetSquaredMagnitude() == 0.0f) {
+            cosOrientation = -1.0f;
+            return;
+        }
+        turn.Normalize();
+        axis = Rotate(axis, turn, thetaO - thetaA);
+        axis.Normalize();
+        cosOrientation = std::cos(thetaO);
+    }
+
+    float LightBounds::GetImportance(const Point& point, const Normal& normal) const {
+        if(power <= 0.0f)
+            return 0.0f;
+
+        // distance to the centre, clamped so points inside the bounds do not blow up
+        Point centre = bounds.GetCentroid();
+        Vector toPoint = point - centre;
+        float squaredDistance = toPoint.GetSquaredMagnitude();
+        float halfDiagonal = 0.5f * bounds.GetDiagonal().GetMagnitude();
+        squaredDistance = std::max(squaredDistance, halfDiagonal);
+        float distance = std::sqrt(toPoint.GetSquaredMagnitude());
+        Vector direction = distance > 0.0f ? toPoint / distance : Vector(0.0f, 0.0f, 1.0f);
+
+        // angle the bounds subtend seen from point, all of them from inside
+        float cosBounds = -1.0f, sinBounds = 0.0f;
+        if(distance > halfDiagonal) {
+            float sinSquared = halfDiagonal * halfDiagonal / (distance * distance);
+            cosBounds = SafeSqrt(1.0f - sinSquared);
+            sinBounds = std::sqrt(sinSquared);
+        }
+
+        // smallest angle between point and a direction the lights favour
+        float cosToPoint = axis * direction;
+        float sinToPoint = SafeSqrt(1.0f - cosToPoint * cosToPoint);
+        float sinOrientation = SafeSqrt(1.0f - cosOrientation * cosOrientation);
+        float cosOutside = CosSubClamped(sinToPoint, cosToPoint, sinOrientation, cosOrientation);
+        float sinOutside = SinSubClamped(sinToPoint, cosToPoint, sinOrientation, cosOrientation);
+        float cosLight = CosSubClamped(sinOutside, cosOutside, sinBounds, cosBounds);
+        if(cosLight <= cosEmission)
+            return 0.0f;
+
+        float importance = power * cosLight / squaredDistance;
+        if(normal.GetSquaredMagnitude() > 0.0f) {
+            // smallest angle between the normal and a direction towards the bounds
+            float cosSurface = std::abs(normal * direction);
+            float sinSurface = SafeSqrt(1.0f - cosSurface * cosSurface);
+            importance *= CosSubClamped(sinSurface, cosSurface, sinBounds, cosBounds);
+        }
+        return std::max(importance, 0.0f);
+    }
+
+    float LightBounds::GetOrientationMeasure() const {
+        float thetaO = SafeAcos(cosOrientation);
+        float thetaE = SafeAcos(cosEmission);
+        float thetaW = std::min(thetaO + thetaE, pi);
+        float sinO = SafeSqrt(1.0f - cosOrientation * cosOrientation);
+        return 2.0f * pi * (1.0f - cosOrientation) +
+               0.5f * pi * (2.0f * thetaW * sinO - std::cos(thetaO - 2.0f * thetaW) - 2.0f * thetaO * sinO +
+                            cosOrientation);
+    }
+
+    LightBounds LightBVHNode::GetBounds() const {
+        LightBounds result;
+        result.bounds = AABB(Point(minimum[0], minimum[1], minimum[2]), Point(maximum[0], maximum[1], maximum[2]));
+        result.axis = Vector(axis[0], axis[1], axis[2]);
+        result.power = power;
+        result.cosOrientation = cosOrientation;
+        result.cosEmission = cosEmission;
+        return result;
+    }
+
+    LightBVH::LightBVH() {
+
+    }
+
+    void LightBVH::Build(const std::vector<Light>& lightsArg) {
+        TraceRecorder::Scope trace("light bvh build", "build", "lights", (std::int64_t)lightsArg.size());
+        lights = lightsArg;
+        nodes.clear();
+        trails.assign(lights.size(), 0);
+        depths.assign(lights.size(), 0);
+
+        std::vector<LightBounds> bounds;
+        std::vector<std::uint32_t> order;
+        bounds.reserve(lights.size());
+        for(std::size_t i = 0; i < lights.size(); i++) {
+            bounds.push_back(LightBounds(lights[i]));
+            if(bounds.back().power > 0.0f)
+                order.push_back((std::uint32_t)i);
+        }
+        if(order.empty())
+            return;
+        nodes.reserve(2 * order.size() - 1);
+        BuildRecursive(bounds, order, 0, order.size(), 0, 0);
+    }
+
+    LightBounds LightBVH::BuildRecursive(const std::vector<LightBounds>& bounds, std::vector<std::uint32_t>& order,
+                                         std::size_t begin, std::size_t end, std::uint64_t trail, int depth) {
+        const std::size_t index = nodes.size();
+        nodes.push_back(LightBVHNode());
+        LightBounds nodeBounds;
+        if(end - begin == 1) {
+            nodeBounds = bounds[order[begin]];
+            nodes[index].offset = order[begin];
+            nodes[index].count = 1;
+            trails[order[begin]] = trail;
+            depths[order[begin]] = (std::uint8_t)depth;
+        }
+        else {
+            AABB centroidBounds;
+            for(std::size_t i = begin; i < end; i++)
+                centroidBounds.Expand(bounds[order[i]].bounds.GetCentroid());
+            Vector extent = centroidBounds.GetDiagonal();
+            const float maximumExtent = std::max(extent.GetX(), std::max(extent.GetY(), extent.GetZ()));
+
+            // the split of least power times area times orientation spread, stretched for thin axes
+            std::size_t middle = begin + (end - begin) / 2;
+            if(maximumExtent > 0.0f && depth < medianSplitDepth) {
+                float bestCost = std::numeric_limits<float>::infinity();
+                int bestAxis = -1, bestSplit = 0;
+                for(int axis = 0; axis < 3; axis++) {
+                    if(extent.Data()[axis] <= 0.0f)
+                        continue;
+                    LightBounds bins[binCount];
+                    for(std::size_t i = begin; i < end; i++) {
+                        const LightBounds& light = bounds[order[i]];
+                        bins[BinIndex(centroidBounds, light.bounds.GetCentroid(), axis)].Expand(light);
+                    }
+                    LightBounds above[binCount];
+                    for(int b = binCount - 1; b > 0; b--) {
+                        above[b] = bins[b];
+                        if(b + 1 < binCount)
+                            above[b].Expand(above[b + 1]);
+                    }
+                    const float thinness = maximumExtent / extent.Data()[axis];
+                    LightBounds below;
+                    for(int b = 1; b < binCount; b++) {
+                        below.Expand(bins[b - 1]);
+                        if(below.power <= 0.0f || above[b].power <= 0.0f)
+                            continue;
+                        float cost = thinness *
+                            (below.power * below.GetOrientationMeasure() * below.bounds.GetSurfaceArea() +
+                             above[b].power * above[b].GetOrientationMeasure() * above[b].bounds.GetSurfaceArea());
+                        if(cost < bestCost) {
+                            bestCost = cost;
+                            bestAxis = axis;
+                            bestSplit = b;
+                        }
+                    }
+                }
+                if(bestAxis >= 0) {
+                    auto split = std::partition(order.begin() + begin, order.begin() + end,
+                        [&bounds, &centroidBounds, bestAxis, bestSplit](std::uint32_t light) {
+                            return BinIndex(centroidBounds, bounds[light].bounds.GetCentroid(), bestAxis) < bestSplit;
+                        });
+                    middle = (std::size_t)(split - order.begin());
+                }
+            }
+            else if(maximumExtent > 0.0f) {
+                const int axis = centroidBounds.GetMaximumExtent();
+                std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                    [&bounds, axis](std::uint32_t first, std::uint32_t second) {
+                        return bounds[first].bounds.GetCentroid().Data()[axis] <
+                               bounds[second].bounds.GetCentroid().Data()[axis];
+                    });
+            }
+            if(middle == begin || middle == end)
+                middle = begin + (end - begin) / 2;
+
+            nodeBounds = BuildRecursive(bounds, order, begin, middle, trail, depth + 1);
+            nodes[index].offset = (std::uint32_t)nodes.size();
+            nodes[index].count = 0;
+            nodeBounds.Expand(BuildRecursive(bounds, order, middle, end, trail | (1ull << depth), depth + 1));
+        }
+
+        LightBVHNode& node = nodes[index];
+        for(int axis = 0; axis < 3; axis++) {
+            node.minimum[axis] = nodeBounds.bounds.GetMinimum().Data()[axis];
+            node.maximum[axis] = nodeBounds.bounds.GetMaximum().Data()[axis];
+            node.axis[axis] = nodeBounds.axis.Data()[axis];
+        }
+        node.power = nodeBounds.power;
+        node.cosOrientation = nodeBounds.cosOrientation;
+        node.cosEmission = nodeBounds.cosEmission;
+        return nodeBounds;
+    }
+
+    bool LightBVH::Sample(const Point& point, const Normal& normal, float u, std::uint32_t& light,
+                          float& probability) const {
+        if(nodes.empty())
+            return false;
+        // a lone light still has to be able to reach point
+        if(nodes[0].IsLeaf() && nodes[0].GetBounds().GetImportance(point, normal) <= 0.0f)
+            return false;
+
+        std::uint32_t index = 0;
+        probability = 1.0f;
+        while(!nodes[index].IsLeaf()) {
+            const std::uint32_t first = index + 1, second = nodes[index].offset;
+            float firstImportance = nodes[first].GetBounds().GetImportance(point, normal);
+            float secondImportance = nodes[second].GetBounds().GetImportance(point, normal);
+            if(firstImportance <= 0.0f && secondImportance <= 0.0f)
+                return false;
+
+            // the sample number is stretched back over [0, 1) for the next choice
+            float firstProbability = firstImportance / (firstImportance + secondImportance);
+            if(u < firstProbability) {
+                index = first;
+                probability *= firstProbability;
+                u = std::min(u / firstProbability, oneMinusEpsilon);
+            }
+            else {
+                index = second;
+                probability *= 1.0f - firstProbability;
+                u = std::min((u - firstProbability) / (1.0f - firstProbability), oneMinusEpsilon);
+            }
+        }
+        light = nodes[index].offset;
+        return true;
+    }
+
+    float LightBVH::GetProbability(const Point& point, const Normal& normal, std::uint32_t light) const {
+        if(nodes.empty() || light >= lights.size())
+            return 0.0f;
+        if(nodes[0].IsLeaf())
+            return nodes[0].offset == light && nodes[0].GetBounds().GetImportance(point, normal) > 0.0f ? 1.0f : 0.0f;
+        if(depths[light] == 0)
+            return 0.0f;
+
+        std::uint32_t index = 0;
+        float probability = 1.0f;
+        for(int depth = 0; depth < depths[light]; depth++) {
+            const std::uint32_t first = index + 1, second = nodes[index].offset;
+            float firstImportance = nodes[first].GetBounds().GetImportance(point, normal);
+            float secondImportance = nodes[second].GetBounds().GetImportance(point, normal);
+            if(firstImportance <= 0.0f && secondImportance <= 0.0f)
+                return 0.0f;
+            const bool takeSecond = (trails[light] >> depth) & 1;
+            probability *= (takeSecond ? secondImportance : firstImportance) / (firstImportance + secondImportance);
+            index = takeSecond ? second : first;
+        }
+        return probability;
+    }
+
+    void LightBVH::DisplayContents() const {
+        std::cout << "LightBVH: " << lights.size() << " lights, " << nodes.size() << " nodes";
+        if(!nodes.empty())
+            std::cout << ", total power " << nodes[0].power;
+        std::cout << std::endl;
+    }
+}
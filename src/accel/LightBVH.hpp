@@ -0,0 +1,248 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   LightBVH.hpp
+ * 
+ * Hierarchy over point and spot lights for importance sampling many lights
+ * Class and method definitions
+ */
+
+/*!
+ \file LightBVH.hpp
+ Header definition for the LightBVH class, its lights and their bounds
+ */
+
+#ifndef LIGHTBVH_HPP
+#define	LIGHTBVH_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "AABB.hpp"
+#include "../utility/Color.hpp"
+#include "../utility/Normal.hpp"
+#include "../utility/Point.hpp"
+#include "../utility/Vector.hpp"
+
+namespace SCPPR {
+
+    //! Point light emitting into a cone about its axis
+    /*!
+     A cosSpread of -1 makes it emit in every direction. Inside the cone
+     the intensity is the same in every direction.
+     */
+    struct Light {
+        Point position;        //!< Where the light sits
+        Normal axis;           //!< Unit centre of the emission cone
+        Color intensity;       //!< Radiant intensity inside the cone
+        float cosSpread;       //!< Cosine of the cone's half angle
+
+        //! Constructs an omnidirectional light at position
+        Light(const Point& positionArg = Point(), const Color& intensityArg = Color(1.0f));
+
+        //! Constructs a spot light
+        Light(const Point& positionArg, const Normal& axisArg, float cosSpreadArg,
+              const Color& intensityArg);
+
+        //! Returns the intensity sent along a unit direction leaving the light
+        Color GetIntensity(const Vector& direction) const;
+
+        //! Returns the luminance of the power over the whole cone
+        float GetPower() const;
+    };
+
+    //! Bounds of a group of lights in space, power and direction
+    /*!
+     Every light of the group sits inside bounds and emits its strongest
+     light within cosOrientation of axis, none further than cosEmission
+     beyond that. A group of omnidirectional lights has a cosOrientation
+     of -1.
+     */
+    struct LightBounds {
+        AABB bounds;            //!< Positions of the lights
+        Vector axis;            //!< Unit centre of the orientation cone
+        float power;            //!< Summed luminance of the light powers
+        float cosOrientation;   //!< Cosine of the orientation cone's half angle
+        float cosEmission;      //!< Cosine of the spread beyond the orientation cone
+
+        //! Constructs bounds around no lights
+        LightBounds();
+
+        //! Constructs the bounds of a single light
+        explicit LightBounds(const Light& light);
+
+        //! Grows the bounds to hold another group
+        void Expand(const LightBounds& other);
+
+        //! Returns an estimate of the light the group sends to point
+        /*!
+         The estimate bounds the cosines at the light and, for a non zero
+         normal, at the surface from what bounds and cones allow, so a
+         group that cannot reach point scores zero.
+         */
+        float GetImportance(const Point& point, const Normal& normal) const;
+
+        //! Returns the solid angle measure of the orientation and emission cones
+        float GetOrientationMeasure() const;
+    };
+
+    //! Node of a flattened LightBVH
+    /*!
+     Stored depth first like BVHNode: the first child follows an interior
+     node and offset is the second child. A leaf holds one light and
+     offset is its index.
+     */
+    struct alignas(16) LightBVHNode {
+        float minimum[3];        //!< Minimum corner of the positions
+        float maximum[3];        //!< Maximum corner of the positions
+        float axis[3];           //!< Centre of the orientation cone
+        float power;             //!< Summed light power
+        float cosOrientation;    //!< As LightBounds
+        float cosEmission;       //!< As LightBounds
+        std::uint32_t offset;    //!< Second child or light index
+        std::uint32_t count;     //!< 1 for leaves, 0 for interior nodes
+
+        //! Returns true for leaf nodes
+        bool IsLeaf() const;
+
+        //! Returns the bounds of the node's lights
+        LightBounds GetBounds() const;
+    };
+
+    static_assert(sizeof(LightBVHNode) == 64, "LightBVHNode must stay 64 bytes");
+
+    //! Bounding volume hierarchy that picks lights in proportion to their contribution
+    /*!
+     Build groups lights with a binned surface area orientation heuristic,
+     which weighs the usual surface area cost by the power and the spread
+     of directions of each side. Sample walks from the root to a single
+     light, choosing between the two children of each node in proportion
+     to their importance at the shading point, so a pick costs O(log N)
+     importance evaluations and lights that cannot reach the point are
+     never chosen.
+
+     GetProbability replays the same choices from a bit trail recorded per
+     light, for weighting light picks against other strategies.
+     */
+    class LightBVH {
+
+    public:
+
+        static const int binCount = 12;          //!< Bins per axis when splitting
+        static const int medianSplitDepth = 32;  //!< Depth after which splits halve, bounding trails to 64 bits
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs a hierarchy with no lights
+         */
+        LightBVH();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Builds the hierarchy over a copy of lights
+        /*!
+         Lights without power are left out of the hierarchy and never
+         sampled.
+         */
+        void Build(const std::vector<Light>& lightsArg);
+
+        //! Picks a light for a shading point
+        /*!
+         normal may be zero for points inside media. Uses u in [0, 1),
+         writes the light index and the probability it was picked with and
+         returns true, or returns false when no light can reach point.
+         */
+        bool Sample(const Point& point, const Normal& normal, float u, std::uint32_t& light,
+                    float& probability) const;
+
+        //! Returns the probability that Sample picks light for a shading point
+        float GetProbability(const Point& point, const Normal& normal, std::uint32_t light) const;
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the number of lights
+        std::size_t GetLightCount() const;
+
+        //! Returns a light
+        const Light& GetLight(std::uint32_t light) const;
+
+        //! Returns the flattened nodes
+        const std::vector<LightBVHNode>& GetNodes() const;
+
+        // end accessor declarations--------------------------------------------
+
+        //! Displays the light and node counts in the console
+        void DisplayContents() const;
+
+    protected:
+
+        //! Builds the subtree over entries [begin, end) of order and returns its bounds
+        LightBounds BuildRecursive(const std::vector<LightBounds>& bounds, std::vector<std::uint32_t>& order,
+                                   std::size_t begin, std::size_t end, std::uint64_t trail, int depth);
+
+        std::vector<Light> lights;            //!< Lights by index
+        std::vector<LightBVHNode> nodes;      //!< Flattened hierarchy
+        std::vector<std::uint64_t> trails;    //!< Choices down to each light's leaf, bit d for depth d
+        std::vector<std::uint8_t> depths;     //!< Depth of each light's leaf, 0 when not in the hierarchy
+    };
+
+    inline Light::Light(const Point& positionArg, const Color& intensityArg) :
+        position(positionArg), axis(0.0f, 0.0f, 1.0f), intensity(intensityArg), cosSpread(-1.0f) {
+
+    }
+
+    inline Light::Light(const Point& positionArg, const Normal& axisArg, float cosSpreadArg,
+                        const Color& intensityArg) :
+        position(positionArg), axis(axisArg), intensity(intensityArg), cosSpread(cosSpreadArg) {
+
+    }
+
+    inline Color Light::GetIntensity(const Vector& direction) const {
+        return direction * axis >= cosSpread ? intensity : Color();
+    }
+
+    inline float Light::GetPower() const {
+        // intensity times the solid angle of the cone
+        return intensity.GetLuminance() * 6.2831853f * (1.0f - cosSpread);
+    }
+
+    inline bool LightBVHNode::IsLeaf() const {
+        return count != 0;
+    }
+
+    inline std::size_t LightBVH::GetLightCount() const {
+        return lights.size();
+    }
+
+    inline const Light& LightBVH::GetLight(std::uint32_t light) const {
+        return lights[light];
+    }
+
+    inline const std::vector<LightBVHNode>& LightBVH::GetNodes() const {
+        return nodes;
+    }
+}
+
+#endif	/* LIGHTBVH_HPP */
@@ -0,0 +1,221 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TriangleBVH.cpp
+ * 
+ * BVH over triangles with SIMD tests at the leaves
+ */
+
+#include <iostream>
+
+#include "TriangleBVH.hpp"
+#include "../geometry/TriangleMesh.hpp"
+#include "../parallel/TaskPool.hpp"
+#include "../parallel/TraceRecorder.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        // Triangles or nodes per task when bounds and packets are filled in parallel
+        const std::size_t parallelGrainSize = 4096;
+    }
+
+    TriangleBVH::TriangleBVH() :
+        packets(0), packetCount(0), leafPacket(0), triangleCount(0) {
+
+    }
+
+    TriangleBVH::TriangleBVH(const TriangleBVH& copy) :
+        bvh(copy.bvh), packets(copy.packets), packetCount(copy.packetCount),
+        leafPacket(copy.leafPacket), packetStorage(copy.packetStorage),
+        leafPacketStorage(copy.leafPacketStorage), triangleCount(copy.triangleCount) {
+        if(!bvh.IsBorrowed())
+            UpdateViews();
+    }
+
+    TriangleBVH& TriangleBVH::operator= (const TriangleBVH& copy) {
+        if(this != &copy) {
+            bvh = copy.bvh;
+            packets = copy.packets;
+            packetCount = copy.packetCount;
+            leafPacket = copy.leafPacket;
+            packetStorage = copy.packetStorage;
+            leafPacketStorage = copy.leafPacketStorage;
+            triangleCount = copy.triangleCount;
+            if(!bvh.IsBorrowed())
+                UpdateViews();
+        }
+        return(*this);
+    }
+
+    void TriangleBVH::Build(const std::vector<Point>& vertices, const std::vector<std::uint32_t>& indices,
+                            TaskPool* pool) {
+        auto corner = [&vertices, &indices](std::size_t triangle, int k) {
+            return vertices[indices[3 * triangle + k]];
+        };
+        BuildTriangles(indices.size() / 3, corner, pool);
+    }
+
+    void TriangleBVH::Build(const TriangleMesh& mesh, TaskPool* pool) {
+        auto corner = [&mesh](std::size_t triangle, int k) {
+            return mesh.GetPosition(mesh.GetTriangle(triangle)[k]);
+        };
+        BuildTriangles(mesh.GetTriangleCount(), corner, pool);
+    }
+
+    bool TriangleBVH::Update(const std::vector<Point>& vertices, const std::vector<std::uint32_t>& indices,
+                             TaskPool* pool, float rebuildThreshold) {
+        auto corner = [&vertices, &indices](std::size_t triangle, int k) {
+            return vertices[indices[3 * triangle + k]];
+        };
+        return UpdateTriangles(indices.size() / 3, corner, pool, rebuildThreshold);
+    }
+
+    bool TriangleBVH::Update(const TriangleMesh& mesh, TaskPool* pool, float rebuildThreshold) {
+        auto corner = [&mesh](std::size_t triangle, int k) {
+            return mesh.GetPosition(mesh.GetTriangle(triangle)[k]);
+        };
+        return UpdateTriangles(mesh.GetTriangleCount(), corner, pool, rebuildThreshold);
+    }
+
+    template <typename CornerFunction>
+    void TriangleBVH::BuildTriangles(std::size_t count, const CornerFunction& corner, TaskPool* pool) {
+        triangleCount = count;
+        std::vector<AABB> bounds;
+        {
+            TraceRecorder::Scope trace("triangle bounds", "build", "triangles", (std::int64_t)count);
+            GatherBounds(corner, pool, bounds);
+        }
+        bvh.Build(bounds, pool, TrianglePacket8::width, TrianglePacket8::width);
+        TraceRecorder::Scope trace("triangle packets", "build", "triangles", (std::int64_t)count);
+        AssignPackets();
+        FillPackets(corner, pool);
+    }
+
+    template <typename CornerFunction>
+    bool TriangleBVH::UpdateTriangles(std::size_t count, const CornerFunction& corner, TaskPool* pool,
+                                      float rebuildThreshold) {
+        if(count != triangleCount || bvh.IsEmpty()) {
+            BuildTriangles(count, corner, pool);
+            return true;
+        }
+
+        if(packets != packetStorage.data()) {
+            // packets are about to be rewritten, take them out of the file
+            // before the refit detaches the hierarchy and releases it
+            packetStorage.assign(packets, packets + packetCount);
+            leafPacketStorage.assign(leafPacket, leafPacket + bvh.GetPrimitiveCount());
+            UpdateViews();
+        }
+
+        std::vector<AABB> bounds;
+        GatherBounds(corner, pool, bounds);
+        bvh.Refit(bounds, pool);
+        bool rebuilt = bvh.GetCostRatio() > rebuildThreshold;
+        if(rebuilt) {
+            bvh.Build(bounds, pool, TrianglePacket8::width, TrianglePacket8::width);
+            AssignPackets();
+        }
+        FillPackets(corner, pool);
+        return rebuilt;
+    }
+
+    template <typename CornerFunction>
+    void TriangleBVH::GatherBounds(const CornerFunction& corner, TaskPool* pool, std::vector<AABB>& bounds) const {
+        bounds.resize(triangleCount);
+        auto gather = [&corner, &bounds](std::size_t begin, std::size_t end) {
+            for(std::size_t i = begin; i < end; i++) {
+                AABB box(corner(i, 0), corner(i, 1));
+                box.Expand(corner(i, 2));
+                bounds[i] = box;
+            }
+        };
+        if(pool)
+            pool->ParallelFor(triangleCount, parallelGrainSize, gather);
+        else
+            gather(0, triangleCount);
+    }
+
+    void TriangleBVH::AssignPackets() {
+        // one packet per leaf, in node order
+        const BVHNode* nodes = bvh.GetNodes();
+        leafPacketStorage.assign(bvh.GetPrimitiveCount(), 0);
+        std::size_t leafCount = 0;
+        for(std::size_t n = 0; n < bvh.GetNodeCount(); n++)
+            if(nodes[n].IsLeaf())
+                leafPacketStorage[nodes[n].offset] = (std::uint32_t)leafCount++;
+        packetStorage.assign(leafCount, TrianglePacket8());
+        UpdateViews();
+    }
+
+    template <typename CornerFunction>
+    void TriangleBVH::FillPackets(const CornerFunction& corner, TaskPool* pool) {
+        // copy the triangles of every leaf into its packet
+        const BVHNode* nodes = bvh.GetNodes();
+        const std::uint32_t* order = bvh.GetPrimitiveIndices();
+        auto fill = [this, &corner, nodes, order](std::size_t begin, std::size_t end) {
+            for(std::size_t n = begin; n < end; n++) {
+                if(!nodes[n].IsLeaf())
+                    continue;
+                TrianglePacket8& packet = packetStorage[leafPacketStorage[nodes[n].offset]];
+                for(int lane = 0; lane < nodes[n].count; lane++) {
+                    std::uint32_t triangle = order[nodes[n].offset + lane];
+                    packet.SetTriangle(lane, corner(triangle, 0), corner(triangle, 1),
+                                       corner(triangle, 2), triangle);
+                }
+            }
+        };
+        if(pool)
+            pool->ParallelFor(bvh.GetNodeCount(), parallelGrainSize, fill);
+        else
+            fill(0, bvh.GetNodeCount());
+    }
+
+    void TriangleBVH::Borrow(const std::shared_ptr<const MappedFile>& file, const BVHNode* nodeData,
+                             std::size_t nodeCount, const std::uint32_t* indexData, std::size_t indexCount,
+                             const TrianglePacket8* packetData, std::size_t packetCountArg,
+                             const std::uint32_t* leafPacketData, std::size_t triangleCountArg) {
+        bvh.Borrow(file, nodeData, nodeCount, indexData, indexCount, TrianglePacket8::width);
+        packetStorage.clear();
+        packetStorage.shrink_to_fit();
+        leafPacketStorage.clear();
+        leafPacketStorage.shrink_to_fit();
+        packets = packetData;
+        packetCount = packetCountArg;
+        leafPacket = leafPacketData;
+        triangleCount = triangleCountArg;
+    }
+
+    void TriangleBVH::UpdateViews() {
+        packets = packetStorage.data();
+        packetCount = packetStorage.size();
+        leafPacket = leafPacketStorage.data();
+    }
+
+    void TriangleBVH::DisplayContents() const {
+        std::cout << "TriangleBVH: " << triangleCount << " triangles, " << packetCount
+                  << " packets" << std::endl;
+        bvh.DisplayContents();
+    }
+}
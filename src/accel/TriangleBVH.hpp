@@ -0,0 +1,304 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TriangleBVH.hpp
+ * 
+ * BVH over triangles with SIMD tests at the leaves
+ * Class and method definitions
+ */
+
+/*!
+ \file TriangleBVH.hpp
+ Header definition for the TriangleBVH class
+ */
+
+#ifndef TRIANGLEBVH_HPP
+#define	TRIANGLEBVH_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/StdVector>
+
+#include "BVH.hpp"
+#include "TrianglePacket8.hpp"
+#include "../utility/Point.hpp"
+#include "../utility/Ray.hpp"
+#include "../utility/RayPacket8.hpp"
+
+namespace SCPPR {
+
+    class MappedFile;
+    class TaskPool;
+    class TriangleMesh;
+
+    //! Bounding volume hierarchy over an indexed triangle list
+    /*!
+     Leaves hold up to eight triangles and each leaf's triangles are copied
+     into one TrianglePacket8, so a leaf costs one SIMD test instead of one
+     scalar test per triangle. Like BVH, the packets are read through views
+     so a hierarchy can be borrowed from a mapped cache file. Deforming
+     meshes call Update each frame to refit rather than rebuild.
+     */
+    class TriangleBVH {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs an empty hierarchy
+         */
+        TriangleBVH();
+
+        //! Copy constructor
+        /*!
+         Copies owned buffers and shares borrowed ones
+         */
+        TriangleBVH(const TriangleBVH& copy);
+
+        //! Assignment operator
+        TriangleBVH& operator= (const TriangleBVH& copy);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Builds the hierarchy over an indexed triangle list
+        /*!
+         Triangle i has the vertices indices[3i], indices[3i + 1] and
+         indices[3i + 2]. When pool is not null the build runs on it.
+         */
+        void Build(const std::vector<Point>& vertices, const std::vector<std::uint32_t>& indices,
+                   TaskPool* pool = 0);
+
+        //! Builds the hierarchy over the triangles of a mesh
+        /*!
+         Reads the packed buffers directly, so mapped meshes are never
+         copied. When pool is not null the build runs on it.
+         */
+        void Build(const TriangleMesh& mesh, TaskPool* pool = 0);
+
+        //! Follows moved vertices of the triangle list the hierarchy was built over
+        /*!
+         The triangles must keep their vertex indices; only positions may
+         change. Refits the nodes and rewrites the leaf packets in place,
+         in parallel when pool is not null, or rebuilds when the refitted
+         SAH cost exceeds rebuildThreshold times the cost at the last build.
+         A different triangle count always rebuilds. Returns true when it
+         rebuilt.
+         */
+        bool Update(const std::vector<Point>& vertices, const std::vector<std::uint32_t>& indices,
+                    TaskPool* pool = 0, float rebuildThreshold = 1.5f);
+
+        //! Follows moved vertices of the mesh the hierarchy was built over
+        /*!
+         As the indexed list version, reading the mesh buffers directly.
+         */
+        bool Update(const TriangleMesh& mesh, TaskPool* pool = 0, float rebuildThreshold = 1.5f);
+
+        //! Points the hierarchy at buffers inside a mapped file
+        /*!
+         The buffers must be the ones a build produced, as returned by the
+         accessors below. The hierarchy shares ownership of file.
+         */
+        void Borrow(const std::shared_ptr<const MappedFile>& file, const BVHNode* nodeData,
+                    std::size_t nodeCount, const std::uint32_t* indexData, std::size_t indexCount,
+                    const TrianglePacket8* packetData, std::size_t packetCountArg,
+                    const std::uint32_t* leafPacketData, std::size_t triangleCountArg);
+
+        //! Returns the underlying hierarchy
+        const BVH& GetBVH() const;
+
+        //! Returns the leaf packets
+        const TrianglePacket8* GetPackets() const;
+
+        //! Returns the number of leaf packets
+        std::size_t GetPacketCount() const;
+
+        //! Returns the packet of the leaf starting at each primitive offset
+        /*!
+         Holds GetBVH().GetPrimitiveCount() entries.
+         */
+        const std::uint32_t* GetLeafPackets() const;
+
+        //! Returns the number of triangles
+        std::size_t GetTriangleCount() const;
+
+        //! Finds the closest triangle hit before tMax
+        /*!
+         On a hit lowers tMax, fills hit with the triangle index and its
+         barycentric coordinates and returns true.
+         */
+        bool Intersect(const Ray& ray, float& tMax, TriangleHit& hit) const;
+
+        //! Returns true when any triangle is hit before tMax
+        bool IntersectAny(const Ray& ray, float tMax) const;
+
+        //! Finds the closest triangle hit of every active ray of a packet
+        /*!
+         Lane i behaves as Intersect(ray i, tMax[i], hits[i]). Returns the
+         lanes that hit; only their tMax lanes and hits are written.
+         */
+        Mask8 IntersectPacket(const RayPacket8& rays, const Mask8& active, Float8& tMax,
+                              TriangleHit hits[8]) const;
+
+        //! Returns the active lanes of a packet that hit any triangle before tMax
+        Mask8 IntersectAnyPacket(const RayPacket8& rays, const Mask8& active, const Float8& tMax) const;
+
+        //! Displays the hierarchy size in the console
+        void DisplayContents() const;
+
+    protected:
+
+        //! Shared build over count triangles
+        /*!
+         corner(triangle, k) returns vertex k of the triangle as a Point.
+         */
+        template <typename CornerFunction>
+        void BuildTriangles(std::size_t count, const CornerFunction& corner, TaskPool* pool);
+
+        //! Shared refit or rebuild over count triangles
+        template <typename CornerFunction>
+        bool UpdateTriangles(std::size_t count, const CornerFunction& corner, TaskPool* pool,
+                             float rebuildThreshold);
+
+        //! Fills bounds with the bounds of every triangle
+        template <typename CornerFunction>
+        void GatherBounds(const CornerFunction& corner, TaskPool* pool, std::vector<AABB>& bounds) const;
+
+        //! Gives every leaf of the hierarchy an owned packet
+        void AssignPackets();
+
+        //! Copies the triangles of every leaf into its packet
+        template <typename CornerFunction>
+        void FillPackets(const CornerFunction& corner, TaskPool* pool);
+
+        //! Points the views at the owned buffers
+        void UpdateViews();
+
+        //! Packet array, aligned for the SIMD registers it holds
+        typedef std::vector<TrianglePacket8, Eigen::aligned_allocator<TrianglePacket8> > PacketArray;
+
+        BVH bvh;                                      //!< Hierarchy over triangle bounds
+        const TrianglePacket8* packets;               //!< One packet per leaf
+        std::size_t packetCount;                      //!< Number of packets
+        const std::uint32_t* leafPacket;              //!< Packet of the leaf starting at each primitive offset
+        PacketArray packetStorage;                    //!< Owned packets
+        std::vector<std::uint32_t> leafPacketStorage; //!< Owned leaf packet table
+        std::size_t triangleCount;                    //!< Number of triangles
+    };
+
+    inline const BVH& TriangleBVH::GetBVH() const {
+        return bvh;
+    }
+
+    inline const TrianglePacket8* TriangleBVH::GetPackets() const {
+        return packets;
+    }
+
+    inline std::size_t TriangleBVH::GetPacketCount() const {
+        return packetCount;
+    }
+
+    inline const std::uint32_t* TriangleBVH::GetLeafPackets() const {
+        return leafPacket;
+    }
+
+    inline std::size_t TriangleBVH::GetTriangleCount() const {
+        return triangleCount;
+    }
+
+    inline bool TriangleBVH::Intersect(const Ray& ray, float& tMax, TriangleHit& hit) const {
+        std::uint64_t tests = 0;
+        auto leafIntersector = [this, &hit, &tests](const BVHNode& leaf, const Ray& leafRay, float& leafMax) {
+            tests += leaf.count;
+            return packets[leafPacket[leaf.offset]].IntersectClosest(leafRay, leafMax, hit);
+        };
+        bool found = bvh.IntersectLeaves(ray, tMax, leafIntersector);
+        RenderCounters::Add(RenderCounters::triangleTests, tests);
+        return found;
+    }
+
+    inline bool TriangleBVH::IntersectAny(const Ray& ray, float tMax) const {
+        std::uint64_t tests = 0;
+        auto leafIntersector = [this, &tests](const BVHNode& leaf, const Ray& leafRay, float leafMax) {
+            tests += leaf.count;
+            return packets[leafPacket[leaf.offset]].IntersectAny(leafRay, leafMax);
+        };
+        bool occluded = bvh.IntersectAnyLeaves(ray, tMax, leafIntersector);
+        RenderCounters::Add(RenderCounters::triangleTests, tests);
+        return occluded;
+    }
+
+    inline Mask8 TriangleBVH::IntersectPacket(const RayPacket8& rays, const Mask8& active, Float8& tMax,
+                                              TriangleHit hits[8]) const {
+        // the leaf packet already spends its SIMD width on triangles, so lanes take turns
+        std::uint64_t tests = 0;
+        auto leafIntersector = [this, hits, &tests](const BVHNode& leaf, const RayPacket8& leafRays,
+                                                    const Mask8& lanes, Float8& leafMax) {
+            const TrianglePacket8& packet = packets[leafPacket[leaf.offset]];
+            int hitBits = 0;
+            for(int bits = lanes.GetBits(), lane = 0; bits != 0; bits >>= 1, lane++) {
+                if(!(bits & 1))
+                    continue;
+                tests += leaf.count;
+                float laneMax = leafMax[lane];
+                Ray ray(leafRays.GetOrigin().Extract(lane), leafRays.GetDirection().Extract(lane));
+                if(packet.IntersectClosest(ray, laneMax, hits[lane])) {
+                    leafMax.SetLane(lane, laneMax);
+                    hitBits |= 1 << lane;
+                }
+            }
+            return Mask8::FromBits(hitBits);
+        };
+        Mask8 found = bvh.IntersectPacketLeaves(rays, active, tMax, leafIntersector);
+        RenderCounters::Add(RenderCounters::triangleTests, tests);
+        return found;
+    }
+
+    inline Mask8 TriangleBVH::IntersectAnyPacket(const RayPacket8& rays, const Mask8& active,
+                                                 const Float8& tMax) const {
+        std::uint64_t tests = 0;
+        auto leafIntersector = [this, &tests](const BVHNode& leaf, const RayPacket8& leafRays,
+                                              const Mask8& lanes, const Float8& leafMax) {
+            const TrianglePacket8& packet = packets[leafPacket[leaf.offset]];
+            int hitBits = 0;
+            for(int bits = lanes.GetBits(), lane = 0; bits != 0; bits >>= 1, lane++) {
+                if(!(bits & 1))
+                    continue;
+                tests += leaf.count;
+                Ray ray(leafRays.GetOrigin().Extract(lane), leafRays.GetDirection().Extract(lane));
+                if(packet.IntersectAny(ray, leafMax[lane]))
+                    hitBits |= 1 << lane;
+            }
+            return Mask8::FromBits(hitBits);
+        };
+        Mask8 occluded = bvh.IntersectAnyPacketLeaves(rays, active, tMax, leafIntersector);
+        RenderCounters::Add(RenderCounters::triangleTests, tests);
+        return occluded;
+    }
+}
+
+#endif	/* TRIANGLEBVH_HPP */
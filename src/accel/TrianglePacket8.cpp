@@ -0,0 +1,45 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TrianglePacket8.cpp
+ * 
+ * Eight triangles in structure-of-arrays layout with a SIMD ray test
+ */
+
+#include <iostream>
+
+#include "TrianglePacket8.hpp"
+
+namespace SCPPR {
+
+    void TrianglePacket8::DisplayContents() const {
+        for(int lane = 0; lane < width; lane++) {
+            if(!(valid.GetBits() & (1 << lane)))
+                continue;
+            std::cout << "triangle " << primitives[lane] << std::endl;
+            vertex.Extract(lane).DisplayContents();
+            (vertex.Extract(lane) + edge1.Extract(lane)).DisplayContents();
+            (vertex.Extract(lane) + edge2.Extract(lane)).DisplayContents();
+        }
+    }
+}
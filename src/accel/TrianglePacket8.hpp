@@ -0,0 +1,190 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TrianglePacket8.hpp
+ * 
+ * Eight triangles in structure-of-arrays layout with a SIMD ray test
+ * Class and method definitions
+ */
+
+/*!
+ \file TrianglePacket8.hpp
+ Header definition for the TrianglePacket8 class and TriangleHit record
+ */
+
+#ifndef TRIANGLEPACKET8_HPP
+#define	TRIANGLEPACKET8_HPP
+
+#include <cstdint>
+#include <limits>
+
+#include "../utility/Float8.hpp"
+#include "../utility/Point.hpp"
+#include "../utility/PointPacket8.hpp"
+#include "../utility/Ray.hpp"
+#include "../utility/VectorPacket8.hpp"
+
+namespace SCPPR {
+
+    //! Closest hit found by a triangle test
+    struct TriangleHit {
+        float t;                  //!< Distance along the ray in units of its direction
+        float u;                  //!< Barycentric weight of the second vertex
+        float v;                  //!< Barycentric weight of the third vertex
+        std::uint32_t primitive;  //!< Index of the triangle that was hit
+    };
+
+    //! Packet of eight triangles
+    /*!
+     Stores the first vertex and the two edges leaving it for eight triangles
+     as separate x, y and z registers. Intersect runs Moller-Trumbore for one
+     ray against all eight in a single pass. Unused lanes are masked off, so
+     a packet may hold anywhere from one to eight triangles.
+     */
+    class TrianglePacket8 {
+
+    public:
+
+        static const int width = 8; //!< Triangles per packet
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs a packet with every lane empty
+         */
+        TrianglePacket8();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Stores triangle (p0, p1, p2) with index primitive in lane
+        void SetTriangle(int lane, const Point& p0, const Point& p1, const Point& p2,
+                         std::uint32_t primitive);
+
+        //! Returns the number of occupied lanes
+        int GetCount() const;
+
+        //! Returns the triangle index stored in lane
+        std::uint32_t GetPrimitive(int lane) const;
+
+        //! Tests ray against every triangle of the packet
+        /*!
+         Returns the lanes hit with 0 < t < tMax and writes t and the
+         barycentric coordinates of every lane.
+         */
+        Mask8 Intersect(const Ray& ray, const Float8& tMax, Float8& t, Float8& u, Float8& v) const;
+
+        //! Finds the closest triangle hit before tMax
+        /*!
+         On a hit lowers tMax to the hit distance, fills hit and returns true.
+         */
+        bool IntersectClosest(const Ray& ray, float& tMax, TriangleHit& hit) const;
+
+        //! Returns true when any triangle is hit before tMax
+        bool IntersectAny(const Ray& ray, float tMax) const;
+
+        //! Displays the packet in the console
+        void DisplayContents() const;
+
+    protected:
+
+        PointPacket8 vertex;          //!< First vertex of each triangle
+        VectorPacket8 edge1;          //!< Second vertex minus the first
+        VectorPacket8 edge2;          //!< Third vertex minus the first
+        Mask8 valid;                  //!< Occupied lanes
+        std::uint32_t primitives[8];  //!< Triangle index per lane
+    };
+
+    inline TrianglePacket8::TrianglePacket8() :
+        valid(Mask8::FromBits(0)) {
+        for(int lane = 0; lane < width; lane++)
+            primitives[lane] = 0;
+    }
+
+    inline void TrianglePacket8::SetTriangle(int lane, const Point& p0, const Point& p1,
+                                             const Point& p2, std::uint32_t primitive) {
+        vertex.Insert(lane, p0);
+        edge1.Insert(lane, p1 - p0);
+        edge2.Insert(lane, p2 - p0);
+        valid |= Mask8::FromBits(1 << lane);
+        primitives[lane] = primitive;
+    }
+
+    inline int TrianglePacket8::GetCount() const {
+        int count = 0;
+        for(int bits = valid.GetBits(); bits; bits &= bits - 1)
+            count++;
+        return count;
+    }
+
+    inline std::uint32_t TrianglePacket8::GetPrimitive(int lane) const {
+        return primitives[lane];
+    }
+
+    inline Mask8 TrianglePacket8::Intersect(const Ray& ray, const Float8& tMax,
+                                            Float8& t, Float8& u, Float8& v) const {
+        const VectorPacket8 direction(ray.GetDirection());
+        const VectorPacket8 p = direction ^ edge2;
+        const Float8 determinant = edge1 * p;
+        const Float8 inverse = Float8(1.0f) / determinant;
+
+        const VectorPacket8 toOrigin = PointPacket8(ray.GetOrigin()) - vertex;
+        u = (toOrigin * p) * inverse;
+
+        const VectorPacket8 q = toOrigin ^ edge1;
+        v = (direction * q) * inverse;
+        t = (edge2 * q) * inverse;
+
+        const Float8 zero(0.0f);
+        Mask8 hit = valid.AndNot(determinant == zero);
+        hit = hit & (u >= zero) & (v >= zero) & (u + v <= Float8(1.0f));
+        return hit & (t > zero) & (t < tMax);
+    }
+
+    inline bool TrianglePacket8::IntersectClosest(const Ray& ray, float& tMax, TriangleHit& hit) const {
+        Float8 t, u, v;
+        Mask8 hits = Intersect(ray, Float8(tMax), t, u, v);
+        if(hits.None())
+            return false;
+
+        const Float8 masked = Float8::Select(hits, t, Float8(std::numeric_limits<float>::infinity()));
+        const float closest = Float8::HorizontalMin(masked);
+        int lane = 0;
+        for(int bits = (hits & (masked == Float8(closest))).GetBits(); !(bits & 1); bits >>= 1)
+            lane++;
+
+        tMax = closest;
+        hit.t = closest;
+        hit.u = u[lane];
+        hit.v = v[lane];
+        hit.primitive = primitives[lane];
+        return true;
+    }
+
+    inline bool TrianglePacket8::IntersectAny(const Ray& ray, float tMax) const {
+        Float8 t, u, v;
+        return Intersect(ray, Float8(tMax), t, u, v).Any();
+    }
+}
+
+#endif	/* TRIANGLEPACKET8_HPP */
@@ -0,0 +1,204 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TriangleMesh.cpp
+ * 
+ * Indexed triangle mesh with packed vertex buffers
+ */
+
+#include <iostream>
+
+#include "TriangleMesh.hpp"
+#include "../io/MappedFile.hpp"
+#include "../parallel/TaskPool.hpp"
+
+namespace SCPPR {
+
+    TriangleMesh::TriangleMesh() :
+        vertexCount(0), triangleCount(0), hasNormals(false), normalsCompressed(false), hasUVs(false),
+        positions(0), normals(0), compressedNormals(0), uvs(0), indices(0) {
+
+    }
+
+    void TriangleMesh::Allocate(std::size_t vertexCountArg, std::size_t triangleCountArg,
+                                bool withNormals, bool withUVs) {
+        file.reset();
+        vertexCount = vertexCountArg;
+        triangleCount = triangleCountArg;
+        hasNormals = withNormals;
+        normalsCompressed = false;
+        hasUVs = withUVs;
+
+        positionStorage.Assign(vertexCount);
+        normalStorage.Assign(withNormals ? vertexCount : 0);
+        compressedNormalStorage.clear();
+        uvStorage.assign(withUVs ? 2 * vertexCount : 0, 0.0f);
+        indexStorage.assign(3 * triangleCount, 0);
+        UpdateViews();
+    }
+
+    std::uint32_t TriangleMesh::AddVertex(const Point& position, const Normal& normal, float u, float v) {
+        Detach();
+        positionStorage.PushBack(position);
+        if(normalsCompressed)
+            compressedNormalStorage.push_back(OctahedralNormal32(normal));
+        else if(hasNormals)
+            normalStorage.PushBack(normal);
+        if(hasUVs) {
+            uvStorage.push_back(u);
+            uvStorage.push_back(v);
+        }
+        UpdateViews();
+        return (std::uint32_t)vertexCount++;
+    }
+
+    void TriangleMesh::AddTriangle(std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+        Detach();
+        indexStorage.push_back(a);
+        indexStorage.push_back(b);
+        indexStorage.push_back(c);
+        UpdateViews();
+        triangleCount++;
+    }
+
+    void TriangleMesh::ShrinkToFit() {
+        positionStorage.ShrinkToFit();
+        normalStorage.ShrinkToFit();
+        compressedNormalStorage.shrink_to_fit();
+        uvStorage.shrink_to_fit();
+        indexStorage.shrink_to_fit();
+        if(!file)
+            UpdateViews();
+    }
+
+    void TriangleMesh::Borrow(const std::shared_ptr<const MappedFile>& fileArg, std::size_t vertexCountArg,
+                              std::size_t triangleCountArg, const float* positionData,
+                              const float* normalData, const float* uvData,
+                              const std::uint32_t* indexData,
+                              const OctahedralNormal32* compressedNormalData) {
+        positionStorage.Clear();
+        normalStorage.Clear();
+        compressedNormalStorage.clear();
+        uvStorage.clear();
+        indexStorage.clear();
+
+        file = fileArg;
+        vertexCount = vertexCountArg;
+        triangleCount = triangleCountArg;
+        hasNormals = normalData != 0 || compressedNormalData != 0;
+        normalsCompressed = compressedNormalData != 0;
+        hasUVs = uvData != 0;
+        positions = reinterpret_cast<const Point3Packed*>(positionData);
+        normals = compressedNormalData ? 0 : reinterpret_cast<const Normal3Packed*>(normalData);
+        compressedNormals = compressedNormalData;
+        uvs = uvData;
+        indices = indexData;
+    }
+
+    float* TriangleMesh::GetMutablePositions() {
+        return file ? 0 : reinterpret_cast<float*>(positionStorage.GetData());
+    }
+
+    float* TriangleMesh::GetMutableNormals() {
+        if(file || !hasNormals || normalsCompressed)
+            return 0;
+        return reinterpret_cast<float*>(normalStorage.GetData());
+    }
+
+    float* TriangleMesh::GetMutableUVs() {
+        return file || !hasUVs ? 0 : uvStorage.data();
+    }
+
+    std::uint32_t* TriangleMesh::GetMutableIndices() {
+        return file ? 0 : indexStorage.data();
+    }
+
+    AABB TriangleMesh::GetBounds() const {
+        AABB bounds;
+        for(std::size_t i = 0; i < vertexCount; i++)
+            bounds.Expand(GetPosition(i));
+        return bounds;
+    }
+
+    void TriangleMesh::CompressNormals(TaskPool* pool) {
+        if(!hasNormals || normalsCompressed)
+            return;
+        Detach();
+
+        const std::size_t grainSize = 1 << 16;
+        compressedNormalStorage.resize(vertexCount);
+        auto encode = [this](std::size_t begin, std::size_t end) {
+            // widen a batch to Normals, then encode it eight at a time
+            std::vector<Normal> batch(end - begin);
+            for(std::size_t i = begin; i < end; i++)
+                batch[i - begin] = normalStorage.Get(i);
+            OctahedralNormal32::Encode(batch.data(), compressedNormalStorage.data() + begin, end - begin);
+        };
+        if(pool)
+            pool->ParallelFor(vertexCount, grainSize, encode);
+        else
+            encode(0, vertexCount);
+
+        normalStorage.Clear();
+        normalStorage.ShrinkToFit();
+        normalsCompressed = true;
+        UpdateViews();
+    }
+
+    std::size_t TriangleMesh::GetMemoryUsage() const {
+        std::size_t normalSize = normalsCompressed ? sizeof(OctahedralNormal32) :
+                                 hasNormals ? sizeof(Normal3Packed) : 0;
+        return vertexCount * (sizeof(Point3Packed) + normalSize + (hasUVs ? 2 * sizeof(float) : 0)) +
+               triangleCount * 3 * sizeof(std::uint32_t);
+    }
+
+    void TriangleMesh::DisplayContents() const {
+        std::cout << "TriangleMesh: " << vertexCount << " vertices, " << triangleCount
+                  << " triangles" << (normalsCompressed ? ", compressed normals" : hasNormals ? ", normals" : "")
+                  << (hasUVs ? ", uvs" : "")
+                  << (file ? ", mapped" : "") << std::endl;
+    }
+
+    void TriangleMesh::Detach() {
+        if(!file)
+            return;
+        positionStorage.Assign(positions, positions + vertexCount);
+        if(hasNormals && !normalsCompressed)
+            normalStorage.Assign(normals, normals + vertexCount);
+        if(normalsCompressed)
+            compressedNormalStorage.assign(compressedNormals, compressedNormals + vertexCount);
+        if(hasUVs)
+            uvStorage.assign(uvs, uvs + 2 * vertexCount);
+        indexStorage.assign(indices, indices + 3 * triangleCount);
+        file.reset();
+        UpdateViews();
+    }
+
+    void TriangleMesh::UpdateViews() {
+        positions = positionStorage.GetData();
+        normals = hasNormals && !normalsCompressed ? normalStorage.GetData() : 0;
+        compressedNormals = normalsCompressed ? compressedNormalStorage.data() : 0;
+        uvs = hasUVs ? uvStorage.data() : 0;
+        indices = indexStorage.data();
+    }
+}
@@ -0,0 +1,283 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TriangleMesh.hpp
+ * 
+ * Indexed triangle mesh with packed vertex buffers
+ * Class and method definitions
+ */
+
+/*!
+ \file TriangleMesh.hpp
+ Header definition for the TriangleMesh class
+ */
+
+#ifndef TRIANGLEMESH_HPP
+#define	TRIANGLEMESH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../accel/AABB.hpp"
+#include "../utility/AttributeArray.hpp"
+#include "../utility/Normal.hpp"
+#include "../utility/Normal3Packed.hpp"
+#include "../utility/OctahedralNormal.hpp"
+#include "../utility/Point.hpp"
+#include "../utility/Point3Packed.hpp"
+
+namespace SCPPR {
+
+    class MappedFile;
+    class TaskPool;
+
+    //! Indexed triangle mesh
+    /*!
+     Vertex attributes live in shared buffers: positions and normals as
+     Point3Packed and Normal3Packed, texture coordinates as two floats, and
+     three 32 bit vertex indices per triangle. Packing drops the unused w of
+     the 16 byte Point and Normal types, a quarter of their size.
+
+     Shading normals can be compressed to 32 bit OctahedralNormals, a
+     quarter of the packed size, once the mesh is complete. GetNormal
+     decodes them on access.
+
+     The buffers are either owned by the mesh or borrowed from a memory
+     mapped mesh file, in which case the mesh keeps the mapping alive and is
+     read only. Accessors read the same way in both cases.
+     */
+    class TriangleMesh {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs an empty mesh with owned storage
+         */
+        TriangleMesh();
+
+        // end constructor declarations-----------------------------------------
+
+        // begin building methods-----------------------------------------------
+
+        //! Replaces the contents with owned, zeroed buffers of the given sizes
+        /*!
+         Importers fill the buffers through the GetMutable accessors.
+         */
+        void Allocate(std::size_t vertexCountArg, std::size_t triangleCountArg,
+                      bool withNormals, bool withUVs);
+
+        //! Appends a vertex, returns its index
+        /*!
+         Normals and texture coordinates are only stored when the mesh has
+         them; the arguments are otherwise ignored.
+         */
+        std::uint32_t AddVertex(const Point& position, const Normal& normal = Normal(),
+                                float u = 0.0f, float v = 0.0f);
+
+        //! Appends the triangle (a, b, c)
+        void AddTriangle(std::uint32_t a, std::uint32_t b, std::uint32_t c);
+
+        //! Shrinks owned buffers to their contents
+        void ShrinkToFit();
+
+        //! Replaces the normals with OctahedralNormal32 encodings
+        /*!
+         Encodes in parallel when pool is not null. Does nothing when the
+         mesh has no normals or they are compressed already.
+         */
+        void CompressNormals(TaskPool* pool = 0);
+
+        //! Points the mesh at buffers inside a mapped file
+        /*!
+         normalData, compressedNormalData and uvData may be null, at most
+         one of the normal buffers may be set. The mesh shares ownership of
+         file and becomes read only.
+         */
+        void Borrow(const std::shared_ptr<const MappedFile>& file, std::size_t vertexCountArg,
+                    std::size_t triangleCountArg, const float* positionData,
+                    const float* normalData, const float* uvData,
+                    const std::uint32_t* indexData,
+                    const OctahedralNormal32* compressedNormalData = 0);
+
+        // end building methods-------------------------------------------------
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the number of vertices
+        std::size_t GetVertexCount() const;
+
+        //! Returns the number of triangles
+        std::size_t GetTriangleCount() const;
+
+        //! Returns true when the mesh has per vertex normals
+        bool HasNormals() const;
+
+        //! Returns true when the normals are stored as OctahedralNormal32
+        bool HasCompressedNormals() const;
+
+        //! Returns true when the mesh has texture coordinates
+        bool HasUVs() const;
+
+        //! Returns true when the buffers belong to a mapped file
+        bool IsMapped() const;
+
+        //! Returns the packed positions, three floats per vertex
+        const float* GetPositions() const;
+
+        //! Returns the packed normals, or null when absent or compressed
+        const float* GetNormals() const;
+
+        //! Returns the compressed normals, or null when absent or not compressed
+        const OctahedralNormal32* GetCompressedNormals() const;
+
+        //! Returns the texture coordinates, two floats per vertex, or null
+        const float* GetUVs() const;
+
+        //! Returns the vertex indices, three per triangle
+        const std::uint32_t* GetIndices() const;
+
+        //! Returns the writable positions of an owned mesh
+        float* GetMutablePositions();
+
+        //! Returns the writable normals of an owned mesh, or null when absent or compressed
+        float* GetMutableNormals();
+
+        //! Returns the writable texture coordinates of an owned mesh, or null
+        float* GetMutableUVs();
+
+        //! Returns the writable indices of an owned mesh
+        std::uint32_t* GetMutableIndices();
+
+        //! Returns the position of vertex
+        Point GetPosition(std::size_t vertex) const;
+
+        //! Returns the normal of vertex, zero when the mesh has none
+        Normal GetNormal(std::size_t vertex) const;
+
+        //! Returns the three vertex indices of triangle
+        const std::uint32_t* GetTriangle(std::size_t triangle) const;
+
+        // end accessor declarations--------------------------------------------
+
+        //! Returns the bounds of every vertex
+        AABB GetBounds() const;
+
+        //! Returns the bytes held by the vertex and index buffers
+        std::size_t GetMemoryUsage() const;
+
+        //! Displays the mesh size in the console
+        void DisplayContents() const;
+
+    protected:
+
+        //! Copies borrowed buffers into owned storage and releases the file
+        void Detach();
+
+        //! Points the views at the owned buffers
+        void UpdateViews();
+
+        std::size_t vertexCount;                //!< Number of vertices
+        std::size_t triangleCount;              //!< Number of triangles
+        bool hasNormals;                        //!< Normals present
+        bool normalsCompressed;                 //!< Normals stored as OctahedralNormal32
+        bool hasUVs;                            //!< Texture coordinates present
+
+        const Point3Packed* positions;          //!< Position view
+        const Normal3Packed* normals;           //!< Normal view, may be null
+        const OctahedralNormal32* compressedNormals; //!< Compressed normal view, may be null
+        const float* uvs;                       //!< Texture coordinate view, may be null
+        const std::uint32_t* indices;           //!< Index view
+
+        AttributeArray<Point> positionStorage;  //!< Owned positions
+        AttributeArray<Normal> normalStorage;   //!< Owned normals
+        std::vector<OctahedralNormal32> compressedNormalStorage; //!< Owned compressed normals
+        std::vector<float> uvStorage;           //!< Owned texture coordinates
+        std::vector<std::uint32_t> indexStorage; //!< Owned indices
+        std::shared_ptr<const MappedFile> file; //!< Mapping the views borrow from
+    };
+
+    inline std::size_t TriangleMesh::GetVertexCount() const {
+        return vertexCount;
+    }
+
+    inline std::size_t TriangleMesh::GetTriangleCount() const {
+        return triangleCount;
+    }
+
+    inline bool TriangleMesh::HasNormals() const {
+        return hasNormals;
+    }
+
+    inline bool TriangleMesh::HasCompressedNormals() const {
+        return normalsCompressed;
+    }
+
+    inline bool TriangleMesh::HasUVs() const {
+        return hasUVs;
+    }
+
+    inline bool TriangleMesh::IsMapped() const {
+        return file != 0;
+    }
+
+    inline const float* TriangleMesh::GetPositions() const {
+        return reinterpret_cast<const float*>(positions);
+    }
+
+    inline const float* TriangleMesh::GetNormals() const {
+        return reinterpret_cast<const float*>(normals);
+    }
+
+    inline const OctahedralNormal32* TriangleMesh::GetCompressedNormals() const {
+        return compressedNormals;
+    }
+
+    inline const float* TriangleMesh::GetUVs() const {
+        return uvs;
+    }
+
+    inline const std::uint32_t* TriangleMesh::GetIndices() const {
+        return indices;
+    }
+
+    inline Point TriangleMesh::GetPosition(std::size_t vertex) const {
+        return Point(positions[vertex]);
+    }
+
+    inline Normal TriangleMesh::GetNormal(std::size_t vertex) const {
+        if(normalsCompressed)
+            return Normal(compressedNormals[vertex]);
+        return hasNormals ? Normal(normals[vertex]) : Normal();
+    }
+
+    inline const std::uint32_t* TriangleMesh::GetTriangle(std::size_t triangle) const {
+        return indices + 3 * triangle;
+    }
+}
+
+#endif	/* TRIANGLEMESH_HPP */
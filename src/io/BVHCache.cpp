@@ -0,0 +1,379 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   BVHCache.cpp
+ * 
+ * Binary cache of built acceleration structures
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Geometry>
+
+#include "BVHCache.hpp"
+#include "MappedFile.hpp"
+#include "../accel/InstanceBVH.hpp"
+#include "../parallel/TraceRecorder.hpp"
+#include "../utility/ErrorMessage.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const char cacheMagic[8] = {'S', 'C', 'P', 'P', 'R', 'B', 'V', 'H'};
+
+        const std::uint64_t prime1 = 0x9E3779B185EBCA87ull;
+        const std::uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+        const std::uint64_t prime3 = 0x165667B19E3779F9ull;
+
+        // rounds offset up to the buffer alignment
+        std::uint64_t AlignOffset(std::uint64_t offset) {
+            return (offset + BVHCache::alignment - 1) & ~(std::uint64_t)(BVHCache::alignment - 1);
+        }
+
+        // true when [offset, offset + count * size) is aligned and inside the file
+        bool RangeValid(std::uint64_t offset, std::uint64_t count, std::uint64_t size,
+                        std::uint64_t fileSize) {
+            return offset % BVHCache::alignment == 0 && offset <= fileSize &&
+                   count <= (fileSize - offset) / size;
+        }
+
+        // true when nodes form a tree traversal can walk without leaving the buffers
+        bool NodesValid(const BVHNode* nodes, std::uint64_t nodeCount, std::uint64_t indexCount,
+                        int maximumLeafSize) {
+            if(nodeCount == 0)
+                return indexCount == 0;
+            // children always follow their parent, so depths settle in one pass
+            std::vector<std::uint8_t> depth(nodeCount, 0);
+            for(std::uint64_t i = 0; i < nodeCount; i++) {
+                const BVHNode& node = nodes[i];
+                if(node.IsLeaf()) {
+                    if(node.count > maximumLeafSize || node.offset > indexCount ||
+                       node.count > indexCount - node.offset)
+                        return false;
+                    continue;
+                }
+                if(i + 1 >= nodeCount || node.offset <= i + 1 || node.offset >= nodeCount ||
+                   depth[i] + 1 >= BVH::maximumDepth)
+                    return false;
+                depth[i + 1] = std::max<std::uint8_t>(depth[i + 1], depth[i] + 1);
+                depth[node.offset] = std::max<std::uint8_t>(depth[node.offset], depth[i] + 1);
+            }
+            return true;
+        }
+
+        // true when every entry of values is below limit
+        bool IndicesValid(const std::uint32_t* values, std::uint64_t count, std::uint64_t limit) {
+            for(std::uint64_t i = 0; i < count; i++)
+                if(values[i] >= limit)
+                    return false;
+            return true;
+        }
+
+        Matrix ReadMatrix(const float values[16]) {
+            Eigen::Affine3f contents;
+            contents.matrix() = Eigen::Map<const Eigen::Matrix4f>(values);
+            return Matrix(contents);
+        }
+
+        void WriteMatrix(const Matrix& matrix, float values[16]) {
+            Eigen::Map<Eigen::Matrix4f> contents(values);
+            contents = matrix.GetContents().matrix();
+        }
+
+        std::uint64_t Rotate(std::uint64_t value, int bits) {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        std::uint64_t ReadWord(const unsigned char* bytes) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes, sizeof(word));
+            return word;
+        }
+
+        std::uint64_t Round(std::uint64_t accumulator, std::uint64_t word) {
+            return Rotate(accumulator + word * prime2, 31) * prime1;
+        }
+    }
+
+    const std::uint32_t BVHCache::version;
+    const std::uint32_t BVHCache::byteOrderMark;
+    const std::size_t BVHCache::alignment;
+
+    bool BVHCache::Write(const InstanceBVH& scene, std::uint64_t key, const std::string& path,
+                         std::string* error) {
+        TraceRecorder::Scope trace("cache write", "io");
+        // instances sharing a hierarchy share its record
+        std::vector<const TriangleBVH*> objects;
+        std::map<const TriangleBVH*, std::uint32_t> objectIndices;
+        std::vector<InstanceRecord> instances(scene.GetInstanceCount());
+        for(std::size_t i = 0; i < instances.size(); i++) {
+            const Instance& instance = scene.GetInstance(i);
+            auto found = objectIndices.insert(std::make_pair(instance.object.get(),
+                                                             (std::uint32_t)objects.size()));
+            if(found.second)
+                objects.push_back(instance.object.get());
+            std::memset(&instances[i], 0, sizeof(InstanceRecord));
+            WriteMatrix(instance.transform.GetMatrix(), instances[i].forward);
+            WriteMatrix(instance.transform.GetInverseMatrix(), instances[i].inverse);
+            instances[i].object = found.first->second;
+        }
+
+        const BVH& top = scene.GetBVH();
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+        header.version = version;
+        header.byteOrder = byteOrderMark;
+        header.nodeSize = sizeof(BVHNode);
+        header.packetSize = sizeof(TrianglePacket8);
+        header.key = key;
+        header.objectCount = objects.size();
+        header.instanceCount = instances.size();
+        header.nodeCount = top.GetNodeCount();
+
+        std::uint64_t offset = AlignOffset(sizeof(Header));
+        header.objectOffset = offset;
+        offset = AlignOffset(offset + objects.size() * sizeof(ObjectRecord));
+        header.instanceOffset = offset;
+        offset = AlignOffset(offset + instances.size() * sizeof(InstanceRecord));
+        header.nodeOffset = offset;
+        offset = AlignOffset(offset + top.GetNodeCount() * sizeof(BVHNode));
+        header.indexOffset = offset;
+        offset = AlignOffset(offset + top.GetPrimitiveCount() * sizeof(std::uint32_t));
+
+        std::vector<ObjectRecord> records(objects.size());
+        for(std::size_t i = 0; i < objects.size(); i++) {
+            const TriangleBVH& object = *objects[i];
+            ObjectRecord& record = records[i];
+            std::memset(&record, 0, sizeof(record));
+            record.triangleCount = object.GetTriangleCount();
+            record.nodeCount = object.GetBVH().GetNodeCount();
+            record.packetCount = object.GetPacketCount();
+            record.nodeOffset = offset;
+            offset = AlignOffset(offset + record.nodeCount * sizeof(BVHNode));
+            record.indexOffset = offset;
+            offset = AlignOffset(offset + record.triangleCount * sizeof(std::uint32_t));
+            record.packetOffset = offset;
+            offset = AlignOffset(offset + record.packetCount * sizeof(TrianglePacket8));
+            record.leafPacketOffset = offset;
+            offset += record.triangleCount * sizeof(std::uint32_t);
+        }
+        header.fileSize = offset;
+
+        // the partial file is renamed over path once its checksum is in place
+        std::string partialPath = path + ".partial" +
+            std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        {
+            std::ofstream stream(partialPath.c_str(), std::ios::binary | std::ios::trunc);
+            if(!stream)
+                return Fail(error, "cannot open " + partialPath + " for writing");
+
+            // writes a buffer at its offset, zero padding the gap before it
+            std::uint64_t written = 0;
+            auto writeAt = [&stream, &written](std::uint64_t at, const void* bytes, std::uint64_t length) {
+                static const char zeros[BVHCache::alignment] = {};
+                while(written < at) {
+                    std::uint64_t gap = std::min<std::uint64_t>(at - written, sizeof(zeros));
+                    stream.write(zeros, (std::streamsize)gap);
+                    written += gap;
+                }
+                stream.write(static_cast<const char*>(bytes), (std::streamsize)length);
+                written += length;
+            };
+
+            writeAt(0, &header, sizeof(header));
+            writeAt(header.objectOffset, records.data(), records.size() * sizeof(ObjectRecord));
+            writeAt(header.instanceOffset, instances.data(), instances.size() * sizeof(InstanceRecord));
+            writeAt(header.nodeOffset, top.GetNodes(), top.GetNodeCount() * sizeof(BVHNode));
+            writeAt(header.indexOffset, top.GetPrimitiveIndices(),
+                    top.GetPrimitiveCount() * sizeof(std::uint32_t));
+            for(std::size_t i = 0; i < objects.size(); i++) {
+                const TriangleBVH& object = *objects[i];
+                const ObjectRecord& record = records[i];
+                writeAt(record.nodeOffset, object.GetBVH().GetNodes(), record.nodeCount * sizeof(BVHNode));
+                writeAt(record.indexOffset, object.GetBVH().GetPrimitiveIndices(),
+                        record.triangleCount * sizeof(std::uint32_t));
+                writeAt(record.packetOffset, object.GetPackets(),
+                        record.packetCount * sizeof(TrianglePacket8));
+                writeAt(record.leafPacketOffset, object.GetLeafPackets(),
+                        record.triangleCount * sizeof(std::uint32_t));
+            }
+            stream.flush();
+            if(!stream) {
+                std::remove(partialPath.c_str());
+                return Fail(error, "failed writing " + partialPath);
+            }
+        }
+
+        // hash the payload back from the file rather than holding a copy of it
+        {
+            MappedFile file;
+            if(!file.Open(partialPath)) {
+                std::remove(partialPath.c_str());
+                return Fail(error, file.GetError());
+            }
+            header.checksum = Hash(file.GetData() + sizeof(Header), file.GetSize() - sizeof(Header));
+        }
+        {
+            std::fstream stream(partialPath.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+            stream.seekp(0);
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream.flush();
+            if(!stream) {
+                std::remove(partialPath.c_str());
+                return Fail(error, "failed writing " + partialPath);
+            }
+        }
+        if(std::rename(partialPath.c_str(), path.c_str()) != 0) {
+            std::remove(partialPath.c_str());
+            return Fail(error, "cannot replace " + path);
+        }
+        return true;
+    }
+
+    bool BVHCache::Map(const std::string& path, std::uint64_t key, InstanceBVH& scene,
+                       std::string* error) {
+        TraceRecorder::Scope trace("cache map", "io");
+        std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+        if(!file->Open(path))
+            return Fail(error, file->GetError());
+        if(file->GetSize() < sizeof(Header))
+            return Fail(error, path + " is too small to be a BVH cache");
+
+        Header header;
+        std::memcpy(&header, file->GetData(), sizeof(header));
+        if(std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0)
+            return Fail(error, path + " is not a BVH cache");
+        if(header.byteOrder != byteOrderMark)
+            return Fail(error, path + " was written with a different byte order");
+        if(header.version != version)
+            return Fail(error, path + " has unsupported version " + std::to_string(header.version));
+        if(header.nodeSize != sizeof(BVHNode) || header.packetSize != sizeof(TrianglePacket8))
+            return Fail(error, path + " was written with a different structure layout");
+        if(header.key != key)
+            return Fail(error, path + " was written for different geometry");
+
+        std::uint64_t size = file->GetSize();
+        if(header.fileSize != size)
+            return Fail(error, path + " is truncated");
+        const unsigned char* base = file->GetData();
+        if(Hash(base + sizeof(Header), size - sizeof(Header)) != header.checksum)
+            return Fail(error, path + " fails its checksum");
+
+        if(!RangeValid(header.objectOffset, header.objectCount, sizeof(ObjectRecord), size) ||
+           !RangeValid(header.instanceOffset, header.instanceCount, sizeof(InstanceRecord), size) ||
+           !RangeValid(header.nodeOffset, header.nodeCount, sizeof(BVHNode), size) ||
+           !RangeValid(header.indexOffset, header.instanceCount, sizeof(std::uint32_t), size) ||
+           header.instanceCount > UINT32_MAX)
+            return Fail(error, path + " has tables outside the file");
+
+        const ObjectRecord* records = reinterpret_cast<const ObjectRecord*>(base + header.objectOffset);
+        std::vector<std::shared_ptr<const TriangleBVH> > objects(header.objectCount);
+        for(std::size_t i = 0; i < objects.size(); i++) {
+            const ObjectRecord& record = records[i];
+            if(!RangeValid(record.nodeOffset, record.nodeCount, sizeof(BVHNode), size) ||
+               !RangeValid(record.indexOffset, record.triangleCount, sizeof(std::uint32_t), size) ||
+               !RangeValid(record.packetOffset, record.packetCount, sizeof(TrianglePacket8), size) ||
+               !RangeValid(record.leafPacketOffset, record.triangleCount, sizeof(std::uint32_t), size))
+                return Fail(error, path + " has buffers outside the file");
+
+            const BVHNode* nodes = reinterpret_cast<const BVHNode*>(base + record.nodeOffset);
+            const std::uint32_t* order = reinterpret_cast<const std::uint32_t*>(base + record.indexOffset);
+            const std::uint32_t* leafPackets =
+                reinterpret_cast<const std::uint32_t*>(base + record.leafPacketOffset);
+            if(!NodesValid(nodes, record.nodeCount, record.triangleCount, TrianglePacket8::width) ||
+               !IndicesValid(order, record.triangleCount, record.triangleCount))
+                return Fail(error, path + " has a malformed object hierarchy");
+            for(std::uint64_t n = 0; n < record.nodeCount; n++)
+                if(nodes[n].IsLeaf() && leafPackets[nodes[n].offset] >= record.packetCount)
+                    return Fail(error, path + " has a malformed object hierarchy");
+
+            std::shared_ptr<TriangleBVH> object = std::make_shared<TriangleBVH>();
+            object->Borrow(file, nodes, (std::size_t)record.nodeCount, order,
+                           (std::size_t)record.triangleCount,
+                           reinterpret_cast<const TrianglePacket8*>(base + record.packetOffset),
+                           (std::size_t)record.packetCount, leafPackets, (std::size_t)record.triangleCount);
+            objects[i] = object;
+        }
+
+        const BVHNode* nodes = reinterpret_cast<const BVHNode*>(base + header.nodeOffset);
+        const std::uint32_t* order = reinterpret_cast<const std::uint32_t*>(base + header.indexOffset);
+        if(!NodesValid(nodes, header.nodeCount, header.instanceCount,
+                       std::numeric_limits<std::uint16_t>::max()) ||
+           !IndicesValid(order, header.instanceCount, header.instanceCount))
+            return Fail(error, path + " has a malformed top level hierarchy");
+
+        InstanceBVH loaded;
+        const InstanceRecord* instances =
+            reinterpret_cast<const InstanceRecord*>(base + header.instanceOffset);
+        for(std::size_t i = 0; i < header.instanceCount; i++) {
+            if(instances[i].object >= objects.size())
+                return Fail(error, path + " references a missing object");
+            loaded.AddInstance(objects[instances[i].object],
+                               Transform(ReadMatrix(instances[i].forward), ReadMatrix(instances[i].inverse)));
+        }
+        loaded.Borrow(file, nodes, (std::size_t)header.nodeCount, order, (std::size_t)header.instanceCount);
+        scene = loaded;
+        return true;
+    }
+
+    // xxHash64 style: four lanes of rounds, merged and avalanched
+    std::uint64_t BVHCache::Hash(const void* data, std::size_t length, std::uint64_t seed) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        std::size_t offset = 0;
+        std::uint64_t hash;
+        if(length >= 32) {
+            std::uint64_t lanes[4] = {seed + prime1 + prime2, seed + prime2, seed, seed - prime1};
+            for(; offset + 32 <= length; offset += 32)
+                for(int lane = 0; lane < 4; lane++)
+                    lanes[lane] = Round(lanes[lane], ReadWord(bytes + offset + 8 * lane));
+            hash = Rotate(lanes[0], 1) + Rotate(lanes[1], 7) + Rotate(lanes[2], 12) + Rotate(lanes[3], 18);
+            for(int lane = 0; lane < 4; lane++)
+                hash = (hash ^ Round(0, lanes[lane])) * prime1 + prime3;
+        }
+        else
+            hash = seed + prime3;
+        hash += length;
+
+        for(; offset + 8 <= length; offset += 8)
+            hash = Rotate(hash ^ Round(0, ReadWord(bytes + offset)), 27) * prime1 + prime3;
+        for(; offset < length; offset++)
+            hash = Rotate(hash ^ (bytes[offset] * prime3), 11) * prime1;
+
+        hash ^= hash >> 33;
+        hash *= prime2;
+        hash ^= hash >> 29;
+        hash *= prime3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+}
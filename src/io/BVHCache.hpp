@@ -0,0 +1,144 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   BVHCache.hpp
+ * 
+ * Binary cache of built acceleration structures
+ * Class and method definitions
+ */
+
+/*!
+ \file BVHCache.hpp
+ Header definition for the BVHCache reader and writer
+ */
+
+#ifndef BVHCACHE_HPP
+#define	BVHCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace SCPPR {
+
+    class InstanceBVH;
+
+    //! Reader and writer for cached acceleration structures
+    /*!
+     Saves a built InstanceBVH, its instance transforms and every distinct
+     TriangleBVH it references, so the next run over the same geometry maps
+     them back instead of building. A file is a 128 byte header followed by
+     tables and raw buffers, each on a 64 byte boundary:
+
+     - magic "SCPPRBVH", format version, byte order mark and layout sizes
+     - key of the input geometry and checksum of everything after the header
+     - one ObjectRecord per bottom level hierarchy
+     - one InstanceRecord per instance, holding both transform matrices
+     - top level nodes and instance order
+     - per object nodes, triangle order, leaf packets and leaf packet table
+
+     The key is chosen by the caller, normally Hash over the meshes and the
+     placements, so a stale cache is detected without reading the payload.
+     Mapping checks the key, layout and checksum and validates every node
+     before handing the buffers out, then the hierarchies read the file in
+     place. Files are tied to the host byte order and structure layout.
+     */
+    class BVHCache {
+
+    public:
+
+        //! Fixed header at the start of every file
+        struct Header {
+            char magic[8];                 //!< "SCPPRBVH"
+            std::uint32_t version;         //!< Format version
+            std::uint32_t byteOrder;       //!< byteOrderMark as written by the host
+            std::uint32_t nodeSize;        //!< sizeof(BVHNode) of the writer
+            std::uint32_t packetSize;      //!< sizeof(TrianglePacket8) of the writer
+            std::uint64_t key;             //!< Caller supplied key of the input geometry
+            std::uint64_t checksum;        //!< Hash of bytes [sizeof(Header), fileSize)
+            std::uint64_t objectCount;     //!< Number of bottom level hierarchies
+            std::uint64_t objectOffset;    //!< Byte offset of the object records
+            std::uint64_t instanceCount;   //!< Number of instances
+            std::uint64_t instanceOffset;  //!< Byte offset of the instance records
+            std::uint64_t nodeCount;       //!< Number of top level nodes
+            std::uint64_t nodeOffset;      //!< Byte offset of the top level nodes
+            std::uint64_t indexOffset;     //!< Byte offset of the top level instance order
+            std::uint64_t fileSize;        //!< Total size in bytes
+            std::uint8_t reserved[24];     //!< Zero
+        };
+
+        //! Location of one bottom level hierarchy
+        struct ObjectRecord {
+            std::uint64_t triangleCount;     //!< Number of triangles
+            std::uint64_t nodeCount;         //!< Number of nodes
+            std::uint64_t nodeOffset;        //!< Byte offset of the nodes
+            std::uint64_t indexOffset;       //!< Byte offset of the triangle order
+            std::uint64_t packetCount;       //!< Number of leaf packets
+            std::uint64_t packetOffset;      //!< Byte offset of the leaf packets
+            std::uint64_t leafPacketOffset;  //!< Byte offset of the leaf packet table
+            std::uint64_t reserved;          //!< Zero
+        };
+
+        //! Placement of one instance
+        struct InstanceRecord {
+            float forward[16];           //!< Object to world, column major
+            float inverse[16];           //!< World to object, column major
+            std::uint32_t object;        //!< Index of the object record
+            std::uint32_t reserved[3];   //!< Zero
+        };
+
+        static const std::uint32_t version = 1;                 //!< Current format version
+        static const std::uint32_t byteOrderMark = 0x01020304u; //!< Detects foreign byte order
+        static const std::size_t alignment = 64;                //!< Buffer alignment in bytes
+
+        //! Writes the built scene to path under key, returns false on failure
+        /*!
+         The file is written next to path and renamed over it once complete,
+         so concurrent runs never map a partial cache.
+         */
+        static bool Write(const InstanceBVH& scene, std::uint64_t key, const std::string& path,
+                          std::string* error = 0);
+
+        //! Maps the cache at path into scene without copying
+        /*!
+         Fails when the file was written under another key. On failure
+         leaves scene untouched, returns false and describes the problem in
+         error when it is not null.
+         */
+        static bool Map(const std::string& path, std::uint64_t key, InstanceBVH& scene,
+                        std::string* error = 0);
+
+        //! Returns a 64 bit hash of length bytes, chained through seed
+        /*!
+         Reads four independent 64 bit words per step, so keying a large
+         mesh runs at memory speed. Hash(b, Hash(a)) keys a then b.
+         */
+        static std::uint64_t Hash(const void* data, std::size_t length, std::uint64_t seed = 0);
+    };
+
+    static_assert(sizeof(BVHCache::Header) == 128, "BVHCache header must be 128 bytes");
+    static_assert(sizeof(BVHCache::ObjectRecord) == 64, "BVHCache object record must be 64 bytes");
+    static_assert(sizeof(BVHCache::InstanceRecord) == 144, "BVHCache instance record must be 144 bytes");
+}
+
+#endif	/* BVHCACHE_HPP */
@@ -0,0 +1,354 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   ImageWriter.cpp
+ * 
+ * Background writer streaming finished tiles to image files
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#define SCPPR_HAS_FSEEKO 1
+#endif
+
+#include "ImageWriter.hpp"
+#include "../parallel/TraceRecorder.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        bool HostIsLittleEndian() {
+            const std::uint16_t probe = 1;
+            unsigned char first;
+            std::memcpy(&first, &probe, 1);
+            return first == 1;
+        }
+
+        // appends value as little endian bytes
+        template <typename Value>
+        void Append(std::vector<unsigned char>& bytes, Value value) {
+            unsigned char raw[sizeof(Value)];
+            std::memcpy(raw, &value, sizeof(Value));
+            if(!HostIsLittleEndian())
+                std::reverse(raw, raw + sizeof(Value));
+            bytes.insert(bytes.end(), raw, raw + sizeof(Value));
+        }
+
+        void AppendString(std::vector<unsigned char>& bytes, const char* text) {
+            bytes.insert(bytes.end(), text, text + std::strlen(text) + 1);
+        }
+
+        // appends an OpenEXR attribute header, the value follows
+        void AppendAttribute(std::vector<unsigned char>& bytes, const char* name,
+                             const char* type, std::int32_t size) {
+            AppendString(bytes, name);
+            AppendString(bytes, type);
+            Append(bytes, size);
+        }
+
+        const std::int32_t exrMagic = 20000630;
+        const std::int32_t exrVersion = 2;
+        const std::int32_t exrTiledFlag = 0x200;
+        const std::int32_t exrFloatPixels = 2;
+        const unsigned char exrNoCompression = 0;
+        const unsigned char exrRandomLineOrder = 2;
+        const unsigned char exrOneLevel = 0;
+    }
+
+    ImageWriter::ImageWriter() :
+        file(0), format(ppmFormat), width(0), height(0), tileSize(0), headerSize(0), end(0),
+        bytesWritten(0), closing(false), failed(false) {
+
+    }
+
+    ImageWriter::~ImageWriter() {
+        Close();
+    }
+
+    ImageWriter::Format ImageWriter::GetFormat(const std::string& path) {
+        std::size_t dot = path.find_last_of('.');
+        std::string extension = dot == std::string::npos ? std::string() : path.substr(dot);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if(extension == ".pfm")
+            return pfmFormat;
+        if(extension == ".exr")
+            return exrFormat;
+        return ppmFormat;
+    }
+
+    bool ImageWriter::Open(const std::string& path, int widthArg, int heightArg, int tileSizeArg,
+                           Format formatArg) {
+        Close();
+        width = widthArg;
+        height = heightArg;
+        tileSize = std::max(tileSizeArg, 1);
+        format = formatArg;
+        bytesWritten = 0;
+        closing = false;
+        failed = false;
+        error.clear();
+
+        file = std::fopen(path.c_str(), "wb");
+        if(!file) {
+            error = "could not create " + path;
+            return false;
+        }
+        if(!WriteHeader()) {
+            std::fclose(file);
+            file = 0;
+            return false;
+        }
+        thread = std::thread(&ImageWriter::Run, this);
+        return true;
+    }
+
+    void ImageWriter::SubmitTile(const Framebuffer& framebuffer, const Tile& tile) {
+        PendingTile pending;
+        pending.tile = tile;
+        pending.rows.resize((std::size_t)(tile.x1 - tile.x0) * (tile.y1 - tile.y0));
+        framebuffer.CopyTile(tile, pending.rows.data());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(pending));
+        }
+        ready.notify_one();
+    }
+
+    bool ImageWriter::Close() {
+        if(!file)
+            return !failed;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+        }
+        ready.notify_one();
+        thread.join();
+
+        if(format == exrFormat && !failed) {
+            // tiles never submitted are written black so the file stays readable
+            int tilesPerRow = (width + tileSize - 1) / tileSize;
+            for(std::size_t i = 0; i < tileOffsets.size() && !failed; i++) {
+                if(tileOffsets[i])
+                    continue;
+                PendingTile pending;
+                int tx = (int)(i % tilesPerRow);
+                int ty = (int)(i / tilesPerRow);
+                pending.tile.x0 = tx * tileSize;
+                pending.tile.y0 = ty * tileSize;
+                pending.tile.x1 = std::min(pending.tile.x0 + tileSize, width);
+                pending.tile.y1 = std::min(pending.tile.y0 + tileSize, height);
+                pending.rows.resize((std::size_t)(pending.tile.x1 - pending.tile.x0) *
+                                    (pending.tile.y1 - pending.tile.y0));
+                failed = !WriteTile(pending);
+            }
+            std::vector<unsigned char> table;
+            for(std::uint64_t offset : tileOffsets)
+                Append(table, offset);
+            if(!failed && !WriteAt(headerSize, table.data(), table.size()))
+                failed = true;
+        }
+
+        if(std::fclose(file) != 0 && !failed) {
+            failed = true;
+            error = "could not finish writing the image";
+        }
+        file = 0;
+        return !failed;
+    }
+
+    std::uint64_t ImageWriter::GetBytesWritten() const {
+        return bytesWritten;
+    }
+
+    const std::string& ImageWriter::GetError() const {
+        return error;
+    }
+
+    void ImageWriter::Run() {
+        TraceRecorder::SetThreadName("image writer");
+        for(;;) {
+            PendingTile pending;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [this]() {
+                    return closing || !queue.empty();
+                });
+                if(queue.empty())
+                    return;
+                pending = std::move(queue.front());
+                queue.pop_front();
+                if(failed)
+                    continue;
+            }
+            if(!WriteTile(pending)) {
+                std::lock_guard<std::mutex> lock(mutex);
+                failed = true;
+            }
+        }
+    }
+
+    bool ImageWriter::WriteHeader() {
+        std::vector<unsigned char> header;
+        if(format == ppmFormat || format == pfmFormat) {
+            char text[64];
+            int length = format == ppmFormat ?
+                std::snprintf(text, sizeof(text), "P6\n%d %d\n255\n", width, height) :
+                std::snprintf(text, sizeof(text), "PF\n%d %d\n%s\n", width, height,
+                              HostIsLittleEndian() ? "-1.0" : "1.0");
+            header.assign(text, text + length);
+        }
+        else {
+            Append(header, exrMagic);
+            Append(header, exrVersion | exrTiledFlag);
+
+            // channels are listed in alphabetical order
+            AppendAttribute(header, "channels", "chlist", 3 * 18 + 1);
+            for(const char* channel : { "B", "G", "R" }) {
+                AppendString(header, channel);
+                Append(header, exrFloatPixels);
+                Append(header, std::uint32_t(0)); // pLinear and reserved
+                Append(header, std::int32_t(1));  // x sampling
+                Append(header, std::int32_t(1));  // y sampling
+            }
+            header.push_back(0);
+
+            AppendAttribute(header, "compression", "compression", 1);
+            header.push_back(exrNoCompression);
+            for(const char* window : { "dataWindow", "displayWindow" }) {
+                AppendAttribute(header, window, "box2i", 16);
+                Append(header, std::int32_t(0));
+                Append(header, std::int32_t(0));
+                Append(header, std::int32_t(width - 1));
+                Append(header, std::int32_t(height - 1));
+            }
+            AppendAttribute(header, "lineOrder", "lineOrder", 1);
+            header.push_back(exrRandomLineOrder);
+            AppendAttribute(header, "pixelAspectRatio", "float", 4);
+            Append(header, 1.0f);
+            AppendAttribute(header, "screenWindowCenter", "v2f", 8);
+            Append(header, 0.0f);
+            Append(header, 0.0f);
+            AppendAttribute(header, "screenWindowWidth", "float", 4);
+            Append(header, 1.0f);
+            AppendAttribute(header, "tiles", "tiledesc", 9);
+            Append(header, std::uint32_t(tileSize));
+            Append(header, std::uint32_t(tileSize));
+            header.push_back(exrOneLevel);
+            header.push_back(0);
+
+            // the tile offset table follows the header and is written by Close
+            int tilesPerRow = (width + tileSize - 1) / tileSize;
+            int tilesPerColumn = (height + tileSize - 1) / tileSize;
+            tileOffsets.assign((std::size_t)tilesPerRow * tilesPerColumn, 0);
+        }
+
+        headerSize = header.size();
+        end = headerSize + tileOffsets.size() * sizeof(std::uint64_t);
+        if(!WriteAt(0, header.data(), header.size())) {
+            error = "could not write the image header";
+            return false;
+        }
+        return true;
+    }
+
+    bool ImageWriter::WriteTile(const PendingTile& pending) {
+        const Tile& tile = pending.tile;
+        TraceRecorder::Scope trace("write tile", "io", "x", tile.x0, "y", tile.y0);
+        int tileWidth = tile.x1 - tile.x0;
+        const Color* row = pending.rows.data();
+
+        if(format == ppmFormat) {
+            buffer.resize((std::size_t)tileWidth * 3);
+            for(int y = tile.y0; y < tile.y1; y++, row += tileWidth) {
+                for(int x = 0; x < tileWidth; x++) {
+                    buffer[3 * x + 0] = Framebuffer::EncodeSRGB(row[x].GetRed());
+                    buffer[3 * x + 1] = Framebuffer::EncodeSRGB(row[x].GetGreen());
+                    buffer[3 * x + 2] = Framebuffer::EncodeSRGB(row[x].GetBlue());
+                }
+                std::uint64_t offset = headerSize + ((std::uint64_t)y * width + tile.x0) * 3;
+                if(!WriteAt(offset, buffer.data(), buffer.size()))
+                    return false;
+            }
+            return true;
+        }
+
+        if(format == pfmFormat) {
+            buffer.resize((std::size_t)tileWidth * 3 * sizeof(float));
+            for(int y = tile.y0; y < tile.y1; y++, row += tileWidth) {
+                float* values = reinterpret_cast<float*>(buffer.data());
+                for(int x = 0; x < tileWidth; x++) {
+                    values[3 * x + 0] = row[x].GetRed();
+                    values[3 * x + 1] = row[x].GetGreen();
+                    values[3 * x + 2] = row[x].GetBlue();
+                }
+                std::uint64_t offset = headerSize +
+                    ((std::uint64_t)(height - 1 - y) * width + tile.x0) * 3 * sizeof(float);
+                if(!WriteAt(offset, buffer.data(), buffer.size()))
+                    return false;
+            }
+            return true;
+        }
+
+        // an EXR tile chunk: coordinates, level, size, then each row as B, G and R runs
+        int tilesPerRow = (width + tileSize - 1) / tileSize;
+        std::int32_t tileX = tile.x0 / tileSize;
+        std::int32_t tileY = tile.y0 / tileSize;
+        std::int32_t dataSize = (std::int32_t)(pending.rows.size() * 3 * sizeof(float));
+        buffer.clear();
+        Append(buffer, tileX);
+        Append(buffer, tileY);
+        Append(buffer, std::int32_t(0));
+        Append(buffer, std::int32_t(0));
+        Append(buffer, dataSize);
+        for(int y = tile.y0; y < tile.y1; y++, row += tileWidth) {
+            for(int x = 0; x < tileWidth; x++)
+                Append(buffer, row[x].GetBlue());
+            for(int x = 0; x < tileWidth; x++)
+                Append(buffer, row[x].GetGreen());
+            for(int x = 0; x < tileWidth; x++)
+                Append(buffer, row[x].GetRed());
+        }
+        tileOffsets[(std::size_t)tileY * tilesPerRow + tileX] = end;
+        end += buffer.size();
+        return WriteAt(tileOffsets[(std::size_t)tileY * tilesPerRow + tileX], buffer.data(), buffer.size());
+    }
+
+    bool ImageWriter::WriteAt(std::uint64_t offset, const void* bytes, std::size_t length) {
+#if defined(SCPPR_HAS_FSEEKO)
+        bool placed = fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#else
+        bool placed = std::fseek(file, (long)offset, SEEK_SET) == 0;
+#endif
+        if(!placed || std::fwrite(bytes, 1, length, file) != length) {
+            if(error.empty())
+                error = "could not write the image";
+            return false;
+        }
+        bytesWritten += length;
+        return true;
+    }
+}
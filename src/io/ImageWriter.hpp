@@ -0,0 +1,173 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   ImageWriter.hpp
+ * 
+ * Background writer streaming finished tiles to image files
+ * Class and method definitions
+ */
+
+/*!
+ \file ImageWriter.hpp
+ Header definition for the ImageWriter class
+ */
+
+#ifndef IMAGEWRITER_HPP
+#define	IMAGEWRITER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../render/Framebuffer.hpp"
+#include "../utility/Color.hpp"
+
+namespace SCPPR {
+
+    //! Writes an image tile by tile on a thread of its own
+    /*!
+     SubmitTile copies a finished tile out of the framebuffer and queues it;
+     a background thread encodes queued tiles and writes them while
+     rendering continues, so by the time the last tile is rendered the
+     file is nearly complete.
+
+     - PPM: 8 bit sRGB. Each tile row goes straight to its place in the
+       file.
+     - PFM: 32 bit linear float, rows bottom to top as the format requires,
+       placed the same way.
+     - EXR: tiled OpenEXR with uncompressed float R, G and B channels and
+       tiles of the framebuffer tile size. Tiles are appended in the order
+       they finish, which the file records as random line order, and the
+       tile offset table is filled in by Close.
+     */
+    class ImageWriter {
+
+    public:
+
+        //! Output encodings
+        enum Format {
+            ppmFormat, //!< Binary PPM, 8 bit sRGB
+            pfmFormat, //!< Portable float map, linear
+            exrFormat  //!< Tiled OpenEXR, linear float
+        };
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs a writer with no file open
+         */
+        ImageWriter();
+
+        //! Destructor, finishes writing an open file
+        ~ImageWriter();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Returns the format matching the extension of path, PPM when unknown
+        static Format GetFormat(const std::string& path);
+
+        //! Creates the file and starts the writer thread
+        /*!
+         Tiles are tileSize pixels square, clipped at the image edges.
+         Returns false and sets the error when the file cannot be created.
+         */
+        bool Open(const std::string& path, int widthArg, int heightArg, int tileSizeArg,
+                  Format formatArg);
+
+        //! Queues a copy of the tile's pixels for writing
+        /*!
+         Safe to call from any thread. For EXR the tile must be one of the
+         tileSize grid tiles.
+         */
+        void SubmitTile(const Framebuffer& framebuffer, const Tile& tile);
+
+        //! Writes the remaining tiles and closes the file, returns false on any failure
+        bool Close();
+
+        //! Returns true while a file is open
+        bool IsOpen() const;
+
+        //! Returns the bytes written so far
+        std::uint64_t GetBytesWritten() const;
+
+        //! Returns a description of the first failure
+        const std::string& GetError() const;
+
+    protected:
+
+        //! A tile copied out of the framebuffer
+        struct PendingTile {
+            Tile tile;                //!< Pixel rectangle
+            std::vector<Color> rows;  //!< Row major pixels, top row first
+        };
+
+        //! Writer thread body
+        void Run();
+
+        //! Encodes one tile and writes it to the file
+        bool WriteTile(const PendingTile& pending);
+
+        //! Writes the format header
+        bool WriteHeader();
+
+        //! Writes bytes at offset
+        bool WriteAt(std::uint64_t offset, const void* bytes, std::size_t length);
+
+        std::FILE* file;                  //!< Output file
+        Format format;                    //!< Output encoding
+        int width;                        //!< Image width in pixels
+        int height;                       //!< Image height in pixels
+        int tileSize;                     //!< Tile edge in pixels
+        std::uint64_t headerSize;         //!< Bytes before the pixel data
+        std::uint64_t end;                //!< Append position of EXR tile chunks
+        std::atomic<std::uint64_t> bytesWritten; //!< Bytes written so far
+        std::vector<std::uint64_t> tileOffsets; //!< EXR tile offset table
+        std::vector<unsigned char> buffer; //!< Encoding scratch of the writer thread
+
+        std::deque<PendingTile> queue;    //!< Tiles waiting to be written
+        bool closing;                     //!< Set when Close asks the thread to finish
+        bool failed;                      //!< Set on the first failure
+        std::string error;                //!< Description of the first failure
+        mutable std::mutex mutex;         //!< Guards the queue and the flags
+        std::condition_variable ready;    //!< Signals queued tiles or closing
+        std::thread thread;               //!< Writer thread
+
+    private:
+
+        ImageWriter(const ImageWriter&);
+        ImageWriter& operator= (const ImageWriter&);
+    };
+
+    inline bool ImageWriter::IsOpen() const {
+        return file != 0;
+    }
+}
+
+#endif	/* IMAGEWRITER_HPP */
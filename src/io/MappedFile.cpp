@@ -0,0 +1,125 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   MappedFile.cpp
+ * 
+ * Read only memory mapped file
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SCPPR_HAS_MMAP 1
+#endif
+
+#include "MappedFile.hpp"
+
+namespace SCPPR {
+
+    MappedFile::MappedFile() :
+        data(0), size(0), open(false), mapped(false) {
+
+    }
+
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    bool MappedFile::Open(const std::string& path) {
+        Close();
+        error.clear();
+
+#if defined(SCPPR_HAS_MMAP)
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if(descriptor < 0) {
+            error = path + ": " + std::strerror(errno);
+            return false;
+        }
+
+        struct stat status;
+        if(fstat(descriptor, &status) != 0) {
+            error = path + ": " + std::strerror(errno);
+            ::close(descriptor);
+            return false;
+        }
+
+        size = (std::size_t)status.st_size;
+        if(size > 0) {
+            void* address = mmap(0, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if(address == MAP_FAILED) {
+                error = path + ": " + std::strerror(errno);
+                ::close(descriptor);
+                size = 0;
+                return false;
+            }
+            data = static_cast<const unsigned char*>(address);
+        }
+        // the mapping stays valid after the descriptor is closed
+        ::close(descriptor);
+        mapped = true;
+#else
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if(!file) {
+            error = path + ": " + std::strerror(errno);
+            return false;
+        }
+        std::fseek(file, 0, SEEK_END);
+        size = (std::size_t)std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        unsigned char* buffer = new unsigned char[size > 0 ? size : 1];
+        if(std::fread(buffer, 1, size, file) != size) {
+            error = path + ": short read";
+            delete[] buffer;
+            std::fclose(file);
+            size = 0;
+            return false;
+        }
+        std::fclose(file);
+        data = buffer;
+        mapped = false;
+#endif
+        open = true;
+        return true;
+    }
+
+    void MappedFile::Close() {
+        if(!open)
+            return;
+#if defined(SCPPR_HAS_MMAP)
+        if(mapped && data)
+            munmap(const_cast<unsigned char*>(data), size);
+#endif
+        if(!mapped)
+            delete[] data;
+        data = 0;
+        size = 0;
+        open = false;
+        mapped = false;
+    }
+}
@@ -0,0 +1,115 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   MappedFile.hpp
+ * 
+ * Read only memory mapped file
+ * Class and method definitions
+ */
+
+/*!
+ \file MappedFile.hpp
+ Header definition for the MappedFile class
+ */
+
+#ifndef MAPPEDFILE_HPP
+#define	MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace SCPPR {
+
+    //! Read only view of a whole file
+    /*!
+     Maps the file into memory on POSIX systems so that its contents are
+     paged in on first touch rather than read up front. Elsewhere the file
+     is read into a heap buffer, with the same interface.
+     */
+    class MappedFile {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs a closed file
+         */
+        MappedFile();
+
+        //! Destructor, unmaps the file
+        ~MappedFile();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Maps the file at path, returns false and sets the error on failure
+        bool Open(const std::string& path);
+
+        //! Unmaps the file
+        void Close();
+
+        //! Returns true while a file is mapped
+        bool IsOpen() const;
+
+        //! Returns the first byte of the file
+        const unsigned char* GetData() const;
+
+        //! Returns the size of the file in bytes
+        std::size_t GetSize() const;
+
+        //! Returns a description of the last failure
+        const std::string& GetError() const;
+
+    protected:
+
+        const unsigned char* data; //!< Start of the mapping
+        std::size_t size;          //!< Length of the mapping in bytes
+        bool open;                 //!< True while a file is held
+        bool mapped;               //!< True for mmap, false for a heap buffer
+        std::string error;         //!< Last failure
+
+    private:
+
+        MappedFile(const MappedFile&);
+        MappedFile& operator= (const MappedFile&);
+    };
+
+    inline bool MappedFile::IsOpen() const {
+        return open;
+    }
+
+    inline const unsigned char* MappedFile::GetData() const {
+        return data;
+    }
+
+    inline std::size_t MappedFile::GetSize() const {
+        return size;
+    }
+
+    inline const std::string& MappedFile::GetError() const {
+        return error;
+    }
+}
+
+#endif	/* MAPPEDFILE_HPP */
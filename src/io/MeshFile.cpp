@@ -0,0 +1,171 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   MeshFile.cpp
+ * 
+ * Binary mesh format that can be memory mapped
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#include "MeshFile.hpp"
+#include "MappedFile.hpp"
+#include "../geometry/TriangleMesh.hpp"
+#include "../utility/ErrorMessage.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const char meshMagic[8] = {'S', 'C', 'P', 'P', 'R', 'M', 'S', 'H'};
+
+        // rounds offset up to the buffer alignment
+        std::uint64_t AlignOffset(std::uint64_t offset) {
+            return (offset + MeshFile::alignment - 1) & ~(std::uint64_t)(MeshFile::alignment - 1);
+        }
+
+        // true when [offset, offset + length) is aligned and inside the file
+        bool RangeValid(std::uint64_t offset, std::uint64_t length, std::uint64_t fileSize) {
+            return offset % MeshFile::alignment == 0 && offset <= fileSize &&
+                   length <= fileSize - offset;
+        }
+    }
+
+    const std::uint32_t MeshFile::version;
+    const std::uint32_t MeshFile::byteOrderMark;
+    const std::uint32_t MeshFile::hasNormals;
+    const std::uint32_t MeshFile::hasUVs;
+    const std::uint32_t MeshFile::compressedNormals;
+    const std::size_t MeshFile::alignment;
+
+    bool MeshFile::Write(const TriangleMesh& mesh, const std::string& path, std::string* error) {
+        std::uint64_t vertexCount = mesh.GetVertexCount();
+        std::uint64_t triangleCount = mesh.GetTriangleCount();
+
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, meshMagic, sizeof(meshMagic));
+        header.version = version;
+        header.byteOrder = byteOrderMark;
+        header.flags = (mesh.HasNormals() ? hasNormals : 0) | (mesh.HasUVs() ? hasUVs : 0) |
+                       (mesh.HasCompressedNormals() ? compressedNormals : 0);
+        const std::uint64_t normalSize = mesh.HasCompressedNormals() ? sizeof(OctahedralNormal32) :
+                                                                       3 * sizeof(float);
+        header.vertexCount = vertexCount;
+        header.triangleCount = triangleCount;
+
+        std::uint64_t offset = AlignOffset(sizeof(Header));
+        header.positionOffset = offset;
+        offset = AlignOffset(offset + vertexCount * 3 * sizeof(float));
+        if(mesh.HasNormals()) {
+            header.normalOffset = offset;
+            offset = AlignOffset(offset + vertexCount * normalSize);
+        }
+        if(mesh.HasUVs()) {
+            header.uvOffset = offset;
+            offset = AlignOffset(offset + vertexCount * 2 * sizeof(float));
+        }
+        header.indexOffset = offset;
+        header.fileSize = offset + triangleCount * 3 * sizeof(std::uint32_t);
+
+        std::ofstream stream(path.c_str(), std::ios::binary | std::ios::trunc);
+        if(!stream)
+            return Fail(error, "cannot open " + path + " for writing");
+
+        // writes a buffer at its offset, zero padding the gap before it
+        std::uint64_t written = 0;
+        auto writeAt = [&stream, &written](std::uint64_t at, const void* bytes, std::uint64_t length) {
+            static const char zeros[MeshFile::alignment] = {};
+            while(written < at) {
+                std::uint64_t gap = std::min<std::uint64_t>(at - written, sizeof(zeros));
+                stream.write(zeros, (std::streamsize)gap);
+                written += gap;
+            }
+            stream.write(static_cast<const char*>(bytes), (std::streamsize)length);
+            written += length;
+        };
+
+        writeAt(0, &header, sizeof(header));
+        writeAt(header.positionOffset, mesh.GetPositions(), vertexCount * 3 * sizeof(float));
+        if(mesh.HasCompressedNormals())
+            writeAt(header.normalOffset, mesh.GetCompressedNormals(), vertexCount * normalSize);
+        else if(mesh.HasNormals())
+            writeAt(header.normalOffset, mesh.GetNormals(), vertexCount * normalSize);
+        if(mesh.HasUVs())
+            writeAt(header.uvOffset, mesh.GetUVs(), vertexCount * 2 * sizeof(float));
+        writeAt(header.indexOffset, mesh.GetIndices(), triangleCount * 3 * sizeof(std::uint32_t));
+
+        stream.flush();
+        if(!stream)
+            return Fail(error, "failed writing " + path);
+        return true;
+    }
+
+    bool MeshFile::Map(const std::string& path, TriangleMesh& mesh, std::string* error) {
+        std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+        if(!file->Open(path))
+            return Fail(error, file->GetError());
+        if(file->GetSize() < sizeof(Header))
+            return Fail(error, path + " is too small to be a mesh file");
+
+        Header header;
+        std::memcpy(&header, file->GetData(), sizeof(header));
+        if(std::memcmp(header.magic, meshMagic, sizeof(meshMagic)) != 0)
+            return Fail(error, path + " is not a mesh file");
+        if(header.byteOrder != byteOrderMark)
+            return Fail(error, path + " was written with a different byte order");
+        if(header.version < 1 || header.version > version)
+            return Fail(error, path + " has unsupported version " + std::to_string(header.version));
+
+        std::uint64_t size = file->GetSize();
+        std::uint64_t vertexCount = header.vertexCount;
+        std::uint64_t triangleCount = header.triangleCount;
+        if(header.fileSize > size || vertexCount > size || triangleCount > size ||
+           vertexCount > UINT32_MAX)
+            return Fail(error, path + " is truncated");
+
+        bool normalsPresent = (header.flags & hasNormals) != 0;
+        bool uvsPresent = (header.flags & hasUVs) != 0;
+        bool normalsCompressed = normalsPresent && (header.flags & compressedNormals) != 0;
+        std::uint64_t normalSize = normalsCompressed ? sizeof(OctahedralNormal32) : 3 * sizeof(float);
+        if(!RangeValid(header.positionOffset, vertexCount * 3 * sizeof(float), size) ||
+           (normalsPresent && !RangeValid(header.normalOffset, vertexCount * normalSize, size)) ||
+           (uvsPresent && !RangeValid(header.uvOffset, vertexCount * 2 * sizeof(float), size)) ||
+           !RangeValid(header.indexOffset, triangleCount * 3 * sizeof(std::uint32_t), size))
+            return Fail(error, path + " has buffers outside the file");
+
+        const unsigned char* base = file->GetData();
+        mesh.Borrow(file, (std::size_t)vertexCount, (std::size_t)triangleCount,
+                    reinterpret_cast<const float*>(base + header.positionOffset),
+                    normalsPresent && !normalsCompressed ?
+                        reinterpret_cast<const float*>(base + header.normalOffset) : 0,
+                    uvsPresent ? reinterpret_cast<const float*>(base + header.uvOffset) : 0,
+                    reinterpret_cast<const std::uint32_t*>(base + header.indexOffset),
+                    normalsCompressed ?
+                        reinterpret_cast<const OctahedralNormal32*>(base + header.normalOffset) : 0);
+        return true;
+    }
+}
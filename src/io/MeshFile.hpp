@@ -0,0 +1,105 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   MeshFile.hpp
+ * 
+ * Binary mesh format that can be memory mapped
+ * Class and method definitions
+ */
+
+/*!
+ \file MeshFile.hpp
+ Header definition for the MeshFile reader and writer
+ */
+
+#ifndef MESHFILE_HPP
+#define	MESHFILE_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace SCPPR {
+
+    class TriangleMesh;
+
+    //! Reader and writer for the binary mesh format
+    /*!
+     A file is a 128 byte header followed by the raw TriangleMesh buffers,
+     each starting on a 64 byte boundary so it can be used in place:
+
+     - magic "SCPPRMSH", format version, byte order mark and flags
+     - vertex and triangle counts
+     - byte offsets of the positions, normals, texture coordinates and indices
+
+     Normals are three floats per vertex, or one OctahedralNormal32 when the
+     compressedNormals flag is set.
+
+     Loading maps the file and points a mesh at the buffers, so opening a
+     mesh costs a header check regardless of its size and pages are read on
+     first touch. Files are written in the byte order of the host and are
+     rejected on hosts of the other order.
+     */
+    class MeshFile {
+
+    public:
+
+        //! Fixed header at the start of every file
+        struct Header {
+            char magic[8];                 //!< "SCPPRMSH"
+            std::uint32_t version;         //!< Format version
+            std::uint32_t byteOrder;       //!< byteOrderMark as written by the host
+            std::uint32_t flags;           //!< hasNormals, hasUVs and compressedNormals bits
+            std::uint32_t reserved0;       //!< Zero
+            std::uint64_t vertexCount;     //!< Number of vertices
+            std::uint64_t triangleCount;   //!< Number of triangles
+            std::uint64_t positionOffset;  //!< Byte offset of the positions
+            std::uint64_t normalOffset;    //!< Byte offset of the normals, zero when absent
+            std::uint64_t uvOffset;        //!< Byte offset of the uvs, zero when absent
+            std::uint64_t indexOffset;     //!< Byte offset of the indices
+            std::uint64_t fileSize;        //!< Total size in bytes
+            std::uint8_t reserved1[48];    //!< Zero
+        };
+
+        static const std::uint32_t version = 2;               //!< Current format version, reads 1 and up
+        static const std::uint32_t byteOrderMark = 0x01020304u; //!< Detects foreign byte order
+        static const std::uint32_t hasNormals = 1u;           //!< Flag bit for normals
+        static const std::uint32_t hasUVs = 2u;               //!< Flag bit for uvs
+        static const std::uint32_t compressedNormals = 4u;    //!< Normals are OctahedralNormal32, since version 2
+        static const std::size_t alignment = 64;              //!< Buffer alignment in bytes
+
+        //! Writes mesh to path, returns false on failure
+        static bool Write(const TriangleMesh& mesh, const std::string& path,
+                          std::string* error = 0);
+
+        //! Maps the mesh at path into mesh without copying
+        /*!
+         On failure leaves mesh untouched, returns false and describes the
+         problem in error when it is not null.
+         */
+        static bool Map(const std::string& path, TriangleMesh& mesh, std::string* error = 0);
+    };
+
+    static_assert(sizeof(MeshFile::Header) == 128, "MeshFile header must be 128 bytes");
+}
+
+#endif	/* MESHFILE_HPP */
@@ -0,0 +1,152 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   MeshImporter.cpp
+ * 
+ * Parallel mesh import front end and shared text parsing
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include "MeshImporter.hpp"
+#include "MappedFile.hpp"
+#include "MeshFile.hpp"
+#include "ObjImporter.hpp"
+#include "PlyImporter.hpp"
+#include "../geometry/TriangleMesh.hpp"
+#include "../parallel/TaskPool.hpp"
+#include "../parallel/TraceRecorder.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        // lower case extension of path including the dot, empty when none
+        std::string GetExtension(const std::string& path) {
+            std::size_t dot = path.find_last_of('.');
+            std::size_t slash = path.find_last_of("/\\");
+            if(dot == std::string::npos || (slash != std::string::npos && dot < slash))
+                return std::string();
+            std::string extension = path.substr(dot);
+            std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+            return extension;
+        }
+    }
+
+    const std::size_t MeshImporter::minimumChunkBytes;
+    const std::size_t MeshImporter::chunksPerThread;
+
+    bool MeshImporter::Import(const std::string& path, TriangleMesh& mesh, TaskPool* pool,
+                              ImportStatistics* statistics, std::string* error) {
+        TraceRecorder::Scope trace("mesh import", "io");
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::string extension = GetExtension(path);
+        std::string message;
+        bool success = false;
+        std::size_t bytes = 0;
+        std::size_t chunks = 1;
+
+        if(extension == ".mesh") {
+            success = MeshFile::Map(path, mesh, &message);
+            bytes = success ? mesh.GetMemoryUsage() : 0;
+        }
+        else if(extension == ".obj" || extension == ".ply") {
+            MappedFile file;
+            if(!file.Open(path))
+                message = file.GetError();
+            else {
+                const char* begin = reinterpret_cast<const char*>(file.GetData());
+                const char* end = begin + file.GetSize();
+                bytes = file.GetSize();
+                chunks = GetChunkCount(pool, bytes);
+                success = extension == ".obj" ?
+                    ObjImporter::Import(begin, end, mesh, pool, chunks, &message) :
+                    PlyImporter::Import(begin, end, mesh, pool, chunks, &message);
+                if(!success)
+                    message = path + ": " + message;
+            }
+        }
+        else
+            message = path + ": no importer for extension '" + extension + "'";
+
+        if(!success) {
+            if(error)
+                *error = message;
+            return false;
+        }
+        if(statistics) {
+            statistics->bytes = bytes;
+            statistics->chunks = chunks;
+            statistics->seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+        return true;
+    }
+
+    bool MeshImporter::IsSupported(const std::string& path) {
+        std::string extension = GetExtension(path);
+        return extension == ".obj" || extension == ".ply" || extension == ".mesh";
+    }
+
+    std::size_t MeshImporter::GetChunkCount(TaskPool* pool, std::size_t bytes) {
+        if(!pool)
+            return 1;
+        std::size_t bySize = std::max<std::size_t>(1, bytes / minimumChunkBytes);
+        return std::min(bySize, pool->GetThreadCount() * chunksPerThread);
+    }
+
+    std::vector<const char*> MeshImporter::SplitLines(const char* begin, const char* end,
+                                                      std::size_t chunkCount) {
+        chunkCount = std::max<std::size_t>(1, chunkCount);
+        std::vector<const char*> boundaries(chunkCount + 1);
+        boundaries[0] = begin;
+        boundaries[chunkCount] = end;
+        std::size_t length = end - begin;
+        for(std::size_t i = 1; i < chunkCount; i++) {
+            const char* cursor = std::max(begin + length / chunkCount * i, boundaries[i - 1]);
+            if(cursor > begin && cursor < end && cursor[-1] != '\n') {
+                const char* lineEnd = FindLineEnd(cursor, end);
+                cursor = lineEnd < end ? lineEnd + 1 : end;
+            }
+            boundaries[i] = cursor;
+        }
+        return boundaries;
+    }
+
+    void MeshImporter::ForEachChunk(TaskPool* pool, std::size_t chunkCount,
+                                    const std::function<void(std::size_t)>& body) {
+        if(!pool || chunkCount < 2) {
+            for(std::size_t i = 0; i < chunkCount; i++)
+                body(i);
+            return;
+        }
+        pool->ParallelFor(chunkCount, 1, [&body](std::size_t first, std::size_t last) {
+            for(std::size_t i = first; i < last; i++) {
+                TraceRecorder::Scope trace("parse chunk", "io", "chunk", (std::int64_t)i);
+                body(i);
+            }
+        });
+    }
+}
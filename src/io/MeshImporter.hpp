@@ -0,0 +1,243 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   MeshImporter.hpp
+ * 
+ * Parallel mesh import front end and shared text parsing
+ * Class and method definitions
+ */
+
+/*!
+ \file MeshImporter.hpp
+ Header definition for the MeshImporter class
+ */
+
+#ifndef MESHIMPORTER_HPP
+#define	MESHIMPORTER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SCPPR {
+
+    class TaskPool;
+    class TriangleMesh;
+
+    //! Size and duration of an import
+    struct ImportStatistics {
+        std::size_t bytes;   //!< Bytes of the source file
+        std::size_t chunks;  //!< Chunks the file was parsed in
+        double seconds;      //!< Wall time from open to finished mesh
+
+        ImportStatistics() : bytes(0), chunks(0), seconds(0.0) {
+
+        }
+
+        //! Returns the parse throughput in megabytes (10^6 bytes) per second
+        double GetMegabytesPerSecond() const {
+            return seconds > 0.0 ? bytes / (seconds * 1e6) : 0.0;
+        }
+    };
+
+    //! Loads meshes from files
+    /*!
+     Import maps the file and hands its bytes to the parser matching the
+     extension: .obj to ObjImporter, .ply to PlyImporter and .mesh to
+     MeshFile. The text parsers split the file into line aligned chunks and
+     parse the chunks on a TaskPool, writing straight into the TriangleMesh
+     buffers.
+
+     The static helpers below are the shared low level text scanning used
+     by the parsers. They never read past end and do not depend on the
+     locale.
+     */
+    class MeshImporter {
+
+    public:
+
+        //! Chunks smaller than this are not split further
+        static const std::size_t minimumChunkBytes = 1 << 20;
+
+        //! Chunks per worker, so that uneven chunks still balance
+        static const std::size_t chunksPerThread = 8;
+
+        //! Imports the mesh at path into mesh
+        /*!
+         Parses on pool when it is not null. On failure returns false and
+         describes the problem in error when it is not null.
+         */
+        static bool Import(const std::string& path, TriangleMesh& mesh, TaskPool* pool = 0,
+                           ImportStatistics* statistics = 0, std::string* error = 0);
+
+        //! Returns true when the extension of path has an importer
+        static bool IsSupported(const std::string& path);
+
+        // begin chunking helpers-----------------------------------------------
+
+        //! Returns how many chunks to split bytes into for pool
+        static std::size_t GetChunkCount(TaskPool* pool, std::size_t bytes);
+
+        //! Splits [begin, end) into chunkCount pieces that start on line starts
+        /*!
+         Returns the chunkCount + 1 boundaries; neighbouring boundaries may
+         coincide when lines are long.
+         */
+        static std::vector<const char*> SplitLines(const char* begin, const char* end,
+                                                   std::size_t chunkCount);
+
+        //! Calls body(chunk) for every chunk, on pool when it is not null
+        static void ForEachChunk(TaskPool* pool, std::size_t chunkCount,
+                                 const std::function<void(std::size_t)>& body);
+
+        // end chunking helpers-------------------------------------------------
+
+        // begin text scanning helpers------------------------------------------
+
+        //! Returns true for blanks other than the line end
+        static bool IsBlank(char c);
+
+        //! Returns the first non blank at or after cursor
+        static const char* SkipBlanks(const char* cursor, const char* end);
+
+        //! Returns the first blank or line end at or after cursor
+        static const char* SkipToken(const char* cursor, const char* end);
+
+        //! Returns the '\n' ending the line at cursor, or end
+        static const char* FindLineEnd(const char* cursor, const char* end);
+
+        //! Parses a decimal float, returns the character after it or null
+        static const char* ParseFloat(const char* cursor, const char* end, float& value);
+
+        //! Parses a decimal integer, returns the character after it or null
+        static const char* ParseInteger(const char* cursor, const char* end, std::int64_t& value);
+
+        // end text scanning helpers--------------------------------------------
+    };
+
+    inline bool MeshImporter::IsBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline const char* MeshImporter::SkipBlanks(const char* cursor, const char* end) {
+        while(cursor < end && IsBlank(*cursor))
+            cursor++;
+        return cursor;
+    }
+
+    inline const char* MeshImporter::SkipToken(const char* cursor, const char* end) {
+        while(cursor < end && !IsBlank(*cursor) && *cursor != '\n')
+            cursor++;
+        return cursor;
+    }
+
+    inline const char* MeshImporter::FindLineEnd(const char* cursor, const char* end) {
+        const void* found = std::memchr(cursor, '\n', end - cursor);
+        return found ? static_cast<const char*>(found) : end;
+    }
+
+    inline const char* MeshImporter::ParseInteger(const char* cursor, const char* end,
+                                                  std::int64_t& value) {
+        bool negative = false;
+        if(cursor < end && (*cursor == '-' || *cursor == '+'))
+            negative = *cursor++ == '-';
+        const char* first = cursor;
+        std::int64_t result = 0;
+        while(cursor < end && *cursor >= '0' && *cursor <= '9')
+            result = result * 10 + (*cursor++ - '0');
+        if(cursor == first)
+            return 0;
+        value = negative ? -result : result;
+        return cursor;
+    }
+
+    inline const char* MeshImporter::ParseFloat(const char* cursor, const char* end, float& value) {
+        static const double powers[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+        const char* start = cursor;
+        bool negative = false;
+        if(cursor < end && (*cursor == '-' || *cursor == '+'))
+            negative = *cursor++ == '-';
+
+        // up to 19 significant digits fit the mantissa, the rest only scale
+        std::uint64_t mantissa = 0;
+        int significant = 0;
+        int exponent = 0;
+        bool digits = false;
+        for(; cursor < end && *cursor >= '0' && *cursor <= '9'; cursor++, digits = true) {
+            if(significant < 19) {
+                mantissa = mantissa * 10 + (*cursor - '0');
+                significant += mantissa != 0;
+            }
+            else
+                exponent++;
+        }
+        if(cursor < end && *cursor == '.') {
+            for(cursor++; cursor < end && *cursor >= '0' && *cursor <= '9'; cursor++, digits = true) {
+                if(significant < 19) {
+                    mantissa = mantissa * 10 + (*cursor - '0');
+                    significant += mantissa != 0;
+                    exponent--;
+                }
+            }
+        }
+
+        if(!digits) {
+            // inf and nan spellings are rare enough for the C library
+            char buffer[32];
+            std::size_t length = std::min<std::size_t>(SkipToken(start, end) - start, sizeof(buffer) - 1);
+            std::memcpy(buffer, start, length);
+            buffer[length] = 0;
+            char* parsedEnd;
+            value = std::strtof(buffer, &parsedEnd);
+            return parsedEnd == buffer ? 0 : start + (parsedEnd - buffer);
+        }
+
+        if(cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+            std::int64_t power;
+            const char* after = ParseInteger(cursor + 1, end, power);
+            if(after) {
+                exponent += (int)std::max<std::int64_t>(-1000, std::min<std::int64_t>(1000, power));
+                cursor = after;
+            }
+        }
+
+        double result = (double)mantissa;
+        if(exponent < 0)
+            result = exponent >= -22 ? result / powers[-exponent] : result * std::pow(10.0, exponent);
+        else if(exponent > 0)
+            result = exponent <= 22 ? result * powers[exponent] : result * std::pow(10.0, exponent);
+        value = (float)(negative ? -result : result);
+        return cursor;
+    }
+}
+
+#endif	/* MESHIMPORTER_HPP */
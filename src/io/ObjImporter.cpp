@@ -0,0 +1,384 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   ObjImporter.cpp
+ * 
+ * Parallel Wavefront OBJ parser
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "ObjImporter.hpp"
+#include "MeshImporter.hpp"
+#include "../geometry/TriangleMesh.hpp"
+#include "../parallel/TaskPool.hpp"
+#include "../utility/ErrorMessage.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const std::uint32_t absent = 0xffffffffu;
+
+        enum Statement {
+            otherStatement, positionStatement, normalStatement, uvStatement, faceStatement
+        };
+
+        //! Face corner as written, 1 based or negative, 0 when absent
+        struct RawCorner {
+            std::int64_t position;
+            std::int64_t uv;
+            std::int64_t normal;
+        };
+
+        //! Face corner as 0 based attribute indices, absent when missing
+        struct Corner {
+            std::uint32_t position;
+            std::uint32_t uv;
+            std::uint32_t normal;
+        };
+
+        //! Line aligned slice of the file with its statement counts and offsets
+        struct ObjChunk {
+            const char* begin;
+            const char* end;
+            std::size_t positionCount;
+            std::size_t normalCount;
+            std::size_t uvCount;
+            std::size_t triangleCount;
+            std::size_t positionBase;
+            std::size_t normalBase;
+            std::size_t uvBase;
+            std::size_t triangleBase;
+            bool shared;       //!< Every corner names its position index for all attributes
+            bool mismatch;     //!< A shared looking corner resolved to different indices
+            const char* error; //!< Offending line, or null
+        };
+
+        //! Buffers the second pass writes into
+        struct ObjTarget {
+            float* positions;
+            float* normals;
+            float* uvs;
+            std::uint32_t* indices; //!< Triangle indices when corners share indices
+            Corner* corners;        //!< Triangle corners otherwise
+            std::size_t positionTotal;
+            std::size_t normalTotal;
+            std::size_t uvTotal;
+        };
+
+        bool IsTokenEnd(const char* cursor, const char* end) {
+            return cursor >= end || MeshImporter::IsBlank(*cursor) || *cursor == '\n';
+        }
+
+        // classifies the statement at cursor and moves cursor past its keyword
+        Statement Classify(const char*& cursor, const char* end) {
+            cursor = MeshImporter::SkipBlanks(cursor, end);
+            if(cursor >= end)
+                return otherStatement;
+            if(cursor[0] == 'v') {
+                if(IsTokenEnd(cursor + 1, end)) {
+                    cursor += 1;
+                    return positionStatement;
+                }
+                if(cursor + 1 < end && IsTokenEnd(cursor + 2, end)) {
+                    if(cursor[1] == 'n') {
+                        cursor += 2;
+                        return normalStatement;
+                    }
+                    if(cursor[1] == 't') {
+                        cursor += 2;
+                        return uvStatement;
+                    }
+                }
+            }
+            else if(cursor[0] == 'f' && IsTokenEnd(cursor + 1, end)) {
+                cursor += 1;
+                return faceStatement;
+            }
+            return otherStatement;
+        }
+
+        // parses "v", "v/vt", "v//vn" or "v/vt/vn"
+        const char* ParseCorner(const char* cursor, const char* end, RawCorner& corner) {
+            corner.uv = 0;
+            corner.normal = 0;
+            cursor = MeshImporter::ParseInteger(cursor, end, corner.position);
+            if(!cursor || corner.position == 0)
+                return 0;
+            if(cursor < end && *cursor == '/') {
+                cursor++;
+                if(cursor < end && *cursor != '/') {
+                    cursor = MeshImporter::ParseInteger(cursor, end, corner.uv);
+                    if(!cursor)
+                        return 0;
+                }
+                if(cursor < end && *cursor == '/') {
+                    cursor = MeshImporter::ParseInteger(cursor + 1, end, corner.normal);
+                    if(!cursor)
+                        return 0;
+                }
+            }
+            return IsTokenEnd(cursor, end) ? cursor : 0;
+        }
+
+        // resolves a raw index against the attributes defined so far, absent when invalid
+        std::uint32_t Resolve(std::int64_t raw, std::size_t defined, std::size_t total) {
+            std::int64_t index = raw > 0 ? raw - 1 : (std::int64_t)defined + raw;
+            return index >= 0 && (std::size_t)index < total ? (std::uint32_t)index : absent;
+        }
+
+        // parses up to count floats into values, zero filling the rest
+        bool ParseFloats(const char* cursor, const char* end, float* values, int required, int count) {
+            for(int i = 0; i < count; i++) {
+                cursor = MeshImporter::SkipBlanks(cursor, end);
+                const char* after = cursor < end && *cursor != '\n' ?
+                    MeshImporter::ParseFloat(cursor, end, values[i]) : 0;
+                if(!after) {
+                    if(i < required)
+                        return false;
+                    for(; i < count; i++)
+                        values[i] = 0.0f;
+                    return true;
+                }
+                cursor = after;
+            }
+            return true;
+        }
+
+        // first pass: counts the statements and triangles of a chunk
+        void CountChunk(ObjChunk& chunk) {
+            RawCorner corner;
+            for(const char* line = chunk.begin; line < chunk.end && !chunk.error; ) {
+                const char* lineEnd = MeshImporter::FindLineEnd(line, chunk.end);
+                const char* cursor = line;
+                switch(Classify(cursor, lineEnd)) {
+                    case positionStatement: chunk.positionCount++; break;
+                    case normalStatement: chunk.normalCount++; break;
+                    case uvStatement: chunk.uvCount++; break;
+                    case faceStatement: {
+                        std::size_t corners = 0;
+                        for(cursor = MeshImporter::SkipBlanks(cursor, lineEnd); cursor < lineEnd;
+                            cursor = MeshImporter::SkipBlanks(cursor, lineEnd)) {
+                            cursor = ParseCorner(cursor, lineEnd, corner);
+                            if(!cursor) {
+                                chunk.error = line;
+                                break;
+                            }
+                            chunk.shared = chunk.shared &&
+                                (corner.uv == 0 || corner.uv == corner.position) &&
+                                (corner.normal == 0 || corner.normal == corner.position);
+                            corners++;
+                        }
+                        if(corners >= 3)
+                            chunk.triangleCount += corners - 2;
+                        break;
+                    }
+                    default: break;
+                }
+                line = lineEnd + 1;
+            }
+        }
+
+        // second pass: parses a chunk into its slice of the target buffers
+        void ParseChunk(ObjChunk& chunk, const ObjTarget& target) {
+            std::size_t positions = chunk.positionBase;
+            std::size_t normals = chunk.normalBase;
+            std::size_t uvs = chunk.uvBase;
+            std::size_t triangle = chunk.triangleBase;
+            std::vector<Corner> face;
+            RawCorner raw;
+            for(const char* line = chunk.begin; line < chunk.end && !chunk.error; ) {
+                const char* lineEnd = MeshImporter::FindLineEnd(line, chunk.end);
+                const char* cursor = line;
+                switch(Classify(cursor, lineEnd)) {
+                    case positionStatement:
+                        if(!ParseFloats(cursor, lineEnd, target.positions + 3 * positions++, 3, 3))
+                            chunk.error = line;
+                        break;
+                    case normalStatement:
+                        if(!ParseFloats(cursor, lineEnd, target.normals + 3 * normals++, 3, 3))
+                            chunk.error = line;
+                        break;
+                    case uvStatement:
+                        if(!ParseFloats(cursor, lineEnd, target.uvs + 2 * uvs++, 1, 2))
+                            chunk.error = line;
+                        break;
+                    case faceStatement:
+                        face.clear();
+                        for(cursor = MeshImporter::SkipBlanks(cursor, lineEnd); cursor < lineEnd;
+                            cursor = MeshImporter::SkipBlanks(cursor, lineEnd)) {
+                            cursor = ParseCorner(cursor, lineEnd, raw);
+                            if(!cursor) {
+                                chunk.error = line;
+                                break;
+                            }
+                            Corner corner;
+                            corner.position = Resolve(raw.position, positions, target.positionTotal);
+                            corner.uv = raw.uv ? Resolve(raw.uv, uvs, target.uvTotal) : absent;
+                            corner.normal = raw.normal ? Resolve(raw.normal, normals, target.normalTotal) : absent;
+                            if(corner.position == absent || (raw.uv && corner.uv == absent) ||
+                               (raw.normal && corner.normal == absent)) {
+                                chunk.error = line;
+                                break;
+                            }
+                            face.push_back(corner);
+                        }
+                        for(std::size_t i = 2; i < face.size() && !chunk.error; i++, triangle++) {
+                            const Corner* fan[3] = { &face[0], &face[i - 1], &face[i] };
+                            for(int k = 0; k < 3; k++) {
+                                if(target.indices) {
+                                    const Corner& c = *fan[k];
+                                    chunk.mismatch = chunk.mismatch ||
+                                        (c.uv != absent && c.uv != c.position) ||
+                                        (c.normal != absent && c.normal != c.position);
+                                    target.indices[3 * triangle + k] = c.position;
+                                }
+                                else
+                                    target.corners[3 * triangle + k] = *fan[k];
+                            }
+                        }
+                        break;
+                    default:
+                        break;
+                }
+                line = lineEnd + 1;
+            }
+        }
+
+        bool FailAt(std::string* error, const char* begin, const char* line) {
+            return Fail(error, "malformed statement at byte " + std::to_string(line - begin));
+        }
+    }
+
+    bool ObjImporter::Import(const char* begin, const char* end, TriangleMesh& mesh,
+                             TaskPool* pool, std::size_t chunkCount, std::string* error) {
+        if(chunkCount == 0)
+            chunkCount = MeshImporter::GetChunkCount(pool, end - begin);
+        std::vector<const char*> boundaries = MeshImporter::SplitLines(begin, end, chunkCount);
+
+        std::vector<ObjChunk> chunks(chunkCount);
+        for(std::size_t i = 0; i < chunkCount; i++) {
+            ObjChunk chunk = {};
+            chunk.begin = boundaries[i];
+            chunk.end = boundaries[i + 1];
+            chunk.shared = true;
+            chunks[i] = chunk;
+        }
+        MeshImporter::ForEachChunk(pool, chunkCount, [&chunks](std::size_t i) {
+            CountChunk(chunks[i]);
+        });
+
+        // prefix sums turn the counts into write offsets
+        std::size_t positionTotal = 0, normalTotal = 0, uvTotal = 0, triangleTotal = 0;
+        bool shared = true;
+        for(ObjChunk& chunk : chunks) {
+            if(chunk.error)
+                return FailAt(error, begin, chunk.error);
+            chunk.positionBase = positionTotal;
+            chunk.normalBase = normalTotal;
+            chunk.uvBase = uvTotal;
+            chunk.triangleBase = triangleTotal;
+            positionTotal += chunk.positionCount;
+            normalTotal += chunk.normalCount;
+            uvTotal += chunk.uvCount;
+            triangleTotal += chunk.triangleCount;
+            shared = shared && chunk.shared;
+        }
+        if(3 * triangleTotal >= absent || positionTotal >= absent) {
+            if(error)
+                *error = "mesh exceeds 32 bit vertex indices";
+            return false;
+        }
+
+        ObjTarget target = {};
+        target.positionTotal = positionTotal;
+        target.normalTotal = normalTotal;
+        target.uvTotal = uvTotal;
+        auto parse = [&chunks, &target](std::size_t i) {
+            ParseChunk(chunks[i], target);
+        };
+
+        // attribute arrays double as mesh buffers when corners share indices
+        if(shared && (normalTotal == 0 || normalTotal == positionTotal) &&
+           (uvTotal == 0 || uvTotal == positionTotal)) {
+            mesh.Allocate(positionTotal, triangleTotal, normalTotal > 0, uvTotal > 0);
+            target.positions = mesh.GetMutablePositions();
+            target.normals = mesh.GetMutableNormals();
+            target.uvs = mesh.GetMutableUVs();
+            target.indices = mesh.GetMutableIndices();
+            MeshImporter::ForEachChunk(pool, chunkCount, parse);
+
+            bool mismatch = false;
+            for(const ObjChunk& chunk : chunks) {
+                if(chunk.error)
+                    return FailAt(error, begin, chunk.error);
+                mismatch = mismatch || chunk.mismatch;
+            }
+            if(!mismatch)
+                return true;
+        }
+
+        // otherwise every triangle corner becomes a vertex of its own
+        std::vector<float> positions(3 * positionTotal);
+        std::vector<float> normals(3 * normalTotal);
+        std::vector<float> uvs(2 * uvTotal);
+        std::vector<Corner> corners(3 * triangleTotal);
+        target.positions = positions.data();
+        target.normals = normals.data();
+        target.uvs = uvs.data();
+        target.indices = 0;
+        target.corners = corners.data();
+        MeshImporter::ForEachChunk(pool, chunkCount, parse);
+        for(const ObjChunk& chunk : chunks)
+            if(chunk.error)
+                return FailAt(error, begin, chunk.error);
+
+        mesh.Allocate(3 * triangleTotal, triangleTotal, normalTotal > 0, uvTotal > 0);
+        float* meshPositions = mesh.GetMutablePositions();
+        float* meshNormals = mesh.GetMutableNormals();
+        float* meshUVs = mesh.GetMutableUVs();
+        std::uint32_t* meshIndices = mesh.GetMutableIndices();
+        auto gather = [&](std::size_t first, std::size_t last) {
+            for(std::size_t i = 3 * first; i < 3 * last; i++) {
+                const Corner& corner = corners[i];
+                for(int k = 0; k < 3; k++)
+                    meshPositions[3 * i + k] = positions[3 * corner.position + k];
+                if(meshNormals)
+                    for(int k = 0; k < 3; k++)
+                        meshNormals[3 * i + k] = corner.normal != absent ? normals[3 * corner.normal + k] : 0.0f;
+                if(meshUVs)
+                    for(int k = 0; k < 2; k++)
+                        meshUVs[2 * i + k] = corner.uv != absent ? uvs[2 * corner.uv + k] : 0.0f;
+                meshIndices[i] = (std::uint32_t)i;
+            }
+        };
+        if(pool)
+            pool->ParallelFor(triangleTotal, 1 << 16, gather);
+        else
+            gather(0, triangleTotal);
+        return true;
+    }
+}
@@ -0,0 +1,77 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   ObjImporter.hpp
+ * 
+ * Parallel Wavefront OBJ parser
+ * Class and method definitions
+ */
+
+/*!
+ \file ObjImporter.hpp
+ Header definition for the ObjImporter class
+ */
+
+#ifndef OBJIMPORTER_HPP
+#define	OBJIMPORTER_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace SCPPR {
+
+    class TaskPool;
+    class TriangleMesh;
+
+    //! Wavefront OBJ parser
+    /*!
+     Reads v, vt, vn and f statements; polygons are fan triangulated and
+     every other statement is ignored. The text is split into line aligned
+     chunks and parsed in two parallel passes: the first counts the
+     statements of each chunk, a prefix sum turns the counts into write
+     offsets, and the second parses every chunk straight into its slice of
+     the mesh buffers. Relative face indices resolve against the chunk's
+     offset.
+
+     When every face corner uses the same index for its position, uv and
+     normal the OBJ attribute arrays become the mesh buffers as they are.
+     Otherwise each triangle corner gets a vertex of its own, gathered in a
+     third parallel pass.
+     */
+    class ObjImporter {
+
+    public:
+
+        //! Parses the OBJ text in [begin, end) into mesh
+        /*!
+         Splits the text into chunkCount chunks, or picks a count for pool
+         when it is 0. On failure returns false and describes the problem
+         in error when it is not null.
+         */
+        static bool Import(const char* begin, const char* end, TriangleMesh& mesh,
+                           TaskPool* pool = 0, std::size_t chunkCount = 0,
+                           std::string* error = 0);
+    };
+}
+
+#endif	/* OBJIMPORTER_HPP */
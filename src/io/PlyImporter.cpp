@@ -0,0 +1,672 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   PlyImporter.cpp
+ * 
+ * Parallel Stanford PLY parser
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include "PlyImporter.hpp"
+#include "MeshImporter.hpp"
+#include "../geometry/TriangleMesh.hpp"
+#include "../parallel/TaskPool.hpp"
+#include "../utility/ErrorMessage.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const std::size_t vertexGrain = 1 << 16;
+        const std::size_t faceGrain = 1 << 16;
+
+        enum ScalarType {
+            int8Type, uint8Type, int16Type, uint16Type, int32Type, uint32Type,
+            float32Type, float64Type, invalidType
+        };
+
+        enum Format {
+            asciiFormat, littleEndianFormat, bigEndianFormat
+        };
+
+        //! Scalar or list property of an element
+        struct PlyProperty {
+            std::string name;
+            ScalarType type;      //!< Value type, or the item type of a list
+            bool isList;
+            ScalarType countType; //!< Type of the list length
+        };
+
+        //! Element declaration of the header
+        struct PlyElement {
+            std::string name;
+            std::size_t count;
+            std::vector<PlyProperty> properties;
+        };
+
+        //! Attribute properties of the vertex element, -1 when absent
+        struct VertexLayout {
+            int position[3];
+            int normal[3];
+            int uv[2];
+        };
+
+        //! Where the vertex index list sits in a face record
+        struct FaceLayout {
+            int list;                 //!< Property index of the list
+            std::size_t leadingBytes; //!< Binary bytes before the list
+            std::size_t trailingBytes; //!< Binary bytes after the list
+        };
+
+        //! Line aligned slice of an ascii body
+        struct AsciiChunk {
+            const char* begin;
+            const char* end;
+            std::size_t lineCount;
+            std::size_t firstLine;
+            std::size_t triangleCount;
+            std::size_t triangleBase;
+            const char* error;
+        };
+
+        std::size_t GetSize(ScalarType type) {
+            static const std::size_t sizes[] = { 1, 1, 2, 2, 4, 4, 4, 8, 0 };
+            return sizes[type];
+        }
+
+        ScalarType ParseType(const std::string& name) {
+            if(name == "char" || name == "int8") return int8Type;
+            if(name == "uchar" || name == "uint8") return uint8Type;
+            if(name == "short" || name == "int16") return int16Type;
+            if(name == "ushort" || name == "uint16") return uint16Type;
+            if(name == "int" || name == "int32") return int32Type;
+            if(name == "uint" || name == "uint32") return uint32Type;
+            if(name == "float" || name == "float32") return float32Type;
+            if(name == "double" || name == "float64") return float64Type;
+            return invalidType;
+        }
+
+        // reads one binary scalar, swapping bytes for the other byte order
+        double ReadScalar(const unsigned char* source, ScalarType type, bool swap) {
+            unsigned char bytes[8];
+            std::size_t size = GetSize(type);
+            for(std::size_t i = 0; i < size; i++)
+                bytes[i] = source[swap ? size - 1 - i : i];
+            switch(type) {
+                case int8Type: { std::int8_t v; std::memcpy(&v, bytes, 1); return v; }
+                case uint8Type: return bytes[0];
+                case int16Type: { std::int16_t v; std::memcpy(&v, bytes, 2); return v; }
+                case uint16Type: { std::uint16_t v; std::memcpy(&v, bytes, 2); return v; }
+                case int32Type: { std::int32_t v; std::memcpy(&v, bytes, 4); return v; }
+                case uint32Type: { std::uint32_t v; std::memcpy(&v, bytes, 4); return v; }
+                case float32Type: { float v; std::memcpy(&v, bytes, 4); return v; }
+                case float64Type: { double v; std::memcpy(&v, bytes, 8); return v; }
+                default: return 0.0;
+            }
+        }
+
+        bool HostIsLittleEndian() {
+            const std::uint16_t probe = 1;
+            unsigned char first;
+            std::memcpy(&first, &probe, 1);
+            return first == 1;
+        }
+
+        // parses the header, sets body to the first byte after end_header
+        bool ParseHeader(const char* begin, const char* end, Format& format,
+                         std::vector<PlyElement>& elements, const char*& body, std::string* error) {
+            const char* line = begin;
+            bool first = true;
+            bool hasFormat = false;
+            while(line < end) {
+                const char* lineEnd = MeshImporter::FindLineEnd(line, end);
+                std::istringstream words(std::string(line, lineEnd));
+                std::string keyword;
+                words >> keyword;
+                line = lineEnd < end ? lineEnd + 1 : end;
+
+                if(first) {
+                    if(keyword != "ply")
+                        return Fail(error, "missing ply signature");
+                    first = false;
+                }
+                else if(keyword == "format") {
+                    std::string name;
+                    words >> name;
+                    if(name == "ascii") format = asciiFormat;
+                    else if(name == "binary_little_endian") format = littleEndianFormat;
+                    else if(name == "binary_big_endian") format = bigEndianFormat;
+                    else return Fail(error, "unknown format " + name);
+                    hasFormat = true;
+                }
+                else if(keyword == "element") {
+                    PlyElement element;
+                    if(!(words >> element.name >> element.count))
+                        return Fail(error, "malformed element declaration");
+                    elements.push_back(element);
+                }
+                else if(keyword == "property") {
+                    if(elements.empty())
+                        return Fail(error, "property outside an element");
+                    PlyProperty property;
+                    std::string type;
+                    words >> type;
+                    property.isList = type == "list";
+                    property.countType = invalidType;
+                    if(property.isList) {
+                        std::string countType;
+                        words >> countType >> type;
+                        property.countType = ParseType(countType);
+                        if(property.countType == invalidType || property.countType == float32Type ||
+                           property.countType == float64Type)
+                            return Fail(error, "unsupported list length type " + countType);
+                    }
+                    property.type = ParseType(type);
+                    if(property.type == invalidType || !(words >> property.name))
+                        return Fail(error, "malformed property declaration");
+                    elements.back().properties.push_back(property);
+                }
+                else if(keyword == "end_header") {
+                    if(!hasFormat)
+                        return Fail(error, "missing format");
+                    body = line;
+                    return true;
+                }
+                // comment, obj_info and unknown keywords are ignored
+            }
+            return Fail(error, "missing end_header");
+        }
+
+        int FindProperty(const PlyElement& element, const char* const* names) {
+            for(; *names; names++)
+                for(std::size_t i = 0; i < element.properties.size(); i++)
+                    if(!element.properties[i].isList && element.properties[i].name == *names)
+                        return (int)i;
+            return -1;
+        }
+
+        VertexLayout GetVertexLayout(const PlyElement& vertex) {
+            static const char* const x[] = { "x", 0 };
+            static const char* const y[] = { "y", 0 };
+            static const char* const z[] = { "z", 0 };
+            static const char* const nx[] = { "nx", 0 };
+            static const char* const ny[] = { "ny", 0 };
+            static const char* const nz[] = { "nz", 0 };
+            static const char* const u[] = { "u", "s", "texture_u", "texture_s", 0 };
+            static const char* const v[] = { "v", "t", "texture_v", "texture_t", 0 };
+
+            VertexLayout layout;
+            layout.position[0] = FindProperty(vertex, x);
+            layout.position[1] = FindProperty(vertex, y);
+            layout.position[2] = FindProperty(vertex, z);
+            layout.normal[0] = FindProperty(vertex, nx);
+            layout.normal[1] = FindProperty(vertex, ny);
+            layout.normal[2] = FindProperty(vertex, nz);
+            layout.uv[0] = FindProperty(vertex, u);
+            layout.uv[1] = FindProperty(vertex, v);
+            if(layout.normal[0] < 0 || layout.normal[1] < 0 || layout.normal[2] < 0)
+                layout.normal[0] = layout.normal[1] = layout.normal[2] = -1;
+            if(layout.uv[0] < 0 || layout.uv[1] < 0)
+                layout.uv[0] = layout.uv[1] = -1;
+            return layout;
+        }
+
+        // finds the index list of the face element and its binary position
+        bool GetFaceLayout(const PlyElement& face, FaceLayout& layout) {
+            layout.list = -1;
+            layout.leadingBytes = 0;
+            layout.trailingBytes = 0;
+            for(std::size_t i = 0; i < face.properties.size(); i++) {
+                const PlyProperty& property = face.properties[i];
+                bool isIndexList = property.isList &&
+                    (property.name == "vertex_indices" || property.name == "vertex_index");
+                if(isIndexList && layout.list < 0)
+                    layout.list = (int)i;
+                else if(property.isList)
+                    return false;
+                else if(layout.list < 0)
+                    layout.leadingBytes += GetSize(property.type);
+                else
+                    layout.trailingBytes += GetSize(property.type);
+            }
+            return layout.list >= 0 && face.properties[layout.list].type != float32Type &&
+                   face.properties[layout.list].type != float64Type;
+        }
+
+        std::size_t GetStride(const PlyElement& element) {
+            std::size_t stride = 0;
+            for(const PlyProperty& property : element.properties)
+                stride += GetSize(property.type);
+            return stride;
+        }
+
+        bool HasList(const PlyElement& element) {
+            for(const PlyProperty& property : element.properties)
+                if(property.isList)
+                    return true;
+            return false;
+        }
+
+        // walks binary records with lists, returns the end of the element or null when it overruns
+        const unsigned char* SkipListElement(const unsigned char* cursor, const unsigned char* end,
+                                             const PlyElement& element, bool swap) {
+            for(std::size_t r = 0; r < element.count; r++) {
+                for(const PlyProperty& property : element.properties) {
+                    if(property.isList) {
+                        std::size_t countSize = GetSize(property.countType);
+                        if((std::size_t)(end - cursor) < countSize)
+                            return 0;
+                        std::size_t items = (std::size_t)ReadScalar(cursor, property.countType, swap);
+                        cursor += countSize;
+                        if((std::size_t)(end - cursor) / GetSize(property.type) < items)
+                            return 0;
+                        cursor += items * GetSize(property.type);
+                    }
+                    else {
+                        if((std::size_t)(end - cursor) < GetSize(property.type))
+                            return 0;
+                        cursor += GetSize(property.type);
+                    }
+                }
+            }
+            return cursor;
+        }
+
+        // fills one vertex from property values
+        void StoreVertex(const VertexLayout& layout, const double* values, std::size_t vertex,
+                         float* positions, float* normals, float* uvs) {
+            for(int k = 0; k < 3; k++)
+                positions[3 * vertex + k] = (float)values[layout.position[k]];
+            if(normals)
+                for(int k = 0; k < 3; k++)
+                    normals[3 * vertex + k] = (float)values[layout.normal[k]];
+            if(uvs)
+                for(int k = 0; k < 2; k++)
+                    uvs[2 * vertex + k] = (float)values[layout.uv[k]];
+        }
+
+        // calls visit(first, lineEnd) for every non blank line, stops when it returns false
+        template <typename Visitor>
+        void ForEachLine(const char* begin, const char* end, const Visitor& visit) {
+            for(const char* line = begin; line < end; ) {
+                const char* lineEnd = MeshImporter::FindLineEnd(line, end);
+                const char* first = MeshImporter::SkipBlanks(line, lineEnd);
+                if(first < lineEnd && !visit(first, lineEnd))
+                    return;
+                line = lineEnd + 1;
+            }
+        }
+
+        // skips count tokens, returns null when the line runs out
+        const char* SkipTokens(const char* cursor, const char* end, std::size_t count) {
+            for(std::size_t i = 0; i < count; i++) {
+                cursor = MeshImporter::SkipBlanks(cursor, end);
+                if(cursor >= end)
+                    return 0;
+                cursor = MeshImporter::SkipToken(cursor, end);
+            }
+            return MeshImporter::SkipBlanks(cursor, end);
+        }
+
+        bool ImportBinary(const char* body, const char* end, Format format,
+                          const std::vector<PlyElement>& elements, TriangleMesh& mesh,
+                          TaskPool* pool, std::string* error) {
+            bool swap = (format == littleEndianFormat) != HostIsLittleEndian();
+            const unsigned char* cursor = reinterpret_cast<const unsigned char*>(body);
+            const unsigned char* last = reinterpret_cast<const unsigned char*>(end);
+
+            // locate the vertex and face blocks
+            const PlyElement* vertex = 0;
+            const PlyElement* face = 0;
+            const unsigned char* vertexBlock = 0;
+            const unsigned char* faceBlock = 0;
+            for(std::size_t e = 0; e < elements.size() && !(vertex && face); e++) {
+                const PlyElement& element = elements[e];
+                if(element.name == "vertex") {
+                    vertex = &element;
+                    vertexBlock = cursor;
+                }
+                else if(element.name == "face") {
+                    face = &element;
+                    faceBlock = cursor;
+                }
+                if(vertex && face)
+                    break;
+                if(HasList(element))
+                    cursor = SkipListElement(cursor, last, element, swap);
+                else if(GetStride(element) && element.count > (std::size_t)(last - cursor) / GetStride(element))
+                    cursor = 0;
+                else
+                    cursor += element.count * GetStride(element);
+                if(!cursor)
+                    return Fail(error, "element " + element.name + " runs past the end of the file");
+            }
+            if(!vertex)
+                return Fail(error, "missing vertex element");
+            if(HasList(*vertex))
+                return Fail(error, "vertex element has a list property");
+
+            VertexLayout layout = GetVertexLayout(*vertex);
+            if(layout.position[0] < 0 || layout.position[1] < 0 || layout.position[2] < 0)
+                return Fail(error, "vertex element lacks x, y or z");
+            std::size_t vertexCount = vertex->count;
+            std::size_t vertexStride = GetStride(*vertex);
+            if(vertexCount >= 0xffffffffu ||
+               vertexCount > (std::size_t)(last - vertexBlock) / std::max<std::size_t>(1, vertexStride))
+                return Fail(error, "vertex element runs past the end of the file");
+
+            std::vector<std::size_t> offsets;
+            std::size_t offset = 0;
+            for(const PlyProperty& property : vertex->properties) {
+                offsets.push_back(offset);
+                offset += GetSize(property.type);
+            }
+
+            // faces are assumed to be triangles, which fixes their stride
+            FaceLayout faceLayout = {-1, 0, 0};
+            std::size_t faceCount = face ? face->count : 0;
+            if(face && !GetFaceLayout(*face, faceLayout))
+                return Fail(error, "face element lacks a single integer vertex index list");
+            const PlyProperty* list = face ? &face->properties[faceLayout.list] : 0;
+            std::size_t countSize = list ? GetSize(list->countType) : 0;
+            std::size_t indexSize = list ? GetSize(list->type) : 0;
+            std::size_t triangleStride = faceLayout.leadingBytes + countSize + 3 * indexSize +
+                                         faceLayout.trailingBytes;
+            std::atomic<bool> triangles(!face ||
+                faceCount <= (std::size_t)(last - faceBlock) / std::max<std::size_t>(1, triangleStride));
+            auto checkTriangles = [&](std::size_t first, std::size_t lastFace) {
+                for(std::size_t f = first; f < lastFace && triangles.load(std::memory_order_relaxed); f++) {
+                    const unsigned char* record = faceBlock + f * triangleStride + faceLayout.leadingBytes;
+                    if(ReadScalar(record, list->countType, swap) != 3.0)
+                        triangles.store(false, std::memory_order_relaxed);
+                }
+            };
+            if(faceCount && triangles) {
+                if(pool)
+                    pool->ParallelFor(faceCount, faceGrain, checkTriangles);
+                else
+                    checkTriangles(0, faceCount);
+            }
+
+            // otherwise scan the list lengths for record and triangle offsets
+            std::vector<std::size_t> faceOffsets;
+            std::vector<std::size_t> triangleOffsets;
+            std::size_t triangleCount = faceCount;
+            if(faceCount && !triangles) {
+                faceOffsets.resize(faceCount);
+                triangleOffsets.resize(faceCount);
+                const unsigned char* record = faceBlock;
+                triangleCount = 0;
+                for(std::size_t f = 0; f < faceCount; f++) {
+                    if((std::size_t)(last - record) < faceLayout.leadingBytes + countSize)
+                        return Fail(error, "face element runs past the end of the file");
+                    std::size_t items = (std::size_t)ReadScalar(record + faceLayout.leadingBytes,
+                                                                list->countType, swap);
+                    std::size_t size = faceLayout.leadingBytes + countSize + items * indexSize +
+                                       faceLayout.trailingBytes;
+                    if((std::size_t)(last - record) < size)
+                        return Fail(error, "face element runs past the end of the file");
+                    faceOffsets[f] = record - faceBlock;
+                    triangleOffsets[f] = triangleCount;
+                    triangleCount += items >= 3 ? items - 2 : 0;
+                    record += size;
+                }
+            }
+            if(3 * triangleCount >= 0xffffffffu)
+                return Fail(error, "mesh exceeds 32 bit vertex indices");
+
+            mesh.Allocate(vertexCount, triangleCount, layout.normal[0] >= 0, layout.uv[0] >= 0);
+            float* positions = mesh.GetMutablePositions();
+            float* normals = mesh.GetMutableNormals();
+            float* uvs = mesh.GetMutableUVs();
+            std::uint32_t* indices = mesh.GetMutableIndices();
+
+            auto convertVertices = [&](std::size_t first, std::size_t lastVertex) {
+                std::vector<double> values(vertex->properties.size());
+                for(std::size_t v = first; v < lastVertex; v++) {
+                    const unsigned char* record = vertexBlock + v * vertexStride;
+                    for(std::size_t p = 0; p < values.size(); p++)
+                        values[p] = ReadScalar(record + offsets[p], vertex->properties[p].type, swap);
+                    StoreVertex(layout, values.data(), v, positions, normals, uvs);
+                }
+            };
+
+            std::atomic<bool> badIndex(false);
+            auto convertFaces = [&](std::size_t first, std::size_t lastFace) {
+                for(std::size_t f = first; f < lastFace; f++) {
+                    const unsigned char* record = faceBlock +
+                        (faceOffsets.empty() ? f * triangleStride : faceOffsets[f]) + faceLayout.leadingBytes;
+                    std::size_t items = faceOffsets.empty() ? 3 :
+                        (std::size_t)ReadScalar(record, list->countType, swap);
+                    // faces of fewer than three corners make no triangles, and may hold no index to read
+                    if(items < 3)
+                        continue;
+                    std::size_t triangle = faceOffsets.empty() ? f : triangleOffsets[f];
+                    record += countSize;
+                    double firstIndex = ReadScalar(record, list->type, swap);
+                    double previous = ReadScalar(record + indexSize, list->type, swap);
+                    for(std::size_t i = 2; i < items; i++, triangle++) {
+                        double current = ReadScalar(record + i * indexSize, list->type, swap);
+                        double corners[3] = { firstIndex, previous, current };
+                        for(int k = 0; k < 3; k++) {
+                            if(corners[k] < 0.0 || corners[k] >= (double)vertexCount) {
+                                badIndex = true;
+                                corners[k] = 0.0;
+                            }
+                            indices[3 * triangle + k] = (std::uint32_t)corners[k];
+                        }
+                        previous = current;
+                    }
+                }
+            };
+
+            if(pool) {
+                pool->ParallelFor(vertexCount, vertexGrain, convertVertices);
+                pool->ParallelFor(faceCount, faceGrain, convertFaces);
+            }
+            else {
+                convertVertices(0, vertexCount);
+                convertFaces(0, faceCount);
+            }
+            if(badIndex)
+                return Fail(error, "face references a vertex that does not exist");
+            return true;
+        }
+
+        bool ImportAscii(const char* body, const char* end, const std::vector<PlyElement>& elements,
+                         TriangleMesh& mesh, TaskPool* pool, std::size_t chunkCount,
+                         std::string* error) {
+            // every record is one line, so element line ranges follow from the counts
+            const PlyElement* vertex = 0;
+            const PlyElement* face = 0;
+            std::size_t vertexLine = 0, faceLine = 0, lineCount = 0;
+            for(const PlyElement& element : elements) {
+                if(element.name == "vertex" && !vertex) {
+                    vertex = &element;
+                    vertexLine = lineCount;
+                }
+                else if(element.name == "face" && !face) {
+                    face = &element;
+                    faceLine = lineCount;
+                }
+                lineCount += element.count;
+            }
+            if(!vertex)
+                return Fail(error, "missing vertex element");
+            if(HasList(*vertex))
+                return Fail(error, "vertex element has a list property");
+            VertexLayout layout = GetVertexLayout(*vertex);
+            if(layout.position[0] < 0 || layout.position[1] < 0 || layout.position[2] < 0)
+                return Fail(error, "vertex element lacks x, y or z");
+            FaceLayout faceLayout = {-1, 0, 0};
+            if(face && !GetFaceLayout(*face, faceLayout))
+                return Fail(error, "face element lacks a single integer vertex index list");
+            std::size_t vertexCount = vertex->count;
+            std::size_t faceCount = face ? face->count : 0;
+            if(vertexCount >= 0xffffffffu)
+                return Fail(error, "mesh exceeds 32 bit vertex indices");
+
+            std::vector<const char*> boundaries = MeshImporter::SplitLines(body, end, chunkCount);
+            std::vector<AsciiChunk> chunks(chunkCount);
+            for(std::size_t i = 0; i < chunkCount; i++) {
+                AsciiChunk chunk = {};
+                chunk.begin = boundaries[i];
+                chunk.end = boundaries[i + 1];
+                chunks[i] = chunk;
+            }
+
+            // first pass counts lines, second counts the triangles of face lines
+            MeshImporter::ForEachChunk(pool, chunkCount, [&chunks](std::size_t i) {
+                std::size_t& lines = chunks[i].lineCount;
+                ForEachLine(chunks[i].begin, chunks[i].end, [&lines](const char*, const char*) {
+                    lines++;
+                    return true;
+                });
+            });
+            std::size_t totalLines = 0;
+            for(AsciiChunk& chunk : chunks) {
+                chunk.firstLine = totalLines;
+                totalLines += chunk.lineCount;
+            }
+            if(totalLines < lineCount)
+                return Fail(error, "file ends before its last element");
+
+            std::size_t faceEnd = faceLine + faceCount;
+            auto countTriangles = [&](std::size_t i) {
+                AsciiChunk& chunk = chunks[i];
+                std::size_t line = chunk.firstLine;
+                ForEachLine(chunk.begin, chunk.end, [&](const char* first, const char* lineEnd) {
+                    if(line >= faceLine && line < faceEnd) {
+                        std::int64_t items = 0;
+                        const char* cursor = SkipTokens(first, lineEnd, faceLayout.list);
+                        if(!cursor || !MeshImporter::ParseInteger(cursor, lineEnd, items) || items < 0) {
+                            chunk.error = first;
+                            return false;
+                        }
+                        chunk.triangleCount += items >= 3 ? items - 2 : 0;
+                    }
+                    line++;
+                    return line < faceEnd;
+                });
+            };
+            if(face)
+                MeshImporter::ForEachChunk(pool, chunkCount, countTriangles);
+
+            std::size_t triangleCount = 0;
+            for(AsciiChunk& chunk : chunks) {
+                if(chunk.error)
+                    return Fail(error, "malformed face at byte " + std::to_string(chunk.error - body));
+                chunk.triangleBase = triangleCount;
+                triangleCount += chunk.triangleCount;
+            }
+            if(3 * triangleCount >= 0xffffffffu)
+                return Fail(error, "mesh exceeds 32 bit vertex indices");
+
+            mesh.Allocate(vertexCount, triangleCount, layout.normal[0] >= 0, layout.uv[0] >= 0);
+            float* positions = mesh.GetMutablePositions();
+            float* normals = mesh.GetMutableNormals();
+            float* uvs = mesh.GetMutableUVs();
+            std::uint32_t* indices = mesh.GetMutableIndices();
+            std::size_t vertexEnd = vertexLine + vertexCount;
+
+            // third pass parses vertex and face lines into their slots
+            auto parse = [&](std::size_t i) {
+                AsciiChunk& chunk = chunks[i];
+                std::size_t line = chunk.firstLine;
+                std::size_t triangle = chunk.triangleBase;
+                std::vector<double> values(vertex->properties.size());
+                ForEachLine(chunk.begin, chunk.end, [&](const char* first, const char* lineEnd) {
+                    const char* cursor = first;
+                    if(line >= vertexLine && line < vertexEnd) {
+                        for(std::size_t p = 0; p < values.size() && cursor; p++) {
+                            float value;
+                            cursor = MeshImporter::ParseFloat(MeshImporter::SkipBlanks(cursor, lineEnd),
+                                                              lineEnd, value);
+                            values[p] = value;
+                        }
+                        if(!cursor) {
+                            chunk.error = first;
+                            return false;
+                        }
+                        StoreVertex(layout, values.data(), line - vertexLine, positions, normals, uvs);
+                    }
+                    else if(line >= faceLine && line < faceEnd) {
+                        std::int64_t items = 0;
+                        cursor = SkipTokens(first, lineEnd, faceLayout.list);
+                        if(cursor)
+                            cursor = MeshImporter::ParseInteger(cursor, lineEnd, items);
+                        std::int64_t fan[3] = {0, 0, 0};
+                        for(std::int64_t k = 0; k < items && cursor; k++) {
+                            std::int64_t index = -1;
+                            cursor = MeshImporter::ParseInteger(MeshImporter::SkipBlanks(cursor, lineEnd),
+                                                                lineEnd, index);
+                            if(!cursor || index < 0 || (std::size_t)index >= vertexCount) {
+                                cursor = 0;
+                                break;
+                            }
+                            fan[k < 2 ? k : 2] = index;
+                            if(k >= 2) {
+                                indices[3 * triangle] = (std::uint32_t)fan[0];
+                                indices[3 * triangle + 1] = (std::uint32_t)fan[1];
+                                indices[3 * triangle + 2] = (std::uint32_t)fan[2];
+                                triangle++;
+                                fan[1] = fan[2];
+                            }
+                        }
+                        if(!cursor) {
+                            chunk.error = first;
+                            return false;
+                        }
+                    }
+                    line++;
+                    return line < lineCount;
+                });
+            };
+            MeshImporter::ForEachChunk(pool, chunkCount, parse);
+            for(const AsciiChunk& chunk : chunks)
+                if(chunk.error)
+                    return Fail(error, "malformed record at byte " + std::to_string(chunk.error - body));
+            return true;
+        }
+    }
+
+    bool PlyImporter::Import(const char* begin, const char* end, TriangleMesh& mesh,
+                             TaskPool* pool, std::size_t chunkCount, std::string* error) {
+        Format format = asciiFormat;
+        std::vector<PlyElement> elements;
+        const char* body = 0;
+        if(!ParseHeader(begin, end, format, elements, body, error))
+            return false;
+        if(format != asciiFormat)
+            return ImportBinary(body, end, format, elements, mesh, pool, error);
+        if(chunkCount == 0)
+            chunkCount = MeshImporter::GetChunkCount(pool, end - body);
+        return ImportAscii(body, end, elements, mesh, pool, chunkCount, error);
+    }
+}
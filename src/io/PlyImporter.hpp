@@ -0,0 +1,76 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   PlyImporter.hpp
+ * 
+ * Parallel Stanford PLY parser
+ * Class and method definitions
+ */
+
+/*!
+ \file PlyImporter.hpp
+ Header definition for the PlyImporter class
+ */
+
+#ifndef PLYIMPORTER_HPP
+#define	PLYIMPORTER_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace SCPPR {
+
+    class TaskPool;
+    class TriangleMesh;
+
+    //! Stanford PLY parser for ascii and both binary byte orders
+    /*!
+     Reads the vertex element's x, y and z, its nx, ny and nz when present
+     and its u and v (or s and t) when present, and the face element's
+     vertex index list. Polygons are fan triangulated; other elements and
+     properties are skipped.
+
+     Binary vertices have a fixed stride and convert in parallel. Binary
+     faces are assumed to be triangles, which also fixes their stride; the
+     assumption is checked in parallel and a serial scan of the list
+     lengths replaces it only when it fails. Ascii bodies are split into
+     line aligned chunks that are counted, prefix summed and parsed in
+     parallel passes like OBJ.
+     */
+    class PlyImporter {
+
+    public:
+
+        //! Parses the PLY file held in [begin, end) into mesh
+        /*!
+         Splits ascii bodies into chunkCount chunks, or picks a count for
+         pool when it is 0. On failure returns false and describes the
+         problem in error when it is not null.
+         */
+        static bool Import(const char* begin, const char* end, TriangleMesh& mesh,
+                           TaskPool* pool = 0, std::size_t chunkCount = 0,
+                           std::string* error = 0);
+    };
+}
+
+#endif	/* PLYIMPORTER_HPP */
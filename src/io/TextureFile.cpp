@@ -0,0 +1,423 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TextureFile.cpp
+ * 
+ * Tiled, mip-mapped texture format and the converter that writes it
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SCPPR_HAS_PREAD 1
+#endif
+
+#include "TextureFile.hpp"
+#include "MappedFile.hpp"
+#include "../parallel/TraceRecorder.hpp"
+#include "../render/Framebuffer.hpp"
+#include "../utility/ErrorMessage.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const char textureMagic[8] = {'S', 'C', 'P', 'P', 'R', 'T', 'E', 'X'};
+
+        // tiles start on a boundary that suits direct reads
+        const std::uint64_t tileAlignment = 4096;
+
+        bool IsValidTileSize(std::uint32_t tileSize) {
+            return tileSize >= 8 && tileSize <= 1024 && (tileSize & (tileSize - 1)) == 0;
+        }
+
+        float DecodeSRGB(float encoded) {
+            return encoded <= 0.04045f ? encoded / 12.92f : std::pow((encoded + 0.055f) / 1.055f, 2.4f);
+        }
+
+        // Netpbm header fields separated by whitespace and # comments
+        bool ReadToken(const unsigned char*& cursor, const unsigned char* end, std::string& token) {
+            token.clear();
+            while(cursor < end) {
+                if(*cursor == '#')
+                    while(cursor < end && *cursor != '\n')
+                        cursor++;
+                else if(std::isspace(*cursor))
+                    cursor++;
+                else
+                    break;
+            }
+            while(cursor < end && !std::isspace(*cursor))
+                token += (char)*cursor++;
+            return !token.empty();
+        }
+
+        // halves a level with a 2x2 box filter, the last row or column repeating on odd sizes
+        void Downsample(const std::vector<Color>& source, int width, int height,
+                        std::vector<Color>& target, int targetWidth, int targetHeight) {
+            target.resize((std::size_t)targetWidth * targetHeight);
+            for(int y = 0; y < targetHeight; y++) {
+                int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+                for(int x = 0; x < targetWidth; x++) {
+                    int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+                    Color sum = source[(std::size_t)y0 * width + x0] + source[(std::size_t)y0 * width + x1] +
+                                source[(std::size_t)y1 * width + x0] + source[(std::size_t)y1 * width + x1];
+                    target[(std::size_t)y * targetWidth + x] = sum * 0.25f;
+                }
+            }
+        }
+    }
+
+    const std::uint32_t TextureFile::version;
+    const std::uint32_t TextureFile::byteOrderMark;
+    const int TextureFile::defaultTileSize;
+    const int TextureFile::texelSize;
+
+    TextureFile::TextureFile() :
+        descriptor(-1), file(0) {
+        std::memset(&header, 0, sizeof(header));
+    }
+
+    TextureFile::~TextureFile() {
+        Close();
+    }
+
+    std::vector<TextureFile::Level> TextureFile::MakeLevels(int width, int height, int tileSize) {
+        std::vector<Level> levels;
+        std::uint64_t firstTile = 0;
+        for(;;) {
+            Level level;
+            level.width = (std::uint32_t)width;
+            level.height = (std::uint32_t)height;
+            level.tilesX = (std::uint32_t)((width + tileSize - 1) / tileSize);
+            level.tilesY = (std::uint32_t)((height + tileSize - 1) / tileSize);
+            level.firstTile = firstTile;
+            levels.push_back(level);
+            firstTile += (std::uint64_t)level.tilesX * level.tilesY;
+            if(width == 1 && height == 1)
+                return levels;
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+        }
+    }
+
+    bool TextureFile::Write(const std::vector<Color>& pixels, int width, int height,
+                            const std::string& path, int tileSize, std::string* error) {
+        TraceRecorder::Scope trace("texture write", "io", "width", width, "height", height);
+        if(width <= 0 || height <= 0 || pixels.size() != (std::size_t)width * height)
+            return Fail(error, path + ": pixels do not match a " + std::to_string(width) + "x" +
+                        std::to_string(height) + " image");
+        if(!IsValidTileSize((std::uint32_t)tileSize))
+            return Fail(error, path + ": tile size must be a power of two from 8 to 1024");
+
+        std::vector<Level> levels = MakeLevels(width, height, tileSize);
+        const std::size_t tileBytes = (std::size_t)tileSize * tileSize * texelSize;
+        const Level& last = levels.back();
+
+        Header fileHeader;
+        std::memset(&fileHeader, 0, sizeof(fileHeader));
+        std::memcpy(fileHeader.magic, textureMagic, sizeof(textureMagic));
+        fileHeader.version = version;
+        fileHeader.byteOrder = byteOrderMark;
+        fileHeader.width = (std::uint32_t)width;
+        fileHeader.height = (std::uint32_t)height;
+        fileHeader.tileSize = (std::uint32_t)tileSize;
+        fileHeader.levelCount = (std::uint32_t)levels.size();
+        fileHeader.tileOffset = (sizeof(Header) + levels.size() * sizeof(Level) + tileAlignment - 1) &
+                                ~(tileAlignment - 1);
+        fileHeader.tileCount = last.firstTile + (std::uint64_t)last.tilesX * last.tilesY;
+        fileHeader.fileSize = fileHeader.tileOffset + fileHeader.tileCount * tileBytes;
+
+        // the partial file is renamed over path once every tile is written
+        std::string partialPath = path + ".partial" +
+            std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        std::FILE* output = std::fopen(partialPath.c_str(), "wb");
+        if(!output)
+            return Fail(error, "cannot open " + partialPath + " for writing");
+        std::vector<unsigned char> padding(fileHeader.tileOffset - sizeof(Header) - levels.size() * sizeof(Level));
+        bool written = std::fwrite(&fileHeader, sizeof(fileHeader), 1, output) == 1 &&
+                       std::fwrite(levels.data(), sizeof(Level), levels.size(), output) == levels.size() &&
+                       std::fwrite(padding.data(), 1, padding.size(), output) == padding.size();
+
+        std::vector<Color> current = pixels, next;
+        std::vector<unsigned char> tile(tileBytes, 0);
+        for(std::size_t l = 0; l < levels.size() && written; l++) {
+            const int levelWidth = (int)levels[l].width, levelHeight = (int)levels[l].height;
+            if(l > 0) {
+                Downsample(current, (int)levels[l - 1].width, (int)levels[l - 1].height, next,
+                           levelWidth, levelHeight);
+                current.swap(next);
+            }
+            for(std::uint32_t ty = 0; ty < levels[l].tilesY && written; ty++)
+                for(std::uint32_t tx = 0; tx < levels[l].tilesX && written; tx++) {
+                    unsigned char* texel = tile.data();
+                    for(int y = 0; y < tileSize; y++) {
+                        int sourceY = std::min((int)ty * tileSize + y, levelHeight - 1);
+                        for(int x = 0; x < tileSize; x++, texel += texelSize) {
+                            int sourceX = std::min((int)tx * tileSize + x, levelWidth - 1);
+                            const Color& color = current[(std::size_t)sourceY * levelWidth + sourceX];
+                            texel[0] = Framebuffer::EncodeSRGB(color.GetRed());
+                            texel[1] = Framebuffer::EncodeSRGB(color.GetGreen());
+                            texel[2] = Framebuffer::EncodeSRGB(color.GetBlue());
+                        }
+                    }
+                    written = std::fwrite(tile.data(), 1, tileBytes, output) == tileBytes;
+                }
+        }
+
+        if(std::fclose(output) != 0 || !written) {
+            std::remove(partialPath.c_str());
+            return Fail(error, "failed writing " + partialPath);
+        }
+        if(std::rename(partialPath.c_str(), path.c_str()) != 0) {
+            std::remove(partialPath.c_str());
+            return Fail(error, "cannot replace " + path);
+        }
+        return true;
+    }
+
+    bool TextureFile::Convert(const std::string& imagePath, const std::string& path, int tileSize,
+                              std::string* error) {
+        std::vector<Color> pixels;
+        int width = 0, height = 0;
+        if(!ReadImage(imagePath, pixels, width, height, error))
+            return false;
+        return Write(pixels, width, height, path, tileSize, error);
+    }
+
+    bool TextureFile::ReadImage(const std::string& path, std::vector<Color>& pixels, int& width,
+                                int& height, std::string* error) {
+        MappedFile file;
+        if(!file.Open(path))
+            return Fail(error, file.GetError());
+        const unsigned char* cursor = file.GetData();
+        const unsigned char* end = cursor + file.GetSize();
+
+        std::string magic, widthToken, heightToken, rangeToken;
+        if(!ReadToken(cursor, end, magic) || !ReadToken(cursor, end, widthToken) ||
+           !ReadToken(cursor, end, heightToken) || !ReadToken(cursor, end, rangeToken) || cursor >= end)
+            return Fail(error, path + ": truncated image header");
+        // a single whitespace byte separates the header from the samples
+        cursor++;
+        long imageWidth = std::atol(widthToken.c_str()), imageHeight = std::atol(heightToken.c_str());
+        if(imageWidth <= 0 || imageHeight <= 0 || imageWidth > (1L << 20) || imageHeight > (1L << 20))
+            return Fail(error, path + ": bad image size");
+        const std::size_t count = (std::size_t)imageWidth * imageHeight;
+
+        if(magic == "P6") {
+            long range = std::atol(rangeToken.c_str());
+            if(range <= 0 || range > 65535)
+                return Fail(error, path + ": bad PPM sample range");
+            const int sampleBytes = range > 255 ? 2 : 1;
+            if((std::size_t)(end - cursor) < count * 3 * sampleBytes)
+                return Fail(error, path + ": truncated PPM samples");
+
+            // 8 bit files decode through a table, 16 bit ones per sample
+            std::vector<float> decoded(sampleBytes == 1 ? range + 1 : 0);
+            for(std::size_t i = 0; i < decoded.size(); i++)
+                decoded[i] = DecodeSRGB((float)i / range);
+            pixels.resize(count);
+            for(std::size_t i = 0; i < count; i++) {
+                float channels[3];
+                for(int c = 0; c < 3; c++) {
+                    if(sampleBytes == 1)
+                        channels[c] = decoded[std::min<long>(*cursor++, range)];
+                    else {
+                        // 16 bit samples are big endian
+                        long sample = (cursor[0] << 8) | cursor[1];
+                        cursor += 2;
+                        channels[c] = DecodeSRGB((float)std::min(sample, range) / range);
+                    }
+                }
+                pixels[i] = Color(channels[0], channels[1], channels[2]);
+            }
+        }
+        else if(magic == "PF" || magic == "Pf") {
+            const int channelCount = magic == "PF" ? 3 : 1;
+            if((std::size_t)(end - cursor) < count * channelCount * sizeof(float))
+                return Fail(error, path + ": truncated PFM samples");
+            // a negative scale marks little endian samples
+            const std::uint32_t probe = 1;
+            const bool hostLittle = *reinterpret_cast<const unsigned char*>(&probe) == 1;
+            const bool swap = (std::atof(rangeToken.c_str()) < 0.0) != hostLittle;
+            pixels.resize(count);
+            for(long y = 0; y < imageHeight; y++) {
+                // rows are stored bottom to top
+                Color* row = &pixels[(std::size_t)(imageHeight - 1 - y) * imageWidth];
+                for(long x = 0; x < imageWidth; x++) {
+                    float channels[3];
+                    for(int c = 0; c < channelCount; c++) {
+                        unsigned char bytes[4];
+                        std::memcpy(bytes, cursor, 4);
+                        cursor += 4;
+                        if(swap) {
+                            std::swap(bytes[0], bytes[3]);
+                            std::swap(bytes[1], bytes[2]);
+                        }
+                        std::memcpy(&channels[c], bytes, 4);
+                    }
+                    row[x] = channelCount == 3 ? Color(channels[0], channels[1], channels[2]) : Color(channels[0]);
+                }
+            }
+        }
+        else
+            return Fail(error, path + ": only binary PPM and PFM images can be converted");
+
+        width = (int)imageWidth;
+        height = (int)imageHeight;
+        return true;
+    }
+
+    bool TextureFile::Open(const std::string& pathArg, std::string* error) {
+        Close();
+        std::uint64_t size = 0;
+#if defined(SCPPR_HAS_PREAD)
+        descriptor = ::open(pathArg.c_str(), O_RDONLY);
+        struct stat status;
+        if(descriptor < 0 || fstat(descriptor, &status) != 0) {
+            Close();
+            return Fail(error, pathArg + ": " + std::strerror(errno));
+        }
+        size = (std::uint64_t)status.st_size;
+#else
+        file = std::fopen(pathArg.c_str(), "rb");
+        if(!file || std::fseek(file, 0, SEEK_END) != 0) {
+            Close();
+            return Fail(error, pathArg + ": " + std::strerror(errno));
+        }
+        size = (std::uint64_t)std::ftell(file);
+#endif
+
+        // reads the header and level table through the same path as the tiles
+        Header fileHeader;
+        std::vector<Level> fileLevels;
+        bool valid = size >= sizeof(Header);
+        if(valid) {
+#if defined(SCPPR_HAS_PREAD)
+            valid = pread(descriptor, &fileHeader, sizeof(Header), 0) == (ssize_t)sizeof(Header);
+#else
+            valid = std::fseek(file, 0, SEEK_SET) == 0 && std::fread(&fileHeader, sizeof(Header), 1, file) == 1;
+#endif
+        }
+        if(!valid || std::memcmp(fileHeader.magic, textureMagic, sizeof(textureMagic)) != 0) {
+            Close();
+            return Fail(error, pathArg + ": not a texture file");
+        }
+        if(fileHeader.byteOrder != byteOrderMark) {
+            Close();
+            return Fail(error, pathArg + ": written on a host of the other byte order");
+        }
+        if(fileHeader.version != version) {
+            Close();
+            return Fail(error, pathArg + ": unsupported version " + std::to_string(fileHeader.version));
+        }
+        if(fileHeader.width == 0 || fileHeader.height == 0 || fileHeader.width > (1u << 30) ||
+           fileHeader.height > (1u << 30) || !IsValidTileSize(fileHeader.tileSize)) {
+            Close();
+            return Fail(error, pathArg + ": bad texture size");
+        }
+
+        // the level table must be the one the size implies
+        std::vector<Level> expected = MakeLevels((int)fileHeader.width, (int)fileHeader.height,
+                                                 (int)fileHeader.tileSize);
+        const std::uint64_t tileBytes = (std::uint64_t)fileHeader.tileSize * fileHeader.tileSize * texelSize;
+        const std::uint64_t tileCount = expected.back().firstTile +
+                                        (std::uint64_t)expected.back().tilesX * expected.back().tilesY;
+        fileLevels.resize(expected.size());
+        const std::size_t tableBytes = expected.size() * sizeof(Level);
+        valid = fileHeader.levelCount == expected.size() && fileHeader.tileCount == tileCount &&
+                fileHeader.tileOffset >= sizeof(Header) + tableBytes &&
+                fileHeader.fileSize == fileHeader.tileOffset + tileCount * tileBytes && fileHeader.fileSize == size;
+        if(valid) {
+#if defined(SCPPR_HAS_PREAD)
+            valid = pread(descriptor, fileLevels.data(), tableBytes, sizeof(Header)) == (ssize_t)tableBytes;
+#else
+            valid = std::fread(fileLevels.data(), 1, tableBytes, file) == tableBytes;
+#endif
+        }
+        if(valid)
+            valid = std::memcmp(fileLevels.data(), expected.data(), tableBytes) == 0;
+        if(!valid) {
+            Close();
+            return Fail(error, pathArg + ": corrupt level table");
+        }
+
+        header = fileHeader;
+        levels.swap(fileLevels);
+        path = pathArg;
+        return true;
+    }
+
+    void TextureFile::Close() {
+#if defined(SCPPR_HAS_PREAD)
+        if(descriptor >= 0)
+            ::close(descriptor);
+#endif
+        if(file)
+            std::fclose(file);
+        descriptor = -1;
+        file = 0;
+        levels.clear();
+        path.clear();
+        std::memset(&header, 0, sizeof(header));
+    }
+
+    bool TextureFile::ReadTile(int level, int tileX, int tileY, unsigned char* texels) const {
+        const Level& info = levels[level];
+        const std::size_t tileBytes = GetTileBytes();
+        const std::uint64_t offset = header.tileOffset +
+            (info.firstTile + (std::uint64_t)tileY * info.tilesX + (std::uint64_t)tileX) * tileBytes;
+#if defined(SCPPR_HAS_PREAD)
+        std::size_t done = 0;
+        while(done < tileBytes) {
+            ssize_t got = pread(descriptor, texels + done, tileBytes - done, (off_t)(offset + done));
+            if(got <= 0) {
+                if(got < 0 && errno == EINTR)
+                    continue;
+                return false;
+            }
+            done += (std::size_t)got;
+        }
+        return true;
+#else
+        std::lock_guard<std::mutex> lock(fileMutex);
+        return std::fseek(file, (long)offset, SEEK_SET) == 0 && std::fread(texels, 1, tileBytes, file) == tileBytes;
+#endif
+    }
+
+    void TextureFile::DisplayContents() const {
+        std::cout << "TextureFile: " << path << ", " << GetWidth() << "x" << GetHeight() << ", "
+                  << GetLevelCount() << " levels of " << GetTileSize() << " texel tiles, "
+                  << header.tileCount << " tiles" << std::endl;
+    }
+}
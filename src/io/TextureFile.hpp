@@ -0,0 +1,228 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TextureFile.hpp
+ * 
+ * Tiled, mip-mapped texture format and the converter that writes it
+ * Class and method definitions
+ */
+
+/*!
+ \file TextureFile.hpp
+ Header definition for the TextureFile class
+ */
+
+#ifndef TEXTUREFILE_HPP
+#define	TEXTUREFILE_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../utility/Color.hpp"
+
+namespace SCPPR {
+
+    //! Reader and writer for the tiled texture format
+    /*!
+     A file is a 64 byte header, a table of mip levels and then every tile
+     of every level, level 0 first and tiles of a level in row order:
+
+     - magic "SCPPRTEX", format version, byte order mark
+     - width, height, tile edge length and level count
+     - byte offset of the first tile and the total tile count
+
+     Each level halves the one above with a box filter down to a single
+     texel. A tile holds tileSize by tileSize texels of four bytes, sRGB
+     red, green and blue plus an unused byte; tiles on the right and
+     bottom edges repeat the last texel so every tile has the same size
+     and lives at offset firstTile + index * GetTileBytes().
+
+     An opened file keeps only its header and level table in memory.
+     ReadTile reads one tile with a positioned read, safe to call from
+     many threads at once.
+     */
+    class TextureFile {
+
+    public:
+
+        //! Fixed header at the start of every file
+        struct Header {
+            char magic[8];                 //!< "SCPPRTEX"
+            std::uint32_t version;         //!< Format version
+            std::uint32_t byteOrder;       //!< byteOrderMark as written by the host
+            std::uint32_t width;           //!< Width of level 0 in texels
+            std::uint32_t height;          //!< Height of level 0 in texels
+            std::uint32_t tileSize;        //!< Edge length of a tile in texels
+            std::uint32_t levelCount;      //!< Number of mip levels
+            std::uint64_t tileOffset;      //!< Byte offset of the first tile
+            std::uint64_t tileCount;       //!< Tiles over all levels
+            std::uint64_t fileSize;        //!< Total size in bytes
+            std::uint8_t reserved[8];      //!< Zero
+        };
+
+        //! Size and tiling of one mip level
+        struct Level {
+            std::uint32_t width;           //!< Width in texels
+            std::uint32_t height;          //!< Height in texels
+            std::uint32_t tilesX;          //!< Tiles per row
+            std::uint32_t tilesY;          //!< Rows of tiles
+            std::uint64_t firstTile;       //!< Index of the level's first tile in the file
+        };
+
+        static const std::uint32_t version = 1;               //!< Current format version
+        static const std::uint32_t byteOrderMark = 0x01020304u; //!< Detects foreign byte order
+        static const int defaultTileSize = 64;                //!< Tile edge length unless told otherwise
+        static const int texelSize = 4;                       //!< Bytes per texel
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs a reader with no file open
+         */
+        TextureFile();
+
+        //! Destructor, closes the file
+        ~TextureFile();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Writes linear pixels, rows top to bottom, as a tiled mip chain
+        /*!
+         tileSize must be a power of two between 8 and 1024. Returns false
+         and describes the problem in error when it is not null.
+         */
+        static bool Write(const std::vector<Color>& pixels, int width, int height,
+                          const std::string& path, int tileSize = defaultTileSize,
+                          std::string* error = 0);
+
+        //! Converts a PPM or PFM image into a tiled texture at path
+        static bool Convert(const std::string& imagePath, const std::string& path,
+                            int tileSize = defaultTileSize, std::string* error = 0);
+
+        //! Reads a binary PPM (8 or 16 bit, sRGB) or a PFM (linear) into linear pixels
+        static bool ReadImage(const std::string& path, std::vector<Color>& pixels, int& width,
+                              int& height, std::string* error = 0);
+
+        //! Opens path and validates its header and level table
+        bool Open(const std::string& path, std::string* error = 0);
+
+        //! Closes the file
+        void Close();
+
+        //! Reads the texels of one tile into texels, GetTileBytes() long
+        /*!
+         Returns false when the read fails. Safe to call concurrently.
+         */
+        bool ReadTile(int level, int tileX, int tileY, unsigned char* texels) const;
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns true while a file is open
+        bool IsOpen() const;
+
+        //! Returns the width of level 0
+        int GetWidth() const;
+
+        //! Returns the height of level 0
+        int GetHeight() const;
+
+        //! Returns the edge length of a tile
+        int GetTileSize() const;
+
+        //! Returns the size in bytes of one tile
+        std::size_t GetTileBytes() const;
+
+        //! Returns the number of mip levels
+        int GetLevelCount() const;
+
+        //! Returns the size and tiling of a level
+        const Level& GetLevel(int level) const;
+
+        //! Returns the path of the open file
+        const std::string& GetPath() const;
+
+        // end accessor declarations--------------------------------------------
+
+        //! Displays the size and levels using std::cout
+        void DisplayContents() const;
+
+    protected:
+
+        //! Returns the levels of a width by height image in tiles of tileSize
+        static std::vector<Level> MakeLevels(int width, int height, int tileSize);
+
+        Header header;                      //!< Header of the open file
+        std::vector<Level> levels;          //!< Level table of the open file
+        std::string path;                   //!< Path of the open file
+        int descriptor;                     //!< File descriptor, -1 when closed
+        std::FILE* file;                    //!< Stream used where positioned reads are missing
+        mutable std::mutex fileMutex;       //!< Serializes reads through file
+
+    private:
+
+        // the file handle has a single owner
+        TextureFile(const TextureFile& copy);
+        TextureFile& operator= (const TextureFile& copy);
+    };
+
+    static_assert(sizeof(TextureFile::Header) == 64, "TextureFile header must be 64 bytes");
+    static_assert(sizeof(TextureFile::Level) == 24, "TextureFile level must be 24 bytes");
+
+    inline bool TextureFile::IsOpen() const {
+        return !levels.empty();
+    }
+
+    inline int TextureFile::GetWidth() const {
+        return (int)header.width;
+    }
+
+    inline int TextureFile::GetHeight() const {
+        return (int)header.height;
+    }
+
+    inline int TextureFile::GetTileSize() const {
+        return (int)header.tileSize;
+    }
+
+    inline std::size_t TextureFile::GetTileBytes() const {
+        return (std::size_t)header.tileSize * header.tileSize * texelSize;
+    }
+
+    inline int TextureFile::GetLevelCount() const {
+        return (int)levels.size();
+    }
+
+    inline const TextureFile::Level& TextureFile::GetLevel(int level) const {
+        return levels[level];
+    }
+
+    inline const std::string& TextureFile::GetPath() const {
+        return path;
+    }
+}
+
+#endif	/* TEXTUREFILE_HPP */
@@ -27,13 +27,953 @@ THE SOFTWARE.
  * Created on October 25, 2015, 12:32 AM
  */
 
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
 
+#include <Eigen/Core>
+#include <Eigen/StdVector>
 
+#include "accel/AABB.hpp"
+#include "accel/InstanceBVH.hpp"
+#include "accel/LightBVH.hpp"
+#include "accel/TriangleBVH.hpp"
+#include "geometry/TriangleMesh.hpp"
+#include "io/BVHCache.hpp"
+#include "io/ImageWriter.hpp"
+#include "io/MeshFile.hpp"
+#include "io/MeshImporter.hpp"
+#include "io/TextureFile.hpp"
+#include "parallel/TaskPool.hpp"
+#include "parallel/TraceRecorder.hpp"
+#include "render/Camera.hpp"
+#include "render/Framebuffer.hpp"
+#include "render/ProgressiveRenderer.hpp"
+#include "render/RenderStatistics.hpp"
+#include "render/Sampler.hpp"
+#include "render/TextureCache.hpp"
+#include "render/TileRenderer.hpp"
+#include "render/WavefrontRenderer.hpp"
+#include "utility/Color.hpp"
+#include "utility/Normal.hpp"
+#include "utility/Point.hpp"
+#include "utility/RayPacket8.hpp"
+#include "utility/Transform.hpp"
 
-int main(int argc, char** argv) {
-    
+using namespace SCPPR;
+
+namespace {
+
+    //! Command line settings of a render
+    struct Options {
+        int width;
+        int height;
+        int tileSize;
+        unsigned threads;
+        bool pinThreads;
+        bool packets;
+        bool wavefront;
+        std::size_t boxCount;
+        std::size_t instanceCount;
+        std::size_t lightCount;
+        ProgressiveSettings progressive;
+        WavefrontSettings wavefrontSettings;
+        std::string output;
+        std::string meshPath;
+        std::string saveMeshPath;
+        std::string cacheDirectory;
+        bool statistics;
+        std::string statisticsPath;
+        std::string tracePath;
+        std::string texturePath;
+        std::size_t textureBudget;
+
+        Options() :
+            width(1280), height(720), tileSize(32), threads(0), pinThreads(false), packets(true), wavefront(false),
+            boxCount(20000), instanceCount(1), lightCount(0), output("render.ppm"), statistics(false),
+            textureBudget(64u << 20) {
+            // one sample through each pixel centre unless --spp asks for more
+            progressive.maximumSamples = 1;
+        }
+    };
+
+    void PrintUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [-w width] [-h height] [-o output.ppm|pfm|exr]"
+                  << " [-t threads] [--tile size] [--boxes count] [--pin] [--scalar]"
+                  << " [--mesh file.obj|ply|mesh] [--save-mesh file.mesh] [--instances count]"
+                  << " [--bvh-cache directory]"
+                  << " [--spp maximum] [--initial-spp count] [--pass-spp count]"
+                  << " [--error threshold] [--time seconds]"
+                  << " [--sampler independent|halton|sobol|bluenoise]"
+                  << " [--wavefront] [--bounces count] [--wave paths] [--no-sort]"
+                  << " [--stats] [--stats-json file.json] [--trace file.json]"
+                  << " [--texture image.ppm|pfm|tex] [--texture-budget MiB] [--lights count]" << std::endl;
+    }
+
+    //! Parses text as a whole number in [minimum, maximum] into value
+    /*!
+     Returns false, leaving value alone, when text is not a number, has
+     trailing characters or is out of range.
+     */
+    template <typename T>
+    bool ParseInteger(const char* text, long long minimum, long long maximum, T& value) {
+        char* end = 0;
+        errno = 0;
+        long long parsed = std::strtoll(text, &end, 10);
+        if(end == text || *end != '\0' || errno == ERANGE || parsed < minimum || parsed > maximum)
+            return false;
+        value = (T)parsed;
+        return true;
+    }
+
+    //! Parses text as a number above zero and at most maximum into value
+    template <typename T>
+    bool ParsePositive(const char* text, double maximum, T& value) {
+        char* end = 0;
+        errno = 0;
+        double parsed = std::strtod(text, &end);
+        if(end == text || *end != '\0' || errno == ERANGE || !(parsed > 0.0 && parsed <= maximum))
+            return false;
+        value = (T)parsed;
+        return true;
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        // limits keep sizes derived from the options far from overflow
+        const long long maximumDimension = 1 << 15;
+        const long long maximumCount = 1 << 26;
+        for(int i = 1; i < argc; i++) {
+            bool hasValue = i + 1 < argc;
+            if(std::strcmp(argv[i], "-w") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 1, maximumDimension, options.width))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "-h") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 1, maximumDimension, options.height))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "-o") == 0 && hasValue)
+                options.output = argv[++i];
+            else if(std::strcmp(argv[i], "-t") == 0 && hasValue) {
+                // 0 uses every hardware thread
+                if(!ParseInteger(argv[++i], 0, 1024, options.threads))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--tile") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 1, 256, options.tileSize))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--boxes") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 1, maximumCount, options.boxCount))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--mesh") == 0 && hasValue)
+                options.meshPath = argv[++i];
+            else if(std::strcmp(argv[i], "--save-mesh") == 0 && hasValue)
+                options.saveMeshPath = argv[++i];
+            else if(std::strcmp(argv[i], "--bvh-cache") == 0 && hasValue)
+                options.cacheDirectory = argv[++i];
+            else if(std::strcmp(argv[i], "--instances") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 1, maximumCount, options.instanceCount))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--spp") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 1, 1 << 20, options.progressive.maximumSamples))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--initial-spp") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 1, 1 << 20, options.progressive.initialSamples))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--pass-spp") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 1, 1 << 20, options.progressive.samplesPerPass))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--error") == 0 && hasValue) {
+                if(!ParsePositive(argv[++i], 1.0e3, options.progressive.errorThreshold))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--time") == 0 && hasValue) {
+                if(!ParsePositive(argv[++i], 1.0e7, options.progressive.timeBudget))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--sampler") == 0 && hasValue) {
+                if(!Sampler::Parse(argv[++i], options.progressive.sampler))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--pin") == 0)
+                options.pinThreads = true;
+            else if(std::strcmp(argv[i], "--scalar") == 0)
+                options.packets = false;
+            else if(std::strcmp(argv[i], "--wavefront") == 0)
+                options.wavefront = true;
+            else if(std::strcmp(argv[i], "--bounces") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 0, 64, options.wavefrontSettings.maximumBounces))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--wave") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 1, maximumCount, options.wavefrontSettings.waveSize))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--stats") == 0)
+                options.statistics = true;
+            else if(std::strcmp(argv[i], "--stats-json") == 0 && hasValue)
+                options.statisticsPath = argv[++i];
+            else if(std::strcmp(argv[i], "--trace") == 0 && hasValue)
+                options.tracePath = argv[++i];
+            else if(std::strcmp(argv[i], "--texture") == 0 && hasValue)
+                options.texturePath = argv[++i];
+            else if(std::strcmp(argv[i], "--texture-budget") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 1, 1 << 16, options.textureBudget))
+                    return false;
+                options.textureBudget <<= 20;
+            }
+            else if(std::strcmp(argv[i], "--lights") == 0 && hasValue) {
+                if(!ParseInteger(argv[++i], 0, maximumCount, options.lightCount))
+                    return false;
+            }
+            else if(std::strcmp(argv[i], "--no-sort") == 0) {
+                options.wavefrontSettings.sortRays = false;
+                options.wavefrontSettings.sortHits = false;
+            }
+            else
+                return false;
+        }
+        return true;
+    }
+
+    //! Returns the number of set bits of a lane mask
+    int CountBits(int bits) {
+        int count = 0;
+        for(; bits != 0; bits &= bits - 1)
+            count++;
+        return count;
+    }
+
+    //! Appends the twelve triangles of the box between minimum and maximum
+    void AddBox(const Point& minimum, const Point& maximum, TriangleMesh& mesh) {
+        static const std::uint32_t faces[36] = {
+            0, 2, 1,  1, 2, 3,   4, 5, 6,  5, 7, 6,    // -z, +z
+            0, 1, 4,  1, 5, 4,   2, 6, 3,  3, 6, 7,    // -y, +y
+            0, 4, 2,  2, 4, 6,   1, 3, 5,  3, 7, 5 };  // -x, +x
+
+        std::uint32_t first = (std::uint32_t)mesh.GetVertexCount();
+        for(int corner = 0; corner < 8; corner++)
+            mesh.AddVertex(Point(corner & 1 ? maximum.GetX() : minimum.GetX(),
+                                 corner & 2 ? maximum.GetY() : minimum.GetY(),
+                                 corner & 4 ? maximum.GetZ() : minimum.GetZ()));
+        for(int i = 0; i < 36; i += 3)
+            mesh.AddTriangle(first + faces[i], first + faces[i + 1], first + faces[i + 2]);
+    }
+
+    //! Fills mesh with random boxes standing on a ground slab, one color per box
+    void MakeBoxField(std::size_t boxCount, TriangleMesh& mesh, std::vector<Color>& colors) {
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+        std::uniform_real_distribution<float> size(0.1f, 0.8f);
+        std::uniform_real_distribution<float> shade(0.2f, 0.9f);
+
+        AddBox(Point(-25.0f, -1.0f, -25.0f), Point(25.0f, 0.0f, 25.0f), mesh);
+        colors.push_back(Color(0.6f));
+        for(std::size_t i = 0; i < boxCount; i++) {
+            float x = position(generator);
+            float z = position(generator);
+            float extent = size(generator);
+            float height = extent * (1.0f + 4.0f * size(generator));
+            colors.push_back(Color(shade(generator), shade(generator), shade(generator)));
+            AddBox(Point(x, 0.0f, z), Point(x + extent, height, z + extent), mesh);
+        }
+        mesh.ShrinkToFit();
+    }
+
+    //! Scatters count small lamps over the footprint of bounds
+    /*!
+     Half are bare bulbs lighting every way, the others spots aimed down.
+     The total power grows with the footprint and not with count, so
+     more lights make the same overall brightness.
+     */
+    void MakeLights(std::size_t count, const AABB& bounds, std::vector<Light>& lights) {
+        std::mt19937 generator(13);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const Point& minimum = bounds.GetMinimum();
+        Vector extent = bounds.GetDiagonal();
+        float height = std::max(0.25f * extent.GetY(), 1.0f);
+        float intensity = 12.0f * extent.GetX() * extent.GetZ() / (float)std::max<std::size_t>(count, 1);
+        for(std::size_t i = 0; i < count; i++) {
+            Point position(minimum.GetX() + extent.GetX() * unit(generator),
+                           minimum.GetY() + 0.5f + height * unit(generator),
+                           minimum.GetZ() + extent.GetZ() * unit(generator));
+            // warm lamps of varied strength, a few much brighter than the rest
+            float strength = intensity * 0.25f / (0.05f + unit(generator));
+            Color color = Color(1.0f, 0.55f + 0.35f * unit(generator), 0.25f + 0.3f * unit(generator)) * strength;
+            if(i % 2 == 0)
+                lights.push_back(Light(position, color));
+            else
+                lights.push_back(Light(position, Normal(0.0f, -1.0f, 0.0f), 0.6f, color));
+        }
+    }
+
+    //! Instances of one triangle mesh lit by a sun or by many lamps
+    /*!
+     The mesh gets a single TriangleBVH shared by every instance. With more
+     than one instance, copies are scattered over a grid with a random turn
+     and scale. Triangles are colored in runs of trianglesPerColor from
+     colors, or grey when there are no colors. Given a cache directory,
+     the hierarchies are mapped from a BVHCache file keyed by the mesh and
+     placements, or built and saved there when none matches. Given lights,
+     the sun sets and every shading point picks one lamp from a LightBVH.
+     */
+    class MeshScene {
+
+    public:
+
+        MeshScene(TaskPool& pool, std::shared_ptr<const TriangleMesh> meshArg,
+                  const std::vector<Color>& colorsArg, std::size_t trianglesPerColorArg,
+                  std::size_t instanceCount, const std::string& cacheDirectory) :
+            mesh(meshArg), colors(colorsArg), trianglesPerColor(trianglesPerColorArg), cached(false),
+            textures(0), texture(-1), pixelSpread(0.0f), ambient(0.15f), skyScale(1.0f) {
+            const Vector toSun(0.4f, 0.8f, 0.45f);
+            sun = toSun / toSun.GetMagnitude();
+            std::vector<Transform, Eigen::aligned_allocator<Transform> > placements;
+            if(instanceCount <= 1) {
+                placements.push_back(Transform());
+            }
+            else {
+                std::mt19937 generator(11);
+                std::uniform_real_distribution<float> turn(0.0f, 6.2831853f);
+                std::uniform_real_distribution<float> scale(0.7f, 1.3f);
+                AABB bounds = mesh->GetBounds();
+                float spacing = 1.2f * std::max(bounds.GetDiagonal().GetX(), bounds.GetDiagonal().GetZ());
+                std::size_t side = (std::size_t)std::ceil(std::sqrt((double)instanceCount));
+                Point center = bounds.GetCentroid();
+                for(std::size_t i = 0; i < instanceCount; i++) {
+                    float x = ((float)(i % side) - 0.5f * (side - 1)) * spacing;
+                    float z = ((float)(i / side) - 0.5f * (side - 1)) * spacing;
+                    placements.push_back(Transform::Translate(x, 0.0f, z) *
+                        Transform::Rotate(turn(generator), Vector(0.0f, 1.0f, 0.0f)) *
+                        Transform::Scale(scale(generator)) *
+                        Transform::Translate(-center.GetX(), 0.0f, -center.GetZ()));
+                }
+            }
+
+            // the cache is named after the geometry it was built from
+            std::string cachePath;
+            std::uint64_t key = 0;
+            if(!cacheDirectory.empty()) {
+                key = BVHCache::Hash(mesh->GetPositions(), mesh->GetVertexCount() * 3 * sizeof(float));
+                key = BVHCache::Hash(mesh->GetIndices(), mesh->GetTriangleCount() * 3 * sizeof(std::uint32_t), key);
+                for(std::size_t i = 0; i < placements.size(); i++) {
+                    Eigen::Matrix4f forward = placements[i].GetMatrix().GetContents().matrix();
+                    key = BVHCache::Hash(forward.data(), sizeof(float) * 16, key);
+                }
+                char name[32];
+                std::snprintf(name, sizeof(name), "%016llx.bvh", (unsigned long long)key);
+                cachePath = cacheDirectory + "/" + name;
+                std::string error;
+                cached = BVHCache::Map(cachePath, key, instances, &error);
+                if(!cached)
+                    std::cout << "bvh cache miss: " << error << std::endl;
+            }
+            if(cached)
+                return;
+
+            std::shared_ptr<TriangleBVH> object = std::make_shared<TriangleBVH>();
+            object->Build(*mesh, &pool);
+            for(std::size_t i = 0; i < placements.size(); i++)
+                instances.AddInstance(object, placements[i]);
+            instances.Build(&pool);
+            std::string error;
+            if(!cachePath.empty() && !BVHCache::Write(instances, key, cachePath, &error))
+                std::cerr << "bvh cache not written: " << error << std::endl;
+        }
+
+        //! Returns true when the hierarchies were mapped from the cache
+        bool IsCached() const {
+            return cached;
+        }
+
+        //! Modulates the albedo with a texture of cache
+        /*!
+         pixelSpread is the angle one pixel covers, which with the hit
+         distance sizes the texture footprint.
+         */
+        void SetTexture(const TextureCache* texturesArg, int textureArg, float pixelSpreadArg) {
+            textures = texturesArg;
+            texture = textureArg;
+            pixelSpread = pixelSpreadArg;
+        }
+
+        //! Replaces the sun with lamps sampled through a light hierarchy
+        void SetLights(const std::vector<Light>& sceneLights) {
+            lights.Build(sceneLights);
+            ambient = 0.01f;
+            skyScale = 0.02f;
+        }
+
+        //! Returns the lamp hierarchy, empty under the sun
+        const LightBVH& GetLights() const {
+            return lights;
+        }
+
+        //! Returns the world bounds of every instance
+        AABB GetBounds() const {
+            return instances.GetBounds();
+        }
+
+        //! Shades a primary ray with one light, hard shadows and a sky gradient
+        Color Radiance(const Ray& ray) const {
+            InstanceHit hit;
+            float tMax = std::numeric_limits<float>::infinity();
+            if(!instances.Intersect(ray, tMax, hit))
+                return Sky(ray);
+
+            Color albedo;
+            Ray shadow;
+            float shadowDistance;
+            Color direct = Shade(ray, tMax, hit, SampleNumber(ray), albedo, shadow, shadowDistance);
+            RenderCounters::Add(RenderCounters::shadeCalls);
+            if(!direct.IsBlack()) {
+                RenderCounters::Add(RenderCounters::shadowRays);
+                if(instances.IntersectAny(shadow, shadowDistance))
+                    direct = Color();
+            }
+            return albedo * (Color(ambient) + direct);
+        }
+
+        //! Shades the active lanes of a packet of primary rays like Radiance
+        /*!
+         Primary rays are traced as one packet, then the shadow rays of the
+         lit lanes as another. Under the sun they all share its direction.
+         */
+        void RadiancePacket(const RayPacket8& rays, const Mask8& active, Color colors[8]) const {
+            InstanceHit hits[8];
+            Float8 tMax(std::numeric_limits<float>::infinity());
+            int hitBits = instances.IntersectPacket(rays, active, tMax, hits).GetBits();
+
+            Point shadowOrigins[8];
+            Vector shadowDirections[8];
+            Float8 shadowMax;
+            Color albedos[8];
+            Color directs[8];
+            int litBits = 0;
+            for(int lane = 0; lane < 8; lane++) {
+                if(!active[lane])
+                    continue;
+                Ray ray(rays.GetOrigin().Extract(lane), rays.GetDirection().Extract(lane));
+                if(!(hitBits & (1 << lane))) {
+                    colors[lane] = Sky(ray);
+                    continue;
+                }
+                Ray shadow;
+                float shadowDistance;
+                directs[lane] = Shade(ray, tMax[lane], hits[lane], SampleNumber(ray), albedos[lane], shadow,
+                                      shadowDistance);
+                shadowOrigins[lane] = shadow.GetOrigin();
+                shadowDirections[lane] = shadow.GetDirection();
+                shadowMax.SetLane(lane, shadowDistance);
+                if(!directs[lane].IsBlack())
+                    litBits |= 1 << lane;
+            }
+
+            RenderCounters::Add(RenderCounters::shadeCalls, CountBits(hitBits & active.GetBits()));
+            int occludedBits = 0;
+            if(litBits != 0) {
+                RenderCounters::Add(RenderCounters::shadowRays, CountBits(litBits));
+                // unlit lanes still load a valid ray, the mask keeps them out
+                for(int lane = 0; lane < 8; lane++)
+                    if(!(litBits & (1 << lane))) {
+                        shadowOrigins[lane] = rays.GetOrigin().Extract(lane);
+                        shadowDirections[lane] = rays.GetDirection().Extract(lane);
+                    }
+                occludedBits = instances.IntersectAnyPacket(RayPacket8::Gather(shadowOrigins, shadowDirections),
+                                                            Mask8::FromBits(litBits), shadowMax).GetBits();
+            }
+            for(int lane = 0; lane < 8; lane++)
+                if(hitBits & (1 << lane)) {
+                    Color direct = occludedBits & (1 << lane) ? Color() : directs[lane];
+                    colors[lane] = albedos[lane] * (Color(ambient) + direct);
+                }
+        }
+
+        //! Finds the closest hits of queued rays [begin, end), eight at a time
+        /*!
+         Misses keep material 0, hits take 1 plus their color index, so the
+         shade stage sees each box color as one run.
+         */
+        void Extend(RayQueue& rays, std::size_t begin, std::size_t end) const {
+            for(std::size_t first = begin; first < end; first += 8) {
+                int activeBits = 0;
+                Float8 tMax;
+                for(int lane = 0; lane < 8 && first + lane < end; lane++) {
+                    activeBits |= 1 << lane;
+                    tMax.SetLane(lane, rays.GetMaximumDistance(first + lane));
+                }
+                InstanceHit hits[8];
+                int hitBits = instances.IntersectPacket(rays.GetPacket(first), Mask8::FromBits(activeBits),
+                                                        tMax, hits).GetBits();
+                for(int lane = 0; lane < 8 && first + lane < end; lane++) {
+                    QueueHit& hit = rays.GetHit(first + lane);
+                    hit = QueueHit();
+                    if(hitBits & (1 << lane)) {
+                        hit.t = tMax[lane];
+                        hit.primitive = hits[lane].triangle.primitive;
+                        hit.instance = hits[lane].instance;
+                        hit.u = hits[lane].triangle.u;
+                        hit.v = hits[lane].triangle.v;
+                        hit.material = colors.empty() ? 1 : 1 + (std::uint32_t)(hit.primitive / trianglesPerColor);
+                    }
+                }
+            }
+        }
+
+        //! Shades a path vertex: the sky on a miss, one light and a diffuse bounce on a hit
+        void ShadePath(const Ray& ray, const QueueHit& queueHit, const float random[3],
+                       ShadeResult& result) const {
+            if(queueHit.t == std::numeric_limits<float>::infinity()) {
+                result.emitted = Sky(ray);
+                return;
+            }
+            InstanceHit hit;
+            hit.triangle.t = queueHit.t;
+            hit.triangle.u = queueHit.u;
+            hit.triangle.v = queueHit.v;
+            hit.triangle.primitive = queueHit.primitive;
+            hit.instance = queueHit.instance;
+            Normal normal, shading;
+            GetSurface(ray, hit, normal, shading);
+            Color albedo = GetAlbedo(ray, queueHit.t, hit);
+            Point origin = ray.PointAt(queueHit.t) + Vector(normal) * 1e-3f;
+
+            // the same direct light as Radiance, the third number picking the lamp
+            Color direct = SampleDirect(origin, shading, random[2], result.shadow, result.shadowDistance);
+            if(!direct.IsBlack())
+                result.direct = albedo * direct;
+
+            // cosine weighted directions cancel the cosine over the pdf, leaving the albedo
+            Vector direction = SampleCosine(shading, random[0], random[1]);
+            if(direction * normal > 0.0f) {
+                result.bounce = Ray(origin, direction);
+                result.bounceWeight = albedo;
+            }
+        }
+
+        //! Marks the queued shadow rays [begin, end) that hit anything, eight at a time
+        void Connect(const RayQueue& shadows, std::size_t begin, std::size_t end, bool* occluded) const {
+            for(std::size_t first = begin; first < end; first += 8) {
+                int activeBits = 0;
+                Float8 tMax;
+                for(int lane = 0; lane < 8 && first + lane < end; lane++) {
+                    activeBits |= 1 << lane;
+                    tMax.SetLane(lane, shadows.GetMaximumDistance(first + lane));
+                }
+                int blockedBits = instances.IntersectAnyPacket(shadows.GetPacket(first),
+                                                               Mask8::FromBits(activeBits), tMax).GetBits();
+                for(int lane = 0; lane < 8 && first + lane < end; lane++)
+                    occluded[first + lane - begin] = (blockedBits & (1 << lane)) != 0;
+            }
+        }
+
+    protected:
+
+        //! Returns the sky gradient seen along a ray that hits nothing
+        Color Sky(const Ray& ray) const {
+            float up = 0.5f * (ray.GetDirection().GetY() + 1.0f);
+            return (Color(1.0f) * (1.0f - up) + Color(0.4f, 0.6f, 1.0f) * up) * skyScale;
+        }
+
+        //! Returns a number in [0, 1) hashed from a ray, for renderers that pass none
+        /*!
+         Jittered samples of a pixel hash to unrelated numbers, so picks
+         made with it still average out over samples.
+         */
+        static float SampleNumber(const Ray& ray) {
+            std::uint32_t bits[6];
+            std::memcpy(bits, ray.GetOrigin().Data(), 3 * sizeof(float));
+            std::memcpy(bits + 3, ray.GetDirection().Data(), 3 * sizeof(float));
+            std::uint32_t hash = 2166136261u;
+            for(int i = 0; i < 6; i++) {
+                hash = (hash ^ bits[i]) * 16777619u;
+                hash ^= hash >> 15;
+            }
+            hash *= 0x2C1B3C6Du;
+            hash ^= hash >> 12;
+            return (float)(hash >> 8) * (1.0f / 16777216.0f);
+        }
+
+        //! Maps two uniform numbers to a cosine distributed direction about normal
+        static Vector SampleCosine(const Normal& normal, float u1, float u2) {
+            float radius = std::sqrt(u1);
+            float angle = 6.2831853f * u2;
+            Vector axis(normal);
+            Vector tangent = (std::abs(axis.GetX()) > 0.9f ? Vector(0.0f, 1.0f, 0.0f) :
+                                                            Vector(1.0f, 0.0f, 0.0f)) ^ axis;
+            tangent.Normalize();
+            Vector bitangent = axis ^ tangent;
+            return tangent * (radius * std::cos(angle)) + bitangent * (radius * std::sin(angle)) +
+                   axis * std::sqrt(std::max(0.0f, 1.0f - u1));
+        }
+
+        //! Returns the unblocked direct light at a hit, with its albedo and shadow ray
+        /*!
+         u picks the lamp when the scene has lamps. The shadow ray is only
+         meaningful when the returned light is not black.
+         */
+        Color Shade(const Ray& ray, float tHit, const InstanceHit& hit, float u, Color& albedo, Ray& shadow,
+                    float& shadowDistance) const {
+            Normal normal, shading;
+            GetSurface(ray, hit, normal, shading);
+            albedo = GetAlbedo(ray, tHit, hit);
+            return SampleDirect(ray.PointAt(tHit) + Vector(normal) * 1e-3f, shading, u, shadow, shadowDistance);
+        }
+
+        //! Returns the light a diffuse surface at origin reflects per unit albedo, before shadowing
+        /*!
+         Under the sun this is the fixed sun term. With lamps, u picks one
+         from the hierarchy and its share is divided by the pick's
+         probability. shadow and shadowDistance reach the light.
+         */
+        Color SampleDirect(const Point& origin, const Normal& shading, float u, Ray& shadow,
+                           float& shadowDistance) const {
+            if(lights.GetLightCount() == 0) {
+                shadow = Ray(origin, sun);
+                shadowDistance = std::numeric_limits<float>::infinity();
+                return Color(0.85f * std::max(0.0f, shading * sun));
+            }
+
+            std::uint32_t index;
+            float probability;
+            shadowDistance = 0.0f;
+            if(!lights.Sample(origin, shading, u, index, probability))
+                return Color();
+            const Light& light = lights.GetLight(index);
+            Vector toLight = light.position - origin;
+            float squaredDistance = toLight.GetSquaredMagnitude();
+            float cosine = shading * toLight;
+            if(cosine <= 0.0f || squaredDistance <= 0.0f)
+                return Color();
+            float distance = std::sqrt(squaredDistance);
+            toLight = toLight / distance;
+            shadow = Ray(origin, toLight);
+            shadowDistance = distance * 0.999f;
+            // a diffuse surface reflects albedo over pi of the irradiance
+            return light.GetIntensity(-toLight) * (cosine / (distance * 3.14159265f * squaredDistance * probability));
+        }
+
+        //! Returns the face normal and shading normal at a hit, both facing the ray
+        void GetSurface(const Ray& ray, const InstanceHit& hit, Normal& normal, Normal& shading) const {
+            const std::uint32_t* triangle = mesh->GetTriangle(hit.triangle.primitive);
+            Point p0 = mesh->GetPosition(triangle[0]);
+            normal = Normal(Vector(mesh->GetPosition(triangle[1]) - p0) ^
+                            Vector(mesh->GetPosition(triangle[2]) - p0));
+            const Transform& transform = instances.GetInstance(hit.instance).transform;
+            normal = transform * normal;
+            normal.Normalize();
+            if(normal * ray.GetDirection() > 0.0f)
+                normal = -normal;
+
+            // interpolated vertex normals shade, the face normal decides the side
+            shading = normal;
+            if(mesh->HasNormals()) {
+                const float u = hit.triangle.u, v = hit.triangle.v;
+                shading = transform * Normal(Vector(mesh->GetNormal(triangle[0])) * (1.0f - u - v) +
+                                             Vector(mesh->GetNormal(triangle[1])) * u +
+                                             Vector(mesh->GetNormal(triangle[2])) * v);
+                if(shading.GetSquaredMagnitude() > 0.0f) {
+                    shading.Normalize();
+                    if(shading * normal < 0.0f)
+                        shading = -shading;
+                }
+                else
+                    shading = normal;
+            }
+        }
+
+        //! Returns the color of a triangle
+        Color GetColor(std::uint32_t primitive) const {
+            return colors.empty() ? Color(0.7f) : colors[primitive / trianglesPerColor];
+        }
+
+        //! Returns the color at a hit, textured when a texture is set
+        /*!
+         Meshes with texture coordinates use them; others are projected
+         from above, one texture repeat every planarScale units.
+         */
+        Color GetAlbedo(const Ray& ray, float tHit, const InstanceHit& hit) const {
+            Color albedo = GetColor(hit.triangle.primitive);
+            if(!textures)
+                return albedo;
+
+            static const float planarScale = 8.0f;
+            float u, v, uvPerUnit;
+            if(mesh->HasUVs()) {
+                const std::uint32_t* triangle = mesh->GetTriangle(hit.triangle.primitive);
+                const float* uv0 = mesh->GetUVs() + 2 * triangle[0];
+                const float* uv1 = mesh->GetUVs() + 2 * triangle[1];
+                const float* uv2 = mesh->GetUVs() + 2 * triangle[2];
+                const float b1 = hit.triangle.u, b2 = hit.triangle.v, b0 = 1.0f - b1 - b2;
+                u = b0 * uv0[0] + b1 * uv1[0] + b2 * uv2[0];
+                v = b0 * uv0[1] + b1 * uv1[1] + b2 * uv2[1];
+                // the ratio of the triangle's areas in uv and object space gives the uv density
+                float uvArea = std::fabs((uv1[0] - uv0[0]) * (uv2[1] - uv0[1]) -
+                                         (uv2[0] - uv0[0]) * (uv1[1] - uv0[1]));
+                Point p0 = mesh->GetPosition(triangle[0]);
+                float area = (Vector(mesh->GetPosition(triangle[1]) - p0) ^
+                              Vector(mesh->GetPosition(triangle[2]) - p0)).GetMagnitude();
+                uvPerUnit = area > 0.0f ? std::sqrt(uvArea / area) : 0.0f;
+            }
+            else {
+                Point position = ray.PointAt(tHit);
+                u = position.GetX() / planarScale;
+                v = position.GetZ() / planarScale;
+                uvPerUnit = 1.0f / planarScale;
+            }
+            return albedo * textures->Sample(texture, u, v, tHit * pixelSpread * uvPerUnit);
+        }
+
+        std::shared_ptr<const TriangleMesh> mesh;
+        std::vector<Color> colors;
+        std::size_t trianglesPerColor;
+        InstanceBVH instances;
+        Vector sun;
+        LightBVH lights;
+        bool cached;
+        const TextureCache* textures;
+        int texture;
+        float pixelSpread;
+        float ambient;
+        float skyScale;
+    };
+
+    //! Records a phase of main from begin until now on the trace timeline
+    void TracePhase(const char* name, std::uint64_t begin) {
+        if(!TraceRecorder::IsEnabled())
+            return;
+        TraceRecorder::Event event = { name, "phase", begin, TraceRecorder::Now(), { 0, 0 }, { 0, 0 } };
+        TraceRecorder::Record(event);
+    }
+
+    double SecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
 }
 
+int main(int argc, char** argv) {
+    Options options;
+    if(!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    TraceRecorder::SetThreadName("main");
+    if(!options.tracePath.empty())
+        TraceRecorder::Enable();
+
+    TaskPool pool(options.threads, options.pinThreads);
+    std::cout << "threads: " << pool.GetThreadCount() << std::endl;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::uint64_t phase = TraceRecorder::Now();
+    std::shared_ptr<TriangleMesh> mesh = std::make_shared<TriangleMesh>();
+    std::vector<Color> colors;
+    if(!options.meshPath.empty()) {
+        std::string error;
+        ImportStatistics statistics;
+        if(!MeshImporter::Import(options.meshPath, *mesh, &pool, &statistics, &error)) {
+            std::cerr << error << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "import: " << statistics.bytes / 1e6 << " MB in " << statistics.chunks
+                  << " chunks, " << statistics.GetMegabytesPerSecond() << " MB/s" << std::endl;
+        // shading normals only need to point the right way, keep them in 32 bits
+        mesh->CompressNormals(&pool);
+    }
+    else
+        MakeBoxField(options.boxCount, *mesh, colors);
+    TracePhase("scene load", phase);
+    std::cout << "mesh: " << mesh->GetTriangleCount() << " triangles, "
+              << mesh->GetMemoryUsage() / (1024 * 1024) << " MiB, " << SecondsSince(start)
+              << " s" << std::endl;
+
+    if(!options.saveMeshPath.empty()) {
+        std::string error;
+        if(!MeshFile::Write(*mesh, options.saveMeshPath, &error)) {
+            std::cerr << error << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    start = std::chrono::steady_clock::now();
+    phase = TraceRecorder::Now();
+    MeshScene scene(pool, mesh, colors, 12, options.instanceCount, options.cacheDirectory);
+    TracePhase("scene build", phase);
+    std::cout << (scene.IsCached() ? "scene mapped: " : "scene build: ") << SecondsSince(start)
+              << " s, " << options.instanceCount << " instances of " << mesh->GetTriangleCount()
+              << " triangles" << std::endl;
+
+    if(options.lightCount > 0) {
+        start = std::chrono::steady_clock::now();
+        std::vector<Light> lights;
+        MakeLights(options.lightCount, scene.GetBounds(), lights);
+        scene.SetLights(lights);
+        std::cout << "light build: " << SecondsSince(start) << " s, ";
+        scene.GetLights().DisplayContents();
+    }
 
+    // frame loaded meshes and instanced scenes, keep the fixed view of the box field
+    Point eye(0.0f, 12.0f, 30.0f);
+    Point target(0.0f, 0.0f, 0.0f);
+    if((!options.meshPath.empty() || options.instanceCount > 1) && mesh->GetTriangleCount() > 0) {
+        AABB bounds = scene.GetBounds();
+        float radius = 0.5f * bounds.GetDiagonal().GetMagnitude();
+        target = bounds.GetCentroid();
+        eye = target + Vector(0.0f, 0.4f, 1.0f) * (2.2f * radius);
+    }
+    Camera camera(eye, target, Vector(0.0f, 1.0f, 0.0f), 0.8f,
+                  (float)options.width / options.height);
+    Framebuffer framebuffer(options.width, options.height, options.tileSize);
+
+    // images are converted to tiled textures once, next to the source
+    std::unique_ptr<TextureCache> textures;
+    if(!options.texturePath.empty()) {
+        std::string texturePath = options.texturePath;
+        std::string error;
+        if(texturePath.size() < 4 || texturePath.compare(texturePath.size() - 4, 4, ".tex") != 0) {
+            texturePath += ".tex";
+            TextureFile existing;
+            if(!existing.Open(texturePath)) {
+                start = std::chrono::steady_clock::now();
+                if(!TextureFile::Convert(options.texturePath, texturePath, TextureFile::defaultTileSize, &error)) {
+                    std::cerr << error << std::endl;
+                    return EXIT_FAILURE;
+                }
+                std::cout << "texture converted: " << texturePath << ", " << SecondsSince(start) << " s"
+                          << std::endl;
+            }
+        }
+        textures.reset(new TextureCache(options.textureBudget));
+        int texture = textures->Add(texturePath, &error);
+        if(texture < 0) {
+            std::cerr << error << std::endl;
+            return EXIT_FAILURE;
+        }
+        textures->GetTexture(texture).DisplayContents();
+        scene.SetTexture(textures.get(), texture, 0.8f / options.height);
+    }
+    int tileSize = framebuffer.GetTileSize();
+    TileRenderer::RadianceFunction radiance = [&scene](const Ray& ray) {
+        return scene.Radiance(ray);
+    };
+    TileRenderer::PacketRadianceFunction radiancePacket = [&scene](const RayPacket8& rays,
+                                                                   const Mask8& active, Color colors[8]) {
+        scene.RadiancePacket(rays, active, colors);
+    };
+
+    // finished tiles stream to the output file while the rest render
+    ImageWriter writer;
+    if(!writer.Open(options.output, options.width, options.height, tileSize,
+                    ImageWriter::GetFormat(options.output))) {
+        std::cerr << writer.GetError() << std::endl;
+        return EXIT_FAILURE;
+    }
+    TileRenderer::TileCallback writeTile = [&writer, &framebuffer](const Tile& tile) {
+        writer.SubmitTile(framebuffer, tile);
+    };
+
+    RenderCounters::Reset();
+    start = std::chrono::steady_clock::now();
+    phase = TraceRecorder::Now();
+    if(options.wavefront) {
+        WavefrontScene wavefrontScene;
+        wavefrontScene.extend = [&scene](RayQueue& rays, std::size_t begin, std::size_t end) {
+            scene.Extend(rays, begin, end);
+        };
+        wavefrontScene.shade = [&scene](const Ray& ray, const QueueHit& hit, const float random[3],
+                                        ShadeResult& result) {
+            scene.ShadePath(ray, hit, random, result);
+        };
+        wavefrontScene.connect = [&scene](const RayQueue& shadows, std::size_t begin, std::size_t end,
+                                          bool* occluded) {
+            scene.Connect(shadows, begin, end, occluded);
+        };
+        wavefrontScene.bounds = scene.GetBounds();
+        options.wavefrontSettings.samplesPerPixel = options.progressive.maximumSamples;
+        WavefrontRenderer renderer(pool, options.wavefrontSettings);
+        WavefrontStatistics statistics = renderer.Render(camera, wavefrontScene, framebuffer, tileSize,
+                                                         writeTile);
+        std::cout << "render: " << statistics.seconds << " s, " << statistics.paths << " paths, "
+                  << statistics.rays << " rays, " << statistics.shadowRays << " shadow rays" << std::endl;
+        std::cout << "stages: sort " << statistics.sortSeconds << " s, extend " << statistics.extendSeconds
+                  << " s, shade " << statistics.shadeSeconds << " s, connect "
+                  << statistics.connectSeconds << " s" << std::endl;
+    }
+    else if(options.progressive.maximumSamples <= 1) {
+        // one ray per pixel centre is coherent enough to trace in packets
+        TileRenderer renderer(pool, tileSize);
+        if(options.packets)
+            renderer.RenderPackets(camera, radiancePacket, framebuffer, writeTile);
+        else
+            renderer.Render(camera, radiance, framebuffer, writeTile);
+        std::cout << "render: " << SecondsSince(start) << " s" << std::endl;
+    }
+    else {
+        ProgressiveRenderer renderer(pool, options.progressive, tileSize);
+        ProgressiveStatistics statistics = renderer.Render(camera, radiance, framebuffer,
+                                                           ProgressiveRenderer::PassCallback(),
+                                                           writeTile);
+        std::size_t pixelCount = (std::size_t)options.width * options.height;
+        std::cout << "render: " << statistics.seconds << " s, " << statistics.passes << " passes, "
+                  << (double)statistics.samples / pixelCount << " samples per pixel, "
+                  << 100.0 * statistics.finishedPixels / pixelCount << "% finished" << std::endl;
+    }
+    TracePhase("render", phase);
+    if(textures)
+        textures->DisplayContents();
+
+    if(options.statistics || !options.statisticsPath.empty()) {
+        RenderStatistics statistics = RenderStatistics::Collect(SecondsSince(start),
+                                                                (std::size_t)options.width * options.height);
+        if(options.statistics)
+            statistics.DisplayContents();
+        if(!options.statisticsPath.empty()) {
+            std::ofstream json(options.statisticsPath.c_str());
+            statistics.WriteJson(json);
+            if(!json) {
+                std::cerr << options.statisticsPath << ": could not write statistics" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    start = std::chrono::steady_clock::now();
+    phase = TraceRecorder::Now();
+    if(!writer.Close()) {
+        std::cerr << options.output << ": " << writer.GetError() << std::endl;
+        return EXIT_FAILURE;
+    }
+    TracePhase("image write", phase);
+    std::cout << "write: " << writer.GetBytesWritten() / 1e6 << " MB, " << SecondsSince(start)
+              << " s after the render" << std::endl;
+
+    if(!options.tracePath.empty()) {
+        TraceRecorder::Disable();
+        std::string error;
+        if(!TraceRecorder::Write(options.tracePath, &error)) {
+            std::cerr << error << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "trace: " << options.tracePath << ", " << TraceRecorder::GetDroppedCount()
+                  << " events dropped" << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,114 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   MemoryArena.cpp
+ * 
+ * Bump allocator for short lived scratch memory
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "MemoryArena.hpp"
+
+namespace SCPPR {
+
+    const std::size_t MemoryArena::blockAlignment;
+
+    MemoryArena::MemoryArena(std::size_t blockSizeArg) :
+        current(0), offset(0), blockSize(std::max(blockSizeArg, blockAlignment)) {
+
+    }
+
+    MemoryArena::~MemoryArena() {
+        Release();
+    }
+
+    void* MemoryArena::AllocateFromNextBlock(std::size_t bytes) {
+        // reuse a block kept by an earlier reset, skipping ones too small
+        std::size_t next = current < blocks.size() ? current + 1 : current;
+        while(next < blocks.size() && blocks[next].size < bytes)
+            next++;
+
+        if(next == blocks.size()) {
+            Block block;
+            block.size = std::max(blockSize, (bytes + blockAlignment - 1) & ~(blockAlignment - 1));
+            block.data = static_cast<unsigned char*>(AllocateAligned(block.size, blockAlignment));
+            blocks.push_back(block);
+        }
+
+        current = next;
+        offset = bytes;
+        return blocks[current].data;
+    }
+
+    void MemoryArena::Release() {
+        for(std::size_t i = 0; i < blocks.size(); i++)
+            FreeAligned(blocks[i].data);
+        blocks.clear();
+        Reset();
+    }
+
+    std::size_t MemoryArena::GetBytesUsed() const {
+        std::size_t used = 0;
+        for(std::size_t i = 0; i < current && i < blocks.size(); i++)
+            used += blocks[i].size;
+        return current < blocks.size() ? used + offset : used;
+    }
+
+    std::size_t MemoryArena::GetBytesReserved() const {
+        std::size_t reserved = 0;
+        for(std::size_t i = 0; i < blocks.size(); i++)
+            reserved += blocks[i].size;
+        return reserved;
+    }
+
+    MemoryArena& MemoryArena::GetThreadArena() {
+        static thread_local MemoryArena arena;
+        return arena;
+    }
+
+    void* MemoryArena::AllocateAligned(std::size_t bytes, std::size_t alignment) {
+        // over allocate and keep the pointer malloc returned just below the aligned one
+        unsigned char* raw = static_cast<unsigned char*>(std::malloc(bytes + alignment + sizeof(void*)));
+        if(!raw)
+            throw std::bad_alloc();
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(raw + sizeof(void*));
+        address = (address + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+        void* aligned = reinterpret_cast<void*>(address);
+        static_cast<void**>(aligned)[-1] = raw;
+        return aligned;
+    }
+
+    void MemoryArena::FreeAligned(void* pointer) {
+        if(pointer)
+            std::free(static_cast<void**>(pointer)[-1]);
+    }
+
+    void MemoryArena::DisplayContents() const {
+        std::cout << "MemoryArena: " << GetBytesUsed() << " of " << GetBytesReserved()
+                  << " bytes used in " << blocks.size() << " blocks" << std::endl;
+    }
+}
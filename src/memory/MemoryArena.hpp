@@ -0,0 +1,216 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   MemoryArena.hpp
+ * 
+ * Bump allocator for short lived scratch memory
+ * Class and method definitions
+ */
+
+/*!
+ \file MemoryArena.hpp
+ Header definition for the MemoryArena class
+ */
+
+#ifndef MEMORYARENA_HPP
+#define	MEMORYARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace SCPPR {
+
+    //! Bump allocator for short lived scratch memory
+    /*!
+     Hands out memory by advancing an offset through a list of large blocks,
+     so an allocation costs a few instructions and never takes the global
+     heap lock. Nothing is freed individually: Reset or a Scope rewinds the
+     offset and the blocks are reused by the next allocations. An arena is
+     not thread safe, GetThreadArena returns one arena per thread.
+     */
+    class MemoryArena {
+
+    public:
+
+        //! Alignment of every block, the largest alignment Allocate honours
+        static const std::size_t blockAlignment = 64;
+
+        //! Position in the arena that can be rewound to
+        struct Marker {
+            std::size_t block;  //!< Index of the current block
+            std::size_t offset; //!< Bytes used in the current block
+        };
+
+        //! Rewinds an arena to where it was when the scope was opened
+        /*!
+         Scopes nest, so a renderer can open one per tile and shading code
+         another per sample. Memory allocated inside a scope must not be used
+         once it closes.
+         */
+        class Scope {
+
+        public:
+
+            //! Records the current position of arenaArg
+            explicit Scope(MemoryArena& arenaArg);
+
+            //! Rewinds the arena to the recorded position
+            ~Scope();
+
+        protected:
+
+            MemoryArena& arena; //!< Arena being rewound
+            Marker marker;      //!< Position when the scope opened
+
+        private:
+
+            Scope(const Scope&);
+            Scope& operator= (const Scope&);
+        };
+
+        // begin constructor declarations---------------------------------------
+
+        //! Parameterized constructor
+        /*!
+         Constructs an empty arena that reserves blocks of blockSizeArg bytes,
+         or larger for allocations that do not fit a block
+         */
+        explicit MemoryArena(std::size_t blockSizeArg = 256 * 1024);
+
+        //! Destructor, frees every block
+        ~MemoryArena();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Returns bytes of memory aligned to alignment, a power of two up to blockAlignment
+        void* Allocate(std::size_t bytes, std::size_t alignment = 16);
+
+        //! Returns count default constructed objects of type T
+        /*!
+         Destructors are never run, so T must be trivially destructible.
+         */
+        template <typename T>
+        T* Allocate(std::size_t count = 1);
+
+        //! Returns the current position
+        Marker GetMarker() const;
+
+        //! Rewinds to a position returned by GetMarker, keeping the blocks
+        void Rewind(const Marker& marker);
+
+        //! Rewinds to the start, keeping the blocks
+        void Reset();
+
+        //! Frees every block
+        void Release();
+
+        //! Returns the bytes handed out since the last reset, including alignment padding
+        std::size_t GetBytesUsed() const;
+
+        //! Returns the bytes held in blocks
+        std::size_t GetBytesReserved() const;
+
+        //! Returns the arena of the calling thread
+        static MemoryArena& GetThreadArena();
+
+        //! Allocates bytes aligned to alignment from the heap
+        static void* AllocateAligned(std::size_t bytes, std::size_t alignment);
+
+        //! Frees memory returned by AllocateAligned
+        static void FreeAligned(void* pointer);
+
+        //! Displays the arena usage using std::cout
+        void DisplayContents() const;
+
+    protected:
+
+        //! A chunk of memory carved up by Allocate
+        struct Block {
+            unsigned char* data;
+            std::size_t size;
+        };
+
+        //! Moves on to a block that can hold bytes, reserving one if needed
+        void* AllocateFromNextBlock(std::size_t bytes);
+
+        std::vector<Block> blocks; //!< Blocks in allocation order
+        std::size_t current;       //!< Index of the block being filled
+        std::size_t offset;        //!< Bytes used in the current block
+        std::size_t blockSize;     //!< Size of newly reserved blocks
+
+    private:
+
+        MemoryArena(const MemoryArena&);
+        MemoryArena& operator= (const MemoryArena&);
+    };
+
+    inline MemoryArena::Scope::Scope(MemoryArena& arenaArg) :
+        arena(arenaArg), marker(arenaArg.GetMarker()) {
+
+    }
+
+    inline MemoryArena::Scope::~Scope() {
+        arena.Rewind(marker);
+    }
+
+    inline void* MemoryArena::Allocate(std::size_t bytes, std::size_t alignment) {
+        std::size_t start = (offset + alignment - 1) & ~(alignment - 1);
+        if(current < blocks.size() && start + bytes <= blocks[current].size) {
+            offset = start + bytes;
+            return blocks[current].data + start;
+        }
+        return AllocateFromNextBlock(bytes);
+    }
+
+    template <typename T>
+    inline T* MemoryArena::Allocate(std::size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena objects are never destroyed");
+        static_assert(alignof(T) <= blockAlignment, "alignment exceeds the block alignment");
+        T* objects = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        for(std::size_t i = 0; i < count; i++)
+            new(objects + i) T();
+        return objects;
+    }
+
+    inline MemoryArena::Marker MemoryArena::GetMarker() const {
+        Marker marker;
+        marker.block = current;
+        marker.offset = offset;
+        return marker;
+    }
+
+    inline void MemoryArena::Rewind(const Marker& marker) {
+        current = marker.block;
+        offset = marker.offset;
+    }
+
+    inline void MemoryArena::Reset() {
+        current = 0;
+        offset = 0;
+    }
+}
+
+#endif	/* MEMORYARENA_HPP */
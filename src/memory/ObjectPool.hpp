@@ -0,0 +1,176 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   ObjectPool.hpp
+ * 
+ * Free list allocator for fixed size records
+ * Class and method definitions
+ */
+
+/*!
+ \file ObjectPool.hpp
+ Header definition for the ObjectPool class template
+ */
+
+#ifndef OBJECTPOOL_HPP
+#define	OBJECTPOOL_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "MemoryArena.hpp"
+
+namespace SCPPR {
+
+    //! Free list allocator for objects of one type
+    /*!
+     Reserves slots for chunkSize objects at a time and threads released
+     slots onto a free list, so records that are created and dropped at a
+     high rate reuse the same memory instead of going through the heap. A
+     pool is not thread safe, each thread should own its own pool.
+     Destroying or clearing the pool frees its memory without running the
+     destructors of objects that were never released.
+     */
+    template <typename T>
+    class ObjectPool {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Parameterized constructor
+        /*!
+         Constructs an empty pool reserving chunkSizeArg slots at a time
+         */
+        explicit ObjectPool(std::size_t chunkSizeArg = 256);
+
+        //! Destructor, frees every chunk
+        ~ObjectPool();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Constructs an object from arguments in a free slot
+        template <typename... Arguments>
+        T* Acquire(Arguments&&... arguments);
+
+        //! Destroys object and returns its slot to the free list
+        void Release(T* object);
+
+        //! Frees every chunk
+        void Clear();
+
+        //! Returns the number of acquired objects not yet released
+        std::size_t GetLiveCount() const;
+
+        //! Returns the number of slots reserved
+        std::size_t GetCapacity() const;
+
+    protected:
+
+        //! Storage for one object, or the link to the next free slot
+        union Slot {
+            Slot* next;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        };
+
+        //! Reserves a chunk and puts its slots on the free list
+        void Grow();
+
+        std::vector<Slot*> chunks; //!< Reserved chunks
+        Slot* freeSlots;           //!< Head of the free list
+        std::size_t chunkSize;     //!< Slots per chunk
+        std::size_t liveCount;     //!< Acquired objects not yet released
+
+    private:
+
+        ObjectPool(const ObjectPool&);
+        ObjectPool& operator= (const ObjectPool&);
+    };
+
+    template <typename T>
+    inline ObjectPool<T>::ObjectPool(std::size_t chunkSizeArg) :
+        freeSlots(0), chunkSize(chunkSizeArg > 0 ? chunkSizeArg : 1), liveCount(0) {
+
+    }
+
+    template <typename T>
+    inline ObjectPool<T>::~ObjectPool() {
+        Clear();
+    }
+
+    template <typename T>
+    template <typename... Arguments>
+    inline T* ObjectPool<T>::Acquire(Arguments&&... arguments) {
+        if(!freeSlots)
+            Grow();
+        Slot* slot = freeSlots;
+        freeSlots = slot->next;
+        T* object = new(&slot->storage) T(std::forward<Arguments>(arguments)...);
+        liveCount++;
+        return object;
+    }
+
+    template <typename T>
+    inline void ObjectPool<T>::Release(T* object) {
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeSlots;
+        freeSlots = slot;
+        liveCount--;
+    }
+
+    template <typename T>
+    inline void ObjectPool<T>::Clear() {
+        for(std::size_t i = 0; i < chunks.size(); i++)
+            MemoryArena::FreeAligned(chunks[i]);
+        chunks.clear();
+        freeSlots = 0;
+        liveCount = 0;
+    }
+
+    template <typename T>
+    inline std::size_t ObjectPool<T>::GetLiveCount() const {
+        return liveCount;
+    }
+
+    template <typename T>
+    inline std::size_t ObjectPool<T>::GetCapacity() const {
+        return chunks.size() * chunkSize;
+    }
+
+    template <typename T>
+    void ObjectPool<T>::Grow() {
+        Slot* chunk = static_cast<Slot*>(MemoryArena::AllocateAligned(sizeof(Slot) * chunkSize,
+                                                                        alignof(Slot)));
+        chunks.push_back(chunk);
+        for(std::size_t i = chunkSize; i > 0; i--) {
+            chunk[i - 1].next = freeSlots;
+            freeSlots = &chunk[i - 1];
+        }
+    }
+}
+
+#endif	/* OBJECTPOOL_HPP */
@@ -0,0 +1,111 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   RenderCounters.cpp
+ * 
+ * Per thread counters of the rendering hot path
+ */
+
+#include <algorithm>
+#include <mutex>
+
+#include "RenderCounters.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        // Every live thread block plus the counts of exited threads
+        struct Registry {
+            std::mutex mutex;
+            std::vector<RenderCounters::Block*> blocks;
+            RenderCounters::Block retired;
+        };
+
+        Registry& GetRegistry() {
+            static Registry registry;
+            return registry;
+        }
+
+        // Block that registers itself on first use and retires its counts on thread exit
+        struct ThreadBlock {
+            RenderCounters::Block block;
+
+            ThreadBlock() {
+                Registry& registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                registry.blocks.push_back(&block);
+            }
+
+            ~ThreadBlock() {
+                Registry& registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                for(int i = 0; i < RenderCounters::counterCount; i++)
+                    registry.retired.values[i] += block.values[i].load(std::memory_order_relaxed);
+                registry.blocks.erase(std::find(registry.blocks.begin(), registry.blocks.end(), &block));
+            }
+        };
+
+        const char* const counterNames[RenderCounters::counterCount] = {
+            "primary_rays", "bounce_rays", "shadow_rays", "node_visits", "triangle_tests",
+            "shade_calls", "samples"
+        };
+    }
+
+    RenderCounters::Block::Block() {
+        for(int i = 0; i < counterCount; i++)
+            values[i].store(0, std::memory_order_relaxed);
+    }
+
+    RenderCounters::Block& RenderCounters::GetThreadBlock() {
+        static thread_local ThreadBlock local;
+        return local.block;
+    }
+
+    const char* RenderCounters::GetName(Counter counter) {
+        return counterNames[counter];
+    }
+
+    void RenderCounters::Reset() {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for(std::size_t b = 0; b < registry.blocks.size(); b++)
+            for(int i = 0; i < counterCount; i++)
+                registry.blocks[b]->values[i].store(0, std::memory_order_relaxed);
+        for(int i = 0; i < counterCount; i++)
+            registry.retired.values[i].store(0, std::memory_order_relaxed);
+    }
+
+    std::vector<std::vector<std::uint64_t> > RenderCounters::Gather() {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::vector<std::vector<std::uint64_t> > counts(registry.blocks.size() + 1,
+                                                         std::vector<std::uint64_t>(counterCount));
+        for(std::size_t b = 0; b <= registry.blocks.size(); b++) {
+            const Block& block = b < registry.blocks.size() ? *registry.blocks[b] : registry.retired;
+            for(int i = 0; i < counterCount; i++)
+                counts[b][i] = block.values[i].load(std::memory_order_relaxed);
+        }
+        return counts;
+    }
+}
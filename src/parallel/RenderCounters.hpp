@@ -0,0 +1,111 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   RenderCounters.hpp
+ * 
+ * Per thread counters of the rendering hot path
+ * Class and method definitions
+ */
+
+/*!
+ \file RenderCounters.hpp
+ Header definition for the RenderCounters class
+ */
+
+#ifndef RENDERCOUNTERS_HPP
+#define	RENDERCOUNTERS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace SCPPR {
+
+    //! Counters bumped by the traversal and rendering code
+    /*!
+     Every thread owns a cache line aligned block of counters. Add only
+     touches the calling thread's block with a relaxed load and store, which
+     compile to a plain add: there is no locked instruction and no shared
+     cache line on the hot path. Gather sums the blocks of every thread;
+     the relaxed atomics only make reading another thread's block while it
+     runs well defined. Counts of threads that have exited are folded into
+     a retired block when they exit.
+
+     Callers in tight loops count into a local and Add once, for example
+     once per traversal rather than once per node.
+     */
+    class RenderCounters {
+
+    public:
+
+        //! Quantity counted
+        enum Counter {
+            primaryRays,    //!< Camera rays
+            bounceRays,     //!< Closest hit rays after a path bounce
+            shadowRays,     //!< Occlusion rays towards lights
+            nodeVisits,     //!< BVH node tests, a packet test counting once
+            triangleTests,  //!< Triangles tested in visited leaves
+            shadeCalls,     //!< Hits shaded
+            samples,        //!< Camera samples taken
+            counterCount    //!< Number of counters
+        };
+
+        //! Counters of one thread
+        struct alignas(64) Block {
+            std::atomic<std::uint64_t> values[counterCount]; //!< One value per Counter
+
+            //! Constructs a zeroed block
+            Block();
+        };
+
+        //! Adds amount to counter of the calling thread
+        static void Add(Counter counter, std::uint64_t amount = 1);
+
+        //! Returns the block of the calling thread
+        static Block& GetThreadBlock();
+
+        //! Returns the short name of counter used in reports
+        static const char* GetName(Counter counter);
+
+        //! Zeroes the counters of every thread
+        /*!
+         Counts added while Reset runs may survive it, reset between renders.
+         */
+        static void Reset();
+
+        //! Returns the counts of every live thread, then the retired counts
+        /*!
+         Each entry holds counterCount values. Thread order is the order
+         threads first counted something.
+         */
+        static std::vector<std::vector<std::uint64_t> > Gather();
+    };
+
+    inline void RenderCounters::Add(Counter counter, std::uint64_t amount) {
+        // only this thread writes its block, so no read-modify-write is needed
+        std::atomic<std::uint64_t>& value = GetThreadBlock().values[counter];
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+}
+
+#endif	/* RENDERCOUNTERS_HPP */
@@ -0,0 +1,213 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TaskPool.cpp
+ * 
+ * Work stealing thread pool running groups of tasks
+ */
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "TaskPool.hpp"
+#include "TraceRecorder.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        // Pool and worker index of the calling thread, if it is a worker
+        thread_local const TaskPool* currentPool = 0;
+        thread_local int currentWorker = -1;
+
+        // Binds the calling thread to one logical processor where supported
+        void PinCurrentThread(unsigned processor) {
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(processor % CPU_SETSIZE, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+            (void)processor;
+#endif
+        }
+    }
+
+    TaskPool::TaskPool(unsigned threadCount, bool pinThreads) :
+        queued(0), sleeping(0), nextQueue(0), stopping(false) {
+        if(threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        for(unsigned i = 0; i < threadCount; i++)
+            queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+        for(unsigned i = 0; i < threadCount; i++)
+            workers.push_back(std::thread(&TaskPool::WorkerLoop, this, (int)i, pinThreads));
+    }
+
+    TaskPool::~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        available.notify_all();
+        for(std::size_t i = 0; i < workers.size(); i++)
+            workers[i].join();
+    }
+
+    int TaskPool::GetWorkerIndex() const {
+        return currentPool == this ? currentWorker : -1;
+    }
+
+    void TaskPool::Submit(TaskGroup& group, const Task& task) {
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+
+        int target = GetWorkerIndex();
+        if(target < 0)
+            target = (int)(nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size());
+        {
+            WorkerQueue& queue = *queues[target];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            Entry entry = { task, &group };
+            queue.tasks.push_back(entry);
+        }
+
+        queued.fetch_add(1);
+        if(sleeping.load() > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            available.notify_one();
+        }
+    }
+
+    void TaskPool::Wait(TaskGroup& group) {
+        const int self = GetWorkerIndex();
+        while(!group.IsDone()) {
+            Entry entry;
+            if(FindTask(self, entry)) {
+                Execute(entry);
+                continue;
+            }
+
+            // nothing to help with, sleep until a group finishes
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            finished.wait_for(lock, std::chrono::milliseconds(1), [&group, this]() {
+                return group.IsDone() || queued.load() > 0;
+            });
+        }
+
+        if(group.failure) {
+            std::exception_ptr failure = group.failure;
+            group.failure = std::exception_ptr();
+            std::rethrow_exception(failure);
+        }
+    }
+
+    void TaskPool::ParallelFor(std::size_t count, std::size_t grainSize, const RangeTask& body) {
+        grainSize = std::max<std::size_t>(grainSize, 1);
+        TaskGroup group;
+        for(std::size_t begin = 0; begin < count; begin += grainSize) {
+            std::size_t end = std::min(count, begin + grainSize);
+            Submit(group, [&body, begin, end]() {
+                body(begin, end);
+            });
+        }
+        Wait(group);
+    }
+
+    bool TaskPool::FindTask(int self, Entry& entry) {
+        if(queued.load(std::memory_order_relaxed) == 0)
+            return false;
+
+        // newest task of our own deque first
+        if(self >= 0) {
+            WorkerQueue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if(!own.tasks.empty()) {
+                entry = own.tasks.back();
+                own.tasks.pop_back();
+                queued.fetch_sub(1);
+                return true;
+            }
+        }
+
+        // then the oldest task of any other deque, starting after our own
+        const std::size_t count = queues.size();
+        const std::size_t start = self >= 0 ? (std::size_t)self + 1 : nextQueue.load(std::memory_order_relaxed);
+        for(std::size_t i = 0; i < count; i++) {
+            WorkerQueue& victim = *queues[(start + i) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if(!victim.tasks.empty()) {
+                entry = victim.tasks.front();
+                victim.tasks.pop_front();
+                queued.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void TaskPool::Execute(Entry& entry) {
+        try {
+            entry.task();
+        }
+        catch(...) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            if(!entry.group->failure)
+                entry.group->failure = std::current_exception();
+        }
+
+        if(entry.group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // take the lock so a waiter cannot miss the notification
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            finished.notify_all();
+        }
+    }
+
+    void TaskPool::WorkerLoop(int index, bool pin) {
+        currentPool = this;
+        currentWorker = index;
+        TraceRecorder::SetThreadName("worker " + std::to_string(index));
+        if(pin)
+            PinCurrentThread((unsigned)index);
+
+        for(;;) {
+            Entry entry;
+            if(FindTask(index, entry)) {
+                Execute(entry);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleeping.fetch_add(1);
+            available.wait(lock, [this]() {
+                return stopping.load() || queued.load() > 0;
+            });
+            sleeping.fetch_sub(1);
+            if(stopping.load() && queued.load() == 0)
+                return;
+        }
+    }
+}
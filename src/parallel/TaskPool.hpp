@@ -0,0 +1,191 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TaskPool.hpp
+ * 
+ * Work stealing thread pool running groups of tasks
+ * Class and method definitions
+ */
+
+/*!
+ \file TaskPool.hpp
+ Header definition for the TaskPool and TaskGroup classes
+ */
+
+#ifndef TASKPOOL_HPP
+#define	TASKPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SCPPR {
+
+    //! A set of tasks that can be waited on together
+    /*!
+     Tasks are added to a group through TaskPool::Submit and the group is
+     complete once every one of them has returned. The first exception thrown
+     by a task is rethrown from TaskPool::Wait.
+     */
+    class TaskGroup {
+
+    public:
+
+        //! Default constructor
+        /*!
+         Constructs an empty, complete group
+         */
+        TaskGroup();
+
+        //! Returns true when no task of the group is queued or running
+        bool IsDone() const;
+
+    protected:
+
+        friend class TaskPool;
+
+        std::atomic<int> pending;   //!< Tasks submitted but not yet finished
+        std::exception_ptr failure; //!< First exception thrown by a task
+    };
+
+    //! Work stealing pool of worker threads
+    /*!
+     Every worker owns a deque. A worker pushes the tasks it submits onto the
+     back of its own deque and pops from the back, so nested work stays
+     depth first and cache warm. Tasks submitted from other threads are dealt
+     round robin across the workers. An idle worker steals from the front of
+     another worker's deque, taking the oldest and usually largest piece of
+     work. A thread waiting on a group runs tasks instead of blocking, so
+     tasks may submit and wait on nested groups.
+     */
+    class TaskPool {
+
+    public:
+
+        //! A unit of work
+        typedef std::function<void()> Task;
+
+        //! A range body, called with [begin, end)
+        typedef std::function<void(std::size_t begin, std::size_t end)> RangeTask;
+
+        // begin constructor declarations---------------------------------------
+
+        //! Parameterized constructor
+        /*!
+         Starts threadCount workers, or one per hardware thread when 0. When
+         pinThreads is set, worker i is bound to logical processor i on
+         platforms that support it.
+         */
+        explicit TaskPool(unsigned threadCount = 0, bool pinThreads = false);
+
+        //! Destructor, finishes queued tasks and joins the workers
+        ~TaskPool();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Returns the number of worker threads
+        unsigned GetThreadCount() const;
+
+        //! Returns the index of the calling worker, or -1 for other threads
+        int GetWorkerIndex() const;
+
+        //! Queues task as part of group
+        void Submit(TaskGroup& group, const Task& task);
+
+        //! Returns once every task of group has finished
+        /*!
+         Runs queued tasks on the calling thread while waiting and rethrows
+         the first exception thrown by a task of the group.
+         */
+        void Wait(TaskGroup& group);
+
+        //! Calls body over [0, count) split into chunks of at most grainSize
+        void ParallelFor(std::size_t count, std::size_t grainSize, const RangeTask& body);
+
+    protected:
+
+        //! A queued task and the group it belongs to
+        struct Entry {
+            Task task;
+            TaskGroup* group;
+        };
+
+        //! Deque owned by one worker
+        /*!
+         Allocated separately and padded so that two workers' locks never
+         share a cache line.
+         */
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<Entry> tasks;
+            char padding[64];
+        };
+
+        //! Pops from the caller's own deque, else steals, returns false if idle
+        bool FindTask(int self, Entry& entry);
+
+        //! Runs entry and records its completion in its group
+        void Execute(Entry& entry);
+
+        //! Body of worker index
+        void WorkerLoop(int index, bool pin);
+
+        std::vector<std::unique_ptr<WorkerQueue> > queues; //!< One deque per worker
+        std::vector<std::thread> workers;      //!< Worker threads
+        std::atomic<int> queued;               //!< Tasks in all deques
+        std::atomic<int> sleeping;             //!< Workers blocked on available
+        std::atomic<unsigned> nextQueue;       //!< Round robin target for outside submits
+        std::mutex sleepMutex;                 //!< Guards available and finished
+        std::condition_variable available;     //!< Signalled when a task is queued
+        std::condition_variable finished;      //!< Signalled when a group completes
+        std::atomic<bool> stopping;            //!< Set when the pool shuts down
+
+    private:
+
+        TaskPool(const TaskPool&);
+        TaskPool& operator= (const TaskPool&);
+    };
+
+    inline TaskGroup::TaskGroup() :
+        pending(0) {
+
+    }
+
+    inline bool TaskGroup::IsDone() const {
+        return pending.load(std::memory_order_acquire) == 0;
+    }
+
+    inline unsigned TaskPool::GetThreadCount() const {
+        return (unsigned)workers.size();
+    }
+}
+
+#endif	/* TASKPOOL_HPP */
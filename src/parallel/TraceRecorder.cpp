@@ -0,0 +1,205 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TraceRecorder.cpp
+ * 
+ * Per-thread timeline of scoped events exported as Chrome trace JSON
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "TraceRecorder.hpp"
+#include "../utility/ErrorMessage.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        // Events of one thread, written only by that thread
+        struct Ring {
+            std::vector<TraceRecorder::Event> events;
+            std::atomic<std::uint64_t> head;
+            std::string name;
+            int id;
+        };
+
+        // Every ring ever created, kept after its thread exits so the export still sees it
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Ring> > rings;
+            std::size_t capacity;
+            std::chrono::steady_clock::time_point epoch;
+
+            Registry() :
+                capacity(TraceRecorder::defaultCapacity), epoch(std::chrono::steady_clock::now()) {
+
+            }
+        };
+
+        Registry& GetRegistry() {
+            static Registry registry;
+            return registry;
+        }
+
+        thread_local Ring* localRing = 0;
+        thread_local std::string localName;
+
+        Ring* CreateRing() {
+            Registry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            std::unique_ptr<Ring> ring(new Ring());
+            ring->events.resize(registry.capacity);
+            ring->head.store(0, std::memory_order_relaxed);
+            ring->id = (int)registry.rings.size() + 1;
+            ring->name = localName.empty() ? "thread " + std::to_string(ring->id) : localName;
+            localRing = ring.get();
+            registry.rings.push_back(std::move(ring));
+            return localRing;
+        }
+
+        std::size_t RoundUpToPowerOfTwo(std::size_t value) {
+            std::size_t power = 1;
+            while(power < value)
+                power <<= 1;
+            return power;
+        }
+
+        // thread names are the only strings not written as literals by the caller
+        std::string Escape(const std::string& text) {
+            std::string escaped;
+            for(std::size_t i = 0; i < text.size(); i++) {
+                if(text[i] == '"' || text[i] == '\\')
+                    escaped += '\\';
+                if((unsigned char)text[i] >= 0x20)
+                    escaped += text[i];
+            }
+            return escaped;
+        }
+    }
+
+    const std::size_t TraceRecorder::defaultCapacity = 1 << 16;
+    std::atomic<bool> TraceRecorder::enabled(false);
+
+    void TraceRecorder::Enable(std::size_t capacity) {
+        Registry& registry = GetRegistry();
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.capacity = RoundUpToPowerOfTwo(std::max<std::size_t>(capacity, 1));
+            registry.epoch = std::chrono::steady_clock::now();
+            for(std::size_t r = 0; r < registry.rings.size(); r++) {
+                registry.rings[r]->events.assign(registry.capacity, Event());
+                registry.rings[r]->head.store(0, std::memory_order_relaxed);
+            }
+        }
+        enabled.store(true, std::memory_order_release);
+    }
+
+    void TraceRecorder::Disable() {
+        enabled.store(false, std::memory_order_release);
+    }
+
+    std::uint64_t TraceRecorder::Now() {
+        return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - GetRegistry().epoch).count();
+    }
+
+    void TraceRecorder::Record(const Event& event) {
+        Ring* ring = localRing ? localRing : CreateRing();
+        std::uint64_t index = ring->head.load(std::memory_order_relaxed);
+        ring->events[index & (ring->events.size() - 1)] = event;
+        ring->head.store(index + 1, std::memory_order_release);
+    }
+
+    void TraceRecorder::SetThreadName(const std::string& name) {
+        localName = name;
+        if(localRing) {
+            std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+            localRing->name = name;
+        }
+    }
+
+    std::uint64_t TraceRecorder::GetDroppedCount() {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::uint64_t dropped = 0;
+        for(std::size_t r = 0; r < registry.rings.size(); r++) {
+            std::uint64_t head = registry.rings[r]->head.load(std::memory_order_acquire);
+            std::uint64_t capacity = registry.rings[r]->events.size();
+            if(head > capacity)
+                dropped += head - capacity;
+        }
+        return dropped;
+    }
+
+    void TraceRecorder::WriteJson(std::ostream& output) {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        char timing[64];
+        output << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        output << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"scppraytracer\"}}";
+        for(std::size_t r = 0; r < registry.rings.size(); r++) {
+            const Ring& ring = *registry.rings[r];
+            output << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << ring.id
+                   << ", \"args\": {\"name\": \"" << Escape(ring.name) << "\"}}";
+            output << ",\n{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << ring.id
+                   << ", \"args\": {\"sort_index\": " << ring.id << "}}";
+
+            // a full ring holds the newest capacity events starting at the head
+            const std::uint64_t head = ring.head.load(std::memory_order_acquire);
+            const std::uint64_t capacity = ring.events.size();
+            for(std::uint64_t i = head > capacity ? head - capacity : 0; i < head; i++) {
+                const Event& event = ring.events[i & (capacity - 1)];
+                // complete events in microseconds, the unit of the format
+                std::snprintf(timing, sizeof(timing), "\"ts\": %.3f, \"dur\": %.3f", event.begin / 1000.0,
+                              (event.end - event.begin) / 1000.0);
+                output << ",\n{\"name\": \"" << event.name << "\", \"cat\": \"" << event.category
+                       << "\", \"ph\": \"X\", " << timing << ", \"pid\": 1, \"tid\": " << ring.id;
+                if(event.argumentNames[0]) {
+                    output << ", \"args\": {\"" << event.argumentNames[0] << "\": " << event.arguments[0];
+                    if(event.argumentNames[1])
+                        output << ", \"" << event.argumentNames[1] << "\": " << event.arguments[1];
+                    output << "}";
+                }
+                output << "}";
+            }
+        }
+        output << "\n]}\n";
+    }
+
+    bool TraceRecorder::Write(const std::string& path, std::string* error) {
+        std::ofstream output(path.c_str());
+        if(!output)
+            return Fail(error, "cannot open " + path + " for writing");
+        WriteJson(output);
+        output.flush();
+        if(!output)
+            return Fail(error, "cannot write " + path);
+        return true;
+    }
+}
@@ -0,0 +1,174 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TraceRecorder.hpp
+ * 
+ * Per-thread timeline of scoped events exported as Chrome trace JSON
+ * Class and method definitions
+ */
+
+/*!
+ \file TraceRecorder.hpp
+ Header definition for the TraceRecorder class
+ */
+
+#ifndef TRACERECORDER_HPP
+#define	TRACERECORDER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace SCPPR {
+
+    //! Records timed events of every thread for a timeline viewer
+    /*!
+     Each thread appends events to its own ring buffer: Record writes the
+     slot and publishes it with one release store, with no lock and no
+     shared cache line. Buffers are allocated the first time a thread
+     records after Enable. When a ring fills the oldest events are
+     overwritten and counted as dropped.
+
+     While disabled a Scope costs one relaxed load. WriteJson exports the
+     Chrome trace event format, loadable by chrome://tracing or Perfetto;
+     call it once the traced work has finished.
+     */
+    class TraceRecorder {
+
+    public:
+
+        //! One complete event on a thread's timeline
+        struct Event {
+            const char* name;               //!< Event name, a string literal
+            const char* category;           //!< Category used to filter in the viewer
+            std::uint64_t begin;            //!< Start in nanoseconds since Enable
+            std::uint64_t end;              //!< End in nanoseconds since Enable
+            const char* argumentNames[2];   //!< Names of the arguments, null when unused
+            std::int64_t arguments[2];      //!< Argument values shown with the event
+        };
+
+        //! Times the enclosing block as one event
+        /*!
+         Name, category and argument names must outlive the export, string
+         literals in practice.
+         */
+        class Scope {
+
+        public:
+
+            //! Starts timing when recording is enabled
+            Scope(const char* nameArg, const char* categoryArg);
+
+            //! Starts timing an event carrying one or two arguments
+            Scope(const char* nameArg, const char* categoryArg, const char* firstName,
+                  std::int64_t firstValue, const char* secondName = 0, std::int64_t secondValue = 0);
+
+            //! Records the event
+            ~Scope();
+
+        private:
+
+            Event event; //!< Event being timed, name null when disabled
+
+            // Scopes are tied to the block that declares them
+            Scope(const Scope& copy);
+            Scope& operator= (const Scope& copy);
+        };
+
+        //! Starts recording with rings of capacity events per thread
+        /*!
+         Capacity is rounded up to a power of two. Events recorded so far
+         are discarded and timestamps restart at zero. Must not race with
+         threads that are recording.
+         */
+        static void Enable(std::size_t capacity = defaultCapacity);
+
+        //! Stops recording, keeping the recorded events for export
+        static void Disable();
+
+        //! Returns true while events are being recorded
+        static bool IsEnabled();
+
+        //! Returns nanoseconds since Enable
+        static std::uint64_t Now();
+
+        //! Appends event to the calling thread's ring
+        static void Record(const Event& event);
+
+        //! Names the calling thread in exported traces
+        static void SetThreadName(const std::string& name);
+
+        //! Returns the events overwritten because a ring was full
+        static std::uint64_t GetDroppedCount();
+
+        //! Writes every recorded event as Chrome trace event JSON
+        static void WriteJson(std::ostream& output);
+
+        //! Writes the trace to path, returning false and setting error on failure
+        static bool Write(const std::string& path, std::string* error = 0);
+
+        static const std::size_t defaultCapacity; //!< Events per thread unless Enable says otherwise
+
+    private:
+
+        static std::atomic<bool> enabled; //!< Whether scopes record
+    };
+
+    inline bool TraceRecorder::IsEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    inline TraceRecorder::Scope::Scope(const char* nameArg, const char* categoryArg) {
+        event.name = IsEnabled() ? nameArg : 0;
+        if(event.name) {
+            event.category = categoryArg;
+            event.argumentNames[0] = event.argumentNames[1] = 0;
+            event.begin = Now();
+        }
+    }
+
+    inline TraceRecorder::Scope::Scope(const char* nameArg, const char* categoryArg, const char* firstName,
+                                       std::int64_t firstValue, const char* secondName,
+                                       std::int64_t secondValue) {
+        event.name = IsEnabled() ? nameArg : 0;
+        if(event.name) {
+            event.category = categoryArg;
+            event.argumentNames[0] = firstName;
+            event.argumentNames[1] = secondName;
+            event.arguments[0] = firstValue;
+            event.arguments[1] = secondValue;
+            event.begin = Now();
+        }
+    }
+
+    inline TraceRecorder::Scope::~Scope() {
+        if(event.name) {
+            event.end = Now();
+            Record(event);
+        }
+    }
+}
+
+#endif	/* TRACERECORDER_HPP */
@@ -0,0 +1,64 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Camera.cpp
+ * 
+ * Pinhole perspective camera
+ */
+
+#include <cmath>
+#include <iostream>
+
+#include "Camera.hpp"
+
+namespace SCPPR {
+
+    Camera::Camera() :
+        Camera(Point(0.0f, 0.0f, 0.0f), Point(0.0f, 0.0f, -1.0f),
+               Vector(0.0f, 1.0f, 0.0f), 1.5707963f, 1.0f) {
+
+    }
+
+    Camera::Camera(const Point& position, const Point& target, const Vector& up,
+                   float verticalFov, float aspect) :
+        origin(position) {
+        Vector forward = target - position;
+        forward.Normalize();
+        Vector right = forward ^ up;
+        right.Normalize();
+        Vector trueUp = right ^ forward;
+
+        float halfHeight = std::tan(0.5f * verticalFov);
+        float halfWidth = halfHeight * aspect;
+        horizontal = right * (2.0f * halfWidth);
+        vertical = trueUp * (-2.0f * halfHeight);
+        topLeft = forward - right * halfWidth + trueUp * halfHeight;
+    }
+
+    void Camera::DisplayContents() const {
+        origin.DisplayContents();
+        topLeft.DisplayContents();
+        horizontal.DisplayContents();
+        vertical.DisplayContents();
+    }
+}
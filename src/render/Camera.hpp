@@ -0,0 +1,100 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Camera.hpp
+ * 
+ * Pinhole perspective camera
+ * Class and method definitions
+ */
+
+/*!
+ \file Camera.hpp
+ Header definition for the Camera class
+ */
+
+#ifndef CAMERA_HPP
+#define	CAMERA_HPP
+
+#include "../utility/Point.hpp"
+#include "../utility/Ray.hpp"
+#include "../utility/Vector.hpp"
+
+namespace SCPPR {
+
+    //! Pinhole perspective camera
+    /*!
+     Maps normalized image coordinates to primary rays. (0, 0) is the top
+     left corner of the image and (1, 1) the bottom right.
+     */
+    class Camera {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs a camera at the origin looking down -z with a 90 degree
+         vertical field of view and a square image
+         */
+        Camera();
+
+        //! Look at constructor
+        /*!
+         Constructs a camera at position looking towards target. verticalFov
+         is in radians and aspect is the image width over its height.
+         */
+        Camera(const Point& position, const Point& target, const Vector& up,
+               float verticalFov, float aspect);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Returns the primary ray through normalized image position (u, v)
+        Ray GenerateRay(float u, float v) const;
+
+        //! Returns the camera position
+        const Point& GetPosition() const;
+
+        //! Displays the camera frame in the console
+        void DisplayContents() const;
+
+    protected:
+
+        Point origin;       //!< Camera position
+        Vector topLeft;     //!< Direction through the top left image corner
+        Vector horizontal;  //!< Image plane span from left to right
+        Vector vertical;    //!< Image plane span from top to bottom
+    };
+
+    inline Ray Camera::GenerateRay(float u, float v) const {
+        Vector direction = topLeft + horizontal * u + vertical * v;
+        direction.Normalize();
+        return Ray(origin, direction);
+    }
+
+    inline const Point& Camera::GetPosition() const {
+        return origin;
+    }
+}
+
+#endif	/* CAMERA_HPP */
@@ -0,0 +1,83 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Framebuffer.cpp
+ * 
+ * Image of linear colors written by the renderers
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "Framebuffer.hpp"
+
+namespace SCPPR {
+
+    Framebuffer::Framebuffer(int widthArg, int heightArg, int tileSizeArg) :
+        width(widthArg), height(heightArg), tileShift(0) {
+        while((1 << tileShift) < tileSizeArg && tileShift < 15)
+            tileShift++;
+        int tileSize = 1 << tileShift;
+        tilesPerRow = (width + tileSize - 1) / tileSize;
+        int tilesPerColumn = (height + tileSize - 1) / tileSize;
+        pixels.resize((std::size_t)tilesPerRow * tilesPerColumn << (2 * tileShift));
+    }
+
+    unsigned char Framebuffer::EncodeSRGB(float linear) {
+        linear = std::min(std::max(linear, 0.0f), 1.0f);
+        float encoded = linear <= 0.0031308f ? 12.92f * linear
+                                             : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+        return (unsigned char)(encoded * 255.0f + 0.5f);
+    }
+
+    void Framebuffer::Clear(const Color& color) {
+        std::fill(pixels.begin(), pixels.end(), color);
+    }
+
+    void Framebuffer::CopyTile(const Tile& tile, Color* rows) const {
+        for(int y = tile.y0; y < tile.y1; y++)
+            for(int x = tile.x0; x < tile.x1; x++)
+                *rows++ = GetPixel(x, y);
+    }
+
+    bool Framebuffer::WritePPM(const std::string& path) const {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if(!file)
+            return false;
+
+        std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+        std::vector<unsigned char> row((std::size_t)width * 3);
+        bool written = true;
+        for(int y = 0; y < height && written; y++) {
+            for(int x = 0; x < width; x++) {
+                const Color& pixel = GetPixel(x, y);
+                row[3 * x + 0] = EncodeSRGB(pixel.GetRed());
+                row[3 * x + 1] = EncodeSRGB(pixel.GetGreen());
+                row[3 * x + 2] = EncodeSRGB(pixel.GetBlue());
+            }
+            written = std::fwrite(&row[0], 1, row.size(), file) == row.size();
+        }
+        return std::fclose(file) == 0 && written;
+    }
+}
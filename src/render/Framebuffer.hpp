@@ -0,0 +1,164 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Framebuffer.hpp
+ * 
+ * Image of linear colors written by the renderers
+ * Class and method definitions
+ */
+
+/*!
+ \file Framebuffer.hpp
+ Header definition for the Framebuffer class
+ */
+
+#ifndef FRAMEBUFFER_HPP
+#define	FRAMEBUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../utility/Color.hpp"
+
+namespace SCPPR {
+
+    //! Rectangle of pixels rendered and written as one unit
+    struct Tile {
+        int x0; //!< First column
+        int y0; //!< First row
+        int x1; //!< One past the last column
+        int y1; //!< One past the last row
+    };
+
+    //! Image of linear colors stored tile by tile
+    /*!
+     Pixels are stored in square tiles whose edge is a power of two. Tiles
+     follow each other in scanline order and the pixels inside a tile follow
+     a Morton curve, so a render tile of the same size is one contiguous
+     block and neighbouring pixels share cache lines in both directions.
+     Edge tiles are padded to the full tile size.
+
+     The pixel array is allocated once at construction. SetPixel takes no
+     lock: renderer threads write disjoint tiles, so no two threads ever
+     touch the same pixel.
+     */
+    class Framebuffer {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Parameterized constructor
+        /*!
+         Constructs a black image of width by height pixels. The tile edge
+         is tileSizeArg rounded up to a power of two.
+         */
+        Framebuffer(int widthArg, int heightArg, int tileSizeArg = 32);
+
+        // end constructor declarations-----------------------------------------
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the width in pixels
+        int GetWidth() const;
+
+        //! Returns the height in pixels
+        int GetHeight() const;
+
+        //! Returns the storage tile edge length in pixels
+        int GetTileSize() const;
+
+        //! Returns the pixel in column x of row y, row 0 at the top
+        const Color& GetPixel(int x, int y) const;
+
+        //! Sets the pixel in column x of row y
+        void SetPixel(int x, int y, const Color& color);
+
+        // end accessor declarations--------------------------------------------
+
+        //! Sets every pixel to color
+        void Clear(const Color& color);
+
+        //! Copies the pixels of tile into rows, row major with the top row first
+        void CopyTile(const Tile& tile, Color* rows) const;
+
+        //! Writes the image as a binary PPM with sRGB gamma, returns false on failure
+        bool WritePPM(const std::string& path) const;
+
+        //! Converts a linear channel to an 8 bit sRGB value
+        static unsigned char EncodeSRGB(float linear);
+
+    protected:
+
+        //! Returns the storage index of the pixel in column x of row y
+        std::size_t GetIndex(int x, int y) const;
+
+        //! Spreads the low 16 bits of value over the even bits
+        static std::uint32_t SpreadBits(std::uint32_t value);
+
+        int width;                 //!< Width in pixels
+        int height;                //!< Height in pixels
+        int tileShift;             //!< Log2 of the tile edge length
+        int tilesPerRow;           //!< Tiles across the image
+        std::vector<Color> pixels; //!< Tile major, Morton ordered pixels
+    };
+
+    inline int Framebuffer::GetWidth() const {
+        return width;
+    }
+
+    inline int Framebuffer::GetHeight() const {
+        return height;
+    }
+
+    inline int Framebuffer::GetTileSize() const {
+        return 1 << tileShift;
+    }
+
+    inline std::uint32_t Framebuffer::SpreadBits(std::uint32_t value) {
+        value &= 0x0000ffffu;
+        value = (value | (value << 8)) & 0x00ff00ffu;
+        value = (value | (value << 4)) & 0x0f0f0f0fu;
+        value = (value | (value << 2)) & 0x33333333u;
+        value = (value | (value << 1)) & 0x55555555u;
+        return value;
+    }
+
+    inline std::size_t Framebuffer::GetIndex(int x, int y) const {
+        std::size_t tile = (std::size_t)(y >> tileShift) * tilesPerRow + (x >> tileShift);
+        std::uint32_t mask = (1u << tileShift) - 1;
+        return (tile << (2 * tileShift)) + (SpreadBits(x & mask) | (SpreadBits(y & mask) << 1));
+    }
+
+    inline const Color& Framebuffer::GetPixel(int x, int y) const {
+        return pixels[GetIndex(x, y)];
+    }
+
+    inline void Framebuffer::SetPixel(int x, int y, const Color& color) {
+        pixels[GetIndex(x, y)] = color;
+    }
+}
+
+#endif	/* FRAMEBUFFER_HPP */
@@ -0,0 +1,176 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   ProgressiveRenderer.cpp
+ * 
+ * Progressive renderer with per pixel adaptive sampling
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+#include "ProgressiveRenderer.hpp"
+#include "../memory/MemoryArena.hpp"
+#include "../parallel/RenderCounters.hpp"
+#include "../parallel/TaskPool.hpp"
+#include "../parallel/TraceRecorder.hpp"
+
+namespace SCPPR {
+
+    constexpr float ProgressiveRenderer::minimumLuminance;
+
+    ProgressiveRenderer::ProgressiveRenderer(TaskPool& poolArg, const ProgressiveSettings& settingsArg,
+                                             int tileSizeArg) :
+        pool(poolArg), settings(settingsArg), sampler(settingsArg.sampler), tileSize(std::max(tileSizeArg, 1)), width(0) {
+        // the sample cap is the user's, the pass sizes give way to it; every
+        // pixel still takes at least one sample
+        settings.maximumSamples = std::max(settings.maximumSamples, 1);
+        settings.initialSamples = std::min(std::max(settings.initialSamples, 1), settings.maximumSamples);
+        settings.samplesPerPass = std::min(std::max(settings.samplesPerPass, 1), settings.maximumSamples);
+    }
+
+    ProgressiveStatistics ProgressiveRenderer::Render(const Camera& camera,
+                                                      const TileRenderer::RadianceFunction& radiance,
+                                                      Framebuffer& framebuffer,
+                                                      const PassCallback& onPass,
+                                                      const TileRenderer::TileCallback& onTile) {
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+        Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(settings.timeBudget));
+
+        width = framebuffer.GetWidth();
+        PixelState blank = { Color(), 0.0f, 0.0f, 0, true };
+        pixels.assign((std::size_t)width * framebuffer.GetHeight(), blank);
+        std::vector<Tile> tiles = TileRenderer::MakeTiles(width, framebuffer.GetHeight(), tileSize);
+        std::vector<std::size_t> tileActive(tiles.size());
+        for(std::size_t i = 0; i < tiles.size(); i++)
+            tileActive[i] = (std::size_t)(tiles[i].x1 - tiles[i].x0) * (tiles[i].y1 - tiles[i].y0);
+
+        ProgressiveStatistics statistics;
+        std::atomic<std::uint64_t> samples(0);
+        std::atomic<bool> outOfBudget(false);
+        auto budgetSpent = [&]() {
+            return (settings.timeBudget > 0.0 && Clock::now() >= deadline) ||
+                   (settings.sampleBudget > 0 && samples.load() >= settings.sampleBudget);
+        };
+
+        std::size_t activePixels = pixels.size();
+        while(activePixels > 0 && !outOfBudget) {
+            // the first pass always runs to the end so no pixel is left unwritten
+            bool firstPass = statistics.passes == 0;
+            int sampleCount = firstPass ? settings.initialSamples : settings.samplesPerPass;
+
+            TaskGroup group;
+            for(std::size_t i = 0; i < tiles.size(); i++) {
+                if(!tileActive[i])
+                    continue;
+                pool.Submit(group, [&, i, firstPass]() {
+                    if(!firstPass && (outOfBudget.load(std::memory_order_relaxed) || budgetSpent())) {
+                        outOfBudget = true;
+                        return;
+                    }
+                    samples += RenderTile(tiles[i], sampleCount, camera, radiance, framebuffer,
+                                          tileActive[i]);
+                    if(!tileActive[i] && onTile)
+                        onTile(tiles[i]);
+                });
+            }
+            pool.Wait(group);
+
+            activePixels = 0;
+            for(std::size_t active : tileActive)
+                activePixels += active;
+
+            statistics.passes++;
+            statistics.samples = samples;
+            statistics.activePixels = activePixels;
+            statistics.finishedPixels = pixels.size() - activePixels;
+            statistics.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            outOfBudget = outOfBudget || budgetSpent();
+            if(onPass)
+                onPass(statistics);
+        }
+
+        // tiles a budget cut short are final now as well
+        if(onTile)
+            for(std::size_t i = 0; i < tiles.size(); i++)
+                if(tileActive[i])
+                    onTile(tiles[i]);
+        return statistics;
+    }
+
+    std::uint64_t ProgressiveRenderer::RenderTile(const Tile& tile, int sampleCount, const Camera& camera,
+                                                  const TileRenderer::RadianceFunction& radiance,
+                                                  Framebuffer& framebuffer, std::size_t& active) {
+        TraceRecorder::Scope trace("tile", "render", "x", tile.x0, "y", tile.y0);
+        const float inverseWidth = 1.0f / framebuffer.GetWidth();
+        const float inverseHeight = 1.0f / framebuffer.GetHeight();
+        MemoryArena& arena = MemoryArena::GetThreadArena();
+        std::uint64_t taken = 0;
+        active = 0;
+        for(int y = tile.y0; y < tile.y1; y++)
+            for(int x = tile.x0; x < tile.x1; x++) {
+                PixelState& pixel = pixels[(std::size_t)y * width + x];
+                if(!pixel.active)
+                    continue;
+                int count = std::min<int>(sampleCount, settings.maximumSamples - (int)pixel.samples);
+                MemoryArena::Scope positions(arena);
+                SampleBlock block(arena, (std::size_t)count, 2);
+                sampler.Generate(x, y, pixel.samples, (std::size_t)count, 0, block);
+                const float* jitterX = block.GetColumn(0);
+                const float* jitterY = block.GetColumn(1);
+                for(int s = 0; s < count; s++) {
+                    MemoryArena::Scope scratch(arena);
+                    pixel.samples++;
+                    Color sample = radiance(camera.GenerateRay((x + jitterX[s]) * inverseWidth,
+                                                               (y + jitterY[s]) * inverseHeight));
+                    float luminance = sample.GetLuminance();
+                    pixel.sum += sample;
+                    pixel.luminanceSum += luminance;
+                    pixel.luminanceSquaredSum += luminance * luminance;
+                }
+                taken += count;
+                pixel.active = !IsFinished(pixel);
+                active += pixel.active;
+                framebuffer.SetPixel(x, y, pixel.sum / (float)pixel.samples);
+            }
+        RenderCounters::Add(RenderCounters::primaryRays, taken);
+        RenderCounters::Add(RenderCounters::samples, taken);
+        return taken;
+    }
+
+    bool ProgressiveRenderer::IsFinished(const PixelState& pixel) const {
+        if((int)pixel.samples >= settings.maximumSamples)
+            return true;
+        if(pixel.samples < 2)
+            return false;
+        float n = (float)pixel.samples;
+        float mean = pixel.luminanceSum / n;
+        float variance = std::max(0.0f, (pixel.luminanceSquaredSum - mean * pixel.luminanceSum) / (n - 1.0f));
+        float standardError = std::sqrt(variance / n);
+        return standardError <= settings.errorThreshold * std::max(mean, minimumLuminance);
+    }
+}
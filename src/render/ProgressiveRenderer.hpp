@@ -0,0 +1,181 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   ProgressiveRenderer.hpp
+ * 
+ * Progressive renderer with per pixel adaptive sampling
+ * Class and method definitions
+ */
+
+/*!
+ \file ProgressiveRenderer.hpp
+ Header definition for the ProgressiveRenderer class
+ */
+
+#ifndef PROGRESSIVERENDERER_HPP
+#define	PROGRESSIVERENDERER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Camera.hpp"
+#include "Framebuffer.hpp"
+#include "Sampler.hpp"
+#include "TileRenderer.hpp"
+#include "../utility/Color.hpp"
+
+namespace SCPPR {
+
+    class TaskPool;
+
+    //! Limits of a progressive render
+    struct ProgressiveSettings {
+        int initialSamples;          //!< Samples every pixel takes in the first pass
+        int samplesPerPass;          //!< Samples an unconverged pixel takes in later passes
+        int maximumSamples;          //!< Per pixel sample cap
+        float errorThreshold;        //!< Relative standard error a pixel converges below
+        double timeBudget;           //!< Seconds before the render stops, 0 for none
+        std::uint64_t sampleBudget;  //!< Samples over the image before it stops, 0 for none
+        SamplerType sampler;         //!< Sequence the pixel positions are drawn from
+
+        ProgressiveSettings() :
+            initialSamples(4), samplesPerPass(4), maximumSamples(256), errorThreshold(0.01f),
+            timeBudget(0.0), sampleBudget(0), sampler(SamplerType::sobol) {
+
+        }
+    };
+
+    //! Progress of a progressive render after a pass
+    struct ProgressiveStatistics {
+        int passes;                   //!< Passes finished
+        std::uint64_t samples;        //!< Samples taken over the image
+        std::size_t finishedPixels;   //!< Pixels that converged or reached the sample cap
+        std::size_t activePixels;     //!< Pixels still taking samples
+        double seconds;               //!< Wall time since the render started
+
+        ProgressiveStatistics() :
+            passes(0), samples(0), finishedPixels(0), activePixels(0), seconds(0.0) {
+
+        }
+    };
+
+    //! Renders an image in passes, sampling only pixels that have not converged
+    /*!
+     Every pass renders the tiles that still hold active pixels as tasks on
+     the pool. Each active pixel takes a few samples at positions drawn
+     from the settings' sampler, generated a pass at a time, and keeps
+     running sums of color, luminance and squared luminance. A pixel stops
+     once the standard error of its mean luminance falls below
+     errorThreshold times the mean, or when it reaches maximumSamples;
+     means darker than minimumLuminance are compared against
+     minimumLuminance so that black pixels converge as well.
+
+     The framebuffer holds the running mean after every pass. The render
+     ends when no pixel is active, or early when the time or sample budget
+     runs out; a tile already started finishes its pixels. The budgets are
+     only checked from the second pass on, so every pixel gets at least the
+     initial samples.
+     */
+    class ProgressiveRenderer {
+
+    public:
+
+        //! Called after every pass with the framebuffer up to date
+        typedef std::function<void(const ProgressiveStatistics& statistics)> PassCallback;
+
+        //! Floor of the mean in the convergence test
+        static constexpr float minimumLuminance = 0.01f;
+
+        // begin constructor declarations---------------------------------------
+
+        //! Parameterized constructor
+        /*!
+         Constructs a renderer running on pool with square tiles of
+         tileSizeArg pixels
+         */
+        ProgressiveRenderer(TaskPool& poolArg, const ProgressiveSettings& settingsArg,
+                            int tileSizeArg = 32);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Returns the settings
+        const ProgressiveSettings& GetSettings() const;
+
+        //! Renders until every pixel converges or a budget runs out
+        /*!
+         Calls onPass after every pass when it is set. Calls onTile once per
+         tile when it is set: from a worker as soon as every pixel of the
+         tile has finished, or after the last pass for tiles a budget cut
+         short.
+         */
+        ProgressiveStatistics Render(const Camera& camera,
+                                     const TileRenderer::RadianceFunction& radiance,
+                                     Framebuffer& framebuffer,
+                                     const PassCallback& onPass = PassCallback(),
+                                     const TileRenderer::TileCallback& onTile =
+                                         TileRenderer::TileCallback());
+
+        //! Returns the samples taken by the pixel in column x of row y
+        std::uint32_t GetSampleCount(int x, int y) const;
+
+    protected:
+
+        //! Running sums of one pixel
+        struct PixelState {
+            Color sum;                  //!< Sum of sample colors
+            float luminanceSum;         //!< Sum of sample luminance
+            float luminanceSquaredSum;  //!< Sum of squared sample luminance
+            std::uint32_t samples;      //!< Samples taken
+            bool active;                //!< Still taking samples
+        };
+
+        //! Samples the active pixels of a tile, returns the samples taken
+        /*!
+         Sets active to the number of pixels of the tile still active.
+         */
+        std::uint64_t RenderTile(const Tile& tile, int sampleCount, const Camera& camera,
+                                 const TileRenderer::RadianceFunction& radiance,
+                                 Framebuffer& framebuffer, std::size_t& active);
+
+        //! Returns true when the pixel has converged or reached the sample cap
+        bool IsFinished(const PixelState& pixel) const;
+
+        TaskPool& pool;                   //!< Pool the tiles run on
+        ProgressiveSettings settings;     //!< Limits of the render
+        Sampler sampler;                  //!< Positions of the samples within their pixels
+        int tileSize;                     //!< Tile edge length in pixels
+        int width;                        //!< Width of the last render
+        std::vector<PixelState> pixels;   //!< State of every pixel
+    };
+
+    inline const ProgressiveSettings& ProgressiveRenderer::GetSettings() const {
+        return settings;
+    }
+
+    inline std::uint32_t ProgressiveRenderer::GetSampleCount(int x, int y) const {
+        return pixels[(std::size_t)y * width + x].samples;
+    }
+}
+
+#endif	/* PROGRESSIVERENDERER_HPP */
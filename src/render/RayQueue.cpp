@@ -0,0 +1,89 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   RayQueue.cpp
+ * 
+ * Structure-of-arrays queue of path states for the wavefront renderer
+ */
+
+#include <iostream>
+
+#include "RayQueue.hpp"
+
+namespace SCPPR {
+
+    RayQueue::RayQueue(std::size_t capacityArg) :
+        size(0) {
+        Reserve(capacityArg);
+    }
+
+    void RayQueue::Reserve(std::size_t capacity) {
+        originX.resize(capacity);
+        originY.resize(capacity);
+        originZ.resize(capacity);
+        directionX.resize(capacity);
+        directionY.resize(capacity);
+        directionZ.resize(capacity);
+        maximumDistance.resize(capacity);
+        weights.resize(capacity);
+        pixels.resize(capacity);
+        randomStates.resize(capacity);
+        hits.resize(capacity);
+        keys.resize(capacity);
+        Clear();
+    }
+
+    void RayQueue::Clear() {
+        size.store(0, std::memory_order_relaxed);
+    }
+
+    void RayQueue::Permute(const RayQueue& source, const std::uint32_t* order, std::size_t count,
+                           std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            std::uint32_t from = order[i];
+            originX[i] = source.originX[from];
+            originY[i] = source.originY[from];
+            originZ[i] = source.originZ[from];
+            directionX[i] = source.directionX[from];
+            directionY[i] = source.directionY[from];
+            directionZ[i] = source.directionZ[from];
+            maximumDistance[i] = source.maximumDistance[from];
+            weights[i] = source.weights[from];
+            pixels[i] = source.pixels[from];
+            randomStates[i] = source.randomStates[from];
+            hits[i] = source.hits[from];
+            keys[i] = source.keys[from];
+        }
+        size.store(count, std::memory_order_relaxed);
+    }
+
+    std::size_t RayQueue::GetMemoryUsage() const {
+        return GetCapacity() * (7 * sizeof(float) + sizeof(Color) + 3 * sizeof(std::uint32_t) +
+                                sizeof(QueueHit));
+    }
+
+    void RayQueue::DisplayContents() const {
+        std::cout << "RayQueue: " << GetSize() << " of " << GetCapacity() << " rays, "
+                  << GetMemoryUsage() / 1024 << " KiB" << std::endl;
+    }
+}
@@ -0,0 +1,302 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   RayQueue.hpp
+ * 
+ * Structure-of-arrays queue of path states for the wavefront renderer
+ * Class and method definitions
+ */
+
+/*!
+ \file RayQueue.hpp
+ Header definition for the RayQueue class
+ */
+
+#ifndef RAYQUEUE_HPP
+#define	RAYQUEUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../utility/Color.hpp"
+#include "../utility/Float8.hpp"
+#include "../utility/Ray.hpp"
+#include "../utility/RayPacket8.hpp"
+
+namespace SCPPR {
+
+    //! Closest hit of a queued ray, written by the extend stage
+    struct QueueHit {
+        float t;                  //!< Hit distance, infinity on a miss
+        std::uint32_t primitive;  //!< Primitive that was hit
+        std::uint32_t instance;   //!< Instance that was hit
+        float u;                  //!< First barycentric coordinate
+        float v;                  //!< Second barycentric coordinate
+        std::uint32_t material;   //!< Bin the shade stage groups hits by
+
+        QueueHit() :
+            t(std::numeric_limits<float>::infinity()), primitive(0), instance(0), u(0.0f),
+            v(0.0f), material(0) {
+
+        }
+    };
+
+    //! Fixed capacity queue of rays and the paths they belong to
+    /*!
+     Ray origins and directions are kept as six separate float columns so
+     that eight neighbouring rays load straight into a RayPacket8. The rest
+     of a path's state lives in parallel columns indexed the same way.
+     Claim hands out ranges of slots to many threads at once; everything
+     else expects the caller to keep threads on disjoint slots.
+     */
+    class RayQueue {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Parameterized constructor
+        /*!
+         Constructs an empty queue with room for capacityArg rays
+         */
+        explicit RayQueue(std::size_t capacityArg = 0);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Sets the capacity to capacity rays and empties the queue
+        void Reserve(std::size_t capacity);
+
+        //! Empties the queue, keeping its capacity
+        void Clear();
+
+        //! Reserves count consecutive slots, returns the first
+        /*!
+         Safe to call from many threads at once. The caller must fill every
+         slot it claims. Claiming past the capacity is an error the caller
+         avoids by sizing the queue for the largest wave.
+         */
+        std::size_t Claim(std::size_t count);
+
+        //! Copies count rays of source into this queue in the given order
+        /*!
+         Slot i of this queue takes slot order[i] of source. Slots
+         [begin, end) are copied, so disjoint ranges may be copied in
+         parallel; the size becomes count.
+         */
+        void Permute(const RayQueue& source, const std::uint32_t* order, std::size_t count,
+                     std::size_t begin, std::size_t end);
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the number of queued rays
+        std::size_t GetSize() const;
+
+        //! Returns the number of rays the queue can hold
+        std::size_t GetCapacity() const;
+
+        //! Returns true when no rays are queued
+        bool IsEmpty() const;
+
+        //! Returns ray index
+        Ray GetRay(std::size_t index) const;
+
+        //! Returns rays index to index + 7 as a packet
+        /*!
+         Lanes past the size hold stale rays and lanes past the capacity
+         repeat ray index, so callers mask every lane past the size.
+         */
+        RayPacket8 GetPacket(std::size_t index) const;
+
+        //! Replaces ray index
+        void SetRay(std::size_t index, const Ray& ray);
+
+        //! Returns the longest distance ray index is traced to
+        float GetMaximumDistance(std::size_t index) const;
+
+        //! Sets the longest distance ray index is traced to
+        void SetMaximumDistance(std::size_t index, float distance);
+
+        //! Returns the path throughput or shadow ray contribution of slot index
+        const Color& GetWeight(std::size_t index) const;
+
+        //! Sets the path throughput or shadow ray contribution of slot index
+        void SetWeight(std::size_t index, const Color& weight);
+
+        //! Returns the pixel slot index belongs to
+        std::uint32_t GetPixel(std::size_t index) const;
+
+        //! Sets the pixel slot index belongs to
+        void SetPixel(std::size_t index, std::uint32_t pixel);
+
+        //! Returns the random number state of the path in slot index
+        std::uint32_t& GetRandomState(std::size_t index);
+
+        //! Returns the hit of ray index
+        const QueueHit& GetHit(std::size_t index) const;
+
+        //! Returns the hit of ray index for writing
+        QueueHit& GetHit(std::size_t index);
+
+        //! Returns the sort key of slot index
+        std::uint32_t GetKey(std::size_t index) const;
+
+        //! Sets the sort key of slot index
+        void SetKey(std::size_t index, std::uint32_t key);
+
+        //! Returns the sort keys of every slot
+        const std::uint32_t* GetKeys() const;
+
+        //! Returns the bytes held by the columns
+        std::size_t GetMemoryUsage() const;
+
+        // end accessor declarations--------------------------------------------
+
+        //! Displays the size and capacity in the console
+        void DisplayContents() const;
+
+    protected:
+
+        std::vector<float> originX;               //!< Origin x of every ray
+        std::vector<float> originY;               //!< Origin y of every ray
+        std::vector<float> originZ;               //!< Origin z of every ray
+        std::vector<float> directionX;            //!< Direction x of every ray
+        std::vector<float> directionY;            //!< Direction y of every ray
+        std::vector<float> directionZ;            //!< Direction z of every ray
+        std::vector<float> maximumDistance;       //!< Distance every ray is traced to
+        std::vector<Color> weights;               //!< Throughput or contribution
+        std::vector<std::uint32_t> pixels;        //!< Pixel of every path
+        std::vector<std::uint32_t> randomStates;  //!< Random number state of every path
+        std::vector<QueueHit> hits;               //!< Closest hit of every ray
+        std::vector<std::uint32_t> keys;          //!< Sort key of every slot
+        std::atomic<std::size_t> size;            //!< Slots claimed so far
+
+    private:
+
+        //! Private copy constructor
+        RayQueue(const RayQueue&);
+
+        //! Private assignment operator
+        RayQueue& operator= (const RayQueue&);
+    };
+
+    inline std::size_t RayQueue::Claim(std::size_t count) {
+        return size.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    inline std::size_t RayQueue::GetSize() const {
+        return size.load(std::memory_order_relaxed);
+    }
+
+    inline std::size_t RayQueue::GetCapacity() const {
+        return pixels.size();
+    }
+
+    inline bool RayQueue::IsEmpty() const {
+        return GetSize() == 0;
+    }
+
+    inline Ray RayQueue::GetRay(std::size_t index) const {
+        return Ray(Point(originX[index], originY[index], originZ[index]),
+                   Vector(directionX[index], directionY[index], directionZ[index]));
+    }
+
+    inline RayPacket8 RayQueue::GetPacket(std::size_t index) const {
+        if(index + 8 <= GetCapacity())
+            return RayPacket8(PointPacket8(Float8::LoadUnaligned(&originX[index]),
+                                           Float8::LoadUnaligned(&originY[index]),
+                                           Float8::LoadUnaligned(&originZ[index])),
+                              VectorPacket8(Float8::LoadUnaligned(&directionX[index]),
+                                            Float8::LoadUnaligned(&directionY[index]),
+                                            Float8::LoadUnaligned(&directionZ[index])));
+        // the last few slots of a full queue, assembled a lane at a time
+        Point origins[8];
+        Vector directions[8];
+        for(int lane = 0; lane < 8; lane++) {
+            Ray ray = GetRay(index + lane < GetCapacity() ? index + lane : index);
+            origins[lane] = ray.GetOrigin();
+            directions[lane] = ray.GetDirection();
+        }
+        return RayPacket8::Gather(origins, directions);
+    }
+
+    inline void RayQueue::SetRay(std::size_t index, const Ray& ray) {
+        originX[index] = ray.GetOrigin().GetX();
+        originY[index] = ray.GetOrigin().GetY();
+        originZ[index] = ray.GetOrigin().GetZ();
+        directionX[index] = ray.GetDirection().GetX();
+        directionY[index] = ray.GetDirection().GetY();
+        directionZ[index] = ray.GetDirection().GetZ();
+    }
+
+    inline float RayQueue::GetMaximumDistance(std::size_t index) const {
+        return maximumDistance[index];
+    }
+
+    inline void RayQueue::SetMaximumDistance(std::size_t index, float distance) {
+        maximumDistance[index] = distance;
+    }
+
+    inline const Color& RayQueue::GetWeight(std::size_t index) const {
+        return weights[index];
+    }
+
+    inline void RayQueue::SetWeight(std::size_t index, const Color& weight) {
+        weights[index] = weight;
+    }
+
+    inline std::uint32_t RayQueue::GetPixel(std::size_t index) const {
+        return pixels[index];
+    }
+
+    inline void RayQueue::SetPixel(std::size_t index, std::uint32_t pixel) {
+        pixels[index] = pixel;
+    }
+
+    inline std::uint32_t& RayQueue::GetRandomState(std::size_t index) {
+        return randomStates[index];
+    }
+
+    inline const QueueHit& RayQueue::GetHit(std::size_t index) const {
+        return hits[index];
+    }
+
+    inline QueueHit& RayQueue::GetHit(std::size_t index) {
+        return hits[index];
+    }
+
+    inline std::uint32_t RayQueue::GetKey(std::size_t index) const {
+        return keys[index];
+    }
+
+    inline void RayQueue::SetKey(std::size_t index, std::uint32_t key) {
+        keys[index] = key;
+    }
+
+    inline const std::uint32_t* RayQueue::GetKeys() const {
+        return keys.data();
+    }
+}
+
+#endif	/* RAYQUEUE_HPP */
@@ -0,0 +1,125 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   RenderStatistics.cpp
+ * 
+ * Render counter totals and their reports
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include "RenderStatistics.hpp"
+
+namespace SCPPR {
+
+    RenderStatistics::RenderStatistics() :
+        totals(RenderCounters::counterCount, 0), seconds(0.0), pixels(0) {
+
+    }
+
+    RenderStatistics RenderStatistics::Collect(double seconds, std::size_t pixels) {
+        RenderStatistics statistics;
+        statistics.threads = RenderCounters::Gather();
+        statistics.seconds = seconds;
+        statistics.pixels = pixels;
+        for(std::size_t t = 0; t < statistics.threads.size(); t++)
+            for(int i = 0; i < RenderCounters::counterCount; i++)
+                statistics.totals[i] += statistics.threads[t][i];
+        return statistics;
+    }
+
+    std::uint64_t RenderStatistics::GetTotal(RenderCounters::Counter counter) const {
+        return totals[counter];
+    }
+
+    std::uint64_t RenderStatistics::GetRays() const {
+        return totals[RenderCounters::primaryRays] + totals[RenderCounters::bounceRays] +
+               totals[RenderCounters::shadowRays];
+    }
+
+    double RenderStatistics::GetSamplesPerPixel() const {
+        return pixels > 0 ? (double)totals[RenderCounters::samples] / pixels : 0.0;
+    }
+
+    const std::vector<std::vector<std::uint64_t> >& RenderStatistics::GetThreads() const {
+        return threads;
+    }
+
+    void RenderStatistics::DisplayContents() const {
+        const double rays = (double)std::max<std::uint64_t>(GetRays(), 1);
+        const std::ios_base::fmtflags flags = std::cout.flags();
+        const std::streamsize precision = std::cout.precision();
+        std::cout << std::left << std::setw(16) << "counter" << std::right << " " << std::setw(16) << "total"
+                  << " " << std::setw(14) << "per second" << " " << std::setw(12) << "per ray" << std::endl;
+        for(int i = 0; i < RenderCounters::counterCount; i++)
+            std::cout << std::left << std::setw(16) << RenderCounters::GetName((RenderCounters::Counter)i)
+                      << std::right << " " << std::setw(16) << totals[i] << " " << std::defaultfloat
+                      << std::setprecision(4) << std::setw(14) << (seconds > 0.0 ? totals[i] / seconds : 0.0) << " "
+                      << std::fixed << std::setprecision(3) << std::setw(12) << totals[i] / rays << std::endl;
+        std::cout << std::left << std::setw(16) << "rays" << std::right << " " << std::setw(16) << GetRays()
+                  << " " << std::defaultfloat << std::setprecision(4) << std::setw(14)
+                  << (seconds > 0.0 ? GetRays() / seconds : 0.0) << std::endl;
+        std::cout << std::left << std::setw(16) << "samples/pixel" << std::right << " " << std::fixed
+                  << std::setprecision(2) << std::setw(16) << GetSamplesPerPixel() << std::endl;
+
+        // rays per thread show how evenly the work spread
+        std::cout << std::left << std::setw(16) << "thread rays" << std::right;
+        for(std::size_t t = 0; t < threads.size(); t++) {
+            const std::vector<std::uint64_t>& counts = threads[t];
+            std::uint64_t threadRays = counts[RenderCounters::primaryRays] +
+                                       counts[RenderCounters::bounceRays] +
+                                       counts[RenderCounters::shadowRays];
+            if(t + 1 < threads.size() || threadRays > 0)
+                std::cout << " " << threadRays;
+        }
+        std::cout << std::endl;
+        std::cout.flags(flags);
+        std::cout.precision(precision);
+    }
+
+    void RenderStatistics::WriteJson(std::ostream& output) const {
+        output << "{\n";
+        output << "  \"seconds\": " << seconds << ",\n";
+        output << "  \"pixels\": " << pixels << ",\n";
+        output << "  \"rays\": " << GetRays() << ",\n";
+        output << "  \"samples_per_pixel\": " << GetSamplesPerPixel() << ",\n";
+        output << "  \"totals\": {";
+        for(int i = 0; i < RenderCounters::counterCount; i++)
+            output << (i ? ", " : "") << "\"" << RenderCounters::GetName((RenderCounters::Counter)i) << "\": "
+                   << totals[i];
+        output << "},\n";
+        // the last entry holds the counts of threads that already exited
+        output << "  \"threads\": [\n";
+        for(std::size_t t = 0; t < threads.size(); t++) {
+            output << "    {";
+            for(int i = 0; i < RenderCounters::counterCount; i++)
+                output << (i ? ", " : "") << "\"" << RenderCounters::GetName((RenderCounters::Counter)i) << "\": "
+                       << threads[t][i];
+            output << (t + 1 < threads.size() ? "},\n" : "}\n");
+        }
+        output << "  ]\n";
+        output << "}\n";
+    }
+}
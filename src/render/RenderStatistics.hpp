@@ -0,0 +1,100 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   RenderStatistics.hpp
+ * 
+ * Render counter totals and their reports
+ * Class and method definitions
+ */
+
+/*!
+ \file RenderStatistics.hpp
+ Header definition for the RenderStatistics class
+ */
+
+#ifndef RENDERSTATISTICS_HPP
+#define	RENDERSTATISTICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "../parallel/RenderCounters.hpp"
+
+namespace SCPPR {
+
+    //! Totals of the render counters with a table and JSON report
+    class RenderStatistics {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs empty statistics
+         */
+        RenderStatistics();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Takes the current counts of every thread
+        /*!
+         seconds is the wall time of the render and pixels its pixel count,
+         used for the rates and the samples per pixel.
+         */
+        static RenderStatistics Collect(double seconds, std::size_t pixels);
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the total of counter over every thread
+        std::uint64_t GetTotal(RenderCounters::Counter counter) const;
+
+        //! Returns every ray traced, of any type
+        std::uint64_t GetRays() const;
+
+        //! Returns the mean samples per pixel
+        double GetSamplesPerPixel() const;
+
+        //! Returns the counts of every thread, retired threads last
+        const std::vector<std::vector<std::uint64_t> >& GetThreads() const;
+
+        // end accessor declarations--------------------------------------------
+
+        //! Displays the totals, rates and per thread rays as a table
+        void DisplayContents() const;
+
+        //! Writes the totals and per thread counts as JSON
+        void WriteJson(std::ostream& output) const;
+
+    protected:
+
+        std::vector<std::uint64_t> totals;                  //!< Sum over threads per counter
+        std::vector<std::vector<std::uint64_t> > threads;   //!< Counts per thread
+        double seconds;                                     //!< Wall time of the render
+        std::size_t pixels;                                 //!< Pixels in the image
+    };
+}
+
+#endif	/* RENDERSTATISTICS_HPP */
@@ -0,0 +1,449 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Sampler.cpp
+ * 
+ * Low-discrepancy sample sequences and tile sized sample blocks
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Sampler.hpp"
+#include "../memory/MemoryArena.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        // largest float below one
+        const float oneMinusEpsilon = 0.99999994f;
+
+        std::uint32_t Mix(std::uint32_t h) {
+            h ^= h >> 16;
+            h *= 0x7feb352du;
+            h ^= h >> 15;
+            h *= 0x846ca68bu;
+            h ^= h >> 16;
+            return h;
+        }
+
+        std::uint32_t Hash(std::uint32_t a, std::uint32_t b) {
+            return Mix(a ^ Mix(b + 0x9e3779b9u));
+        }
+
+        // the hash the progressive renderer jittered with before there were samplers
+        std::uint32_t HashSample(std::uint32_t x, std::uint32_t y, std::uint32_t sample, std::uint32_t dimension,
+                                 std::uint32_t seed) {
+            return Mix(x * 0x8da6b343u ^ y * 0xd8163841u ^ sample * 0xcb1ab31fu ^ dimension * 0x165667b1u ^
+                       seed * 0x9e3779b9u);
+        }
+
+        // maps 32 bits to [0, 1)
+        float ToUnitFloat(std::uint32_t bits) {
+            return (bits >> 8) * (1.0f / 16777216.0f);
+        }
+
+        // adds a toroidal shift to a number in [0, 1)
+        float Rotate(float value, float shift) {
+            value += shift;
+            value -= value >= 1.0f ? 1.0f : 0.0f;
+            return std::min(value, oneMinusEpsilon);
+        }
+
+        std::uint32_t ReverseBits(std::uint32_t bits) {
+            bits = (bits << 16) | (bits >> 16);
+            bits = ((bits & 0x00ff00ffu) << 8) | ((bits & 0xff00ff00u) >> 8);
+            bits = ((bits & 0x0f0f0f0fu) << 4) | ((bits & 0xf0f0f0f0u) >> 4);
+            bits = ((bits & 0x33333333u) << 2) | ((bits & 0xccccccccu) >> 2);
+            bits = ((bits & 0x55555555u) << 1) | ((bits & 0xaaaaaaaau) >> 1);
+            return bits;
+        }
+
+        // hash based Owen scramble: each bit flips by a hash of the bits above it
+        std::uint32_t OwenScramble(std::uint32_t bits, std::uint32_t seed) {
+            bits = ReverseBits(bits);
+            bits += seed;
+            bits ^= bits * 0x6c50b47cu;
+            bits ^= bits * 0xb82f1e52u;
+            bits ^= bits * 0xc7afe638u;
+            bits ^= bits * 0x8d22f6e6u;
+            return ReverseBits(bits);
+        }
+
+        // Sobol direction numbers of the first four Joe and Kuo dimensions
+        struct SobolTable {
+            std::uint32_t directions[Sampler::sobolBits][Sampler::sobolDimensions];
+            // xor of the direction numbers selected by every value of every index byte
+            std::uint32_t bytes[Sampler::sobolBits / 8][256][Sampler::sobolDimensions];
+
+            SobolTable() {
+                // degree, coefficients and initial numbers of each primitive polynomial
+                static const int degrees[Sampler::sobolDimensions] = { 0, 1, 2, 3 };
+                static const std::uint32_t coefficients[Sampler::sobolDimensions] = { 0, 0, 1, 1 };
+                static const std::uint32_t initial[Sampler::sobolDimensions][3] = {
+                    { 0, 0, 0 }, { 1, 0, 0 }, { 1, 3, 0 }, { 1, 3, 1 } };
+
+                for(int k = 0; k < Sampler::sobolBits; k++)
+                    directions[k][0] = 1u << (31 - k);
+                for(int d = 1; d < Sampler::sobolDimensions; d++) {
+                    const int s = degrees[d];
+                    for(int k = 0; k < Sampler::sobolBits; k++) {
+                        if(k < s) {
+                            directions[k][d] = initial[d][k] << (31 - k);
+                            continue;
+                        }
+                        std::uint32_t v = directions[k - s][d] ^ (directions[k - s][d] >> s);
+                        for(int j = 1; j < s; j++)
+                            if((coefficients[d] >> (s - 1 - j)) & 1u)
+                                v ^= directions[k - j][d];
+                        directions[k][d] = v;
+                    }
+                }
+                for(int b = 0; b < Sampler::sobolBits / 8; b++)
+                    for(int value = 0; value < 256; value++)
+                        for(int d = 0; d < Sampler::sobolDimensions; d++) {
+                            std::uint32_t v = 0;
+                            for(int k = 0; k < 8; k++)
+                                if((value >> k) & 1)
+                                    v ^= directions[8 * b + k][d];
+                            bytes[b][value][d] = v;
+                        }
+            }
+        };
+
+        // primes and fixed digit permutations of the Halton dimensions
+        struct HaltonTable {
+            int primes[Sampler::haltonDimensions];
+            std::uint32_t offsets[Sampler::haltonDimensions];
+            std::vector<std::uint16_t> permutations;
+
+            HaltonTable() {
+                int count = 0;
+                for(int candidate = 2; count < Sampler::haltonDimensions; candidate++) {
+                    bool prime = true;
+                    for(int i = 0; i < count && primes[i] * primes[i] <= candidate; i++)
+                        if(candidate % primes[i] == 0) {
+                            prime = false;
+                            break;
+                        }
+                    if(prime)
+                        primes[count++] = candidate;
+                }
+                // zero keeps its place so the endless trailing zero digits stay zero
+                std::mt19937 generator(0x5eed);
+                for(int d = 0; d < Sampler::haltonDimensions; d++) {
+                    offsets[d] = (std::uint32_t)permutations.size();
+                    for(int digit = 0; digit < primes[d]; digit++)
+                        permutations.push_back((std::uint16_t)digit);
+                    if(d > 0)
+                        std::shuffle(permutations.begin() + offsets[d] + 1, permutations.end(), generator);
+                }
+            }
+
+            float RadicalInverse(int dimension, std::uint32_t index) const {
+                const std::uint32_t base = (std::uint32_t)primes[dimension];
+                const std::uint16_t* permutation = &permutations[offsets[dimension]];
+                std::uint64_t reversed = 0;
+                double scale = 1.0;
+                while(index != 0) {
+                    std::uint32_t next = index / base;
+                    reversed = reversed * base + permutation[index - next * base];
+                    scale /= base;
+                    index = next;
+                }
+                return std::min((float)(reversed * scale), oneMinusEpsilon);
+            }
+        };
+
+        // void and cluster dither mask, every value once
+        struct BlueNoiseMask {
+            float values[Sampler::blueNoiseSize * Sampler::blueNoiseSize];
+
+            BlueNoiseMask() {
+                const int size = Sampler::blueNoiseSize, count = size * size;
+                const float sigma = 1.9f;
+                std::vector<float> kernel(count);
+                for(int y = 0; y < size; y++)
+                    for(int x = 0; x < size; x++) {
+                        float dx = (float)std::min(x, size - x), dy = (float)std::min(y, size - y);
+                        kernel[y * size + x] = std::exp(-(dx * dx + dy * dy) / (2.0f * sigma * sigma));
+                    }
+
+                std::vector<float> energy(count, 0.0f);
+                std::vector<char> set(count, 0);
+                auto toggle = [&](int pixel, bool on) {
+                    const int px = pixel % size, py = pixel / size;
+                    const float sign = on ? 1.0f : -1.0f;
+                    set[pixel] = on;
+                    for(int y = 0; y < size; y++) {
+                        const float* row = &kernel[((y - py) & (size - 1)) * size];
+                        for(int x = 0; x < size; x++)
+                            energy[y * size + x] += sign * row[(x - px) & (size - 1)];
+                    }
+                };
+                // the set pixel with the most set neighbours, or the empty one with the fewest
+                auto find = [&](bool tightestCluster) {
+                    int best = -1;
+                    for(int i = 0; i < count; i++)
+                        if((set[i] != 0) == tightestCluster &&
+                           (best < 0 || (tightestCluster ? energy[i] > energy[best] : energy[i] < energy[best])))
+                            best = i;
+                    return best;
+                };
+
+                // a random tenth of the pixels, then moved until evenly spread
+                std::mt19937 generator(0xb1ee);
+                std::uniform_int_distribution<int> pick(0, count - 1);
+                const int initialCount = count / 10;
+                for(int placed = 0; placed < initialCount;) {
+                    int pixel = pick(generator);
+                    if(!set[pixel]) {
+                        toggle(pixel, true);
+                        placed++;
+                    }
+                }
+                for(int iteration = 0; iteration < count; iteration++) {
+                    int cluster = find(true);
+                    toggle(cluster, false);
+                    int hole = find(false);
+                    toggle(hole, true);
+                    if(hole == cluster)
+                        break;
+                }
+
+                // ranks below the initial pattern come from taking it apart, the rest from filling voids
+                std::vector<int> rank(count);
+                std::vector<float> initialEnergy = energy;
+                std::vector<char> initialSet = set;
+                for(int r = initialCount - 1; r >= 0; r--) {
+                    int cluster = find(true);
+                    toggle(cluster, false);
+                    rank[cluster] = r;
+                }
+                energy = initialEnergy;
+                set = initialSet;
+                for(int r = initialCount; r < count; r++) {
+                    int hole = find(false);
+                    toggle(hole, true);
+                    rank[hole] = r;
+                }
+                for(int i = 0; i < count; i++)
+                    values[i] = ((float)rank[i] + 0.5f) / (float)count;
+            }
+        };
+
+        const SobolTable& GetSobolTable() {
+            static const SobolTable table;
+            return table;
+        }
+
+        const HaltonTable& GetHaltonTable() {
+            static const HaltonTable table;
+            return table;
+        }
+
+        const BlueNoiseMask& GetBlueNoiseMask() {
+            static const BlueNoiseMask mask;
+            return mask;
+        }
+
+        // seeds of the index shuffle of a Sobol run and the scramble of a dimension
+        std::uint32_t RunSeed(std::uint32_t pixelSeed, int run) {
+            return Hash(pixelSeed, 2u * (std::uint32_t)run);
+        }
+
+        std::uint32_t DimensionSeed(std::uint32_t pixelSeed, int dimension) {
+            return Hash(pixelSeed, 2u * (std::uint32_t)dimension + 1u);
+        }
+
+        // mask offset of a dimension along the R2 sequence, so dimensions see unrelated parts of the mask
+        void MaskOffset(int dimension, int& x, int& y) {
+            float fx = 0.5f + 0.7548776662f * (float)dimension, fy = 0.5f + 0.5698402910f * (float)dimension;
+            x = (int)((fx - std::floor(fx)) * Sampler::blueNoiseSize);
+            y = (int)((fy - std::floor(fy)) * Sampler::blueNoiseSize);
+        }
+
+        // all four dimensions of Sobol point index, a table lookup per index byte
+        void SobolPoint(std::uint32_t index, std::uint32_t bits[Sampler::sobolDimensions]) {
+            const SobolTable& table = GetSobolTable();
+            const std::uint32_t* b0 = table.bytes[0][index & 0xffu];
+            const std::uint32_t* b1 = table.bytes[1][(index >> 8) & 0xffu];
+            const std::uint32_t* b2 = table.bytes[2][(index >> 16) & 0xffu];
+            const std::uint32_t* b3 = table.bytes[3][index >> 24];
+            for(int d = 0; d < Sampler::sobolDimensions; d++)
+                bits[d] = b0[d] ^ b1[d] ^ b2[d] ^ b3[d];
+        }
+    }
+
+    const int SampleBlock::maximumDimensions;
+    const int Sampler::sobolDimensions;
+    const int Sampler::sobolBits;
+    const int Sampler::haltonDimensions;
+    const int Sampler::blueNoiseSize;
+
+    SampleBlock::SampleBlock(MemoryArena& arena, std::size_t capacityArg, int dimensionCountArg) :
+        size(0), capacity(capacityArg),
+        dimensionCount(std::min(std::max(dimensionCountArg, 1), (int)maximumDimensions)) {
+        // whole packets of eight, so the last samples load like the rest
+        const std::size_t padded = (capacity + 7) & ~(std::size_t)7;
+        for(int d = 0; d < maximumDimensions; d++)
+            columns[d] = d < dimensionCount ? static_cast<float*>(arena.Allocate(padded * sizeof(float), 32)) : 0;
+    }
+
+    Sampler::Sampler(SamplerType typeArg, std::uint32_t seedArg) :
+        type(typeArg), seed(seedArg) {
+
+    }
+
+    std::uint32_t Sampler::GetPixelSeed(int x, int y) const {
+        // the blue noise variant scrambles every pixel alike, the mask decorrelates them
+        if(type == SamplerType::blueNoise)
+            return Hash(seed, 0xb1ee);
+        return Hash(Hash((std::uint32_t)x, (std::uint32_t)y), seed);
+    }
+
+    float Sampler::Get(int x, int y, std::uint32_t index, int dimension) const {
+        switch(type) {
+            case SamplerType::sobol:
+            case SamplerType::blueNoise: {
+                const std::uint32_t pixelSeed = GetPixelSeed(x, y);
+                std::uint32_t bits[sobolDimensions];
+                SobolPoint(OwenScramble(index, RunSeed(pixelSeed, dimension / sobolDimensions)), bits);
+                float value = ToUnitFloat(OwenScramble(bits[dimension % sobolDimensions],
+                                                       DimensionSeed(pixelSeed, dimension)));
+                if(type == SamplerType::blueNoise) {
+                    int offsetX, offsetY;
+                    MaskOffset(dimension, offsetX, offsetY);
+                    value = Rotate(value, GetBlueNoise(x + offsetX, y + offsetY));
+                }
+                return value;
+            }
+            case SamplerType::halton:
+                if(dimension < haltonDimensions)
+                    return Rotate(GetHaltonTable().RadicalInverse(dimension, index),
+                                  ToUnitFloat(DimensionSeed(GetPixelSeed(x, y), dimension)));
+                break;
+            case SamplerType::independent:
+                break;
+        }
+        return ToUnitFloat(HashSample((std::uint32_t)x, (std::uint32_t)y, index, (std::uint32_t)dimension, seed));
+    }
+
+    bool Sampler::Generate(int x, int y, std::uint32_t firstIndex, std::size_t count, int firstDimension,
+                           SampleBlock& block) const {
+        std::size_t first;
+        if(!block.Append(count, first))
+            return false;
+        const int dimensionCount = block.GetDimensionCount();
+        const std::uint32_t pixelSeed = GetPixelSeed(x, y);
+
+        for(int d = 0; d < dimensionCount;) {
+            const int dimension = firstDimension + d;
+            if(type == SamplerType::sobol || type == SamplerType::blueNoise) {
+                // the dimensions of one run share the index shuffle and one walk over the direction numbers
+                const int inRun = dimension % sobolDimensions;
+                const int width = std::min(sobolDimensions - inRun, dimensionCount - d);
+                const std::uint32_t runSeed = RunSeed(pixelSeed, dimension / sobolDimensions);
+                std::uint32_t scrambles[sobolDimensions];
+                float shifts[sobolDimensions] = { 0.0f, 0.0f, 0.0f, 0.0f };
+                float* columns[sobolDimensions];
+                for(int w = 0; w < width; w++) {
+                    scrambles[w] = DimensionSeed(pixelSeed, dimension + w);
+                    columns[w] = block.GetColumn(d + w) + first;
+                    if(type == SamplerType::blueNoise) {
+                        int offsetX, offsetY;
+                        MaskOffset(dimension + w, offsetX, offsetY);
+                        shifts[w] = GetBlueNoise(x + offsetX, y + offsetY);
+                    }
+                }
+                for(std::size_t s = 0; s < count; s++) {
+                    std::uint32_t bits[sobolDimensions];
+                    SobolPoint(OwenScramble(firstIndex + (std::uint32_t)s, runSeed), bits);
+                    for(int w = 0; w < width; w++)
+                        columns[w][s] = Rotate(ToUnitFloat(OwenScramble(bits[inRun + w], scrambles[w])), shifts[w]);
+                }
+                d += width;
+                continue;
+            }
+
+            float* column = block.GetColumn(d) + first;
+            if(type == SamplerType::halton && dimension < haltonDimensions) {
+                const HaltonTable& table = GetHaltonTable();
+                const float shift = ToUnitFloat(DimensionSeed(pixelSeed, dimension));
+                for(std::size_t s = 0; s < count; s++)
+                    column[s] = Rotate(table.RadicalInverse(dimension, firstIndex + (std::uint32_t)s), shift);
+            }
+            else {
+                for(std::size_t s = 0; s < count; s++)
+                    column[s] = ToUnitFloat(HashSample((std::uint32_t)x, (std::uint32_t)y,
+                                                       firstIndex + (std::uint32_t)s, (std::uint32_t)dimension, seed));
+            }
+            d++;
+        }
+        return true;
+    }
+
+    bool Sampler::GenerateTile(const Tile& tile, std::uint32_t firstIndex, int samplesPerPixel, int firstDimension,
+                               SampleBlock& block) const {
+        const std::size_t count = (std::size_t)(tile.x1 - tile.x0) * (tile.y1 - tile.y0) * samplesPerPixel;
+        if(count > block.GetCapacity() - block.GetSize())
+            return false;
+        for(int y = tile.y0; y < tile.y1; y++)
+            for(int x = tile.x0; x < tile.x1; x++)
+                Generate(x, y, firstIndex, (std::size_t)samplesPerPixel, firstDimension, block);
+        return true;
+    }
+
+    const char* Sampler::GetName(SamplerType type) {
+        switch(type) {
+            case SamplerType::independent:
+                return "independent";
+            case SamplerType::halton:
+                return "halton";
+            case SamplerType::sobol:
+                return "sobol";
+            case SamplerType::blueNoise:
+                return "bluenoise";
+        }
+        return "unknown";
+    }
+
+    bool Sampler::Parse(const std::string& name, SamplerType& type) {
+        static const SamplerType types[] = { SamplerType::independent, SamplerType::halton, SamplerType::sobol,
+                                             SamplerType::blueNoise };
+        for(SamplerType candidate : types)
+            if(name == GetName(candidate)) {
+                type = candidate;
+                return true;
+            }
+        return false;
+    }
+
+    float Sampler::GetBlueNoise(int x, int y) {
+        const int mask = blueNoiseSize - 1;
+        return GetBlueNoiseMask().values[(y & mask) * blueNoiseSize + (x & mask)];
+    }
+}
@@ -0,0 +1,257 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Sampler.hpp
+ * 
+ * Low-discrepancy sample sequences and tile sized sample blocks
+ * Class and method definitions
+ */
+
+/*!
+ \file Sampler.hpp
+ Header definition for the Sampler and SampleBlock classes
+ */
+
+#ifndef SAMPLER_HPP
+#define	SAMPLER_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "Framebuffer.hpp"
+
+namespace SCPPR {
+
+    class MemoryArena;
+
+    //! Sequences a Sampler can draw from
+    enum class SamplerType {
+        independent,   //!< Hashed uniform numbers, no stratification
+        halton,        //!< Digit permuted Halton, rotated per pixel
+        sobol,         //!< Owen scrambled Sobol, scrambled per pixel
+        blueNoise      //!< One Owen scrambled Sobol sequence shifted per pixel by a blue noise mask
+    };
+
+    //! Samples of many pixels, one column of floats per dimension
+    /*!
+     Columns live in a MemoryArena and stay valid until the arena scope
+     they were taken in closes. Column d holds dimension d of every sample
+     in the order they were generated, so a renderer reads eight
+     neighbouring samples of a dimension with one aligned load.
+     */
+    class SampleBlock {
+
+    public:
+
+        static const int maximumDimensions = 16;   //!< Columns a block can hold
+
+        // begin constructor declarations---------------------------------------
+
+        //! Parameterized constructor
+        /*!
+         Takes room for capacityArg samples of dimensionCountArg dimensions,
+         at most maximumDimensions, from arena
+         */
+        SampleBlock(MemoryArena& arena, std::size_t capacityArg, int dimensionCountArg);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Reserves count more samples and sets first to the first of them
+        /*!
+         Returns false and reserves nothing when the block has no room for
+         them.
+         */
+        bool Append(std::size_t count, std::size_t& first);
+
+        //! Empties the block, keeping its columns
+        void Clear();
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the number of samples
+        std::size_t GetSize() const;
+
+        //! Returns the number of samples there is room for
+        std::size_t GetCapacity() const;
+
+        //! Returns the number of dimensions of every sample
+        int GetDimensionCount() const;
+
+        //! Returns the column of a dimension, 32 byte aligned
+        const float* GetColumn(int dimension) const;
+
+        //! Returns the column of a dimension for writing
+        float* GetColumn(int dimension);
+
+        //! Returns one dimension of one sample
+        float Get(std::size_t sample, int dimension) const;
+
+        // end accessor declarations--------------------------------------------
+
+    protected:
+
+        float* columns[maximumDimensions];   //!< One arena array per dimension
+        std::size_t size;                    //!< Samples written
+        std::size_t capacity;                //!< Length of every column
+        int dimensionCount;                  //!< Columns in use
+    };
+
+    //! Generator of well stratified sample numbers per pixel
+    /*!
+     A sample is addressed by pixel, sample index and dimension and is the
+     same every time it is asked for, whatever order the samples are asked
+     in, so adaptive renderers can take more samples of a pixel later.
+
+     - sobol pads four dimensional Sobol points: every run of four
+       dimensions gets its own Owen scrambled index shuffle, and every
+       dimension its own Owen scramble, seeded by the pixel. Any power of
+       two count of consecutive samples stays stratified in each run.
+     - halton uses the first haltonDimensions primes with fixed random
+       digit permutations, rotated by a per pixel offset.
+     - blueNoise shares one scrambled Sobol sequence between all pixels
+       and shifts it per pixel and dimension by a blue noise mask, so the
+       error left at low sample counts looks like blue noise rather than
+       white noise.
+
+     Dimensions the sequence has no table for fall back to independent
+     numbers. The direction numbers, digit permutations and the mask are
+     built once per process on first use.
+
+     Get returns one number; Generate and GenerateTile fill a SampleBlock
+     for many samples at once, working out the per pixel and per
+     dimension state once rather than once per number.
+     */
+    class Sampler {
+
+    public:
+
+        static const int sobolDimensions = 4;      //!< Dimensions of a padded Sobol run
+        static const int sobolBits = 32;           //!< Direction numbers per dimension
+        static const int haltonDimensions = 64;    //!< Dimensions with a Halton prime
+        static const int blueNoiseSize = 64;       //!< Edge length of the tiled blue noise mask
+
+        // begin constructor declarations---------------------------------------
+
+        //! Parameterized constructor
+        /*!
+         Constructs a sampler of typeArg; seedArg picks among otherwise
+         identical sequences
+         */
+        explicit Sampler(SamplerType typeArg = SamplerType::sobol, std::uint32_t seedArg = 0);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Returns one dimension of a sample of pixel x, y in [0, 1)
+        float Get(int x, int y, std::uint32_t index, int dimension) const;
+
+        //! Appends samples [firstIndex, firstIndex + count) of pixel x, y to block
+        /*!
+         Fills dimensions firstDimension onwards, one per column of block.
+         Returns false and writes nothing when block has no room for them.
+         */
+        bool Generate(int x, int y, std::uint32_t firstIndex, std::size_t count, int firstDimension,
+                      SampleBlock& block) const;
+
+        //! Appends samplesPerPixel samples of every pixel of a tile to block
+        /*!
+         Pixels follow in rows, each with its samples together, as
+         Generate would append them one pixel at a time. Returns false and
+         writes nothing when block has no room for the whole tile.
+         */
+        bool GenerateTile(const Tile& tile, std::uint32_t firstIndex, int samplesPerPixel, int firstDimension,
+                          SampleBlock& block) const;
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the sequence
+        SamplerType GetType() const;
+
+        //! Returns the seed
+        std::uint32_t GetSeed() const;
+
+        //! Returns the command line name of a sequence
+        static const char* GetName(SamplerType type);
+
+        //! Finds the sequence named name, returns false when there is none
+        static bool Parse(const std::string& name, SamplerType& type);
+
+        //! Returns the blue noise mask value at x, y, repeating every blueNoiseSize pixels
+        static float GetBlueNoise(int x, int y);
+
+        // end accessor declarations--------------------------------------------
+
+    protected:
+
+        //! Returns the seed of a pixel's scrambles
+        std::uint32_t GetPixelSeed(int x, int y) const;
+
+        SamplerType type;       //!< Sequence drawn from
+        std::uint32_t seed;     //!< Decorrelates samplers of the same type
+    };
+
+    inline bool SampleBlock::Append(std::size_t count, std::size_t& first) {
+        if(count > capacity - size)
+            return false;
+        first = size;
+        size += count;
+        return true;
+    }
+
+    inline void SampleBlock::Clear() {
+        size = 0;
+    }
+
+    inline std::size_t SampleBlock::GetSize() const {
+        return size;
+    }
+
+    inline std::size_t SampleBlock::GetCapacity() const {
+        return capacity;
+    }
+
+    inline int SampleBlock::GetDimensionCount() const {
+        return dimensionCount;
+    }
+
+    inline const float* SampleBlock::GetColumn(int dimension) const {
+        return columns[dimension];
+    }
+
+    inline float* SampleBlock::GetColumn(int dimension) {
+        return columns[dimension];
+    }
+
+    inline float SampleBlock::Get(std::size_t sample, int dimension) const {
+        return columns[dimension][sample];
+    }
+
+    inline SamplerType Sampler::GetType() const {
+        return type;
+    }
+
+    inline std::uint32_t Sampler::GetSeed() const {
+        return seed;
+    }
+}
+
+#endif	/* SAMPLER_HPP */
@@ -0,0 +1,309 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TextureCache.cpp
+ * 
+ * Thread-safe tile cache over tiled textures with a fixed memory budget
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "TextureCache.hpp"
+#include "../utility/ErrorMessage.hpp"
+
+namespace SCPPR {
+
+    struct TextureCache::Tile {
+        std::uint64_t key;                          // texture and file tile index
+        std::unique_ptr<unsigned char[]> texels;    // GetTileBytes() of sRGB texels
+        std::size_t bytes;                          // size of texels
+    };
+
+    struct TextureCache::Shard {
+        typedef std::list<std::shared_ptr<const Tile> > TileList;
+
+        std::mutex mutex;
+        TileList tiles;                                             // most recently used first
+        std::unordered_map<std::uint64_t, TileList::iterator> index;
+        std::size_t bytes;
+        std::size_t budget;
+        std::uint64_t lookups;
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t evictions;
+        std::uint64_t failedReads;
+        char padding[64];                                           // keeps neighbouring shard locks apart
+
+        Shard() :
+            bytes(0), budget(0), lookups(0), hits(0), misses(0), evictions(0), failedReads(0) {
+
+        }
+    };
+
+    namespace {
+
+        const std::uint64_t emptyKey = ~0ull;
+
+        // Tiles the calling thread touched last, belonging to the cache named owner
+        struct MicroCache {
+            std::uint64_t owner;
+            std::uint64_t keys[TextureCache::microCacheSize];
+            std::shared_ptr<const TextureCache::Tile> tiles[TextureCache::microCacheSize];
+
+            MicroCache() :
+                owner(0) {
+                std::fill(keys, keys + TextureCache::microCacheSize, emptyKey);
+            }
+        };
+
+        thread_local MicroCache microCache;
+
+        std::atomic<std::uint64_t> nextCacheId(1);
+
+        // sRGB bytes to linear floats
+        struct DecodeTable {
+            float values[256];
+
+            DecodeTable() {
+                for(int i = 0; i < 256; i++) {
+                    float encoded = i / 255.0f;
+                    values[i] = encoded <= 0.04045f ? encoded / 12.92f
+                                                    : std::pow((encoded + 0.055f) / 1.055f, 2.4f);
+                }
+            }
+        };
+
+        const DecodeTable decodeTable;
+
+        std::uint64_t MixKey(std::uint64_t key) {
+            key ^= key >> 33;
+            key *= 0xFF51AFD7ED558CCDull;
+            key ^= key >> 33;
+            return key;
+        }
+
+        int Wrap(int value, int size) {
+            if((unsigned)value < (unsigned)size)
+                return value;
+            value %= size;
+            return value < 0 ? value + size : value;
+        }
+
+        Color Decode(const unsigned char* texel) {
+            return Color(decodeTable.values[texel[0]], decodeTable.values[texel[1]], decodeTable.values[texel[2]]);
+        }
+    }
+
+    const int TextureCache::shardCount;
+    const int TextureCache::microCacheSize;
+
+    TextureCache::TextureCache(std::size_t memoryBudgetArg) :
+        shards(new Shard[shardCount]), memoryBudget(memoryBudgetArg),
+        id(nextCacheId.fetch_add(1, std::memory_order_relaxed)), residentBytes(0), peakBytes(0) {
+        for(int i = 0; i < shardCount; i++)
+            shards[i].budget = memoryBudget / shardCount;
+    }
+
+    TextureCache::~TextureCache() {
+
+    }
+
+    int TextureCache::Add(const std::string& path, std::string* error) {
+        // handles share the tile key with the tile index
+        if(textures.size() >= 0xFFFF) {
+            Fail(error, path + ": too many textures");
+            return -1;
+        }
+        std::unique_ptr<TextureFile> texture(new TextureFile());
+        if(!texture->Open(path, error))
+            return -1;
+        textures.push_back(std::move(texture));
+        return (int)textures.size() - 1;
+    }
+
+    Color TextureCache::Fetch(int texture, int level, int x, int y) const {
+        const TextureFile& file = *textures[texture];
+        const TextureFile::Level& info = file.GetLevel(level);
+        x = Wrap(x, (int)info.width);
+        y = Wrap(y, (int)info.height);
+        const int tileSize = file.GetTileSize();
+        const unsigned char* texels = GetTile(texture, level, x / tileSize, y / tileSize);
+        return Decode(texels + ((y % tileSize) * tileSize + x % tileSize) * TextureFile::texelSize);
+    }
+
+    Color TextureCache::Sample(int texture, float u, float v, float footprint) const {
+        const TextureFile& file = *textures[texture];
+        const int lastLevel = file.GetLevelCount() - 1;
+        // level 0 texels per footprint, one level up for every doubling
+        const float texels = footprint * (float)std::max(file.GetWidth(), file.GetHeight());
+        const float lod = texels > 1.0f ? std::min(std::log2(texels), (float)lastLevel) : 0.0f;
+        const int level = (int)lod;
+        const float blend = lod - (float)level;
+        Color color = SampleLevel(texture, level, u, v);
+        if(blend > 0.0f && level < lastLevel)
+            color = color * (1.0f - blend) + SampleLevel(texture, level + 1, u, v) * blend;
+        return color;
+    }
+
+    Color TextureCache::SampleLevel(int texture, int level, float u, float v) const {
+        const TextureFile::Level& info = textures[texture]->GetLevel(level);
+        // texel centres sit at half integers
+        const float s = (u - std::floor(u)) * (float)info.width - 0.5f;
+        const float t = (v - std::floor(v)) * (float)info.height - 0.5f;
+        const float x0 = std::floor(s), y0 = std::floor(t);
+        const float fx = s - x0, fy = t - y0;
+        const int x = (int)x0, y = (int)y0;
+
+        // most footprints lie inside one tile, which is then looked up once
+        const int tileSize = textures[texture]->GetTileSize();
+        const int tileX = x / tileSize, tileY = y / tileSize;
+        Color texels[4];
+        if(x >= 0 && y >= 0 && x + 1 < (int)info.width && y + 1 < (int)info.height &&
+           (x + 1) / tileSize == tileX && (y + 1) / tileSize == tileY) {
+            const int stride = tileSize * TextureFile::texelSize;
+            const unsigned char* texel = GetTile(texture, level, tileX, tileY) +
+                                         ((y % tileSize) * tileSize + x % tileSize) * TextureFile::texelSize;
+            texels[0] = Decode(texel);
+            texels[1] = Decode(texel + TextureFile::texelSize);
+            texels[2] = Decode(texel + stride);
+            texels[3] = Decode(texel + stride + TextureFile::texelSize);
+        }
+        else {
+            texels[0] = Fetch(texture, level, x, y);
+            texels[1] = Fetch(texture, level, x + 1, y);
+            texels[2] = Fetch(texture, level, x, y + 1);
+            texels[3] = Fetch(texture, level, x + 1, y + 1);
+        }
+        Color top = texels[0] * (1.0f - fx) + texels[1] * fx;
+        Color bottom = texels[2] * (1.0f - fx) + texels[3] * fx;
+        return top * (1.0f - fy) + bottom * fy;
+    }
+
+    const unsigned char* TextureCache::GetTile(int texture, int level, int tileX, int tileY) const {
+        const TextureFile::Level& info = textures[texture]->GetLevel(level);
+        const std::uint64_t key = ((std::uint64_t)texture << 48) |
+            (info.firstTile + (std::uint64_t)tileY * info.tilesX + (std::uint64_t)tileX);
+
+        MicroCache& local = microCache;
+        if(local.owner != id) {
+            // the thread last used another cache, whose tiles mean nothing here
+            for(int i = 0; i < microCacheSize; i++) {
+                local.keys[i] = emptyKey;
+                local.tiles[i].reset();
+            }
+            local.owner = id;
+        }
+        const std::uint64_t mixed = MixKey(key);
+        const int slot = (int)(mixed % microCacheSize);
+        if(local.keys[slot] != key) {
+            local.tiles[slot] = LoadTile(key, texture, level, tileX, tileY);
+            local.keys[slot] = key;
+        }
+        return local.tiles[slot]->texels.get();
+    }
+
+    std::shared_ptr<const TextureCache::Tile> TextureCache::LoadTile(std::uint64_t key, int texture, int level,
+                                                                     int tileX, int tileY) const {
+        Shard& shard = shards[(MixKey(key) >> 32) % shardCount];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.lookups++;
+            auto found = shard.index.find(key);
+            if(found != shard.index.end()) {
+                shard.hits++;
+                shard.tiles.splice(shard.tiles.begin(), shard.tiles, found->second);
+                return *found->second;
+            }
+        }
+
+        // read without the lock so other tiles of the shard stay available
+        const TextureFile& file = *textures[texture];
+        std::shared_ptr<Tile> tile = std::make_shared<Tile>();
+        tile->key = key;
+        tile->bytes = file.GetTileBytes();
+        tile->texels.reset(new unsigned char[tile->bytes]);
+        bool read = file.ReadTile(level, tileX, tileY, tile->texels.get());
+        if(!read)
+            std::fill(tile->texels.get(), tile->texels.get() + tile->bytes, (unsigned char)0);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.misses++;
+        if(!read)
+            shard.failedReads++;
+        auto found = shard.index.find(key);
+        if(found != shard.index.end()) {
+            // another thread read the same tile meanwhile
+            shard.tiles.splice(shard.tiles.begin(), shard.tiles, found->second);
+            return *found->second;
+        }
+        shard.tiles.push_front(tile);
+        shard.index[key] = shard.tiles.begin();
+        shard.bytes += tile->bytes;
+        std::size_t resident = residentBytes.fetch_add(tile->bytes, std::memory_order_relaxed) + tile->bytes;
+        while(shard.bytes > shard.budget && shard.tiles.size() > 1) {
+            const std::shared_ptr<const Tile>& coldest = shard.tiles.back();
+            shard.bytes -= coldest->bytes;
+            resident = residentBytes.fetch_sub(coldest->bytes, std::memory_order_relaxed) - coldest->bytes;
+            shard.index.erase(coldest->key);
+            shard.tiles.pop_back();
+            shard.evictions++;
+        }
+        std::size_t peak = peakBytes.load(std::memory_order_relaxed);
+        while(resident > peak && !peakBytes.compare_exchange_weak(peak, resident, std::memory_order_relaxed))
+            continue;
+        return tile;
+    }
+
+    TextureCacheStatistics TextureCache::GetStatistics() const {
+        TextureCacheStatistics statistics;
+        for(int i = 0; i < shardCount; i++) {
+            Shard& shard = shards[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            statistics.lookups += shard.lookups;
+            statistics.hits += shard.hits;
+            statistics.misses += shard.misses;
+            statistics.evictions += shard.evictions;
+            statistics.failedReads += shard.failedReads;
+        }
+        statistics.residentBytes = residentBytes.load(std::memory_order_relaxed);
+        statistics.peakBytes = peakBytes.load(std::memory_order_relaxed);
+        return statistics;
+    }
+
+    void TextureCache::DisplayContents() const {
+        TextureCacheStatistics statistics = GetStatistics();
+        std::cout << "TextureCache: " << textures.size() << " textures, " << statistics.residentBytes / 1024
+                  << " of " << memoryBudget / 1024 << " KiB resident, peak " << statistics.peakBytes / 1024
+                  << " KiB" << std::endl;
+        std::cout << "  " << statistics.lookups << " shared lookups, " << statistics.hits << " hits, "
+                  << statistics.misses << " misses, " << statistics.evictions << " evictions";
+        if(statistics.failedReads > 0)
+            std::cout << ", " << statistics.failedReads << " failed reads";
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,187 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TextureCache.hpp
+ * 
+ * Thread-safe tile cache over tiled textures with a fixed memory budget
+ * Class and method definitions
+ */
+
+/*!
+ \file TextureCache.hpp
+ Header definition for the TextureCache class
+ */
+
+#ifndef TEXTURECACHE_HPP
+#define	TEXTURECACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../io/TextureFile.hpp"
+#include "../utility/Color.hpp"
+
+namespace SCPPR {
+
+    //! Traffic of a texture cache since it was created
+    struct TextureCacheStatistics {
+        std::uint64_t lookups;       //!< Tile lookups that missed the calling thread's cache
+        std::uint64_t hits;          //!< Lookups found in the shared cache
+        std::uint64_t misses;        //!< Lookups that read the tile from disk
+        std::uint64_t evictions;     //!< Tiles dropped to stay within the budget
+        std::uint64_t failedReads;   //!< Tiles that could not be read, served black
+        std::size_t residentBytes;   //!< Texel bytes held by the shared cache now
+        std::size_t peakBytes;       //!< Most texel bytes the shared cache ever held
+
+        TextureCacheStatistics() :
+            lookups(0), hits(0), misses(0), evictions(0), failedReads(0), residentBytes(0),
+            peakBytes(0) {
+
+        }
+    };
+
+    //! Serves filtered lookups into tiled textures from a bounded tile cache
+    /*!
+     Tiles are read on first use and kept in a shared cache split into
+     shardCount shards, each under its own lock with its own least
+     recently used list and an equal share of the memory budget. A shard
+     evicts from the cold end of its list before it grows past its share.
+
+     Every thread also keeps the last microCacheSize tiles it touched,
+     direct mapped, and only takes a shard lock when none of them match.
+     Filtered lookups touch a handful of neighbouring texels, so most of
+     them never reach the shared cache. A tile stays readable while a
+     thread's cache holds it, even after the shared cache evicts it: the
+     texel memory in use can exceed the budget by at most microCacheSize
+     tiles per thread.
+
+     Two threads missing on the same tile may both read it; the second to
+     finish uses the first one's copy.
+
+     Textures must all be added before lookups start.
+     */
+    class TextureCache {
+
+    public:
+
+        static const int shardCount = 16;       //!< Independently locked parts of the shared cache
+        static const int microCacheSize = 8;    //!< Tiles each thread keeps without locking
+
+        //! Texels of one cached tile
+        struct Tile;
+
+        // begin constructor declarations---------------------------------------
+
+        //! Constructs an empty cache holding at most memoryBudget texel bytes
+        /*!
+         The budget should cover several tiles per shard; a shard always
+         keeps the tile it just read.
+         */
+        explicit TextureCache(std::size_t memoryBudget);
+
+        //! Destructor
+        ~TextureCache();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Opens the tiled texture at path and returns its handle
+        /*!
+         Returns -1 and describes the problem in error when it is not null.
+         */
+        int Add(const std::string& path, std::string* error = 0);
+
+        //! Returns the texel at x, y of a level, wrapping coordinates outside it
+        Color Fetch(int texture, int level, int x, int y) const;
+
+        //! Returns the trilinear filtered color at u, v, wrapping outside [0, 1)
+        /*!
+         footprint is the width of the lookup in texture coordinates, which
+         picks the pair of mip levels to blend.
+         */
+        Color Sample(int texture, float u, float v, float footprint) const;
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the number of textures added
+        int GetTextureCount() const;
+
+        //! Returns the file behind a texture handle
+        const TextureFile& GetTexture(int texture) const;
+
+        //! Returns the texel byte budget of the shared cache
+        std::size_t GetMemoryBudget() const;
+
+        //! Returns the traffic so far
+        TextureCacheStatistics GetStatistics() const;
+
+        // end accessor declarations--------------------------------------------
+
+        //! Displays the textures and traffic using std::cout
+        void DisplayContents() const;
+
+    protected:
+
+        //! One independently locked part of the shared cache
+        struct Shard;
+
+        //! Returns the texels of a tile, from the thread's cache when it has them
+        const unsigned char* GetTile(int texture, int level, int tileX, int tileY) const;
+
+        //! Finds or reads a tile in its shard
+        std::shared_ptr<const Tile> LoadTile(std::uint64_t key, int texture, int level, int tileX,
+                                             int tileY) const;
+
+        //! Returns the bilinear filtered color at u, v of one level
+        Color SampleLevel(int texture, int level, float u, float v) const;
+
+        std::vector<std::unique_ptr<TextureFile> > textures;  //!< Open textures by handle
+        std::unique_ptr<Shard[]> shards;                    //!< Parts of the shared cache
+        std::size_t memoryBudget;                           //!< Texel bytes of the shared cache
+        std::uint64_t id;                                   //!< Tells the thread caches of different caches apart
+        mutable std::atomic<std::size_t> residentBytes;     //!< Texel bytes held by every shard
+        mutable std::atomic<std::size_t> peakBytes;         //!< Highest residentBytes seen
+
+    private:
+
+        // shards hold locks and the tiles threads still point at
+        TextureCache(const TextureCache& copy);
+        TextureCache& operator= (const TextureCache& copy);
+    };
+
+    inline int TextureCache::GetTextureCount() const {
+        return (int)textures.size();
+    }
+
+    inline const TextureFile& TextureCache::GetTexture(int texture) const {
+        return *textures[texture];
+    }
+
+    inline std::size_t TextureCache::GetMemoryBudget() const {
+        return memoryBudget;
+    }
+}
+
+#endif	/* TEXTURECACHE_HPP */
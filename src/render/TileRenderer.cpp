@@ -0,0 +1,146 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TileRenderer.cpp
+ * 
+ * Multithreaded renderer splitting the image into tiles
+ */
+
+#include <algorithm>
+
+#include "TileRenderer.hpp"
+#include "../memory/MemoryArena.hpp"
+#include "../parallel/RenderCounters.hpp"
+#include "../parallel/TaskPool.hpp"
+#include "../parallel/TraceRecorder.hpp"
+
+namespace SCPPR {
+
+    const int TileRenderer::packetWidth;
+    const int TileRenderer::packetHeight;
+
+    TileRenderer::TileRenderer(TaskPool& poolArg, int tileSizeArg) :
+        pool(poolArg), tileSize(std::max(tileSizeArg, 1)) {
+
+    }
+
+    std::vector<Tile> TileRenderer::MakeTiles(int width, int height, int tileSize) {
+        std::vector<Tile> tiles;
+        for(int y = 0; y < height; y += tileSize)
+            for(int x = 0; x < width; x += tileSize) {
+                Tile tile = { x, y, std::min(x + tileSize, width), std::min(y + tileSize, height) };
+                tiles.push_back(tile);
+            }
+        return tiles;
+    }
+
+    void TileRenderer::Render(const Camera& camera, const RadianceFunction& radiance,
+                              Framebuffer& framebuffer, const TileCallback& onTile) const {
+        std::vector<Tile> tiles = MakeTiles(framebuffer.GetWidth(), framebuffer.GetHeight(), tileSize);
+
+        TaskGroup group;
+        for(std::size_t i = 0; i < tiles.size(); i++) {
+            const Tile& tile = tiles[i];
+            pool.Submit(group, [this, &tile, &camera, &radiance, &framebuffer, &onTile]() {
+                RenderTile(tile, camera, radiance, framebuffer);
+                if(onTile)
+                    onTile(tile);
+            });
+        }
+        pool.Wait(group);
+    }
+
+    void TileRenderer::RenderPackets(const Camera& camera, const PacketRadianceFunction& radiance,
+                                     Framebuffer& framebuffer, const TileCallback& onTile) const {
+        std::vector<Tile> tiles = MakeTiles(framebuffer.GetWidth(), framebuffer.GetHeight(), tileSize);
+
+        TaskGroup group;
+        for(std::size_t i = 0; i < tiles.size(); i++) {
+            const Tile& tile = tiles[i];
+            pool.Submit(group, [this, &tile, &camera, &radiance, &framebuffer, &onTile]() {
+                RenderPacketTile(tile, camera, radiance, framebuffer);
+                if(onTile)
+                    onTile(tile);
+            });
+        }
+        pool.Wait(group);
+    }
+
+    void TileRenderer::RenderTile(const Tile& tile, const Camera& camera,
+                                  const RadianceFunction& radiance, Framebuffer& framebuffer) const {
+        TraceRecorder::Scope trace("tile", "render", "x", tile.x0, "y", tile.y0);
+        const float inverseWidth = 1.0f / framebuffer.GetWidth();
+        const float inverseHeight = 1.0f / framebuffer.GetHeight();
+        MemoryArena& arena = MemoryArena::GetThreadArena();
+        for(int y = tile.y0; y < tile.y1; y++)
+            for(int x = tile.x0; x < tile.x1; x++) {
+                MemoryArena::Scope scratch(arena);
+                Ray ray = camera.GenerateRay((x + 0.5f) * inverseWidth, (y + 0.5f) * inverseHeight);
+                framebuffer.SetPixel(x, y, radiance(ray));
+            }
+        const std::uint64_t pixels = (std::uint64_t)(tile.x1 - tile.x0) * (tile.y1 - tile.y0);
+        RenderCounters::Add(RenderCounters::primaryRays, pixels);
+        RenderCounters::Add(RenderCounters::samples, pixels);
+    }
+
+    void TileRenderer::RenderPacketTile(const Tile& tile, const Camera& camera,
+                                        const PacketRadianceFunction& radiance,
+                                        Framebuffer& framebuffer) const {
+        static_assert(packetWidth * packetHeight == 8, "a packet block must cover eight pixels");
+        TraceRecorder::Scope trace("tile", "render", "x", tile.x0, "y", tile.y0);
+        const float inverseWidth = 1.0f / framebuffer.GetWidth();
+        const float inverseHeight = 1.0f / framebuffer.GetHeight();
+        MemoryArena& arena = MemoryArena::GetThreadArena();
+        for(int y = tile.y0; y < tile.y1; y += packetHeight)
+            for(int x = tile.x0; x < tile.x1; x += packetWidth) {
+                MemoryArena::Scope scratch(arena);
+                Point origins[8];
+                Vector directions[8];
+                int activeBits = 0;
+                for(int lane = 0; lane < 8; lane++) {
+                    int px = x + lane % packetWidth;
+                    int py = y + lane / packetWidth;
+                    // lanes past the tile edge trace the block's first pixel and stay masked off
+                    if(px < tile.x1 && py < tile.y1)
+                        activeBits |= 1 << lane;
+                    else {
+                        px = x;
+                        py = y;
+                    }
+                    Ray ray = camera.GenerateRay((px + 0.5f) * inverseWidth, (py + 0.5f) * inverseHeight);
+                    origins[lane] = ray.GetOrigin();
+                    directions[lane] = ray.GetDirection();
+                }
+
+                Color colors[8];
+                radiance(RayPacket8::Gather(origins, directions), Mask8::FromBits(activeBits), colors);
+                for(int lane = 0; lane < 8; lane++)
+                    if(activeBits & (1 << lane))
+                        framebuffer.SetPixel(x + lane % packetWidth, y + lane / packetWidth, colors[lane]);
+            }
+        // masked lanes trace a duplicate ray but only active lanes are counted
+        const std::uint64_t pixels = (std::uint64_t)(tile.x1 - tile.x0) * (tile.y1 - tile.y0);
+        RenderCounters::Add(RenderCounters::primaryRays, pixels);
+        RenderCounters::Add(RenderCounters::samples, pixels);
+    }
+}
@@ -0,0 +1,137 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   TileRenderer.hpp
+ * 
+ * Multithreaded renderer splitting the image into tiles
+ * Class and method definitions
+ */
+
+/*!
+ \file TileRenderer.hpp
+ Header definition for the TileRenderer class
+ */
+
+#ifndef TILERENDERER_HPP
+#define	TILERENDERER_HPP
+
+#include <functional>
+#include <vector>
+
+#include "Camera.hpp"
+#include "Framebuffer.hpp"
+#include "../utility/Color.hpp"
+#include "../utility/Ray.hpp"
+#include "../utility/RayPacket8.hpp"
+
+namespace SCPPR {
+
+    class TaskPool;
+
+    //! Renders an image as independent tiles on a TaskPool
+    /*!
+     Every tile is one task. Tiles are dealt across the pool's workers and
+     idle workers steal them, so expensive regions of the image balance out
+     without any up front cost estimate. Each task writes only its own
+     pixels, so the framebuffer is shared without locks.
+     */
+    class TileRenderer {
+
+    public:
+
+        //! Returns the radiance arriving along a primary ray
+        /*!
+         May take scratch memory from MemoryArena::GetThreadArena, which the
+         renderers rewind after every sample.
+         */
+        typedef std::function<Color(const Ray& ray)> RadianceFunction;
+
+        //! Writes colors[i] with the radiance along ray i for every active lane
+        /*!
+         Lets a scene trace coherent primary rays, and the secondary rays
+         they spawn, through the packet traversal of its hierarchies. The
+         same scratch memory rules as RadianceFunction apply.
+         */
+        typedef std::function<void(const RayPacket8& rays, const Mask8& active,
+                                   Color colors[8])> PacketRadianceFunction;
+
+        //! Called from a worker thread once a tile's pixels are final
+        typedef std::function<void(const Tile& tile)> TileCallback;
+
+        // begin constructor declarations---------------------------------------
+
+        //! Parameterized constructor
+        /*!
+         Constructs a renderer running on pool with square tiles of
+         tileSizeArg pixels
+         */
+        explicit TileRenderer(TaskPool& poolArg, int tileSizeArg = 32);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Returns the tile edge length in pixels
+        int GetTileSize() const;
+
+        //! Splits a width by height image into tiles in scanline order
+        static std::vector<Tile> MakeTiles(int width, int height, int tileSize);
+
+        //! Renders one sample through the centre of every pixel
+        /*!
+         Calls onTile after every tile when it is set, so that finished
+         tiles can be written out while the rest of the image renders.
+         */
+        void Render(const Camera& camera, const RadianceFunction& radiance,
+                    Framebuffer& framebuffer, const TileCallback& onTile = TileCallback()) const;
+
+        //! Renders one sample through the centre of every pixel in packets
+        /*!
+         Produces the same image as Render, tracing each tile as blocks of
+         packetWidth by packetHeight pixels so that the eight rays of a
+         packet stay close together on screen.
+         */
+        void RenderPackets(const Camera& camera, const PacketRadianceFunction& radiance,
+                           Framebuffer& framebuffer, const TileCallback& onTile = TileCallback()) const;
+
+        static const int packetWidth = 4;  //!< Pixel columns covered by a packet
+        static const int packetHeight = 2; //!< Pixel rows covered by a packet
+
+    protected:
+
+        //! Renders the pixels of a single tile
+        void RenderTile(const Tile& tile, const Camera& camera,
+                        const RadianceFunction& radiance, Framebuffer& framebuffer) const;
+
+        //! Renders the pixels of a single tile in packets
+        void RenderPacketTile(const Tile& tile, const Camera& camera,
+                              const PacketRadianceFunction& radiance, Framebuffer& framebuffer) const;
+
+        TaskPool& pool; //!< Pool the tiles run on
+        int tileSize;   //!< Tile edge length in pixels
+    };
+
+    inline int TileRenderer::GetTileSize() const {
+        return tileSize;
+    }
+}
+
+#endif	/* TILERENDERER_HPP */
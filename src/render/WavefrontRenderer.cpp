@@ -0,0 +1,400 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   WavefrontRenderer.cpp
+ * 
+ * Path tracer that advances large batches of paths one stage at a time
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "WavefrontRenderer.hpp"
+#include "../memory/MemoryArena.hpp"
+#include "../parallel/RenderCounters.hpp"
+#include "../parallel/TaskPool.hpp"
+#include "../parallel/TraceRecorder.hpp"
+#include "../utility/Normal.hpp"
+#include "../utility/OctahedralNormal.hpp"
+
+namespace SCPPR {
+
+    namespace {
+
+        const std::size_t grainSize = 1024; //!< Slots per task, a multiple of the packet width
+        const int radixBits = 8;            //!< Key bits sorted per radix pass
+        const std::size_t radix = 1 << radixBits;
+
+        double SecondsSince(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // Cell of value in [0, 1) on a grid of cells, clamped, NaN to cell 0
+        std::uint32_t Quantize(float value, std::uint32_t cells) {
+            if(!(value > 0.0f))
+                return 0;
+            return std::min((std::uint32_t)(value * cells), cells - 1);
+        }
+    }
+
+    const int WavefrontRenderer::rayKeyBits;
+
+    WavefrontRenderer::WavefrontRenderer(TaskPool& poolArg, const WavefrontSettings& settingsArg) :
+        pool(poolArg), settings(settingsArg), paths(&queues[0]), nextPaths(&queues[1]),
+        shadows(&queues[2]), spare(&queues[3]) {
+
+    }
+
+    WavefrontStatistics WavefrontRenderer::Render(const Camera& camera, const WavefrontScene& scene,
+                                                  Framebuffer& framebuffer, int tileSize,
+                                                  const TileRenderer::TileCallback& onTile) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        statistics = WavefrontStatistics();
+        const int width = framebuffer.GetWidth();
+        const int height = framebuffer.GetHeight();
+        const std::size_t pixelCount = (std::size_t)width * height;
+        const int samples = std::max(settings.samplesPerPixel, 1);
+
+        // no more paths than pixels, so a wave never holds two paths of one pixel
+        const std::size_t waveSize = std::max<std::size_t>(std::min(settings.waveSize, pixelCount), 1);
+        for(int i = 0; i < 4; i++)
+            if(queues[i].GetCapacity() != waveSize)
+                queues[i].Reserve(waveSize);
+        accumulated.assign(pixelCount, Color());
+
+        const std::uint64_t pathCount = (std::uint64_t)pixelCount * samples;
+        for(std::uint64_t first = 0; first < pathCount; first += waveSize) {
+            std::size_t count = (std::size_t)std::min<std::uint64_t>(waveSize, pathCount - first);
+            Generate(camera, width, height, first, count);
+            statistics.waves++;
+            statistics.paths += count;
+
+            for(int bounce = 0; !paths->IsEmpty(); bounce++) {
+                std::chrono::steady_clock::time_point stage = std::chrono::steady_clock::now();
+                if(settings.sortRays) {
+                    SortRays(paths, scene.bounds);
+                    statistics.sortSeconds += SecondsSince(stage);
+                }
+
+                stage = std::chrono::steady_clock::now();
+                RayQueue& extended = *paths;
+                pool.ParallelFor(extended.GetSize(), grainSize, [&scene, &extended, bounce](std::size_t begin, std::size_t end) {
+                    TraceRecorder::Scope trace("extend", "wavefront", "rays", (std::int64_t)(end - begin));
+                    scene.extend(extended, begin, end);
+                    if(bounce > 0)
+                        RenderCounters::Add(RenderCounters::bounceRays, end - begin);
+                });
+                statistics.rays += extended.GetSize();
+                statistics.extendSeconds += SecondsSince(stage);
+
+                if(settings.sortHits) {
+                    stage = std::chrono::steady_clock::now();
+                    SortHits(paths);
+                    statistics.sortSeconds += SecondsSince(stage);
+                }
+
+                stage = std::chrono::steady_clock::now();
+                Shade(scene, bounce);
+                statistics.shadeSeconds += SecondsSince(stage);
+
+                if(!shadows->IsEmpty()) {
+                    if(settings.sortRays) {
+                        stage = std::chrono::steady_clock::now();
+                        SortRays(shadows, scene.bounds);
+                        statistics.sortSeconds += SecondsSince(stage);
+                    }
+                    stage = std::chrono::steady_clock::now();
+                    Connect(scene);
+                    statistics.connectSeconds += SecondsSince(stage);
+                }
+                std::swap(paths, nextPaths);
+            }
+        }
+
+        const float inverseSamples = 1.0f / samples;
+        pool.ParallelFor((std::size_t)height, 1, [this, &framebuffer, width, inverseSamples](std::size_t begin, std::size_t end) {
+            for(std::size_t y = begin; y < end; y++)
+                for(int x = 0; x < width; x++)
+                    framebuffer.SetPixel(x, (int)y, accumulated[y * width + x] * inverseSamples);
+        });
+        if(onTile) {
+            std::vector<Tile> tiles = TileRenderer::MakeTiles(width, height, tileSize);
+            for(std::size_t i = 0; i < tiles.size(); i++)
+                onTile(tiles[i]);
+        }
+        statistics.seconds = SecondsSince(start);
+        return statistics;
+    }
+
+    std::uint32_t WavefrontRenderer::MakeRayKey(const Ray& ray, const AABB& bounds) {
+        const Vector& direction = ray.GetDirection();
+        std::uint32_t octant = (direction.GetX() < 0.0f ? 1u : 0u) | (direction.GetY() < 0.0f ? 2u : 0u) |
+                               (direction.GetZ() < 0.0f ? 4u : 0u);
+        float u, v;
+        OctahedralMapping::Encode(Normal(direction), u, v);
+        std::uint32_t directionCell[2] = { Quantize(0.5f * (u + 1.0f), 8), Quantize(0.5f * (v + 1.0f), 8) };
+        std::uint32_t originCell[3];
+        for(int axis = 0; axis < 3; axis++)
+            originCell[axis] = Quantize(bounds.GetOffset(ray.GetOrigin(), axis), 32);
+
+        std::uint32_t key = octant << 21;
+        for(int bit = 0; bit < 5; bit++)
+            for(int axis = 0; axis < 3; axis++)
+                key |= ((originCell[axis] >> bit) & 1u) << (6 + 3 * bit + axis);
+        for(int bit = 0; bit < 3; bit++)
+            for(int axis = 0; axis < 2; axis++)
+                key |= ((directionCell[axis] >> bit) & 1u) << (2 * bit + axis);
+        return key;
+    }
+
+    void WavefrontRenderer::Generate(const Camera& camera, int width, int height, std::uint64_t first,
+                                     std::size_t count) {
+        const std::size_t pixelCount = (std::size_t)width * height;
+        const float inverseWidth = 1.0f / width;
+        const float inverseHeight = 1.0f / height;
+        // a single path per pixel goes through its centre, as TileRenderer's does
+        const bool jitter = settings.samplesPerPixel > 1;
+        RayQueue& queue = *paths;
+        queue.Clear();
+        queue.Claim(count);
+        pool.ParallelFor(count, grainSize, [&](std::size_t begin, std::size_t end) {
+            TraceRecorder::Scope trace("generate", "wavefront", "rays", (std::int64_t)(end - begin));
+            for(std::size_t i = begin; i < end; i++) {
+                std::uint64_t path = first + i;
+                std::uint32_t pixel = (std::uint32_t)(path % pixelCount);
+                std::uint32_t state = Seed(path);
+                float dx = 0.5f, dy = 0.5f;
+                if(jitter) {
+                    dx = NextRandom(state);
+                    dy = NextRandom(state);
+                }
+                int x = (int)(pixel % width);
+                int y = (int)(pixel / width);
+                queue.SetRay(i, camera.GenerateRay((x + dx) * inverseWidth, (y + dy) * inverseHeight));
+                queue.SetMaximumDistance(i, std::numeric_limits<float>::infinity());
+                queue.SetWeight(i, Color(1.0f));
+                queue.SetPixel(i, pixel);
+                queue.GetRandomState(i) = state;
+                queue.GetHit(i) = QueueHit();
+            }
+            RenderCounters::Add(RenderCounters::primaryRays, end - begin);
+            RenderCounters::Add(RenderCounters::samples, end - begin);
+        });
+    }
+
+    void WavefrontRenderer::SortRays(RayQueue*& queue, const AABB& bounds) {
+        RayQueue& keyed = *queue;
+        pool.ParallelFor(keyed.GetSize(), grainSize, [&keyed, &bounds](std::size_t begin, std::size_t end) {
+            for(std::size_t i = begin; i < end; i++)
+                keyed.SetKey(i, MakeRayKey(keyed.GetRay(i), bounds));
+        });
+        SortQueue(queue, rayKeyBits);
+    }
+
+    void WavefrontRenderer::SortHits(RayQueue*& queue) {
+        RayQueue& keyed = *queue;
+        pool.ParallelFor(keyed.GetSize(), grainSize, [&keyed](std::size_t begin, std::size_t end) {
+            for(std::size_t i = begin; i < end; i++)
+                keyed.SetKey(i, keyed.GetHit(i).material);
+        });
+        // only sort as many digits as the largest material needs
+        std::uint32_t largest = 0;
+        const std::uint32_t* keys = keyed.GetKeys();
+        for(std::size_t i = 0; i < keyed.GetSize(); i++)
+            largest = std::max(largest, keys[i]);
+        int keyBits = 0;
+        while(keyBits < 32 && (largest >> keyBits) != 0)
+            keyBits++;
+        SortQueue(queue, keyBits);
+    }
+
+    void WavefrontRenderer::SortQueue(RayQueue*& queue, int keyBits) {
+        const std::size_t count = queue->GetSize();
+        if(count < 2 || keyBits <= 0)
+            return;
+        TraceRecorder::Scope trace("sort", "wavefront", "rays", (std::int64_t)count, "bits", keyBits);
+
+        for(int k = 0; k < 2; k++) {
+            sortKeys[k].resize(count);
+            sortOrder[k].resize(count);
+        }
+        const std::size_t chunkSize = std::max(grainSize, count / (4 * pool.GetThreadCount()) + 1);
+        const std::size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+        histograms.resize(chunkCount * radix);
+
+        const std::uint32_t* queueKeys = queue->GetKeys();
+        pool.ParallelFor(count, grainSize, [this, queueKeys](std::size_t begin, std::size_t end) {
+            for(std::size_t i = begin; i < end; i++) {
+                sortKeys[0][i] = queueKeys[i];
+                sortOrder[0][i] = (std::uint32_t)i;
+            }
+        });
+
+        int source = 0;
+        for(int shift = 0; shift < keyBits; shift += radixBits) {
+            const std::uint32_t* keys = sortKeys[source].data();
+            const std::uint32_t* order = sortOrder[source].data();
+            std::uint32_t* keysOut = sortKeys[source ^ 1].data();
+            std::uint32_t* orderOut = sortOrder[source ^ 1].data();
+
+            pool.ParallelFor(chunkCount, 1, [&](std::size_t begin, std::size_t end) {
+                for(std::size_t chunk = begin; chunk < end; chunk++) {
+                    std::size_t* histogram = &histograms[chunk * radix];
+                    std::fill(histogram, histogram + radix, 0);
+                    std::size_t last = std::min(count, (chunk + 1) * chunkSize);
+                    for(std::size_t i = chunk * chunkSize; i < last; i++)
+                        histogram[(keys[i] >> shift) & (radix - 1)]++;
+                }
+            });
+
+            // digit major prefix sum, so equal digits keep their chunk order and the sort is stable
+            std::size_t offset = 0;
+            for(std::size_t digit = 0; digit < radix; digit++)
+                for(std::size_t chunk = 0; chunk < chunkCount; chunk++) {
+                    std::size_t digitCount = histograms[chunk * radix + digit];
+                    histograms[chunk * radix + digit] = offset;
+                    offset += digitCount;
+                }
+
+            pool.ParallelFor(chunkCount, 1, [&](std::size_t begin, std::size_t end) {
+                for(std::size_t chunk = begin; chunk < end; chunk++) {
+                    std::size_t* next = &histograms[chunk * radix];
+                    std::size_t last = std::min(count, (chunk + 1) * chunkSize);
+                    for(std::size_t i = chunk * chunkSize; i < last; i++) {
+                        std::size_t destination = next[(keys[i] >> shift) & (radix - 1)]++;
+                        keysOut[destination] = keys[i];
+                        orderOut[destination] = order[i];
+                    }
+                }
+            });
+            source ^= 1;
+        }
+
+        RayQueue& sorted = *spare;
+        const RayQueue& unsorted = *queue;
+        const std::uint32_t* order = sortOrder[source].data();
+        pool.ParallelFor(count, grainSize, [&sorted, &unsorted, order, count](std::size_t begin, std::size_t end) {
+            sorted.Permute(unsorted, order, count, begin, end);
+        });
+        spare = queue;
+        queue = &sorted;
+    }
+
+    void WavefrontRenderer::Shade(const WavefrontScene& scene, int bounce) {
+        shadows->Clear();
+        nextPaths->Clear();
+        const bool canBounce = bounce < settings.maximumBounces;
+        const bool roulette = bounce >= settings.rouletteBounces;
+        RayQueue& shaded = *paths;
+        RayQueue& shadowQueue = *shadows;
+        RayQueue& bounced = *nextPaths;
+
+        pool.ParallelFor(shaded.GetSize(), grainSize, [&](std::size_t begin, std::size_t end) {
+            TraceRecorder::Scope trace("shade", "wavefront", "rays", (std::int64_t)(end - begin));
+            MemoryArena& arena = MemoryArena::GetThreadArena();
+            MemoryArena::Scope scratch(arena);
+            ShadeResult* results = arena.Allocate<ShadeResult>(end - begin);
+            std::size_t shadowCount = 0;
+            std::size_t bounceCount = 0;
+            RenderCounters::Add(RenderCounters::shadeCalls, end - begin);
+
+            for(std::size_t i = begin; i < end; i++) {
+                ShadeResult& result = results[i - begin];
+                std::uint32_t& state = shaded.GetRandomState(i);
+                const float random[3] = { NextRandom(state), NextRandom(state), NextRandom(state) };
+                scene.shade(shaded.GetRay(i), shaded.GetHit(i), random, result);
+
+                const Color& throughput = shaded.GetWeight(i);
+                if(!result.emitted.IsBlack())
+                    accumulated[shaded.GetPixel(i)] += throughput * result.emitted;
+                if(!result.direct.IsBlack()) {
+                    result.direct = throughput * result.direct;
+                    shadowCount++;
+                }
+
+                // bounceWeight becomes the throughput of the next ray, black when the path ends
+                Color next = throughput * result.bounceWeight;
+                if(!canBounce)
+                    next = Color();
+                else if(roulette && !next.IsBlack()) {
+                    float survival = std::min(0.95f, std::max(next.GetRed(),
+                                                              std::max(next.GetGreen(), next.GetBlue())));
+                    next = NextRandom(state) < survival ? next / survival : Color();
+                }
+                result.bounceWeight = next;
+                if(!next.IsBlack())
+                    bounceCount++;
+            }
+
+            // one claim per task keeps the queue counters out of the inner loop
+            std::size_t shadowSlot = shadowCount > 0 ? shadowQueue.Claim(shadowCount) : 0;
+            std::size_t bounceSlot = bounceCount > 0 ? bounced.Claim(bounceCount) : 0;
+            for(std::size_t i = begin; i < end; i++) {
+                const ShadeResult& result = results[i - begin];
+                if(!result.direct.IsBlack()) {
+                    shadowQueue.SetRay(shadowSlot, result.shadow);
+                    shadowQueue.SetMaximumDistance(shadowSlot, result.shadowDistance);
+                    shadowQueue.SetWeight(shadowSlot, result.direct);
+                    shadowQueue.SetPixel(shadowSlot, shaded.GetPixel(i));
+                    shadowSlot++;
+                }
+                if(!result.bounceWeight.IsBlack()) {
+                    bounced.SetRay(bounceSlot, result.bounce);
+                    bounced.SetMaximumDistance(bounceSlot, std::numeric_limits<float>::infinity());
+                    bounced.SetWeight(bounceSlot, result.bounceWeight);
+                    bounced.SetPixel(bounceSlot, shaded.GetPixel(i));
+                    bounced.GetRandomState(bounceSlot) = shaded.GetRandomState(i);
+                    bounced.GetHit(bounceSlot) = QueueHit();
+                    bounceSlot++;
+                }
+            }
+        });
+    }
+
+    void WavefrontRenderer::Connect(const WavefrontScene& scene) {
+        const RayQueue& connected = *shadows;
+        pool.ParallelFor(connected.GetSize(), grainSize, [&](std::size_t begin, std::size_t end) {
+            TraceRecorder::Scope trace("connect", "wavefront", "rays", (std::int64_t)(end - begin));
+            MemoryArena& arena = MemoryArena::GetThreadArena();
+            MemoryArena::Scope scratch(arena);
+            bool* occluded = arena.Allocate<bool>(end - begin);
+            scene.connect(connected, begin, end, occluded);
+            RenderCounters::Add(RenderCounters::shadowRays, end - begin);
+            for(std::size_t i = begin; i < end; i++)
+                if(!occluded[i - begin])
+                    accumulated[connected.GetPixel(i)] += connected.GetWeight(i);
+        });
+        statistics.shadowRays += connected.GetSize();
+    }
+
+    std::uint32_t WavefrontRenderer::Seed(std::uint64_t index) {
+        // splitmix64 finalizer, so neighbouring paths start far apart
+        std::uint64_t z = index + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        std::uint32_t state = (std::uint32_t)z;
+        return state != 0 ? state : 1u;
+    }
+}
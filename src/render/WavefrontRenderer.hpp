@@ -0,0 +1,252 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   WavefrontRenderer.hpp
+ * 
+ * Path tracer that advances large batches of paths one stage at a time
+ * Class and method definitions
+ */
+
+/*!
+ \file WavefrontRenderer.hpp
+ Header definition for the WavefrontRenderer class
+ */
+
+#ifndef WAVEFRONTRENDERER_HPP
+#define	WAVEFRONTRENDERER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Camera.hpp"
+#include "Framebuffer.hpp"
+#include "RayQueue.hpp"
+#include "TileRenderer.hpp"
+#include "../accel/AABB.hpp"
+#include "../utility/Color.hpp"
+#include "../utility/Ray.hpp"
+
+namespace SCPPR {
+
+    class TaskPool;
+
+    //! Limits of a wavefront render
+    struct WavefrontSettings {
+        int samplesPerPixel;     //!< Paths started through every pixel
+        int maximumBounces;      //!< Bounces a path may take after its primary hit
+        int rouletteBounces;     //!< Bounces before Russian roulette may end a path
+        std::size_t waveSize;    //!< Most paths in flight at once
+        bool sortRays;           //!< Sort rays by direction and origin before tracing them
+        bool sortHits;           //!< Sort hits by material before shading them
+
+        WavefrontSettings() :
+            samplesPerPixel(16), maximumBounces(4), rouletteBounces(2), waveSize(1 << 18),
+            sortRays(true), sortHits(true) {
+
+        }
+    };
+
+    //! Work done by a wavefront render
+    struct WavefrontStatistics {
+        int waves;                   //!< Waves of paths traced
+        std::uint64_t paths;         //!< Paths started
+        std::uint64_t rays;          //!< Closest hit rays traced
+        std::uint64_t shadowRays;    //!< Shadow rays traced
+        double seconds;              //!< Wall time of the whole render
+        double sortSeconds;          //!< Time spent sorting queues
+        double extendSeconds;        //!< Time spent finding closest hits
+        double shadeSeconds;         //!< Time spent shading hits
+        double connectSeconds;       //!< Time spent tracing shadow rays
+
+        WavefrontStatistics() :
+            waves(0), paths(0), rays(0), shadowRays(0), seconds(0.0), sortSeconds(0.0),
+            extendSeconds(0.0), shadeSeconds(0.0), connectSeconds(0.0) {
+
+        }
+    };
+
+    //! What the scene makes of one hit, or of one miss
+    struct ShadeResult {
+        Color emitted;          //!< Radiance leaving the hit back along the ray
+        Color direct;           //!< Light the shadow ray brings when nothing blocks it
+        Ray shadow;             //!< Ray towards a light, traced when direct is not black
+        float shadowDistance;   //!< Distance along shadow to the light
+        Color bounceWeight;     //!< Throughput factor of the bounce, black ends the path
+        Ray bounce;             //!< Next ray of the path
+
+        ShadeResult() :
+            shadowDistance(0.0f) {
+
+        }
+    };
+
+    //! Callbacks through which the wavefront renderer sees a scene
+    struct WavefrontScene {
+
+        //! Finds the closest hit of rays [begin, end) of a queue
+        /*!
+         Writes GetHit for every ray, with t left at infinity on a miss. Ray
+         i is traced up to GetMaximumDistance(i). The material of the hit,
+         misses included, is the bin the shade stage sorts by.
+         */
+        typedef std::function<void(RayQueue& rays, std::size_t begin, std::size_t end)> ExtendFunction;
+
+        //! Shades the hit of a ray, using random's three numbers in [0, 1)
+        typedef std::function<void(const Ray& ray, const QueueHit& hit, const float random[3],
+                                   ShadeResult& result)> ShadeFunction;
+
+        //! Sets occluded[i - begin] for shadow rays [begin, end) blocked within their distance
+        typedef std::function<void(const RayQueue& shadows, std::size_t begin, std::size_t end,
+                                   bool* occluded)> ConnectFunction;
+
+        ExtendFunction extend;    //!< Closest hit query
+        ShadeFunction shade;      //!< Surface and sky response
+        ConnectFunction connect;  //!< Occlusion query
+        AABB bounds;              //!< Bounds of the scene, for binning ray origins
+    };
+
+    //! Path tracer that runs each stage over a whole wave of paths at once
+    /*!
+     A recursive integrator follows one path at a time and jumps around the
+     scene with every bounce. This renderer keeps up to waveSize paths in
+     RayQueues and advances all of them together, one stage per pass over
+     the queue, each pass split across the pool:
+
+     - generate fills the queue with camera rays,
+     - extend finds the closest hit of every queued ray,
+     - shade turns every hit into emitted light, a shadow ray and a bounce,
+     - connect traces the shadow rays and adds the light they bring.
+
+     Between the stages the queues are reordered with a radix sort: rays by
+     direction octant, origin cell and direction before extend and connect,
+     so neighbouring rays walk the same nodes and can be traced in packets;
+     hits by material before shade, so each material's data is touched in
+     one run. Every pixel has at most one path in a wave, so the light a
+     path gathers is added to its pixel without locks.
+     */
+    class WavefrontRenderer {
+
+    public:
+
+        static const int rayKeyBits = 24; //!< Bits of the key rays are sorted by
+
+        // begin constructor declarations---------------------------------------
+
+        //! Parameterized constructor
+        /*!
+         Constructs a renderer running on pool with the given settings
+         */
+        WavefrontRenderer(TaskPool& poolArg, const WavefrontSettings& settingsArg);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Returns the settings
+        const WavefrontSettings& GetSettings() const;
+
+        //! Renders samplesPerPixel paths through every pixel of framebuffer
+        /*!
+         Calls onTile for every tile of tileSize pixels once the image is
+         final, when it is set.
+         */
+        WavefrontStatistics Render(const Camera& camera, const WavefrontScene& scene,
+                                   Framebuffer& framebuffer, int tileSize = 32,
+                                   const TileRenderer::TileCallback& onTile =
+                                       TileRenderer::TileCallback());
+
+        //! Returns the key rays are sorted by before extend and connect
+        /*!
+         Direction octant in the top three bits, then the origin on a 32 by
+         32 by 32 grid over bounds and last the direction on an 8 by 8
+         octahedral grid, both Morton ordered. Origin comes before direction
+         because bounce rays of one octant that start close together share
+         far more nodes than distant rays pointing the same way.
+         */
+        static std::uint32_t MakeRayKey(const Ray& ray, const AABB& bounds);
+
+        //! Returns the next uniform number in [0, 1) of a xorshift state
+        static float NextRandom(std::uint32_t& state);
+
+    protected:
+
+        //! Fills the path queue with the camera rays of paths [first, first + count)
+        void Generate(const Camera& camera, int width, int height, std::uint64_t first,
+                      std::size_t count);
+
+        //! Sets the key of every queued ray with MakeRayKey and sorts the queue
+        void SortRays(RayQueue*& queue, const AABB& bounds);
+
+        //! Sets the key of every queued ray to its hit material and sorts the queue
+        void SortHits(RayQueue*& queue);
+
+        //! Stable radix sort of a queue by its keys through spare
+        /*!
+         Only the low keyBits bits of the keys take part. On return queue
+         points at the sorted queue and spare at the old one.
+         */
+        void SortQueue(RayQueue*& queue, int keyBits);
+
+        //! Shades every queued hit, filling the shadow and next queues
+        void Shade(const WavefrontScene& scene, int bounce);
+
+        //! Traces the shadow queue and adds the light of unblocked rays
+        void Connect(const WavefrontScene& scene);
+
+        //! Returns a non zero xorshift state for path index
+        static std::uint32_t Seed(std::uint64_t index);
+
+        TaskPool& pool;                           //!< Pool every stage runs on
+        WavefrontSettings settings;               //!< Limits of the render
+        RayQueue queues[4];                       //!< Storage for the four queues below
+        RayQueue* paths;                          //!< Paths to extend and shade
+        RayQueue* nextPaths;                      //!< Paths that bounced
+        RayQueue* shadows;                        //!< Shadow rays to connect
+        RayQueue* spare;                          //!< Sort destination
+        std::vector<Color> accumulated;           //!< Summed path radiance of every pixel
+        std::vector<std::uint32_t> sortOrder[2];  //!< Slot order during a radix sort
+        std::vector<std::uint32_t> sortKeys[2];   //!< Keys during a radix sort
+        std::vector<std::size_t> histograms;      //!< Digit counts of every sort chunk
+        WavefrontStatistics statistics;           //!< Work done by the current render
+
+    private:
+
+        //! Private copy constructor
+        WavefrontRenderer(const WavefrontRenderer&);
+
+        //! Private assignment operator
+        WavefrontRenderer& operator= (const WavefrontRenderer&);
+    };
+
+    inline const WavefrontSettings& WavefrontRenderer::GetSettings() const {
+        return settings;
+    }
+
+    inline float WavefrontRenderer::NextRandom(std::uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (float)(state >> 8) * (1.0f / 16777216.0f);
+    }
+}
+
+#endif	/* WAVEFRONTRENDERER_HPP */
@@ -0,0 +1,197 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   AttributeArray.hpp
+ * 
+ * Array of points or normals with a selectable storage layout
+ * Class and method definitions
+ */
+
+/*!
+ \file AttributeArray.hpp
+ Header definition for the AttributeArray class template
+ */
+
+#ifndef ATTRIBUTEARRAY_HPP
+#define	ATTRIBUTEARRAY_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "Normal.hpp"
+#include "Normal3Packed.hpp"
+#include "Point.hpp"
+#include "Point3Packed.hpp"
+
+namespace SCPPR {
+
+    //! Maps a 16 byte type to its 12 byte storage form
+    template <typename T>
+    struct PackedStorage;
+
+    //! Points are packed as Point3Packed
+    template <>
+    struct PackedStorage<Point> {
+        typedef Point3Packed Type;
+    };
+
+    //! Normals are packed as Normal3Packed
+    template <>
+    struct PackedStorage<Normal> {
+        typedef Normal3Packed Type;
+    };
+
+    //! Growable array of Points or Normals
+    /*!
+     Elements are read and written as T. When packed is set they are stored
+     as three floats, the layout for scene data that stays in memory;
+     otherwise they are stored as T itself, which saves the conversion for
+     short lived data that is read many times.
+     */
+    template <typename T, bool packed = true>
+    class AttributeArray {
+
+    public:
+
+        //! Type of a stored element
+        typedef typename std::conditional<packed, typename PackedStorage<T>::Type, T>::type StorageType;
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs an empty array
+         */
+        AttributeArray();
+
+        // end constructor declarations-----------------------------------------
+
+        //! Replaces the contents with count copies of value
+        void Assign(std::size_t count, const T& value = T());
+
+        //! Replaces the contents with the stored elements in [begin, end)
+        void Assign(const StorageType* begin, const StorageType* end);
+
+        //! Appends value
+        void PushBack(const T& value);
+
+        //! Removes every element
+        void Clear();
+
+        //! Releases unused capacity
+        void ShrinkToFit();
+
+        //! Returns element index
+        T Get(std::size_t index) const;
+
+        //! Replaces element index with value
+        void Set(std::size_t index, const T& value);
+
+        //! Returns the number of elements
+        std::size_t GetSize() const;
+
+        //! Returns true when the array holds no elements
+        bool IsEmpty() const;
+
+        //! Returns the bytes held by the elements
+        std::size_t GetMemoryUsage() const;
+
+        //! Returns the stored elements
+        const StorageType* GetData() const;
+
+        //! Returns the stored elements
+        StorageType* GetData();
+
+    protected:
+
+        std::vector<StorageType> elements; //!< Stored elements
+    };
+
+    template <typename T, bool packed>
+    inline AttributeArray<T, packed>::AttributeArray() {
+
+    }
+
+    template <typename T, bool packed>
+    inline void AttributeArray<T, packed>::Assign(std::size_t count, const T& value) {
+        elements.assign(count, StorageType(value));
+    }
+
+    template <typename T, bool packed>
+    inline void AttributeArray<T, packed>::Assign(const StorageType* begin, const StorageType* end) {
+        elements.assign(begin, end);
+    }
+
+    template <typename T, bool packed>
+    inline void AttributeArray<T, packed>::PushBack(const T& value) {
+        elements.push_back(StorageType(value));
+    }
+
+    template <typename T, bool packed>
+    inline void AttributeArray<T, packed>::Clear() {
+        elements.clear();
+    }
+
+    template <typename T, bool packed>
+    inline void AttributeArray<T, packed>::ShrinkToFit() {
+        elements.shrink_to_fit();
+    }
+
+    template <typename T, bool packed>
+    inline T AttributeArray<T, packed>::Get(std::size_t index) const {
+        return T(elements[index]);
+    }
+
+    template <typename T, bool packed>
+    inline void AttributeArray<T, packed>::Set(std::size_t index, const T& value) {
+        elements[index] = StorageType(value);
+    }
+
+    template <typename T, bool packed>
+    inline std::size_t AttributeArray<T, packed>::GetSize() const {
+        return elements.size();
+    }
+
+    template <typename T, bool packed>
+    inline bool AttributeArray<T, packed>::IsEmpty() const {
+        return elements.empty();
+    }
+
+    template <typename T, bool packed>
+    inline std::size_t AttributeArray<T, packed>::GetMemoryUsage() const {
+        return elements.size() * sizeof(StorageType);
+    }
+
+    template <typename T, bool packed>
+    inline const typename AttributeArray<T, packed>::StorageType* AttributeArray<T, packed>::GetData() const {
+        return elements.data();
+    }
+
+    template <typename T, bool packed>
+    inline typename AttributeArray<T, packed>::StorageType* AttributeArray<T, packed>::GetData() {
+        return elements.data();
+    }
+}
+
+#endif	/* ATTRIBUTEARRAY_HPP */
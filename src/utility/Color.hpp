@@ -0,0 +1,208 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Color.hpp
+ * 
+ * Linear RGB color
+ * Class and method definitions
+ */
+
+/*!
+ \file Color.hpp
+ Header definition for the Color class
+ */
+
+#ifndef COLOR_HPP
+#define	COLOR_HPP
+
+#include <type_traits>
+
+namespace SCPPR {
+
+    //! Linear RGB color
+    /*!
+     Three floats with no upper bound, used for radiance as well as
+     reflectance. Trivially copyable so framebuffers can be written and
+     copied as raw memory.
+     */
+    class Color {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs black
+         */
+        constexpr Color();
+
+        //! Grey constructor
+        /*!
+         Constructs a color with all three channels set to value
+         */
+        constexpr explicit Color(float value);
+
+        //! Parameterized constructor
+        /*!
+         Constructs a color from red, green and blue channels
+         */
+        constexpr Color(float redArg, float greenArg, float blueArg);
+
+        // end constructor declarations-----------------------------------------
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the red channel
+        constexpr float GetRed() const;
+
+        //! Returns the green channel
+        constexpr float GetGreen() const;
+
+        //! Returns the blue channel
+        constexpr float GetBlue() const;
+
+        // end accessor declarations--------------------------------------------
+
+        //! Returns the Rec. 709 luminance
+        float GetLuminance() const;
+
+        //! Returns true when every channel is zero
+        bool IsBlack() const;
+
+        //! Displays the channels in the console
+        void DisplayContents() const;
+
+        // begin operator overloads---------------------------------------------
+
+        //! Channel wise addition
+        Color operator+ (const Color& other) const;
+
+        //! Channel wise increment
+        Color& operator+= (const Color& other);
+
+        //! Channel wise subtraction
+        Color operator- (const Color& other) const;
+
+        //! Channel wise product
+        Color operator* (const Color& other) const;
+
+        //! Channel wise product in place
+        Color& operator*= (const Color& other);
+
+        //! Scaling of every channel
+        Color operator* (float scalar) const;
+
+        //! Division of every channel
+        Color operator/ (float scalar) const;
+
+        // end operator overloads-----------------------------------------------
+
+    protected:
+
+        float red;   //!< Red channel
+        float green; //!< Green channel
+        float blue;  //!< Blue channel
+    };
+
+    static_assert(std::is_trivially_copyable<Color>::value, "Color must be trivially copyable");
+
+    inline constexpr Color::Color() :
+        red(0.0f), green(0.0f), blue(0.0f) {
+
+    }
+
+    inline constexpr Color::Color(float value) :
+        red(value), green(value), blue(value) {
+
+    }
+
+    inline constexpr Color::Color(float redArg, float greenArg, float blueArg) :
+        red(redArg), green(greenArg), blue(blueArg) {
+
+    }
+
+    inline constexpr float Color::GetRed() const {
+        return red;
+    }
+
+    inline constexpr float Color::GetGreen() const {
+        return green;
+    }
+
+    inline constexpr float Color::GetBlue() const {
+        return blue;
+    }
+
+    inline float Color::GetLuminance() const {
+        return 0.2126f * red + 0.7152f * green + 0.0722f * blue;
+    }
+
+    inline bool Color::IsBlack() const {
+        return red == 0.0f && green == 0.0f && blue == 0.0f;
+    }
+
+    inline Color Color::operator+ (const Color& other) const {
+        return Color(red + other.red, green + other.green, blue + other.blue);
+    }
+
+    inline Color& Color::operator+= (const Color& other) {
+        red += other.red;
+        green += other.green;
+        blue += other.blue;
+        return(*this);
+    }
+
+    inline Color Color::operator- (const Color& other) const {
+        return Color(red - other.red, green - other.green, blue - other.blue);
+    }
+
+    inline Color Color::operator* (const Color& other) const {
+        return Color(red * other.red, green * other.green, blue * other.blue);
+    }
+
+    inline Color& Color::operator*= (const Color& other) {
+        red *= other.red;
+        green *= other.green;
+        blue *= other.blue;
+        return(*this);
+    }
+
+    inline Color Color::operator* (float scalar) const {
+        return Color(red * scalar, green * scalar, blue * scalar);
+    }
+
+    inline Color Color::operator/ (float scalar) const {
+        float inverse = 1.0f / scalar;
+        return Color(red * inverse, green * inverse, blue * inverse);
+    }
+
+    //! Scaling of a color with the scalar on the left
+    Color operator* (float scalar, const Color& color);
+
+    inline Color operator* (float scalar, const Color& color) {
+        return color * scalar;
+    }
+}
+
+#endif	/* COLOR_HPP */
@@ -0,0 +1,57 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   ErrorMessage.hpp
+ * 
+ * Error reporting for the loaders and writers
+ * Function definitions
+ */
+
+/*!
+ \file ErrorMessage.hpp
+ Header definition for the Fail helper shared by the file readers and
+ writers
+ */
+
+#ifndef ERRORMESSAGE_HPP
+#define	ERRORMESSAGE_HPP
+
+#include <string>
+
+namespace SCPPR {
+
+    //! Stores message in error, when one was passed, and returns false
+    /*!
+     Loaders and writers report failure by returning false and describe it
+     through an optional string, so a failing path can end in
+     return Fail(error, "...").
+     */
+    inline bool Fail(std::string* error, const std::string& message) {
+        if(error)
+            *error = message;
+        return false;
+    }
+
+}
+
+#endif	/* ERRORMESSAGE_HPP */
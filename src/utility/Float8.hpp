@@ -0,0 +1,732 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Float8.hpp
+ * 
+ * Eight lane float register wrapper for SIMD packet operations
+ * Class and method definitions
+ */
+
+/*!
+ \file Float8.hpp
+ Header definition for Float8 and Mask8 SIMD register wrappers
+ */
+
+#ifndef FLOAT8_HPP
+#define	FLOAT8_HPP
+
+#include <cmath>
+#include <cstdint>
+
+// Select a SIMD backend. AVX is used whenever the compiler targets it
+// (e.g. -mavx2 or -march=native), otherwise SSE2 pairs are used on x86 and a
+// portable scalar loop everywhere else. Define SCPPR_FORCE_SCALAR to disable
+// intrinsics completely.
+#if !defined(SCPPR_FORCE_SCALAR) && defined(__AVX__)
+#define SCPPR_SIMD_AVX 1
+#include <immintrin.h>
+#elif !defined(SCPPR_FORCE_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#define SCPPR_SIMD_SSE 1
+#include <emmintrin.h>
+#else
+#define SCPPR_SIMD_SCALAR 1
+#endif
+
+namespace SCPPR {
+
+    class Mask8;
+
+    //! Eight lane float register
+    /*!
+     A wrapper around a 256 bit register (or a pair of 128 bit registers) used
+     as the lane type of the structure-of-arrays packet classes. Lane i of every
+     operand is combined with lane i of every other operand.
+     */
+    class alignas(32) Float8 {
+
+    public:
+
+        static const int width = 8; //!< Number of lanes
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs a register with all lanes set to 0
+         */
+        Float8();
+
+        //! Broadcast constructor
+        /*!
+         Constructs a register with all lanes set to scalar
+         */
+        Float8(float scalar);
+
+        //! Lane constructor
+        /*!
+         Constructs a register from eight lane values, lane 0 first
+         */
+        Float8(float l0, float l1, float l2, float l3,
+               float l4, float l5, float l6, float l7);
+
+        // end constructor declarations-----------------------------------------
+
+        // begin load and store declarations------------------------------------
+
+        //! Loads eight floats from a 32 byte aligned address
+        static Float8 Load(const float* source);
+
+        //! Loads eight floats from an unaligned address
+        static Float8 LoadUnaligned(const float* source);
+
+        //! Stores eight floats to a 32 byte aligned address
+        void Store(float* destination) const;
+
+        //! Stores eight floats to an unaligned address
+        void StoreUnaligned(float* destination) const;
+
+        //! Returns the value of a single lane
+        float operator[] (int lane) const;
+
+        //! Sets the value of a single lane
+        void SetLane(int lane, float value);
+
+        // end load and store declarations--------------------------------------
+
+        // begin operator overloads---------------------------------------------
+
+        Float8 operator+ (const Float8& other) const;
+        Float8 operator- (const Float8& other) const;
+        Float8 operator* (const Float8& other) const;
+        Float8 operator/ (const Float8& other) const;
+        Float8 operator- (void) const;
+
+        Float8& operator+= (const Float8& other);
+        Float8& operator-= (const Float8& other);
+        Float8& operator*= (const Float8& other);
+        Float8& operator/= (const Float8& other);
+
+        Mask8 operator< (const Float8& other) const;
+        Mask8 operator<= (const Float8& other) const;
+        Mask8 operator> (const Float8& other) const;
+        Mask8 operator>= (const Float8& other) const;
+        Mask8 operator== (const Float8& other) const;
+
+        // end operator overloads-----------------------------------------------
+
+        // begin static maths methods-------------------------------------------
+
+        //! Lane-wise minimum
+        static Float8 Min(const Float8& a, const Float8& b);
+
+        //! Lane-wise maximum
+        static Float8 Max(const Float8& a, const Float8& b);
+
+        //! Lane-wise square root
+        static Float8 Sqrt(const Float8& a);
+
+        //! Lane-wise absolute value
+        static Float8 Abs(const Float8& a);
+
+        //! Lane-wise a * b + c, fused when the target supports FMA
+        static Float8 MultiplyAdd(const Float8& a, const Float8& b, const Float8& c);
+
+        //! Lane-wise a * b - c, fused when the target supports FMA
+        static Float8 MultiplySub(const Float8& a, const Float8& b, const Float8& c);
+
+        //! Per lane choice of a where mask is set and b elsewhere
+        static Float8 Select(const Mask8& mask, const Float8& a, const Float8& b);
+
+        //! Smallest value held in any lane
+        static float HorizontalMin(const Float8& a);
+
+        //! Largest value held in any lane
+        static float HorizontalMax(const Float8& a);
+
+        // end static maths methods---------------------------------------------
+
+#if defined(SCPPR_SIMD_AVX)
+        explicit Float8(__m256 raw) : v(raw) {}
+        __m256 v; //!< Wrapped register
+#elif defined(SCPPR_SIMD_SSE)
+        Float8(__m128 rawLo, __m128 rawHi) : lo(rawLo), hi(rawHi) {}
+        __m128 lo; //!< Lanes 0-3
+        __m128 hi; //!< Lanes 4-7
+#else
+        float v[8]; //!< Wrapped lanes
+#endif
+    };
+
+    //! Eight lane boolean mask
+    /*!
+     Result of a Float8 comparison. Each lane is either all ones or all zeros.
+     */
+    class alignas(32) Mask8 {
+
+    public:
+
+        //! Default constructor
+        /*!
+         Constructs a mask with no lanes set
+         */
+        Mask8();
+
+        //! Broadcast constructor
+        /*!
+         Constructs a mask with every lane set to value
+         */
+        explicit Mask8(bool value);
+
+        //! Constructs a mask from the low eight bits of bits, bit i for lane i
+        static Mask8 FromBits(int bits);
+
+        //! Returns one bit per lane, bit i for lane i
+        int GetBits() const;
+
+        //! Returns true if any lane is set
+        bool Any() const;
+
+        //! Returns true if every lane is set
+        bool All() const;
+
+        //! Returns true if no lane is set
+        bool None() const;
+
+        //! Returns whether a single lane is set
+        bool operator[] (int lane) const;
+
+        Mask8 operator& (const Mask8& other) const;
+        Mask8 operator| (const Mask8& other) const;
+        Mask8 operator^ (const Mask8& other) const;
+        Mask8 operator~ (void) const;
+        Mask8& operator&= (const Mask8& other);
+        Mask8& operator|= (const Mask8& other);
+
+        //! Lanes set in this mask and not in other
+        Mask8 AndNot(const Mask8& other) const;
+
+#if defined(SCPPR_SIMD_AVX)
+        explicit Mask8(__m256 raw) : v(raw) {}
+        __m256 v; //!< Wrapped register
+#elif defined(SCPPR_SIMD_SSE)
+        Mask8(__m128 rawLo, __m128 rawHi) : lo(rawLo), hi(rawHi) {}
+        __m128 lo; //!< Lanes 0-3
+        __m128 hi; //!< Lanes 4-7
+#else
+        uint32_t v[8]; //!< Wrapped lanes, 0 or 0xFFFFFFFF
+#endif
+    };
+
+    //! Scalar on the left hand side
+    Float8 operator+ (float scalar, const Float8& a);
+    Float8 operator- (float scalar, const Float8& a);
+    Float8 operator* (float scalar, const Float8& a);
+    Float8 operator/ (float scalar, const Float8& a);
+
+    //! Transposes eight xyzw rows into x, y and z registers
+    /*!
+     Each row must point to four readable floats, aligned to 16 bytes.
+     */
+    void TransposeRows(const float* const rows[8], Float8& x, Float8& y, Float8& z);
+
+    //! Transposes x, y and z registers into eight xyzw rows with w set to 0
+    /*!
+     Each row must point to four writable floats, aligned to 16 bytes.
+     */
+    void TransposeColumns(const Float8& x, const Float8& y, const Float8& z,
+                          float* const rows[8]);
+
+#if defined(SCPPR_SIMD_AVX)
+
+    // AVX backend------------------------------------------------------------
+
+    inline Float8::Float8() : v(_mm256_setzero_ps()) {}
+    inline Float8::Float8(float scalar) : v(_mm256_set1_ps(scalar)) {}
+    inline Float8::Float8(float l0, float l1, float l2, float l3,
+                          float l4, float l5, float l6, float l7) :
+        v(_mm256_setr_ps(l0, l1, l2, l3, l4, l5, l6, l7)) {}
+
+    inline Float8 Float8::Load(const float* source) {
+        return Float8(_mm256_load_ps(source));
+    }
+
+    inline Float8 Float8::LoadUnaligned(const float* source) {
+        return Float8(_mm256_loadu_ps(source));
+    }
+
+    inline void Float8::Store(float* destination) const {
+        _mm256_store_ps(destination, v);
+    }
+
+    inline void Float8::StoreUnaligned(float* destination) const {
+        _mm256_storeu_ps(destination, v);
+    }
+
+    inline Float8 Float8::operator+ (const Float8& o) const { return Float8(_mm256_add_ps(v, o.v)); }
+    inline Float8 Float8::operator- (const Float8& o) const { return Float8(_mm256_sub_ps(v, o.v)); }
+    inline Float8 Float8::operator* (const Float8& o) const { return Float8(_mm256_mul_ps(v, o.v)); }
+    inline Float8 Float8::operator/ (const Float8& o) const { return Float8(_mm256_div_ps(v, o.v)); }
+    inline Float8 Float8::operator- (void) const {
+        return Float8(_mm256_xor_ps(v, _mm256_set1_ps(-0.0f)));
+    }
+
+    inline Mask8 Float8::operator< (const Float8& o) const { return Mask8(_mm256_cmp_ps(v, o.v, _CMP_LT_OQ)); }
+    inline Mask8 Float8::operator<= (const Float8& o) const { return Mask8(_mm256_cmp_ps(v, o.v, _CMP_LE_OQ)); }
+    inline Mask8 Float8::operator> (const Float8& o) const { return Mask8(_mm256_cmp_ps(v, o.v, _CMP_GT_OQ)); }
+    inline Mask8 Float8::operator>= (const Float8& o) const { return Mask8(_mm256_cmp_ps(v, o.v, _CMP_GE_OQ)); }
+    inline Mask8 Float8::operator== (const Float8& o) const { return Mask8(_mm256_cmp_ps(v, o.v, _CMP_EQ_OQ)); }
+
+    inline Float8 Float8::Min(const Float8& a, const Float8& b) { return Float8(_mm256_min_ps(a.v, b.v)); }
+    inline Float8 Float8::Max(const Float8& a, const Float8& b) { return Float8(_mm256_max_ps(a.v, b.v)); }
+    inline Float8 Float8::Sqrt(const Float8& a) { return Float8(_mm256_sqrt_ps(a.v)); }
+    inline Float8 Float8::Abs(const Float8& a) {
+        return Float8(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v));
+    }
+
+    inline Float8 Float8::MultiplyAdd(const Float8& a, const Float8& b, const Float8& c) {
+#if defined(__FMA__)
+        return Float8(_mm256_fmadd_ps(a.v, b.v, c.v));
+#else
+        return Float8(_mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v));
+#endif
+    }
+
+    inline Float8 Float8::MultiplySub(const Float8& a, const Float8& b, const Float8& c) {
+#if defined(__FMA__)
+        return Float8(_mm256_fmsub_ps(a.v, b.v, c.v));
+#else
+        return Float8(_mm256_sub_ps(_mm256_mul_ps(a.v, b.v), c.v));
+#endif
+    }
+
+    inline Float8 Float8::Select(const Mask8& mask, const Float8& a, const Float8& b) {
+        return Float8(_mm256_blendv_ps(b.v, a.v, mask.v));
+    }
+
+    inline float Float8::HorizontalMin(const Float8& a) {
+        __m128 m = _mm_min_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+        m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(m);
+    }
+
+    inline float Float8::HorizontalMax(const Float8& a) {
+        __m128 m = _mm_max_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+        m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(m);
+    }
+
+    inline Mask8::Mask8() : v(_mm256_setzero_ps()) {}
+    inline Mask8::Mask8(bool value) :
+        v(_mm256_castsi256_ps(_mm256_set1_epi32(value ? -1 : 0))) {}
+
+    inline Mask8 Mask8::FromBits(int bits) {
+        const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        __m256 selected = _mm256_and_ps(_mm256_castsi256_ps(_mm256_set1_epi32(bits)),
+                                        _mm256_castsi256_ps(lanes));
+        return Mask8(_mm256_cmp_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(selected)),
+                                   _mm256_setzero_ps(), _CMP_NEQ_OQ));
+    }
+
+    inline int Mask8::GetBits() const { return _mm256_movemask_ps(v); }
+    inline bool Mask8::None() const { return _mm256_testz_ps(v, v) != 0; }
+
+    inline Mask8 Mask8::operator& (const Mask8& o) const { return Mask8(_mm256_and_ps(v, o.v)); }
+    inline Mask8 Mask8::operator| (const Mask8& o) const { return Mask8(_mm256_or_ps(v, o.v)); }
+    inline Mask8 Mask8::operator^ (const Mask8& o) const { return Mask8(_mm256_xor_ps(v, o.v)); }
+    inline Mask8 Mask8::operator~ (void) const {
+        return Mask8(_mm256_xor_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(-1))));
+    }
+    inline Mask8 Mask8::AndNot(const Mask8& o) const { return Mask8(_mm256_andnot_ps(o.v, v)); }
+
+    inline void TransposeRows(const float* const rows[8], Float8& x, Float8& y, Float8& z) {
+        __m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(rows[0])), _mm_load_ps(rows[4]), 1);
+        __m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(rows[1])), _mm_load_ps(rows[5]), 1);
+        __m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(rows[2])), _mm_load_ps(rows[6]), 1);
+        __m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(rows[3])), _mm_load_ps(rows[7]), 1);
+        __m256 t0 = _mm256_unpacklo_ps(r0, r1); // x0 x1 y0 y1
+        __m256 t1 = _mm256_unpacklo_ps(r2, r3); // x2 x3 y2 y3
+        __m256 t2 = _mm256_unpackhi_ps(r0, r1); // z0 z1 w0 w1
+        __m256 t3 = _mm256_unpackhi_ps(r2, r3); // z2 z3 w2 w3
+        x.v = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+        y.v = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+        z.v = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    }
+
+    inline void TransposeColumns(const Float8& x, const Float8& y, const Float8& z,
+                                 float* const rows[8]) {
+        __m256 zero = _mm256_setzero_ps();
+        __m256 t0 = _mm256_unpacklo_ps(x.v, y.v);  // x0 y0 x1 y1
+        __m256 t1 = _mm256_unpackhi_ps(x.v, y.v);  // x2 y2 x3 y3
+        __m256 t2 = _mm256_unpacklo_ps(z.v, zero); // z0 0 z1 0
+        __m256 t3 = _mm256_unpackhi_ps(z.v, zero); // z2 0 z3 0
+        __m256 r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        __m256 r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        _mm_store_ps(rows[0], _mm256_castps256_ps128(r0));
+        _mm_store_ps(rows[1], _mm256_castps256_ps128(r1));
+        _mm_store_ps(rows[2], _mm256_castps256_ps128(r2));
+        _mm_store_ps(rows[3], _mm256_castps256_ps128(r3));
+        _mm_store_ps(rows[4], _mm256_extractf128_ps(r0, 1));
+        _mm_store_ps(rows[5], _mm256_extractf128_ps(r1, 1));
+        _mm_store_ps(rows[6], _mm256_extractf128_ps(r2, 1));
+        _mm_store_ps(rows[7], _mm256_extractf128_ps(r3, 1));
+    }
+
+#elif defined(SCPPR_SIMD_SSE)
+
+    // SSE backend, two 128 bit halves----------------------------------------
+
+    inline Float8::Float8() : lo(_mm_setzero_ps()), hi(_mm_setzero_ps()) {}
+    inline Float8::Float8(float scalar) : lo(_mm_set1_ps(scalar)), hi(_mm_set1_ps(scalar)) {}
+    inline Float8::Float8(float l0, float l1, float l2, float l3,
+                          float l4, float l5, float l6, float l7) :
+        lo(_mm_setr_ps(l0, l1, l2, l3)), hi(_mm_setr_ps(l4, l5, l6, l7)) {}
+
+    inline Float8 Float8::Load(const float* source) {
+        return Float8(_mm_load_ps(source), _mm_load_ps(source + 4));
+    }
+
+    inline Float8 Float8::LoadUnaligned(const float* source) {
+        return Float8(_mm_loadu_ps(source), _mm_loadu_ps(source + 4));
+    }
+
+    inline void Float8::Store(float* destination) const {
+        _mm_store_ps(destination, lo);
+        _mm_store_ps(destination + 4, hi);
+    }
+
+    inline void Float8::StoreUnaligned(float* destination) const {
+        _mm_storeu_ps(destination, lo);
+        _mm_storeu_ps(destination + 4, hi);
+    }
+
+    inline Float8 Float8::operator+ (const Float8& o) const { return Float8(_mm_add_ps(lo, o.lo), _mm_add_ps(hi, o.hi)); }
+    inline Float8 Float8::operator- (const Float8& o) const { return Float8(_mm_sub_ps(lo, o.lo), _mm_sub_ps(hi, o.hi)); }
+    inline Float8 Float8::operator* (const Float8& o) const { return Float8(_mm_mul_ps(lo, o.lo), _mm_mul_ps(hi, o.hi)); }
+    inline Float8 Float8::operator/ (const Float8& o) const { return Float8(_mm_div_ps(lo, o.lo), _mm_div_ps(hi, o.hi)); }
+    inline Float8 Float8::operator- (void) const {
+        __m128 sign = _mm_set1_ps(-0.0f);
+        return Float8(_mm_xor_ps(lo, sign), _mm_xor_ps(hi, sign));
+    }
+
+    inline Mask8 Float8::operator< (const Float8& o) const { return Mask8(_mm_cmplt_ps(lo, o.lo), _mm_cmplt_ps(hi, o.hi)); }
+    inline Mask8 Float8::operator<= (const Float8& o) const { return Mask8(_mm_cmple_ps(lo, o.lo), _mm_cmple_ps(hi, o.hi)); }
+    inline Mask8 Float8::operator> (const Float8& o) const { return Mask8(_mm_cmpgt_ps(lo, o.lo), _mm_cmpgt_ps(hi, o.hi)); }
+    inline Mask8 Float8::operator>= (const Float8& o) const { return Mask8(_mm_cmpge_ps(lo, o.lo), _mm_cmpge_ps(hi, o.hi)); }
+    inline Mask8 Float8::operator== (const Float8& o) const { return Mask8(_mm_cmpeq_ps(lo, o.lo), _mm_cmpeq_ps(hi, o.hi)); }
+
+    inline Float8 Float8::Min(const Float8& a, const Float8& b) { return Float8(_mm_min_ps(a.lo, b.lo), _mm_min_ps(a.hi, b.hi)); }
+    inline Float8 Float8::Max(const Float8& a, const Float8& b) { return Float8(_mm_max_ps(a.lo, b.lo), _mm_max_ps(a.hi, b.hi)); }
+    inline Float8 Float8::Sqrt(const Float8& a) { return Float8(_mm_sqrt_ps(a.lo), _mm_sqrt_ps(a.hi)); }
+    inline Float8 Float8::Abs(const Float8& a) {
+        __m128 sign = _mm_set1_ps(-0.0f);
+        return Float8(_mm_andnot_ps(sign, a.lo), _mm_andnot_ps(sign, a.hi));
+    }
+
+    inline Float8 Float8::MultiplyAdd(const Float8& a, const Float8& b, const Float8& c) {
+        return a * b + c;
+    }
+
+    inline Float8 Float8::MultiplySub(const Float8& a, const Float8& b, const Float8& c) {
+        return a * b - c;
+    }
+
+    inline Float8 Float8::Select(const Mask8& mask, const Float8& a, const Float8& b) {
+        return Float8(_mm_or_ps(_mm_and_ps(mask.lo, a.lo), _mm_andnot_ps(mask.lo, b.lo)),
+                      _mm_or_ps(_mm_and_ps(mask.hi, a.hi), _mm_andnot_ps(mask.hi, b.hi)));
+    }
+
+    inline float Float8::HorizontalMin(const Float8& a) {
+        __m128 m = _mm_min_ps(a.lo, a.hi);
+        m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = _mm_min_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(m);
+    }
+
+    inline float Float8::HorizontalMax(const Float8& a) {
+        __m128 m = _mm_max_ps(a.lo, a.hi);
+        m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(m);
+    }
+
+    inline Mask8::Mask8() : lo(_mm_setzero_ps()), hi(_mm_setzero_ps()) {}
+    inline Mask8::Mask8(bool value) :
+        lo(_mm_castsi128_ps(_mm_set1_epi32(value ? -1 : 0))), hi(lo) {}
+
+    inline Mask8 Mask8::FromBits(int bits) {
+        __m128i b = _mm_set1_epi32(bits);
+        __m128i lowLanes = _mm_setr_epi32(1, 2, 4, 8);
+        __m128i highLanes = _mm_setr_epi32(16, 32, 64, 128);
+        return Mask8(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(b, lowLanes), lowLanes)),
+                     _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(b, highLanes), highLanes)));
+    }
+
+    inline int Mask8::GetBits() const {
+        return _mm_movemask_ps(lo) | (_mm_movemask_ps(hi) << 4);
+    }
+    inline bool Mask8::None() const { return GetBits() == 0; }
+
+    inline Mask8 Mask8::operator& (const Mask8& o) const { return Mask8(_mm_and_ps(lo, o.lo), _mm_and_ps(hi, o.hi)); }
+    inline Mask8 Mask8::operator| (const Mask8& o) const { return Mask8(_mm_or_ps(lo, o.lo), _mm_or_ps(hi, o.hi)); }
+    inline Mask8 Mask8::operator^ (const Mask8& o) const { return Mask8(_mm_xor_ps(lo, o.lo), _mm_xor_ps(hi, o.hi)); }
+    inline Mask8 Mask8::operator~ (void) const {
+        __m128 ones = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        return Mask8(_mm_xor_ps(lo, ones), _mm_xor_ps(hi, ones));
+    }
+    inline Mask8 Mask8::AndNot(const Mask8& o) const {
+        return Mask8(_mm_andnot_ps(o.lo, lo), _mm_andnot_ps(o.hi, hi));
+    }
+
+    inline void TransposeRows(const float* const rows[8], Float8& x, Float8& y, Float8& z) {
+        __m128 r0 = _mm_load_ps(rows[0]), r1 = _mm_load_ps(rows[1]);
+        __m128 r2 = _mm_load_ps(rows[2]), r3 = _mm_load_ps(rows[3]);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        __m128 r4 = _mm_load_ps(rows[4]), r5 = _mm_load_ps(rows[5]);
+        __m128 r6 = _mm_load_ps(rows[6]), r7 = _mm_load_ps(rows[7]);
+        _MM_TRANSPOSE4_PS(r4, r5, r6, r7);
+        x = Float8(r0, r4);
+        y = Float8(r1, r5);
+        z = Float8(r2, r6);
+    }
+
+    inline void TransposeColumns(const Float8& x, const Float8& y, const Float8& z,
+                                 float* const rows[8]) {
+        __m128 c0 = x.lo, c1 = y.lo, c2 = z.lo, c3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_store_ps(rows[0], c0);
+        _mm_store_ps(rows[1], c1);
+        _mm_store_ps(rows[2], c2);
+        _mm_store_ps(rows[3], c3);
+        __m128 c4 = x.hi, c5 = y.hi, c6 = z.hi, c7 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(c4, c5, c6, c7);
+        _mm_store_ps(rows[4], c4);
+        _mm_store_ps(rows[5], c5);
+        _mm_store_ps(rows[6], c6);
+        _mm_store_ps(rows[7], c7);
+    }
+
+#else
+
+    // Portable scalar backend------------------------------------------------
+
+    inline Float8::Float8() {
+        for(int i = 0; i < 8; i++) v[i] = 0;
+    }
+
+    inline Float8::Float8(float scalar) {
+        for(int i = 0; i < 8; i++) v[i] = scalar;
+    }
+
+    inline Float8::Float8(float l0, float l1, float l2, float l3,
+                          float l4, float l5, float l6, float l7) {
+        v[0] = l0; v[1] = l1; v[2] = l2; v[3] = l3;
+        v[4] = l4; v[5] = l5; v[6] = l6; v[7] = l7;
+    }
+
+    inline Float8 Float8::Load(const float* source) { return LoadUnaligned(source); }
+
+    inline Float8 Float8::LoadUnaligned(const float* source) {
+        Float8 result;
+        for(int i = 0; i < 8; i++) result.v[i] = source[i];
+        return result;
+    }
+
+    inline void Float8::Store(float* destination) const { StoreUnaligned(destination); }
+
+    inline void Float8::StoreUnaligned(float* destination) const {
+        for(int i = 0; i < 8; i++) destination[i] = v[i];
+    }
+
+#define SCPPR_FLOAT8_BINARY(op) \
+    inline Float8 Float8::operator op (const Float8& o) const { \
+        Float8 r; for(int i = 0; i < 8; i++) r.v[i] = v[i] op o.v[i]; return r; }
+    SCPPR_FLOAT8_BINARY(+)
+    SCPPR_FLOAT8_BINARY(-)
+    SCPPR_FLOAT8_BINARY(*)
+    SCPPR_FLOAT8_BINARY(/)
+#undef SCPPR_FLOAT8_BINARY
+
+    inline Float8 Float8::operator- (void) const {
+        Float8 r; for(int i = 0; i < 8; i++) r.v[i] = -v[i]; return r;
+    }
+
+#define SCPPR_FLOAT8_COMPARE(op) \
+    inline Mask8 Float8::operator op (const Float8& o) const { \
+        Mask8 r; for(int i = 0; i < 8; i++) r.v[i] = v[i] op o.v[i] ? 0xFFFFFFFFu : 0u; return r; }
+    SCPPR_FLOAT8_COMPARE(<)
+    SCPPR_FLOAT8_COMPARE(<=)
+    SCPPR_FLOAT8_COMPARE(>)
+    SCPPR_FLOAT8_COMPARE(>=)
+    SCPPR_FLOAT8_COMPARE(==)
+#undef SCPPR_FLOAT8_COMPARE
+
+    inline Float8 Float8::Min(const Float8& a, const Float8& b) {
+        Float8 r; for(int i = 0; i < 8; i++) r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; return r;
+    }
+
+    inline Float8 Float8::Max(const Float8& a, const Float8& b) {
+        Float8 r; for(int i = 0; i < 8; i++) r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return r;
+    }
+
+    inline Float8 Float8::Sqrt(const Float8& a) {
+        Float8 r; for(int i = 0; i < 8; i++) r.v[i] = std::sqrt(a.v[i]); return r;
+    }
+
+    inline Float8 Float8::Abs(const Float8& a) {
+        Float8 r; for(int i = 0; i < 8; i++) r.v[i] = std::fabs(a.v[i]); return r;
+    }
+
+    inline Float8 Float8::MultiplyAdd(const Float8& a, const Float8& b, const Float8& c) {
+        return a * b + c;
+    }
+
+    inline Float8 Float8::MultiplySub(const Float8& a, const Float8& b, const Float8& c) {
+        return a * b - c;
+    }
+
+    inline Float8 Float8::Select(const Mask8& mask, const Float8& a, const Float8& b) {
+        Float8 r; for(int i = 0; i < 8; i++) r.v[i] = mask.v[i] ? a.v[i] : b.v[i]; return r;
+    }
+
+    inline float Float8::HorizontalMin(const Float8& a) {
+        float m = a.v[0]; for(int i = 1; i < 8; i++) m = a.v[i] < m ? a.v[i] : m; return m;
+    }
+
+    inline float Float8::HorizontalMax(const Float8& a) {
+        float m = a.v[0]; for(int i = 1; i < 8; i++) m = a.v[i] > m ? a.v[i] : m; return m;
+    }
+
+    inline Mask8::Mask8() {
+        for(int i = 0; i < 8; i++) v[i] = 0;
+    }
+
+    inline Mask8::Mask8(bool value) {
+        for(int i = 0; i < 8; i++) v[i] = value ? 0xFFFFFFFFu : 0u;
+    }
+
+    inline Mask8 Mask8::FromBits(int bits) {
+        Mask8 r; for(int i = 0; i < 8; i++) r.v[i] = (bits >> i) & 1 ? 0xFFFFFFFFu : 0u; return r;
+    }
+
+    inline int Mask8::GetBits() const {
+        int bits = 0; for(int i = 0; i < 8; i++) bits |= (v[i] ? 1 : 0) << i; return bits;
+    }
+
+    inline bool Mask8::None() const { return GetBits() == 0; }
+
+#define SCPPR_MASK8_BINARY(op) \
+    inline Mask8 Mask8::operator op (const Mask8& o) const { \
+        Mask8 r; for(int i = 0; i < 8; i++) r.v[i] = v[i] op o.v[i]; return r; }
+    SCPPR_MASK8_BINARY(&)
+    SCPPR_MASK8_BINARY(|)
+    SCPPR_MASK8_BINARY(^)
+#undef SCPPR_MASK8_BINARY
+
+    inline Mask8 Mask8::operator~ (void) const {
+        Mask8 r; for(int i = 0; i < 8; i++) r.v[i] = ~v[i]; return r;
+    }
+
+    inline Mask8 Mask8::AndNot(const Mask8& o) const {
+        Mask8 r; for(int i = 0; i < 8; i++) r.v[i] = v[i] & ~o.v[i]; return r;
+    }
+
+    inline void TransposeRows(const float* const rows[8], Float8& x, Float8& y, Float8& z) {
+        for(int i = 0; i < 8; i++) {
+            x.v[i] = rows[i][0];
+            y.v[i] = rows[i][1];
+            z.v[i] = rows[i][2];
+        }
+    }
+
+    inline void TransposeColumns(const Float8& x, const Float8& y, const Float8& z,
+                                 float* const rows[8]) {
+        for(int i = 0; i < 8; i++) {
+            rows[i][0] = x.v[i];
+            rows[i][1] = y.v[i];
+            rows[i][2] = z.v[i];
+            rows[i][3] = 0;
+        }
+    }
+
+#endif
+
+    // Backend independent definitions----------------------------------------
+
+    inline float Float8::operator[] (int lane) const {
+        alignas(32) float lanes[8];
+        Store(lanes);
+        return lanes[lane];
+    }
+
+    inline void Float8::SetLane(int lane, float value) {
+        alignas(32) float lanes[8];
+        Store(lanes);
+        lanes[lane] = value;
+        *this = Load(lanes);
+    }
+
+    inline Float8& Float8::operator+= (const Float8& other) {
+        *this = *this + other;
+        return(*this);
+    }
+
+    inline Float8& Float8::operator-= (const Float8& other) {
+        *this = *this - other;
+        return(*this);
+    }
+
+    inline Float8& Float8::operator*= (const Float8& other) {
+        *this = *this * other;
+        return(*this);
+    }
+
+    inline Float8& Float8::operator/= (const Float8& other) {
+        *this = *this / other;
+        return(*this);
+    }
+
+    inline bool Mask8::Any() const { return !None(); }
+    inline bool Mask8::All() const { return GetBits() == 0xFF; }
+    inline bool Mask8::operator[] (int lane) const { return ((GetBits() >> lane) & 1) != 0; }
+
+    inline Mask8& Mask8::operator&= (const Mask8& other) {
+        *this = *this & other;
+        return(*this);
+    }
+
+    inline Mask8& Mask8::operator|= (const Mask8& other) {
+        *this = *this | other;
+        return(*this);
+    }
+
+    inline Float8 operator+ (float scalar, const Float8& a) { return Float8(scalar) + a; }
+    inline Float8 operator- (float scalar, const Float8& a) { return Float8(scalar) - a; }
+    inline Float8 operator* (float scalar, const Float8& a) { return Float8(scalar) * a; }
+    inline Float8 operator/ (float scalar, const Float8& a) { return Float8(scalar) / a; }
+}
+
+#endif	/* FLOAT8_HPP */
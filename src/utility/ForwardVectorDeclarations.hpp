@@ -5,15 +5,28 @@
  * Created on October 26, 2015, 4:33 PM
  * 
  * Helper file to resolve circular dependencies in Normal, Point and Vector classes
+ * and their eight lane packet counterparts
  * 
  */
 
 #ifndef FORWARDVECTORDECLARATIONS_HPP
 #define	FORWARDVECTORDECLARATIONS_HPP
+
+#include <Eigen/Core>
+
 namespace SCPPR {
     class Normal;
     class Vector;
     class Point;
+    class NormalPacket8;
+    class VectorPacket8;
+    class PointPacket8;
+    
+    //! Read-only view of the four floats wrapped by a Vector, Point or Normal
+    typedef Eigen::Map<const Eigen::Vector4f, Eigen::Aligned16> ConstCoordinates;
+    
+    //! Writable view of the four floats wrapped by a Vector, Point or Normal
+    typedef Eigen::Map<Eigen::Vector4f, Eigen::Aligned16> Coordinates;
 };
 #endif	/* FORWARDVECTORDECLARATIONS_HPP */
 
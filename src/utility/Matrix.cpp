@@ -39,6 +39,7 @@ THE SOFTWARE.
 #include <Eigen/LU>
 
 #include "ForwardVectorDeclarations.hpp"
+#include "Float8.hpp"
 #include "Matrix.hpp"
 #include "Point.hpp"
 #include "Normal.hpp"
@@ -65,11 +66,11 @@ namespace SCPPR {
     }
     
     Eigen::Affine3f Matrix::Rotate(float rads, Vector axis) {
-        return (Eigen::Affine3f)Eigen::AngleAxis<float>(rads, axis.GetContents().topRows(3));
+        return (Eigen::Affine3f)Eigen::AngleAxis<float>(rads, axis.GetContents().topRows(3).normalized());
     }
     
     Eigen::Affine3f Matrix::InverseRotate(float rads, Vector axis) {
-        return (Eigen::Affine3f)Eigen::AngleAxis<float>(-rads, axis.GetContents().topRows(3));
+        return (Eigen::Affine3f)Eigen::AngleAxis<float>(-rads, axis.GetContents().topRows(3).normalized());
     }
     
     void Matrix::DisplayContents() const {
@@ -78,22 +79,143 @@ namespace SCPPR {
     
     // Transforming a point
     Point Matrix::operator* (const Point& point) const {
-        // Extract translation component
-        Eigen::VectorXf translation(matrix.translation());
-        translation.resize(4);
-        translation.data()[3] = 0; // set w component to zero
-        return Point((matrix * point.GetContents()) + translation);
+        // Points carry w = 0, so the translation is added explicitly
+        Eigen::Vector4f result = matrix.matrix() * point.GetContents();
+        result.head<3>() += matrix.translation();
+        return Point(result);
     }
     
     // Transforming a vector
     Vector Matrix::operator* (const Vector& vector) const {
-        return Vector((Eigen::Affine3f)matrix.linear() * vector.GetContents());
+        Eigen::Vector4f result = Eigen::Vector4f::Zero();
+        result.head<3>() = matrix.linear() * vector.GetContents().head<3>();
+        return Vector(result);
     }
     
     // Transforming a normal
     Normal Matrix::operator* (const Normal& normal) const {
-        Eigen::Affine3f tempMatrix = (Eigen::Affine3f)matrix.linear().transpose();
-        return Normal(tempMatrix * normal.GetContents());
+        Eigen::Vector4f result = Eigen::Vector4f::Zero();
+        result.head<3>() = matrix.linear().transpose() * normal.GetContents().head<3>();
+        return Normal(result);
+    }
+    
+    namespace {
+        
+        // Applies a 3x3 matrix and an offset to separate x, y and z arrays,
+        // eight elements per iteration
+        void TransformArrays(const Eigen::Matrix3f& linear,
+                             const Eigen::Vector3f& offset,
+                             const float* x, const float* y, const float* z,
+                             float* xOut, float* yOut, float* zOut,
+                             std::size_t count) {
+            const Float8 m00(linear(0, 0)), m01(linear(0, 1)), m02(linear(0, 2));
+            const Float8 m10(linear(1, 0)), m11(linear(1, 1)), m12(linear(1, 2));
+            const Float8 m20(linear(2, 0)), m21(linear(2, 1)), m22(linear(2, 2));
+            const Float8 t0(offset(0)), t1(offset(1)), t2(offset(2));
+            
+            std::size_t i = 0;
+            for(; i + Float8::width <= count; i += Float8::width) {
+                Float8 px = Float8::LoadUnaligned(x + i);
+                Float8 py = Float8::LoadUnaligned(y + i);
+                Float8 pz = Float8::LoadUnaligned(z + i);
+                Float8::MultiplyAdd(m00, px, Float8::MultiplyAdd(m01, py,
+                    Float8::MultiplyAdd(m02, pz, t0))).StoreUnaligned(xOut + i);
+                Float8::MultiplyAdd(m10, px, Float8::MultiplyAdd(m11, py,
+                    Float8::MultiplyAdd(m12, pz, t1))).StoreUnaligned(yOut + i);
+                Float8::MultiplyAdd(m20, px, Float8::MultiplyAdd(m21, py,
+                    Float8::MultiplyAdd(m22, pz, t2))).StoreUnaligned(zOut + i);
+            }
+            
+            // remaining elements
+            for(; i < count; i++) {
+                Eigen::Vector3f result = linear * Eigen::Vector3f(x[i], y[i], z[i]) + offset;
+                xOut[i] = result(0);
+                yOut[i] = result(1);
+                zOut[i] = result(2);
+            }
+        }
+        
+        // Widens a 3x3 linear part to a 4x4 matrix with zero w row and column
+        Eigen::Matrix4f WidenLinear(const Eigen::Matrix3f& linear) {
+            Eigen::Matrix4f widened = Eigen::Matrix4f::Zero();
+            widened.topLeftCorner<3, 3>() = linear;
+            return widened;
+        }
+    }
+    
+    // Batch point transformation
+    void Matrix::TransformPoints(const Point* source, Point* destination,
+                                 std::size_t count) const {
+        // w row and column are zero, so w stays 0 through the product
+        const Eigen::Matrix4f linear = WidenLinear(matrix.linear());
+        Eigen::Vector4f offset = Eigen::Vector4f::Zero();
+        offset.head<3>() = matrix.translation();
+        for(std::size_t i = 0; i < count; i++)
+            destination[i].SetContents(linear * source[i].GetContents() + offset);
+    }
+    
+    void Matrix::TransformPoints(Point* points, std::size_t count) const {
+        TransformPoints(points, points, count);
+    }
+    
+    void Matrix::TransformPoints(const float* x, const float* y, const float* z,
+                                 float* xOut, float* yOut, float* zOut,
+                                 std::size_t count) const {
+        TransformArrays(matrix.linear(), matrix.translation(), x, y, z,
+                        xOut, yOut, zOut, count);
+    }
+    
+    void Matrix::TransformPoints(float* x, float* y, float* z,
+                                 std::size_t count) const {
+        TransformPoints(x, y, z, x, y, z, count);
+    }
+    
+    // Batch vector transformation
+    void Matrix::TransformVectors(const Vector* source, Vector* destination,
+                                  std::size_t count) const {
+        const Eigen::Matrix4f linear = WidenLinear(matrix.linear());
+        for(std::size_t i = 0; i < count; i++)
+            destination[i].SetContents(linear * source[i].GetContents());
+    }
+    
+    void Matrix::TransformVectors(Vector* vectors, std::size_t count) const {
+        TransformVectors(vectors, vectors, count);
+    }
+    
+    void Matrix::TransformVectors(const float* x, const float* y, const float* z,
+                                  float* xOut, float* yOut, float* zOut,
+                                  std::size_t count) const {
+        TransformArrays(matrix.linear(), Eigen::Vector3f::Zero(), x, y, z,
+                        xOut, yOut, zOut, count);
+    }
+    
+    void Matrix::TransformVectors(float* x, float* y, float* z,
+                                  std::size_t count) const {
+        TransformVectors(x, y, z, x, y, z, count);
+    }
+    
+    // Batch normal transformation
+    void Matrix::TransformNormals(const Normal* source, Normal* destination,
+                                  std::size_t count) const {
+        const Eigen::Matrix4f linear = WidenLinear(matrix.linear().transpose());
+        for(std::size_t i = 0; i < count; i++)
+            destination[i].SetContents(linear * source[i].GetContents());
+    }
+    
+    void Matrix::TransformNormals(Normal* normals, std::size_t count) const {
+        TransformNormals(normals, normals, count);
+    }
+    
+    void Matrix::TransformNormals(const float* x, const float* y, const float* z,
+                                  float* xOut, float* yOut, float* zOut,
+                                  std::size_t count) const {
+        TransformArrays(matrix.linear().transpose(), Eigen::Vector3f::Zero(), x, y, z,
+                        xOut, yOut, zOut, count);
+    }
+    
+    void Matrix::TransformNormals(float* x, float* y, float* z,
+                                  std::size_t count) const {
+        TransformNormals(x, y, z, x, y, z, count);
     }
     
     Matrix::~Matrix() {
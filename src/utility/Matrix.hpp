@@ -33,6 +33,8 @@ THE SOFTWARE.
 #ifndef MATRIX_HPP
 #define	MATRIX_HPP
 
+#include <cstddef>
+
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
@@ -87,10 +89,10 @@ namespace SCPPR {
         //! Returns an inverse affine scale for provided x y and z values
         static Eigen::Affine3f InverseScale(float x, float y, float z);
         
-        //! Returns an affine rotation around a given vector
+        //! Returns an affine rotation around a given vector, normalized first
         static Eigen::Affine3f Rotate(float rads, Vector axis);
         
-        //! Returns an inverse affine rotation around a given vector
+        //! Returns an inverse affine rotation around a given vector, normalized first
         static Eigen::Affine3f InverseRotate(float rads, Vector axis);
         
         //! Returns an affine translation with given x y and z values.
@@ -123,6 +125,69 @@ namespace SCPPR {
         
         // End operator overloads-----------------------------------------------
         
+        // Begin batch transformations------------------------------------------
+        
+        //! Transforms count points from source into destination
+        /*!
+         Equivalent to applying operator* to every point, without building a
+         temporary per point. source and destination may be the same array.
+         */
+        void TransformPoints(const Point* source, Point* destination,
+                             std::size_t count) const;
+        
+        //! Transforms count points in place
+        void TransformPoints(Point* points, std::size_t count) const;
+        
+        //! Transforms count points stored as separate x, y and z arrays
+        /*!
+         Output arrays may alias the matching input arrays.
+         */
+        void TransformPoints(const float* x, const float* y, const float* z,
+                             float* xOut, float* yOut, float* zOut,
+                             std::size_t count) const;
+        
+        //! Transforms count points stored as separate arrays in place
+        void TransformPoints(float* x, float* y, float* z,
+                             std::size_t count) const;
+        
+        //! Transforms count vectors from source into destination
+        void TransformVectors(const Vector* source, Vector* destination,
+                              std::size_t count) const;
+        
+        //! Transforms count vectors in place
+        void TransformVectors(Vector* vectors, std::size_t count) const;
+        
+        //! Transforms count vectors stored as separate x, y and z arrays
+        void TransformVectors(const float* x, const float* y, const float* z,
+                              float* xOut, float* yOut, float* zOut,
+                              std::size_t count) const;
+        
+        //! Transforms count vectors stored as separate arrays in place
+        void TransformVectors(float* x, float* y, float* z,
+                              std::size_t count) const;
+        
+        //! Transforms count normals from source into destination
+        /*!
+         Uses the same transposed linear part as operator*(const Normal&),
+         computed once for the whole batch.
+         */
+        void TransformNormals(const Normal* source, Normal* destination,
+                              std::size_t count) const;
+        
+        //! Transforms count normals in place
+        void TransformNormals(Normal* normals, std::size_t count) const;
+        
+        //! Transforms count normals stored as separate x, y and z arrays
+        void TransformNormals(const float* x, const float* y, const float* z,
+                              float* xOut, float* yOut, float* zOut,
+                              std::size_t count) const;
+        
+        //! Transforms count normals stored as separate arrays in place
+        void TransformNormals(float* x, float* y, float* z,
+                              std::size_t count) const;
+        
+        // End batch transformations--------------------------------------------
+        
         // Begin method definitions---------------------------------------------
         
         void DisplayContents() const;
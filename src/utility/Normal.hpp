@@ -34,21 +34,23 @@ THE SOFTWARE.
 #ifndef NORMAL_HPP
 #define	NORMAL_HPP
 
+#include <type_traits>
+
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
 #include "ForwardVectorDeclarations.hpp"
-#include "Vector.hpp"
-#include "Point.hpp"
 
 
 namespace SCPPR {
     
     //! 3D Normal Class
     /*!
-     A wrapper class for Vector4f to provide normal behaviour while transforming
+     A wrapper around four aligned floats to provide normal behaviour while
+     transforming. Defined entirely inline, trivially copyable and 16 byte
+     aligned, like Vector.
      */
-    class Normal {
+    class alignas(16) Normal {
         
     public:
         
@@ -58,56 +60,51 @@ namespace SCPPR {
         /*!
          Constructs a normal of {0,0,0}
          */
-        Normal();
+        constexpr Normal();
         
         //! Parameterized constructor
         /*!
          Constructs a normal of {xArg,yArg,zArg}
          */
-        Normal(float xArg, float yArg, float zArg);
+        constexpr Normal(float xArg, float yArg, float zArg);
         
         //! Array constructor
         /*!
-         Constructs a normal using the floats stored in the array at coords
+         Constructs a normal using the first three floats stored at coords
          */
-        Normal(float *coords);
+        constexpr Normal(const float *coords);
         
         //! Explicit constructor
         /*!
-         Constructs a normal using the provided Eigen::Vector4f
-         */
-        Normal(Eigen::Vector4f copy);
-        
-        //! Copy constructor
-        /*!
-         Clones the provided normal
+         Constructs a normal using the provided 4 component Eigen expression
          */
-        Normal(const Normal& copy);
+        template <typename Derived>
+        Normal(const Eigen::MatrixBase<Derived>& copy);
         
         //! Copy constructor
         /*!
          Creates a normal using the provided vector
          */
-        Normal(const Vector& copy);
+        constexpr Normal(const Vector& copy);
         
         //! Copy constructor
         /*!
          Creates a normal using the provided point
          */
-        Normal(const Point& copy);
+        constexpr Normal(const Point& copy);
         
         // end constructor declarations-----------------------------------------
         
         // begin accessor declarations------------------------------------------
 
         //! Returns X component of wrapped vector
-        float GetX();
+        constexpr float GetX() const;
 
         //! Returns Y component of wrapped vector
-        float GetY();
+        constexpr float GetY() const;
 
         //! Returns Z component of wrapped vector
-        float GetZ();
+        constexpr float GetZ() const;
 
         //! Sets X component of wrapped vector
         /*!
@@ -127,14 +124,20 @@ namespace SCPPR {
          */
         void SetZ(float zCoord);
 
-        //! Returns a copy of the wrapped vector
-        Eigen::Vector4f GetContents() const;
+        //! Returns a read-only Eigen view of the wrapped coordinates
+        ConstCoordinates GetContents() const;
 
         //! Explicitly sets the wrapped vector to a provided Eigen::Vector4f
         /*!
          \param newContents The new contents of the Normal wrapper
          */
-        void SetContents(Eigen::Vector4f newContents);
+        void SetContents(const Eigen::Vector4f& newContents);
+
+        //! Returns a pointer to the four wrapped floats
+        constexpr const float* Data() const;
+
+        //! Returns a pointer to the four wrapped floats
+        float* Data();
         
         // end accessor declarations--------------------------------------------
         
@@ -171,49 +174,127 @@ namespace SCPPR {
         //! Addition of a vector to a normal with vector on the right
         Vector operator+ (const Vector& secondVector) const;
         
-        //! Assignment operator
-        Normal& operator= (const Normal& secondNormal);
-        
         //! Increment operator
         Normal& operator+= (const Normal& secondNormal);
         
-        //! Destructor
-        ~Normal();
-        
     protected:
   
-        Eigen::Vector4f coordinates;  //!< Coordinates of the normal
+        float coordinates[4];  //!< Coordinates of the normal, w is always 0
+        
+        //! Returns a writable Eigen view of the wrapped coordinates
+        Coordinates GetMutableContents();
     };
+
+    static_assert(std::is_trivially_copyable<Normal>::value,
+                  "Normal must stay trivially copyable");
+    static_assert(sizeof(Normal) == 16 && alignof(Normal) == 16,
+                  "Normal must stay a single aligned 16 byte register");
+    
+    // default constructor
+    inline constexpr Normal::Normal() :
+        coordinates{0, 0, 0, 0} {
+        
+    }
+    
+    // parameterized constructor
+    inline constexpr Normal::Normal(float xArg, float yArg, float zArg) :
+        coordinates{xArg, yArg, zArg, 0} {
+        
+    }
     
-    //normal subtraction
+    // array constructor, 4th position is always 0
+    inline constexpr Normal::Normal(const float* coords) : 
+        coordinates{coords[0], coords[1], coords[2], 0} {
+        
+    }
+    
+    // explicit contructor
+    template <typename Derived>
+    inline Normal::Normal(const Eigen::MatrixBase<Derived>& copy) {
+        GetMutableContents() = copy;
+    }
+    
+    // accessors declaration
+    inline constexpr float Normal::GetX() const {
+        return coordinates[0];
+    }
+    
+    inline constexpr float Normal::GetY() const {
+        return coordinates[1];
+    }
+    
+    inline constexpr float Normal::GetZ() const {
+        return coordinates[2];
+    }
+    
+    inline void Normal::SetX(float xCoord) {
+        coordinates[0] = xCoord;
+    }
+    
+    inline void Normal::SetY(float yCoord) {
+        coordinates[1] = yCoord;
+    }
+    
+    inline void Normal::SetZ(float zCoord) {
+        coordinates[2] = zCoord;
+    }
+    
+    // get a view of the wrapped coordinates
+    inline ConstCoordinates Normal::GetContents() const {
+        return ConstCoordinates(coordinates);
+    }
+    
+    //set new wrapped coordinates
+    inline void Normal::SetContents(const Eigen::Vector4f& newContents) {
+        GetMutableContents() = newContents;
+    }
+    
+    inline constexpr const float* Normal::Data() const {
+        return coordinates;
+    }
+    
+    inline float* Normal::Data() {
+        return coordinates;
+    }
+    
+    inline Coordinates Normal::GetMutableContents() {
+        return Coordinates(coordinates);
+    }
+    
+    // get the magnitude of wrapped vector
+    inline float Normal::GetMagnitude() const {
+        return GetContents().norm();
+    }
+    
+    // get the magnitude of the wrapped vector squared
+    inline float Normal::GetSquaredMagnitude() const {
+        return GetContents().squaredNorm();
+    }
+    
+    // normalize the normal
+    inline void Normal::Normalize() {
+        GetMutableContents().normalize();
+    }
+    
+    //normal negation
     inline Normal Normal::operator- (void) const {
-        return Normal(-coordinates);
+        return Normal(-GetContents());
     }
     
     // normal addition
     inline Normal Normal::operator+ (const Normal& secondNormal) const {
-        return Normal(coordinates + secondNormal.coordinates);
+        return Normal(GetContents() + secondNormal.GetContents());
     }
     
     // normal scalar multiplication
     inline Normal Normal::operator* (const float scalar) const {
-        return Normal(coordinates * scalar);
-    }
-    
-    // normal assignment
-    inline Normal& Normal::operator= (const Normal& secondNormal) {
-        // check if assigning the same normal
-        if(this == &secondNormal)
-            return(*this);
-        //set coordinates to those of secondnormal and return this
-        coordinates = secondNormal.coordinates;
-        return(*this);
+        return Normal(GetContents() * scalar);
     }
     
     // Normal increment
     inline Normal& Normal::operator+= (const Normal& secondNormal) {
         // increment and return a reference to this normal
-        coordinates = coordinates + secondNormal.coordinates;
+        GetMutableContents() += secondNormal.GetContents();
         return(*this);
     }
     
@@ -226,5 +307,34 @@ namespace SCPPR {
     }
 };
 
-#endif	/* NORMAL_HPP */
+#include "Point.hpp"
+#include "Vector.hpp"
+
+namespace SCPPR {
+    
+    // operator overrides with circular dependencies
+    
+    // point constructor
+    inline constexpr Normal::Normal(const Point& copy) : 
+        coordinates{copy.GetX(), copy.GetY(), copy.GetZ(), 0} {
+        
+    }
+    
+    // vector constructor
+    inline constexpr Normal::Normal(const Vector& copy) :
+        coordinates{copy.GetX(), copy.GetY(), copy.GetZ(), 0} {
+        
+    }
+    
+    // dot product of vector and normal
+    inline float Normal::operator* (const Vector& secondVector) const {
+        return GetContents().dot(secondVector.GetContents());
+    }
+    
+    // adding a vector to a normal
+    inline Vector Normal::operator+ (const Vector& secondVector) const {
+        return Vector(GetContents() + secondVector.GetContents());
+    }
+};
 
+#endif	/* NORMAL_HPP */
@@ -0,0 +1,152 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Normal3Packed.hpp
+ * 
+ * Twelve byte storage form of Normal
+ * Class and method definitions
+ */
+
+/*!
+ \file Normal3Packed.hpp
+ Header definition for the Normal3Packed storage class
+ */
+
+#ifndef NORMAL3PACKED_HPP
+#define	NORMAL3PACKED_HPP
+
+#include <type_traits>
+
+#include "Normal.hpp"
+
+namespace SCPPR {
+
+    //! Three packed floats holding a Normal in memory
+    /*!
+     Normal keeps a fourth, always zero float so that it fills one aligned
+     register. Normal3Packed drops it for bulk storage, a quarter less memory
+     and bandwidth, and converts to and from Normal when the data is used.
+     It only stores; arithmetic goes through Normal.
+     */
+    class Normal3Packed {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs a normal of {0,0,0}
+         */
+        Normal3Packed();
+
+        //! Parameterized constructor
+        /*!
+         Constructs a normal of {xArg,yArg,zArg}
+         */
+        Normal3Packed(float xArg, float yArg, float zArg);
+
+        //! Normal constructor
+        /*!
+         Packs the x, y and z components of normal
+         */
+        explicit Normal3Packed(const Normal& normal);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Unpacks into a Normal
+        explicit operator Normal() const;
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns X component
+        float GetX() const;
+
+        //! Returns Y component
+        float GetY() const;
+
+        //! Returns Z component
+        float GetZ() const;
+
+        //! Returns a pointer to the three packed floats
+        const float* Data() const;
+
+        //! Returns a pointer to the three packed floats
+        float* Data();
+
+        // end accessor declarations--------------------------------------------
+
+        //! Displays contents of the normal using std::cout
+        void DisplayContents() const;
+
+    protected:
+
+        float coordinates[3]; //!< Packed x, y and z
+    };
+
+    static_assert(std::is_trivially_copyable<Normal3Packed>::value,
+                  "Normal3Packed must stay trivially copyable");
+    static_assert(sizeof(Normal3Packed) == 3 * sizeof(float),
+                  "Normal3Packed must stay three packed floats");
+
+    inline Normal3Packed::Normal3Packed() :
+        coordinates{0, 0, 0} {
+
+    }
+
+    inline Normal3Packed::Normal3Packed(float xArg, float yArg, float zArg) :
+        coordinates{xArg, yArg, zArg} {
+
+    }
+
+    inline Normal3Packed::Normal3Packed(const Normal& normal) :
+        coordinates{normal.GetX(), normal.GetY(), normal.GetZ()} {
+
+    }
+
+    inline Normal3Packed::operator Normal() const {
+        return Normal(coordinates);
+    }
+
+    inline float Normal3Packed::GetX() const {
+        return coordinates[0];
+    }
+
+    inline float Normal3Packed::GetY() const {
+        return coordinates[1];
+    }
+
+    inline float Normal3Packed::GetZ() const {
+        return coordinates[2];
+    }
+
+    inline const float* Normal3Packed::Data() const {
+        return coordinates;
+    }
+
+    inline float* Normal3Packed::Data() {
+        return coordinates;
+    }
+}
+
+#endif	/* NORMAL3PACKED_HPP */
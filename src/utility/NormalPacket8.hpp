@@ -0,0 +1,303 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   NormalPacket8.hpp
+ * 
+ * Structure-of-arrays packet of eight normals for SIMD linear algebra
+ * Class and method definitions
+ */
+
+/*!
+ \file NormalPacket8.hpp
+ Header definition for NormalPacket8 SIMD wrapper class
+ */
+
+#ifndef NORMALPACKET8_HPP
+#define	NORMALPACKET8_HPP
+
+#include <Eigen/Core>
+
+#include "ForwardVectorDeclarations.hpp"
+#include "Float8.hpp"
+#include "Normal.hpp"
+
+namespace SCPPR {
+
+    //! Packet of eight 3D normals
+    /*!
+     Stores eight Normals as separate x, y and z registers so that every
+     operation processes all eight normals at once. Mirrors the operator
+     surface of Normal, with scalar results returned as Float8.
+     */
+    class NormalPacket8 {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs eight normals of {0,0,0}
+         */
+        NormalPacket8();
+
+        //! Component constructor
+        /*!
+         Constructs a packet from x, y and z registers
+         */
+        NormalPacket8(const Float8& xArg, const Float8& yArg, const Float8& zArg);
+
+        //! Broadcast constructor
+        /*!
+         Constructs a packet holding eight copies of normal
+         */
+        explicit NormalPacket8(const Normal& normal);
+
+        //! Vector packet constructor
+        /*!
+         Creates a normal packet using the provided vector packet
+         */
+        explicit NormalPacket8(const VectorPacket8& vectors);
+
+        // end constructor declarations-----------------------------------------
+
+        // gather and scatter declarations--------------------------------------
+
+        //! Loads eight consecutive normals into a packet
+        static NormalPacket8 Gather(const Normal* normals);
+
+        //! Writes the packet out to eight consecutive normals
+        void Scatter(Normal* normals) const;
+
+        //! Returns the normal held in a single lane
+        Normal Extract(int lane) const;
+
+        //! Replaces the normal held in a single lane
+        void Insert(int lane, const Normal& normal);
+
+        // end gather and scatter declarations----------------------------------
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns X components of wrapped normals
+        const Float8& GetX() const;
+
+        //! Returns Y components of wrapped normals
+        const Float8& GetY() const;
+
+        //! Returns Z components of wrapped normals
+        const Float8& GetZ() const;
+
+        //! Sets X components of wrapped normals
+        void SetX(const Float8& xCoords);
+
+        //! Sets Y components of wrapped normals
+        void SetY(const Float8& yCoords);
+
+        //! Sets Z components of wrapped normals
+        void SetZ(const Float8& zCoords);
+
+        // end accessor declarations--------------------------------------------
+
+        // begin general methods declarations-----------------------------------
+
+        //! Returns the magnitude of each normal
+        Float8 GetMagnitude() const;
+
+        //! Returns the squared magnitude of each normal
+        Float8 GetSquaredMagnitude() const;
+
+        //! Normalizes each normal
+        void Normalize();
+
+        //! Displays the contents of the packet in the console.
+        void DisplayContents() const;
+
+        // end general methods declarations-------------------------------------
+
+        // begin operator override declarations---------------------------------
+
+        //! Negation operation
+        NormalPacket8 operator- (void) const;
+
+        //! Addition of two normal packets
+        NormalPacket8 operator+ (const NormalPacket8& secondNormals) const;
+
+        //! Per lane dot product with vectors on the right
+        Float8 operator* (const VectorPacket8& secondVectors) const;
+
+        //! Per lane scalar multiplication with scalars on the right
+        NormalPacket8 operator* (const Float8& scalars) const;
+
+        //! Addition of a vector packet with vectors on the right
+        VectorPacket8 operator+ (const VectorPacket8& secondVectors) const;
+
+        //! Increment operator
+        NormalPacket8& operator+= (const NormalPacket8& secondNormals);
+
+        // end operator override declarations-----------------------------------
+
+    protected:
+
+        Float8 x; //!< X components
+        Float8 y; //!< Y components
+        Float8 z; //!< Z components
+    };
+
+    inline NormalPacket8::NormalPacket8() {
+
+    }
+
+    inline NormalPacket8::NormalPacket8(const Float8& xArg, const Float8& yArg, const Float8& zArg) :
+        x(xArg), y(yArg), z(zArg) {
+
+    }
+
+    inline NormalPacket8::NormalPacket8(const Normal& normal) :
+        x(normal.GetX()), y(normal.GetY()), z(normal.GetZ()) {
+
+    }
+
+    inline NormalPacket8 NormalPacket8::Gather(const Normal* normals) {
+        const float* rowPointers[8];
+        for(int i = 0; i < 8; i++)
+            rowPointers[i] = normals[i].Data();
+        NormalPacket8 packet;
+        TransposeRows(rowPointers, packet.x, packet.y, packet.z);
+        return packet;
+    }
+
+    inline void NormalPacket8::Scatter(Normal* normals) const {
+        float* rowPointers[8];
+        for(int i = 0; i < 8; i++)
+            rowPointers[i] = normals[i].Data();
+        TransposeColumns(x, y, z, rowPointers);
+    }
+
+    inline Normal NormalPacket8::Extract(int lane) const {
+        return Normal(x[lane], y[lane], z[lane]);
+    }
+
+    inline void NormalPacket8::Insert(int lane, const Normal& normal) {
+        x.SetLane(lane, normal.GetX());
+        y.SetLane(lane, normal.GetY());
+        z.SetLane(lane, normal.GetZ());
+    }
+
+    inline const Float8& NormalPacket8::GetX() const {
+        return x;
+    }
+
+    inline const Float8& NormalPacket8::GetY() const {
+        return y;
+    }
+
+    inline const Float8& NormalPacket8::GetZ() const {
+        return z;
+    }
+
+    inline void NormalPacket8::SetX(const Float8& xCoords) {
+        x = xCoords;
+    }
+
+    inline void NormalPacket8::SetY(const Float8& yCoords) {
+        y = yCoords;
+    }
+
+    inline void NormalPacket8::SetZ(const Float8& zCoords) {
+        z = zCoords;
+    }
+
+    inline Float8 NormalPacket8::GetSquaredMagnitude() const {
+        return Float8::MultiplyAdd(x, x, Float8::MultiplyAdd(y, y, z * z));
+    }
+
+    inline Float8 NormalPacket8::GetMagnitude() const {
+        return Float8::Sqrt(GetSquaredMagnitude());
+    }
+
+    inline void NormalPacket8::Normalize() {
+        Float8 invMagnitude = Float8(1.0f) / GetMagnitude();
+        x *= invMagnitude;
+        y *= invMagnitude;
+        z *= invMagnitude;
+    }
+
+    // normal negation
+    inline NormalPacket8 NormalPacket8::operator- (void) const {
+        return NormalPacket8(-x, -y, -z);
+    }
+
+    // normal addition
+    inline NormalPacket8 NormalPacket8::operator+ (const NormalPacket8& secondNormals) const {
+        return NormalPacket8(x + secondNormals.x, y + secondNormals.y, z + secondNormals.z);
+    }
+
+    // normal scalar multiplication
+    inline NormalPacket8 NormalPacket8::operator* (const Float8& scalars) const {
+        return NormalPacket8(x * scalars, y * scalars, z * scalars);
+    }
+
+    // normal increment
+    inline NormalPacket8& NormalPacket8::operator+= (const NormalPacket8& secondNormals) {
+        x += secondNormals.x;
+        y += secondNormals.y;
+        z += secondNormals.z;
+        return(*this);
+    }
+
+    //! Per lane multiplication of normals by scalars, scalars on the left
+    NormalPacket8 operator* (const Float8& scalars, const NormalPacket8& normals);
+
+    // scalar multiplication of normal packet
+    inline NormalPacket8 operator* (const Float8& scalars, const NormalPacket8& normals) {
+        return normals * scalars;
+    }
+};
+
+#include "PointPacket8.hpp"
+#include "VectorPacket8.hpp"
+
+namespace SCPPR {
+
+    // operator overrides with circular dependencies
+
+    inline NormalPacket8::NormalPacket8(const VectorPacket8& vectors) :
+        x(vectors.GetX()), y(vectors.GetY()), z(vectors.GetZ()) {
+
+    }
+
+    // dot product of normals and vectors
+    inline Float8 NormalPacket8::operator* (const VectorPacket8& secondVectors) const {
+        return Float8::MultiplyAdd(x, secondVectors.GetX(),
+               Float8::MultiplyAdd(y, secondVectors.GetY(), z * secondVectors.GetZ()));
+    }
+
+    // adding vectors to normals
+    inline VectorPacket8 NormalPacket8::operator+ (const VectorPacket8& secondVectors) const {
+        return VectorPacket8(x + secondVectors.GetX(), y + secondVectors.GetY(),
+                             z + secondVectors.GetZ());
+    }
+};
+
+#endif	/* NORMALPACKET8_HPP */
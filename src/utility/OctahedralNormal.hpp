@@ -0,0 +1,300 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   OctahedralNormal.hpp
+ * 
+ * Unit normals compressed by octahedral mapping
+ * Class and method definitions
+ */
+
+/*!
+ \file OctahedralNormal.hpp
+ Header definition for the OctahedralMapping class and the OctahedralNormal
+ class template
+ */
+
+#ifndef OCTAHEDRALNORMAL_HPP
+#define	OCTAHEDRALNORMAL_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Float8.hpp"
+#include "Normal.hpp"
+#include "NormalPacket8.hpp"
+
+namespace SCPPR {
+
+    //! Maps unit normals to the [-1,1] square and back
+    /*!
+     The normal is projected onto the octahedron |x| + |y| + |z| = 1, and
+     the lower half of the octahedron is folded out over the corners of the
+     upper half's square. Two coordinates describe the direction with
+     nearly uniform precision over the sphere.
+     */
+    class OctahedralMapping {
+
+    public:
+
+        //! Returns the square coordinates of normal, the centre for a zero normal
+        static void Encode(const Normal& normal, float& u, float& v);
+
+        //! Returns the unit normal at the square coordinates u, v
+        static Normal Decode(float u, float v);
+
+        //! Encodes eight normals at once
+        static void Encode(const NormalPacket8& normals, Float8& u, Float8& v);
+
+        //! Decodes eight normals at once
+        static NormalPacket8 Decode(const Float8& u, const Float8& v);
+
+    protected:
+
+        //! Returns the sign of value, treating zero as positive
+        static float Sign(float value);
+    };
+
+    //! Unit normal compressed to bits bits
+    /*!
+     Stores the octahedral square coordinates as two signed fixed point
+     numbers of bits / 2 bits each, 32 bits for a worst case error under
+     0.004 degrees or 48 bits for under 0.00004 degrees, against 128 bits
+     for a Normal. The bytes are unaligned so that arrays stay packed.
+     */
+    template <int bits>
+    class OctahedralNormal {
+
+        static_assert(bits == 32 || bits == 48, "octahedral normals are 32 or 48 bits");
+
+    public:
+
+        static const int componentBits = bits / 2; //!< Bits per square coordinate
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs the normal {0,0,1}
+         */
+        OctahedralNormal();
+
+        //! Normal constructor
+        /*!
+         Encodes normal, which does not need to be unit length. A zero
+         normal encodes as {0,0,1}.
+         */
+        explicit OctahedralNormal(const Normal& normal);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Decodes into a unit Normal
+        explicit operator Normal() const;
+
+        //! Returns the first square coordinate
+        float GetU() const;
+
+        //! Returns the second square coordinate
+        float GetV() const;
+
+        //! Encodes count normals into encoded
+        static void Encode(const Normal* normals, OctahedralNormal* encoded, std::size_t count);
+
+        //! Decodes count normals into normals
+        static void Decode(const OctahedralNormal* encoded, Normal* normals, std::size_t count);
+
+    protected:
+
+        //! Largest magnitude of a fixed point coordinate
+        static const std::int32_t scale = (1 << (componentBits - 1)) - 1;
+
+        //! Rounds a square coordinate to fixed point
+        static std::int32_t Quantize(float value);
+
+        //! Stores both fixed point coordinates
+        void SetComponents(std::int32_t u, std::int32_t v);
+
+        //! Returns fixed point coordinate index
+        std::int32_t GetComponent(int index) const;
+
+        unsigned char bytes[bits / 8]; //!< Little endian u, then v
+    };
+
+    //! Four byte octahedral normal
+    typedef OctahedralNormal<32> OctahedralNormal32;
+
+    //! Six byte octahedral normal
+    typedef OctahedralNormal<48> OctahedralNormal48;
+
+    static_assert(sizeof(OctahedralNormal32) == 4 && std::is_trivially_copyable<OctahedralNormal32>::value,
+                  "OctahedralNormal32 must stay four packed bytes");
+    static_assert(sizeof(OctahedralNormal48) == 6 && std::is_trivially_copyable<OctahedralNormal48>::value,
+                  "OctahedralNormal48 must stay six packed bytes");
+
+    // zero counts as positive so that points on the fold map consistently
+    inline float OctahedralMapping::Sign(float value) {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    inline void OctahedralMapping::Encode(const Normal& normal, float& u, float& v) {
+        float x = normal.GetX(), y = normal.GetY(), z = normal.GetZ();
+        float l1 = std::abs(x) + std::abs(y) + std::abs(z);
+        if(l1 <= 0.0f) {
+            u = v = 0.0f;
+            return;
+        }
+        u = x / l1;
+        v = y / l1;
+        if(z < 0.0f) {
+            float foldedU = (1.0f - std::abs(v)) * Sign(u);
+            v = (1.0f - std::abs(u)) * Sign(v);
+            u = foldedU;
+        }
+    }
+
+    inline Normal OctahedralMapping::Decode(float u, float v) {
+        float z = 1.0f - std::abs(u) - std::abs(v);
+        float fold = std::max(-z, 0.0f);
+        Normal normal(u - fold * Sign(u), v - fold * Sign(v), z);
+        normal.Normalize();
+        return normal;
+    }
+
+    inline void OctahedralMapping::Encode(const NormalPacket8& normals, Float8& u, Float8& v) {
+        const Float8 zero(0.0f), one(1.0f), minusOne(-1.0f);
+        Float8 l1 = Float8::Abs(normals.GetX()) + Float8::Abs(normals.GetY()) +
+                    Float8::Abs(normals.GetZ());
+        Mask8 valid = l1 > zero;
+        Float8 projectedU = Float8::Select(valid, normals.GetX() / l1, zero);
+        Float8 projectedV = Float8::Select(valid, normals.GetY() / l1, zero);
+        Float8 signU = Float8::Select(projectedU >= zero, one, minusOne);
+        Float8 signV = Float8::Select(projectedV >= zero, one, minusOne);
+        Mask8 lower = normals.GetZ() < zero;
+        u = Float8::Select(lower, (one - Float8::Abs(projectedV)) * signU, projectedU);
+        v = Float8::Select(lower, (one - Float8::Abs(projectedU)) * signV, projectedV);
+    }
+
+    inline NormalPacket8 OctahedralMapping::Decode(const Float8& u, const Float8& v) {
+        const Float8 zero(0.0f), one(1.0f), minusOne(-1.0f);
+        Float8 z = one - Float8::Abs(u) - Float8::Abs(v);
+        Float8 fold = Float8::Max(-z, zero);
+        Float8 x = u - fold * Float8::Select(u >= zero, one, minusOne);
+        Float8 y = v - fold * Float8::Select(v >= zero, one, minusOne);
+        NormalPacket8 normals(x, y, z);
+        normals.Normalize();
+        return normals;
+    }
+
+    template <int bits>
+    const int OctahedralNormal<bits>::componentBits;
+
+    template <int bits>
+    const std::int32_t OctahedralNormal<bits>::scale;
+
+    template <int bits>
+    inline OctahedralNormal<bits>::OctahedralNormal() {
+        SetComponents(0, 0);
+    }
+
+    template <int bits>
+    inline OctahedralNormal<bits>::OctahedralNormal(const Normal& normal) {
+        float u, v;
+        OctahedralMapping::Encode(normal, u, v);
+        SetComponents(Quantize(u), Quantize(v));
+    }
+
+    template <int bits>
+    inline OctahedralNormal<bits>::operator Normal() const {
+        return OctahedralMapping::Decode(GetU(), GetV());
+    }
+
+    template <int bits>
+    inline float OctahedralNormal<bits>::GetU() const {
+        return (float)GetComponent(0) * (1.0f / scale);
+    }
+
+    template <int bits>
+    inline float OctahedralNormal<bits>::GetV() const {
+        return (float)GetComponent(1) * (1.0f / scale);
+    }
+
+    template <int bits>
+    void OctahedralNormal<bits>::Encode(const Normal* normals, OctahedralNormal* encoded, std::size_t count) {
+        alignas(32) float u[8], v[8];
+        std::size_t i = 0;
+        for(; i + 8 <= count; i += 8) {
+            Float8 packetU, packetV;
+            OctahedralMapping::Encode(NormalPacket8::Gather(normals + i), packetU, packetV);
+            packetU.Store(u);
+            packetV.Store(v);
+            for(int lane = 0; lane < 8; lane++)
+                encoded[i + lane].SetComponents(Quantize(u[lane]), Quantize(v[lane]));
+        }
+        for(; i < count; i++)
+            encoded[i] = OctahedralNormal(normals[i]);
+    }
+
+    template <int bits>
+    void OctahedralNormal<bits>::Decode(const OctahedralNormal* encoded, Normal* normals, std::size_t count) {
+        alignas(32) float u[8], v[8];
+        std::size_t i = 0;
+        for(; i + 8 <= count; i += 8) {
+            for(int lane = 0; lane < 8; lane++) {
+                u[lane] = encoded[i + lane].GetU();
+                v[lane] = encoded[i + lane].GetV();
+            }
+            OctahedralMapping::Decode(Float8::Load(u), Float8::Load(v)).Scatter(normals + i);
+        }
+        for(; i < count; i++)
+            normals[i] = Normal(encoded[i]);
+    }
+
+    template <int bits>
+    inline std::int32_t OctahedralNormal<bits>::Quantize(float value) {
+        value = std::min(std::max(value, -1.0f), 1.0f) * (float)scale;
+        return (std::int32_t)(value + (value >= 0.0f ? 0.5f : -0.5f));
+    }
+
+    template <int bits>
+    inline void OctahedralNormal<bits>::SetComponents(std::int32_t u, std::int32_t v) {
+        const int componentBytes = componentBits / 8;
+        std::uint32_t components[2] = { (std::uint32_t)u, (std::uint32_t)v };
+        for(int c = 0; c < 2; c++)
+            for(int b = 0; b < componentBytes; b++)
+                bytes[c * componentBytes + b] = (unsigned char)(components[c] >> (8 * b));
+    }
+
+    template <int bits>
+    inline std::int32_t OctahedralNormal<bits>::GetComponent(int index) const {
+        const int componentBytes = componentBits / 8;
+        std::uint32_t component = 0;
+        for(int b = 0; b < componentBytes; b++)
+            component |= (std::uint32_t)bytes[index * componentBytes + b] << (8 * b);
+        // sign extend from componentBits
+        return (std::int32_t)(component << (32 - componentBits)) >> (32 - componentBits);
+    }
+}
+
+#endif	/* OCTAHEDRALNORMAL_HPP */
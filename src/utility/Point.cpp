@@ -32,123 +32,15 @@ THE SOFTWARE
 
 #include <iostream>
 #include <cstdlib>
-#include <Eigen/Core>
-#include <Eigen/Dense>
 
 #include "ForwardVectorDeclarations.hpp"
 #include "Point.hpp"
-#include "Normal.hpp"
-#include "Vector.hpp"
 
 namespace SCPPR {
-    
-    // constructors declaration
-    
-    // default constructor
-    Point::Point() :
-        coordinates(0,0,0,0) {
-        
-    }
-    
-    // parameterized constructor
-    Point::Point(float xArg, float yArg, float zArg) :
-        coordinates(xArg,yArg,zArg,0) {
-        
-    }
-    
-    // array constructor
-    Point::Point(float* coords) : 
-        coordinates(coords) {
-        coordinates.data()[3] = 0; // ensure term 4 is set to 0
-    }
-    
-    // explicit constructor
-    Point::Point(Eigen::Vector4f copy) : 
-        coordinates(copy) {
-        
-    }
-    
-    // copy constructor
-    Point::Point(const Point& point) :
-        coordinates(point.coordinates){
-        
-    }
-    
-    // normal constructor
-    Point::Point(const Normal& normal) :
-        coordinates(normal.GetContents()){
-        
-    }
-    
-    // vector constructor
-    Point::Point(const Vector& vector) :
-        coordinates(vector.GetContents()) {
-        
-    }
-    // accessors declaration
-    
-    // returns x coordinate
-    float Point::GetX() const {
-        return coordinates.x();
-    }
-    
-    // returns y coordinate
-    float Point::GetY() const {
-        return coordinates.y();
-    }
-    
-    // returns z coordinate
-    float Point::GetZ() const {
-        return coordinates.z();
-    }
-    
-    // sets x coordinate
-    void Point::SetX(float xCoord) {
-        coordinates.x() = xCoord;
-    }
-    
-    // sets y coordinate
-    void Point::SetY(float yCoord) {
-        coordinates.y() = yCoord;
-    }
-    
-    // sets z coordinate
-    void Point::SetZ(float zCoord) {
-        coordinates.z() = zCoord;
-    }
-    
-    // returns wrapped vector
-    Eigen::Vector4f Point::GetContents() const {
-        return coordinates;
-    }
-    
-    // explicitely sets wrapped vector
-    void Point::SetContents(Eigen::Vector4f newContents) {
-        coordinates = newContents;
-    }
-    
+
+    // debug methods
     // displays the contents of the Point in the console
     void Point::DisplayContents() const {
-        std::cout << coordinates << std::endl;
-    }
-    
-    // destructor
-    Point::~Point() {
-        
-    }
-    
-    // Vector addition operator
-    Point Point::operator+ (const Vector& vector) const {
-        return Point(coordinates + vector.GetContents());
-    }
-    
-    // Vector subtraction operator
-    Point Point::operator- (const Vector& vector) const {
-        return Point(coordinates - vector.GetContents());
-    }
-    
-    // Creation of vector from point subtraction
-    Vector Point::operator- (const Point& point) const {
-        return Vector(coordinates - point.coordinates);
+        std::cout << GetContents() << std::endl;
     }
-};
\ No newline at end of file
+};
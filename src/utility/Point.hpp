@@ -33,20 +33,22 @@ THE SOFTWARE.
 #ifndef POINT_HPP
 #define	POINT_HPP
 
+#include <type_traits>
+
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
 #include "ForwardVectorDeclarations.hpp"
-#include "Normal.hpp"
-#include "Vector.hpp"
 
 namespace SCPPR {
     
     //! 3D point class
     /*!
-     A wrapper class for vector4f to provide point behaviour while transforming
+     A wrapper around four aligned floats to provide point behaviour while
+     transforming. Defined entirely inline, trivially copyable and 16 byte
+     aligned, like Vector.
      */
-    class Point {
+    class alignas(16) Point {
     public:
         // begin constructor declarations---------------------------------------
         
@@ -54,56 +56,51 @@ namespace SCPPR {
         /*!
          Constructs a point of {0,0,0}
          */
-        Point();
+        constexpr Point();
         
         //! Parameterized constructor
         /*!
          Constructs a point of {xArg,yArg,zArg}
          */
-        Point(float xArg, float yArg, float zArg);
+        constexpr Point(float xArg, float yArg, float zArg);
         
         //! Array constructor
         /*!
-         Constructs a point with the values stored at coords
+         Constructs a point with the first three values stored at coords
          */
-        Point(float *coords);
+        constexpr Point(const float *coords);
         
         //! Explicit constructor
         /*!
-         Constructs a point to wrap the provided Vector4f
+         Constructs a point to wrap the provided 4 component Eigen expression
          */
-        Point(Eigen::Vector4f copy);
-        
-        //! Copy constructor
-        /*!
-         Clones the provided point
-         */
-        Point(const Point& copy);
+        template <typename Derived>
+        Point(const Eigen::MatrixBase<Derived>& copy);
         
         //! Normal constructor
         /*!
          Clones the provided normal as a point
          */
-        Point(const Normal& normal);
+        constexpr Point(const Normal& normal);
         
         //! Vector constructor
         /*!
          Clones the provided vector as a point
          */
-        Point(const Vector& normal);
+        constexpr Point(const Vector& normal);
         
         // end constructor declarations-----------------------------------------
         
         // begin accessor declarations------------------------------------------
         
         //! Returns X component of wrapped vector
-        float GetX() const;
+        constexpr float GetX() const;
 
         //! Returns Y component of wrapped vector
-        float GetY() const;
+        constexpr float GetY() const;
 
         //! Returns Z component of wrapped vector
-        float GetZ() const;
+        constexpr float GetZ() const;
 
         //! Sets X component of wrapped vector
         /*!
@@ -123,14 +120,20 @@ namespace SCPPR {
          */
         void SetZ(float zCoord);
 
-        //! Returns a copy of the wrapped vector
-        Eigen::Vector4f GetContents() const;
+        //! Returns a read-only Eigen view of the wrapped coordinates
+        ConstCoordinates GetContents() const;
 
         //! Explicitly sets the wrapped vector to a provided Eigen::Vector4f
         /*!
          \param newContents The new contents of the Vector wrapper
          */
-        void SetContents(Eigen::Vector4f newContents);
+        void SetContents(const Eigen::Vector4f& newContents);
+
+        //! Returns a pointer to the four wrapped floats
+        constexpr const float* Data() const;
+
+        //! Returns a pointer to the four wrapped floats
+        float* Data();
         
         // end accessor declarations--------------------------------------------
         
@@ -149,37 +152,107 @@ namespace SCPPR {
         //! Subtraction of a point from a point to yield a vector
         Vector operator- (const Point& point) const;
         
-        //! Assignment operator
-        Point& operator= (const Point& point);
-        
         //! Multiplication by a scalar with scalar on the right
         Point operator* (const float scalar) const;
         
         // end operator overloads-----------------------------------------------
         
-        //! Destructor
-        ~Point();
-
-        
     protected:
         
-        Eigen::Vector4f coordinates; //!< Wrapped vector
+        float coordinates[4]; //!< Wrapped coordinates, w is always 0
+        
+        //! Returns a writable Eigen view of the wrapped coordinates
+        Coordinates GetMutableContents();
     };
+
+    static_assert(std::is_trivially_copyable<Point>::value,
+                  "Point must stay trivially copyable");
+    static_assert(sizeof(Point) == 16 && alignof(Point) == 16,
+                  "Point must stay a single aligned 16 byte register");
+    
+    // constructors declaration
+    
+    // default constructor
+    inline constexpr Point::Point() :
+        coordinates{0, 0, 0, 0} {
+        
+    }
     
+    // parameterized constructor
+    inline constexpr Point::Point(float xArg, float yArg, float zArg) :
+        coordinates{xArg, yArg, zArg, 0} {
+        
+    }
+    
+    // array constructor, term 4 is set to 0
+    inline constexpr Point::Point(const float* coords) : 
+        coordinates{coords[0], coords[1], coords[2], 0} {
+        
+    }
+    
+    // explicit constructor
+    template <typename Derived>
+    inline Point::Point(const Eigen::MatrixBase<Derived>& copy) {
+        GetMutableContents() = copy;
+    }
+    
+    // accessors declaration
+    
+    // returns x coordinate
+    inline constexpr float Point::GetX() const {
+        return coordinates[0];
+    }
+    
+    // returns y coordinate
+    inline constexpr float Point::GetY() const {
+        return coordinates[1];
+    }
+    
+    // returns z coordinate
+    inline constexpr float Point::GetZ() const {
+        return coordinates[2];
+    }
+    
+    // sets x coordinate
+    inline void Point::SetX(float xCoord) {
+        coordinates[0] = xCoord;
+    }
     
-    // Assignment operator
-    inline Point& Point::operator= (const Point& point)  {
-        //Check for self-assignment
-        if(this == &point)
-            return (*this);
-        // Assign passed point coordinates to coordinates
-        coordinates = point.coordinates;
-        return(*this);
+    // sets y coordinate
+    inline void Point::SetY(float yCoord) {
+        coordinates[1] = yCoord;
+    }
+    
+    // sets z coordinate
+    inline void Point::SetZ(float zCoord) {
+        coordinates[2] = zCoord;
+    }
+    
+    // returns view of wrapped vector
+    inline ConstCoordinates Point::GetContents() const {
+        return ConstCoordinates(coordinates);
+    }
+    
+    // explicitly sets wrapped vector
+    inline void Point::SetContents(const Eigen::Vector4f& newContents) {
+        GetMutableContents() = newContents;
+    }
+    
+    inline constexpr const float* Point::Data() const {
+        return coordinates;
+    }
+    
+    inline float* Point::Data() {
+        return coordinates;
+    }
+    
+    inline Coordinates Point::GetMutableContents() {
+        return Coordinates(coordinates);
     }
     
     // Scalar multiplication, scalar on right
     inline Point Point::operator* (const float scalar) const {
-        return Point(coordinates * scalar);
+        return Point(GetContents() * scalar);
     }
     
     //! Multiplication of a point by a scalar with scalar on the left
@@ -191,5 +264,39 @@ namespace SCPPR {
     }
 }
 
-#endif	/* POINT_HPP */
+#include "Normal.hpp"
+#include "Vector.hpp"
+
+namespace SCPPR {
+    
+    // operator overrides with circular dependencies
+    
+    // normal constructor
+    inline constexpr Point::Point(const Normal& normal) :
+        coordinates{normal.GetX(), normal.GetY(), normal.GetZ(), 0} {
+        
+    }
+    
+    // vector constructor
+    inline constexpr Point::Point(const Vector& vector) :
+        coordinates{vector.GetX(), vector.GetY(), vector.GetZ(), 0} {
+        
+    }
+    
+    // Vector addition operator
+    inline Point Point::operator+ (const Vector& vector) const {
+        return Point(GetContents() + vector.GetContents());
+    }
+    
+    // Vector subtraction operator
+    inline Point Point::operator- (const Vector& vector) const {
+        return Point(GetContents() - vector.GetContents());
+    }
+    
+    // Creation of vector from point subtraction
+    inline Vector Point::operator- (const Point& point) const {
+        return Vector(GetContents() - point.GetContents());
+    }
+}
 
+#endif	/* POINT_HPP */
@@ -0,0 +1,152 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Point3Packed.hpp
+ * 
+ * Twelve byte storage form of Point
+ * Class and method definitions
+ */
+
+/*!
+ \file Point3Packed.hpp
+ Header definition for the Point3Packed storage class
+ */
+
+#ifndef POINT3PACKED_HPP
+#define	POINT3PACKED_HPP
+
+#include <type_traits>
+
+#include "Point.hpp"
+
+namespace SCPPR {
+
+    //! Three packed floats holding a Point in memory
+    /*!
+     Point keeps a fourth, always zero float so that it fills one aligned
+     register. Point3Packed drops it for bulk storage, a quarter less memory
+     and bandwidth, and converts to and from Point when the data is used.
+     It only stores; arithmetic goes through Point.
+     */
+    class Point3Packed {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs a point of {0,0,0}
+         */
+        Point3Packed();
+
+        //! Parameterized constructor
+        /*!
+         Constructs a point of {xArg,yArg,zArg}
+         */
+        Point3Packed(float xArg, float yArg, float zArg);
+
+        //! Point constructor
+        /*!
+         Packs the x, y and z components of point
+         */
+        explicit Point3Packed(const Point& point);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Unpacks into a Point
+        explicit operator Point() const;
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns X component
+        float GetX() const;
+
+        //! Returns Y component
+        float GetY() const;
+
+        //! Returns Z component
+        float GetZ() const;
+
+        //! Returns a pointer to the three packed floats
+        const float* Data() const;
+
+        //! Returns a pointer to the three packed floats
+        float* Data();
+
+        // end accessor declarations--------------------------------------------
+
+        //! Displays contents of the point using std::cout
+        void DisplayContents() const;
+
+    protected:
+
+        float coordinates[3]; //!< Packed x, y and z
+    };
+
+    static_assert(std::is_trivially_copyable<Point3Packed>::value,
+                  "Point3Packed must stay trivially copyable");
+    static_assert(sizeof(Point3Packed) == 3 * sizeof(float),
+                  "Point3Packed must stay three packed floats");
+
+    inline Point3Packed::Point3Packed() :
+        coordinates{0, 0, 0} {
+
+    }
+
+    inline Point3Packed::Point3Packed(float xArg, float yArg, float zArg) :
+        coordinates{xArg, yArg, zArg} {
+
+    }
+
+    inline Point3Packed::Point3Packed(const Point& point) :
+        coordinates{point.GetX(), point.GetY(), point.GetZ()} {
+
+    }
+
+    inline Point3Packed::operator Point() const {
+        return Point(coordinates);
+    }
+
+    inline float Point3Packed::GetX() const {
+        return coordinates[0];
+    }
+
+    inline float Point3Packed::GetY() const {
+        return coordinates[1];
+    }
+
+    inline float Point3Packed::GetZ() const {
+        return coordinates[2];
+    }
+
+    inline const float* Point3Packed::Data() const {
+        return coordinates;
+    }
+
+    inline float* Point3Packed::Data() {
+        return coordinates;
+    }
+}
+
+#endif	/* POINT3PACKED_HPP */
@@ -0,0 +1,254 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   PointPacket8.hpp
+ * 
+ * Structure-of-arrays packet of eight points for SIMD linear algebra
+ * Class and method definitions
+ */
+
+/*!
+ \file PointPacket8.hpp
+ Header definition for PointPacket8 SIMD wrapper class
+ */
+
+#ifndef POINTPACKET8_HPP
+#define	POINTPACKET8_HPP
+
+#include <Eigen/Core>
+
+#include "ForwardVectorDeclarations.hpp"
+#include "Float8.hpp"
+#include "Point.hpp"
+
+namespace SCPPR {
+
+    //! Packet of eight 3D points
+    /*!
+     Stores eight Points as separate x, y and z registers so that every
+     operation processes all eight points at once. Mirrors the operator
+     surface of Point.
+     */
+    class PointPacket8 {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs eight points of {0,0,0}
+         */
+        PointPacket8();
+
+        //! Component constructor
+        /*!
+         Constructs a packet from x, y and z registers
+         */
+        PointPacket8(const Float8& xArg, const Float8& yArg, const Float8& zArg);
+
+        //! Broadcast constructor
+        /*!
+         Constructs a packet holding eight copies of point
+         */
+        explicit PointPacket8(const Point& point);
+
+        //! Vector packet constructor
+        /*!
+         Clones the provided vector packet as a point packet
+         */
+        explicit PointPacket8(const VectorPacket8& vectors);
+
+        // end constructor declarations-----------------------------------------
+
+        // gather and scatter declarations--------------------------------------
+
+        //! Loads eight consecutive points into a packet
+        static PointPacket8 Gather(const Point* points);
+
+        //! Writes the packet out to eight consecutive points
+        void Scatter(Point* points) const;
+
+        //! Returns the point held in a single lane
+        Point Extract(int lane) const;
+
+        //! Replaces the point held in a single lane
+        void Insert(int lane, const Point& point);
+
+        // end gather and scatter declarations----------------------------------
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns X components of wrapped points
+        const Float8& GetX() const;
+
+        //! Returns Y components of wrapped points
+        const Float8& GetY() const;
+
+        //! Returns Z components of wrapped points
+        const Float8& GetZ() const;
+
+        //! Sets X components of wrapped points
+        void SetX(const Float8& xCoords);
+
+        //! Sets Y components of wrapped points
+        void SetY(const Float8& yCoords);
+
+        //! Sets Z components of wrapped points
+        void SetZ(const Float8& zCoords);
+
+        // end accessor declarations--------------------------------------------
+
+        //! Displays contents of the packet using std::cout
+        void DisplayContents() const;
+
+        // begin operator overloads---------------------------------------------
+
+        //! Addition of a vector packet to a point packet
+        PointPacket8 operator+ (const VectorPacket8& vectors) const;
+
+        //! Subtraction of a vector packet from a point packet
+        PointPacket8 operator- (const VectorPacket8& vectors) const;
+
+        //! Subtraction of a point packet from a point packet to yield vectors
+        VectorPacket8 operator- (const PointPacket8& points) const;
+
+        //! Per lane multiplication by scalars with scalars on the right
+        PointPacket8 operator* (const Float8& scalars) const;
+
+        // end operator overloads-----------------------------------------------
+
+    protected:
+
+        Float8 x; //!< X components
+        Float8 y; //!< Y components
+        Float8 z; //!< Z components
+    };
+
+    inline PointPacket8::PointPacket8() {
+
+    }
+
+    inline PointPacket8::PointPacket8(const Float8& xArg, const Float8& yArg, const Float8& zArg) :
+        x(xArg), y(yArg), z(zArg) {
+
+    }
+
+    inline PointPacket8::PointPacket8(const Point& point) :
+        x(point.GetX()), y(point.GetY()), z(point.GetZ()) {
+
+    }
+
+    inline PointPacket8 PointPacket8::Gather(const Point* points) {
+        const float* rowPointers[8];
+        for(int i = 0; i < 8; i++)
+            rowPointers[i] = points[i].Data();
+        PointPacket8 packet;
+        TransposeRows(rowPointers, packet.x, packet.y, packet.z);
+        return packet;
+    }
+
+    inline void PointPacket8::Scatter(Point* points) const {
+        float* rowPointers[8];
+        for(int i = 0; i < 8; i++)
+            rowPointers[i] = points[i].Data();
+        TransposeColumns(x, y, z, rowPointers);
+    }
+
+    inline Point PointPacket8::Extract(int lane) const {
+        return Point(x[lane], y[lane], z[lane]);
+    }
+
+    inline void PointPacket8::Insert(int lane, const Point& point) {
+        x.SetLane(lane, point.GetX());
+        y.SetLane(lane, point.GetY());
+        z.SetLane(lane, point.GetZ());
+    }
+
+    inline const Float8& PointPacket8::GetX() const {
+        return x;
+    }
+
+    inline const Float8& PointPacket8::GetY() const {
+        return y;
+    }
+
+    inline const Float8& PointPacket8::GetZ() const {
+        return z;
+    }
+
+    inline void PointPacket8::SetX(const Float8& xCoords) {
+        x = xCoords;
+    }
+
+    inline void PointPacket8::SetY(const Float8& yCoords) {
+        y = yCoords;
+    }
+
+    inline void PointPacket8::SetZ(const Float8& zCoords) {
+        z = zCoords;
+    }
+
+    // Scalar multiplication, scalars on right
+    inline PointPacket8 PointPacket8::operator* (const Float8& scalars) const {
+        return PointPacket8(x * scalars, y * scalars, z * scalars);
+    }
+
+    //! Per lane multiplication of a point packet by scalars on the left
+    PointPacket8 operator* (const Float8& scalars, const PointPacket8& points);
+
+    // Scalar multiplication, scalars on left
+    inline PointPacket8 operator* (const Float8& scalars, const PointPacket8& points) {
+        return points * scalars;
+    }
+}
+
+#include "NormalPacket8.hpp"
+#include "VectorPacket8.hpp"
+
+namespace SCPPR {
+
+    // operator overrides with circular dependencies
+
+    inline PointPacket8::PointPacket8(const VectorPacket8& vectors) :
+        x(vectors.GetX()), y(vectors.GetY()), z(vectors.GetZ()) {
+
+    }
+
+    // Vector addition operator
+    inline PointPacket8 PointPacket8::operator+ (const VectorPacket8& vectors) const {
+        return PointPacket8(x + vectors.GetX(), y + vectors.GetY(), z + vectors.GetZ());
+    }
+
+    // Vector subtraction operator
+    inline PointPacket8 PointPacket8::operator- (const VectorPacket8& vectors) const {
+        return PointPacket8(x - vectors.GetX(), y - vectors.GetY(), z - vectors.GetZ());
+    }
+
+    // Creation of vectors from point subtraction
+    inline VectorPacket8 PointPacket8::operator- (const PointPacket8& points) const {
+        return VectorPacket8(x - points.x, y - points.y, z - points.z);
+    }
+}
+
+#endif	/* POINTPACKET8_HPP */
@@ -0,0 +1,129 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Ray.hpp
+ * 
+ * Ray class pairing an origin point with a direction vector
+ * Class and method definitions
+ */
+
+/*!
+ \file Ray.hpp
+ Header definition for Ray class
+ */
+
+#ifndef RAY_HPP
+#define	RAY_HPP
+
+#include <Eigen/Core>
+
+#include "ForwardVectorDeclarations.hpp"
+#include "Point.hpp"
+#include "Vector.hpp"
+
+namespace SCPPR {
+
+    //! Ray class
+    /*!
+     A half line starting at an origin Point and extending along a direction
+     Vector. The direction is not required to be normalized.
+     */
+    class Ray {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs a degenerate ray at the origin with a zero direction
+         */
+        Ray();
+
+        //! Parameterized constructor
+        /*!
+         Constructs a ray starting at originArg travelling along directionArg
+         */
+        Ray(const Point& originArg, const Vector& directionArg);
+
+        // end constructor declarations-----------------------------------------
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the origin of the ray
+        const Point& GetOrigin() const;
+
+        //! Returns the direction of the ray
+        const Vector& GetDirection() const;
+
+        //! Sets the origin of the ray
+        void SetOrigin(const Point& newOrigin);
+
+        //! Sets the direction of the ray
+        void SetDirection(const Vector& newDirection);
+
+        // end accessor declarations--------------------------------------------
+
+        //! Returns origin + t * direction
+        Point PointAt(float t) const;
+
+        //! Displays the origin and direction of the ray in the console
+        void DisplayContents() const;
+
+    protected:
+
+        Point origin;     //!< Ray origin
+        Vector direction; //!< Ray direction
+    };
+
+    inline Ray::Ray() {
+
+    }
+
+    inline Ray::Ray(const Point& originArg, const Vector& directionArg) :
+        origin(originArg), direction(directionArg) {
+
+    }
+
+    inline const Point& Ray::GetOrigin() const {
+        return origin;
+    }
+
+    inline const Vector& Ray::GetDirection() const {
+        return direction;
+    }
+
+    inline void Ray::SetOrigin(const Point& newOrigin) {
+        origin = newOrigin;
+    }
+
+    inline void Ray::SetDirection(const Vector& newDirection) {
+        direction = newDirection;
+    }
+
+    inline Point Ray::PointAt(float t) const {
+        return origin + direction * t;
+    }
+}
+
+#endif	/* RAY_HPP */
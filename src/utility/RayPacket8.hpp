@@ -0,0 +1,148 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   RayPacket8.hpp
+ * 
+ * Structure-of-arrays packet of eight rays
+ * Class and method definitions
+ */
+
+/*!
+ \file RayPacket8.hpp
+ Header definition for RayPacket8 class
+ */
+
+#ifndef RAYPACKET8_HPP
+#define	RAYPACKET8_HPP
+
+#include "Float8.hpp"
+#include "NormalPacket8.hpp"
+#include "Ray.hpp"
+#include "PointPacket8.hpp"
+#include "VectorPacket8.hpp"
+
+namespace SCPPR {
+
+    //! Packet of eight rays
+    /*!
+     Pairs a packet of origins with a packet of directions so that eight rays
+     can be advanced and tested together.
+     */
+    class RayPacket8 {
+
+    public:
+
+        // begin constructor declarations---------------------------------------
+
+        //! Default constructor
+        /*!
+         Constructs eight degenerate rays at the origin
+         */
+        RayPacket8();
+
+        //! Parameterized constructor
+        /*!
+         Constructs eight rays from packets of origins and directions
+         */
+        RayPacket8(const PointPacket8& originArg, const VectorPacket8& directionArg);
+
+        // end constructor declarations-----------------------------------------
+
+        //! Loads eight consecutive origins and directions into a packet
+        static RayPacket8 Gather(const Point* origins, const Vector* directions);
+
+        //! Loads eight consecutive rays into a packet
+        static RayPacket8 Gather(const Ray* rays);
+
+        // begin accessor declarations------------------------------------------
+
+        //! Returns the ray origins
+        const PointPacket8& GetOrigin() const;
+
+        //! Returns the ray directions
+        const VectorPacket8& GetDirection() const;
+
+        //! Sets the ray origins
+        void SetOrigin(const PointPacket8& newOrigin);
+
+        //! Sets the ray directions
+        void SetDirection(const VectorPacket8& newDirection);
+
+        // end accessor declarations--------------------------------------------
+
+        //! Returns origin + t * direction for each ray
+        PointPacket8 PointAt(const Float8& t) const;
+
+    protected:
+
+        PointPacket8 origin;     //!< Ray origins
+        VectorPacket8 direction; //!< Ray directions
+    };
+
+    inline RayPacket8::RayPacket8() {
+
+    }
+
+    inline RayPacket8::RayPacket8(const PointPacket8& originArg, const VectorPacket8& directionArg) :
+        origin(originArg), direction(directionArg) {
+
+    }
+
+    inline RayPacket8 RayPacket8::Gather(const Point* origins, const Vector* directions) {
+        return RayPacket8(PointPacket8::Gather(origins), VectorPacket8::Gather(directions));
+    }
+
+    inline RayPacket8 RayPacket8::Gather(const Ray* rays) {
+        Point origins[8];
+        Vector directions[8];
+        for(int i = 0; i < 8; i++) {
+            origins[i] = rays[i].GetOrigin();
+            directions[i] = rays[i].GetDirection();
+        }
+        return Gather(origins, directions);
+    }
+
+    inline const PointPacket8& RayPacket8::GetOrigin() const {
+        return origin;
+    }
+
+    inline const VectorPacket8& RayPacket8::GetDirection() const {
+        return direction;
+    }
+
+    inline void RayPacket8::SetOrigin(const PointPacket8& newOrigin) {
+        origin = newOrigin;
+    }
+
+    inline void RayPacket8::SetDirection(const VectorPacket8& newDirection) {
+        direction = newDirection;
+    }
+
+    inline PointPacket8 RayPacket8::PointAt(const Float8& t) const {
+        return PointPacket8(Float8::MultiplyAdd(direction.GetX(), t, origin.GetX()),
+                            Float8::MultiplyAdd(direction.GetY(), t, origin.GetY()),
+                            Float8::MultiplyAdd(direction.GetZ(), t, origin.GetZ()));
+    }
+}
+
+#endif	/* RAYPACKET8_HPP */
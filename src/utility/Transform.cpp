@@ -0,0 +1,158 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Transform.cpp
+ * 
+ * Affine transform with cached inverse and inverse transpose
+ */
+
+#include <iostream>
+#include <cstdlib>
+
+#include <Eigen/Core>
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+
+#include "ForwardVectorDeclarations.hpp"
+#include "Matrix.hpp"
+#include "Normal.hpp"
+#include "Point.hpp"
+#include "Ray.hpp"
+#include "Transform.hpp"
+#include "Vector.hpp"
+
+namespace SCPPR {
+
+    // Default constructor, identity is its own inverse
+    Transform::Transform() :
+        inverseTranspose(Eigen::Matrix3f::Identity()),
+        inverseKnown(true) {
+
+    }
+
+    // Explicit constructor, inverse computed on first use
+    Transform::Transform(const Matrix& forwardArg) :
+        forward(forwardArg),
+        inverseTranspose(Eigen::Matrix3f::Identity()),
+        inverseKnown(false) {
+
+    }
+
+    // Explicit constructor with known inverse
+    Transform::Transform(const Matrix& forwardArg, const Matrix& inverseArg) :
+        forward(forwardArg),
+        inverse(inverseArg),
+        inverseKnown(true) {
+        ComputeInverseTranspose();
+    }
+
+    // Generate scale transform
+    Transform Transform::Scale(float scaleFactor) {
+        return Transform(Matrix(Matrix::Scale(scaleFactor)),
+                         Matrix(Matrix::InverseScale(scaleFactor)));
+    }
+
+    // Generate parameterized scale transform
+    Transform Transform::Scale(float x, float y, float z) {
+        return Transform(Matrix(Matrix::Scale(x, y, z)),
+                         Matrix(Matrix::InverseScale(x, y, z)));
+    }
+
+    // Generate rotation transform
+    Transform Transform::Rotate(float rads, const Vector& axis) {
+        return Transform(Matrix(Matrix::Rotate(rads, axis)),
+                         Matrix(Matrix::InverseRotate(rads, axis)));
+    }
+
+    // Generate translation transform
+    Transform Transform::Translate(float x, float y, float z) {
+        return Transform(Matrix(Matrix::Translate(x, y, z)),
+                         Matrix(Matrix::InverseTranslate(x, y, z)));
+    }
+
+    void Transform::ComputeInverse() const {
+        inverse.SetContents(forward.GetContents().inverse(Eigen::Affine));
+        ComputeInverseTranspose();
+        inverseKnown = true;
+    }
+
+    void Transform::ComputeInverseTranspose() const {
+        inverseTranspose = inverse.GetContents().linear().transpose();
+    }
+
+    // Object to world transformations
+
+    Point Transform::operator* (const Point& point) const {
+        return forward * point;
+    }
+
+    Vector Transform::operator* (const Vector& vector) const {
+        return forward * vector;
+    }
+
+    Normal Transform::operator* (const Normal& normal) const {
+        Prepare();
+        Eigen::Vector4f result = Eigen::Vector4f::Zero();
+        result.head<3>() = inverseTranspose * normal.GetContents().head<3>();
+        return Normal(result);
+    }
+
+    Ray Transform::operator* (const Ray& ray) const {
+        return Ray(forward * ray.GetOrigin(), forward * ray.GetDirection());
+    }
+
+    // World to object transformations
+
+    Point Transform::ApplyInverse(const Point& point) const {
+        Prepare();
+        return inverse * point;
+    }
+
+    Vector Transform::ApplyInverse(const Vector& vector) const {
+        Prepare();
+        return inverse * vector;
+    }
+
+    Normal Transform::ApplyInverse(const Normal& normal) const {
+        // Matrix multiplies normals by the transpose of its linear part, which
+        // for the forward matrix is the inverse transpose of the inverse
+        return forward * normal;
+    }
+
+    Ray Transform::ApplyInverse(const Ray& ray) const {
+        Prepare();
+        return Ray(inverse * ray.GetOrigin(), inverse * ray.GetDirection());
+    }
+
+    // Composition, keeping the inverse in sync when both sides know theirs
+    Transform Transform::operator* (const Transform& secondTransform) const {
+        if(inverseKnown && secondTransform.inverseKnown)
+            return Transform(forward * secondTransform.forward,
+                             secondTransform.inverse * inverse);
+        return Transform(forward * secondTransform.forward);
+    }
+
+    void Transform::DisplayContents() const {
+        forward.DisplayContents();
+    }
+}
@@ -0,0 +1,210 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   Transform.hpp
+ * 
+ * Affine transform with cached inverse and inverse transpose
+ * Class and method definitions
+ */
+
+/*!
+ \file Transform.hpp
+ Header definition for Transform class
+ */
+
+#ifndef TRANSFORM_HPP
+#define	TRANSFORM_HPP
+
+#include <Eigen/Core>
+#include <Eigen/Dense>
+
+#include "ForwardVectorDeclarations.hpp"
+#include "Matrix.hpp"
+
+namespace SCPPR {
+
+    class Ray;
+
+    //! Object to world transformation with cached inverse
+    /*!
+     Wraps a forward Matrix together with its inverse and the inverse transpose
+     of its linear part. Transforms built from the static Scale, Rotate and
+     Translate helpers carry an exact inverse from the start, and composing two
+     transforms whose inverses are known composes the inverses as well, so no
+     matrix is ever inverted. A transform constructed from an arbitrary Matrix
+     inverts it on first use and keeps the result.
+
+     The cache is filled from const methods, so call Prepare() before sharing a
+     transform between threads.
+     */
+    class Transform {
+
+    public:
+
+        // begin constructor definitions----------------------------------------
+
+        //! Default constructor
+        /*!
+         Creates an identity transform
+         */
+        Transform();
+
+        //! Explicit constructor
+        /*!
+         Creates a transform from a forward matrix, inverted on first use
+         */
+        Transform(const Matrix& forwardArg);
+
+        //! Explicit constructor with known inverse
+        /*!
+         Creates a transform from a forward matrix and its inverse
+         */
+        Transform(const Matrix& forwardArg, const Matrix& inverseArg);
+
+        // end constructor definitions------------------------------------------
+
+        // Begin static methods-------------------------------------------------
+
+        //! Returns a transform for a given uniform scale
+        static Transform Scale(float scaleFactor);
+
+        //! Returns a transform scaling by x, y and z
+        static Transform Scale(float x, float y, float z);
+
+        //! Returns a transform rotating rads around a given vector
+        static Transform Rotate(float rads, const Vector& axis);
+
+        //! Returns a transform translating by x, y and z
+        static Transform Translate(float x, float y, float z);
+
+        // End static methods---------------------------------------------------
+
+        // begin accessor definitions-------------------------------------------
+
+        //! Returns the object to world matrix
+        const Matrix& GetMatrix() const;
+
+        //! Returns the world to object matrix
+        const Matrix& GetInverseMatrix() const;
+
+        //! Returns the inverse transpose of the linear part
+        const Eigen::Matrix3f& GetInverseTranspose() const;
+
+        //! Returns the inverse transform, reusing the cached inverse
+        Transform GetInverse() const;
+
+        //! Computes the cached inverse if it is not yet known
+        void Prepare() const;
+
+        // end accessor definitions---------------------------------------------
+
+        // Begin object to world transformations--------------------------------
+
+        //! Point transformation
+        Point operator* (const Point& point) const;
+
+        //! Vector transformation
+        Vector operator* (const Vector& vector) const;
+
+        //! Normal transformation by the inverse transpose
+        Normal operator* (const Normal& normal) const;
+
+        //! Ray transformation
+        Ray operator* (const Ray& ray) const;
+
+        // End object to world transformations----------------------------------
+
+        // Begin world to object transformations--------------------------------
+
+        //! Point transformation by the inverse
+        Point ApplyInverse(const Point& point) const;
+
+        //! Vector transformation by the inverse
+        Vector ApplyInverse(const Vector& vector) const;
+
+        //! Normal transformation by the transpose of the forward matrix
+        Normal ApplyInverse(const Normal& normal) const;
+
+        //! Ray transformation into object space
+        Ray ApplyInverse(const Ray& ray) const;
+
+        // End world to object transformations----------------------------------
+
+        // Begin operator overloads---------------------------------------------
+
+        //! Transform composition, secondTransform applied first
+        Transform operator* (const Transform& secondTransform) const;
+
+        //! Transform unary composition, secondTransform applied first
+        Transform& operator*= (const Transform& secondTransform);
+
+        // End operator overloads-----------------------------------------------
+
+        //! Displays the forward matrix in the console
+        void DisplayContents() const;
+
+    protected:
+
+        //! Fills inverse and inverseTranspose from forward
+        void ComputeInverse() const;
+
+        //! Fills inverseTranspose from inverse
+        void ComputeInverseTranspose() const;
+
+        Matrix forward;                           //!< Object to world
+        mutable Matrix inverse;                   //!< World to object
+        mutable Eigen::Matrix3f inverseTranspose; //!< Inverse transpose of linear part
+        mutable bool inverseKnown;                //!< Whether the cache is filled
+    };
+
+    inline const Matrix& Transform::GetMatrix() const {
+        return forward;
+    }
+
+    inline const Matrix& Transform::GetInverseMatrix() const {
+        Prepare();
+        return inverse;
+    }
+
+    inline const Eigen::Matrix3f& Transform::GetInverseTranspose() const {
+        Prepare();
+        return inverseTranspose;
+    }
+
+    inline void Transform::Prepare() const {
+        if(!inverseKnown)
+            ComputeInverse();
+    }
+
+    inline Transform Transform::GetInverse() const {
+        Prepare();
+        return Transform(inverse, forward);
+    }
+
+    inline Transform& Transform::operator*= (const Transform& secondTransform) {
+        *this = (*this) * secondTransform;
+        return (*this);
+    }
+}
+
+#endif	/* TRANSFORM_HPP */
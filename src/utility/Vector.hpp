@@ -39,21 +39,23 @@ THE SOFTWARE
 #ifndef VECTOR_HPP
 #define	VECTOR_HPP
 
+#include <type_traits>
+
 #include <Eigen/Core>
 #include <Eigen/Dense>
 
 #include "ForwardVectorDeclarations.hpp"
-#include "Normal.hpp"
-#include "Point.hpp"
 
 namespace SCPPR {
 
     //! 3D Vector class
     /*!
-     A wrapper class for the Vector4f to provide vector behaviour while
-     transforming.
+     A wrapper around four aligned floats to provide vector behaviour while
+     transforming. Every method is defined inline in this header, and the
+     class is trivially copyable and 16 byte aligned so arrays of Vectors can
+     be copied with memcpy and loaded directly into SIMD registers.
      */
-    class Vector {
+    class alignas(16) Vector {
         
     public:
 
@@ -63,56 +65,51 @@ namespace SCPPR {
         /*!
          Creates a Vector of {0,0,0}
          */
-        Vector();
+        constexpr Vector();
 
         //! Parameterized constructor
         /*!
          Creates a Vector with chosen coordinates
          */
-        Vector(float xArg, float yArg, float zArg);
+        constexpr Vector(float xArg, float yArg, float zArg);
 
         //! Array constructor
         /*!
-         Constructs a Vector using float values in passed array.
+         Constructs a Vector using the first three float values in passed array.
          */
-        Vector(float *coords);
+        constexpr Vector(const float *coords);
 
         //! Explicit constructor
         /*!
-         Constructs a Vector containing the passed Eigen::Vector4f
-         */
-        Vector(Eigen::Vector4f copy);
-
-        //! Copy constructor
-        /*!
-         Creates a copy of the passed Vector
+         Constructs a Vector containing the passed 4 component Eigen expression
          */
-        Vector(const Vector& copy);
+        template <typename Derived>
+        Vector(const Eigen::MatrixBase<Derived>& copy);
         
         //! Normal copy constructor
         /*!
          Constructs a Vector using the coordinates in the passed Normal
          */
-        Vector(const Normal& normalCopy);
+        constexpr Vector(const Normal& normalCopy);
         
         //! Point copy constructor
         /*!
          Constructs a Vector using the coordinates in the passed Point
          */
-        Vector(const Point& pointCopy);
+        constexpr Vector(const Point& pointCopy);
 
         // end constructor declarations-----------------------------------------
 
         // accessor declarations------------------------------------------------
 
         //! Returns X component of wrapped vector
-        float GetX() const;
+        constexpr float GetX() const;
 
         //! Returns Y component of wrapped vector
-        float GetY() const;
+        constexpr float GetY() const;
 
         //! Returns Z component of wrapped vector
-        float GetZ() const;
+        constexpr float GetZ() const;
 
         //! Sets X component of wrapped vector
         /*!
@@ -132,14 +129,20 @@ namespace SCPPR {
          */
         void SetZ(float zCoord);
 
-        //! Returns a copy of the wrapped vector
-        Eigen::Vector4f GetContents() const;
+        //! Returns a read-only Eigen view of the wrapped coordinates
+        ConstCoordinates GetContents() const;
 
         //! Explicitly sets the wrapped vector to a provided Eigen::Vector4f
         /*!
          \param newContents The new contents of the Vector wrapper
          */
-        void SetContents(Eigen::Vector4f newContents);
+        void SetContents(const Eigen::Vector4f& newContents);
+
+        //! Returns a pointer to the four wrapped floats
+        constexpr const float* Data() const;
+
+        //! Returns a pointer to the four wrapped floats
+        float* Data();
 
         // end accessor declarations--------------------------------------------
 
@@ -159,9 +162,6 @@ namespace SCPPR {
         //! Displays the contents of the vector in the console.
         void DisplayContents() const;
 
-        //! Destructor
-        ~Vector();
-
 
         // begin operator overloads---------------------------------------------
         
@@ -189,9 +189,6 @@ namespace SCPPR {
         //! Cross product
         Vector operator^ (const Vector& secondVector) const;
         
-        //! Assignment operator, vector to a vector
-        Vector& operator= (const Vector& rightSide);
-        
         //! Negation operator
         Vector operator- (void) const;
         
@@ -201,63 +198,148 @@ namespace SCPPR {
         //! Addition of a normal and a vector with the normal on the right
         Vector operator+ (const Normal& secondNormal) const;
         
-    private:
-        // member declarations
-
     protected:
-        Eigen::Vector4f coordinates; //!< Coordinates of vector
+        float coordinates[4]; //!< Coordinates of vector, w is always 0
+        
+        //! Returns a writable Eigen view of the wrapped coordinates
+        Coordinates GetMutableContents();
     };
 
+    static_assert(std::is_trivially_copyable<Vector>::value,
+                  "Vector must stay trivially copyable");
+    static_assert(sizeof(Vector) == 16 && alignof(Vector) == 16,
+                  "Vector must stay a single aligned 16 byte register");
+
+    // Default constructor: Initializes coordinates to an empty vector
+    inline constexpr Vector::Vector() : 
+        coordinates{0, 0, 0, 0} {
+        
+    }
+    
+    // Initializes vector to {xArg,yArg,zArg}
+    inline constexpr Vector::Vector(float xArg, float yArg, float zArg) : 
+        coordinates{xArg, yArg, zArg, 0} {
+        
+    }
+    
+    // Initializes vector to values stored at coords, term 4 is set to 0
+    inline constexpr Vector::Vector(const float *coords) : 
+        coordinates{coords[0], coords[1], coords[2], 0} {
+        
+    }
+    
+    // Initializes coordinates to provided Eigen expression
+    template <typename Derived>
+    inline Vector::Vector(const Eigen::MatrixBase<Derived>& copy) {
+        GetMutableContents() = copy;
+    }
+    
+    // accessors declaration
+    
+    // returns x coordinate
+    inline constexpr float Vector::GetX() const {
+        return coordinates[0];
+    }
+    
+    // returns y coordinate
+    inline constexpr float Vector::GetY() const {
+        return coordinates[1];
+    }
+    
+    // returns z coordinate
+    inline constexpr float Vector::GetZ() const {
+        return coordinates[2];
+    }
+    
+    // sets x coordinate
+    inline void Vector::SetX(float xCoord) {
+        coordinates[0] = xCoord;
+    }
+    
+    // sets y coordinate
+    inline void Vector::SetY(float yCoord) {
+        coordinates[1] = yCoord;
+    }
+    
+    // sets z coordinate
+    inline void Vector::SetZ(float zCoord) {
+        coordinates[2] = zCoord;
+    }
+    
+    // returns view of wrapped vector
+    inline ConstCoordinates Vector::GetContents() const {
+        return ConstCoordinates(coordinates);
+    }
+    
+    // explicitly sets wrapped vector
+    inline void Vector::SetContents(const Eigen::Vector4f& newContents) {
+        GetMutableContents() = newContents;
+    }
+    
+    inline constexpr const float* Vector::Data() const {
+        return coordinates;
+    }
+    
+    inline float* Vector::Data() {
+        return coordinates;
+    }
+    
+    inline Coordinates Vector::GetMutableContents() {
+        return Coordinates(coordinates);
+    }
+    
+    // returns magnitude of the vector
+    inline float Vector::GetMagnitude() const {
+        return GetContents().norm();
+    }
+    
+    // returns magnitude of the vector squared
+    inline float Vector::GetSquaredMagnitude() const {
+        return GetContents().squaredNorm();
+    }
+    
+    // normalizes the vector
+    inline void Vector::Normalize() {
+        GetMutableContents().normalize();
+    }
+
     inline Vector Vector::operator+ (const Vector& otherVector) const {
-        return Vector(coordinates + otherVector.coordinates);        
+        return Vector(GetContents() + otherVector.GetContents());        
     }
     
     inline Vector& Vector::operator+= (const Vector& otherVector) {
-        coordinates = coordinates + otherVector.coordinates;
+        GetMutableContents() += otherVector.GetContents();
         return(*this);
     }
     
     inline Vector Vector::operator- (const Vector& otherVector) const {
-        return Vector(coordinates - otherVector.coordinates);
+        return Vector(GetContents() - otherVector.GetContents());
     }
     
     inline Vector& Vector::operator-= (const Vector& otherVector) {
-        coordinates = coordinates - otherVector.coordinates;
+        GetMutableContents() -= otherVector.GetContents();
         return(*this);
     }
     
     inline Vector Vector::operator* (const float scalar) const {
-        return Vector(coordinates * scalar);
+        return Vector(GetContents() * scalar);
     }
     
     inline Vector Vector::operator/ (const float scalar) const {
-        return Vector(coordinates / scalar);
-    }
-    
-    inline Vector& Vector::operator= (const Vector& otherVector) {
-        // check if assignment of the same vector
-        if(this == &otherVector)
-            return(*this);
-        
-        coordinates = otherVector.coordinates;
-        return(*this);
+        return Vector(GetContents() / scalar);
     }
     
     inline float Vector::operator* (const Vector& otherVector) const {
-        return coordinates.dot(otherVector.coordinates);
+        return GetContents().dot(otherVector.GetContents());
     }
     
-    
     inline Vector Vector::operator^ (const Vector& secondVector) const {
-        //Create temporary Vector3f for cross product
-        Eigen::Vector3f vect1 (coordinates.data());
-        Eigen::Vector3f vect2 (secondVector.coordinates.data());
-        Eigen::Vector3f crossProduct = vect1.cross(vect2);
-        return Vector(crossProduct.data());
+        // cross3 works on the full register and leaves w at 0
+        return Vector(GetContents().cross3(secondVector.GetContents()));
     }
     
     inline Vector Vector::operator- (void) const {
-        return Vector(-coordinates);
+        return Vector(-GetContents());
     }
     
     //! Multiplication of a vector by a scalar on the left side
@@ -268,6 +350,34 @@ namespace SCPPR {
     }
 };
 
+#include "Normal.hpp"
+#include "Point.hpp"
 
-#endif	/* VECTOR_HPP */
+namespace SCPPR {
+    
+    // operator overrides with circular dependencies
+    
+    // Construct from a normal
+    inline constexpr Vector::Vector(const Normal& normalCopy) :
+        coordinates{normalCopy.GetX(), normalCopy.GetY(), normalCopy.GetZ(), 0} {
+        
+    }
+    
+    // Construct from a point
+    inline constexpr Vector::Vector(const Point& pointCopy) : 
+        coordinates{pointCopy.GetX(), pointCopy.GetY(), pointCopy.GetZ(), 0} {
+        
+    }
+    
+    // dot product of normal and a vector
+    inline float Vector::operator* (const Normal& secondNormal) const {
+        return GetContents().dot(secondNormal.GetContents());
+    }
+    
+    // addition of a normal and a vector
+    inline Vector Vector::operator+ (const Normal& secondNormal) const {
+        return Vector(GetContents() + secondNormal.GetContents());
+    }
+};
 
+#endif	/* VECTOR_HPP */
@@ -0,0 +1,47 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   VectorPacket8.cpp
+ * 
+ * Structure-of-arrays packet of eight vectors for SIMD linear algebra
+ */
+
+#include <iostream>
+#include <cstdlib>
+
+#include "ForwardVectorDeclarations.hpp"
+#include "VectorPacket8.hpp"
+
+namespace SCPPR {
+
+    // debug methods
+    // display each component register in the console, one lane per column
+    void VectorPacket8::DisplayContents() const {
+        const Float8* components[3] = { &x, &y, &z };
+        for(int row = 0; row < 3; row++) {
+            for(int lane = 0; lane < Float8::width; lane++)
+                std::cout << (*components[row])[lane] << (lane + 1 < Float8::width ? " " : "");
+            std::cout << std::endl;
+        }
+    }
+};
@@ -0,0 +1,347 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2015 Elanna Stephenson
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+ *  
+ * File:   VectorPacket8.hpp
+ * 
+ * Structure-of-arrays packet of eight vectors for SIMD linear algebra
+ * Class and method definitions
+ */
+
+/*!
+ \file VectorPacket8.hpp
+ Header definition for VectorPacket8 SIMD wrapper class
+ */
+
+#ifndef VECTORPACKET8_HPP
+#define	VECTORPACKET8_HPP
+
+#include <Eigen/Core>
+
+#include "ForwardVectorDeclarations.hpp"
+#include "Float8.hpp"
+#include "Vector.hpp"
+
+namespace SCPPR {
+
+    //! Packet of eight 3D vectors
+    /*!
+     Stores eight Vectors as separate x, y and z registers so that every
+     operation processes all eight vectors at once. Mirrors the operator
+     surface of Vector, with scalar results returned as Float8.
+     */
+    class VectorPacket8 {
+
+    public:
+
+        // constructor declarations --------------------------------------------
+
+        //! Default constructor
+        /*!
+         Creates eight vectors of {0,0,0}
+         */
+        VectorPacket8();
+
+        //! Component constructor
+        /*!
+         Creates a packet from x, y and z registers
+         */
+        VectorPacket8(const Float8& xArg, const Float8& yArg, const Float8& zArg);
+
+        //! Broadcast constructor
+        /*!
+         Creates a packet holding eight copies of vector
+         */
+        explicit VectorPacket8(const Vector& vector);
+
+        //! Normal packet constructor
+        /*!
+         Creates a packet using the coordinates of the passed NormalPacket8
+         */
+        explicit VectorPacket8(const NormalPacket8& normals);
+
+        //! Point packet constructor
+        /*!
+         Creates a packet using the coordinates of the passed PointPacket8
+         */
+        explicit VectorPacket8(const PointPacket8& points);
+
+        // end constructor declarations-----------------------------------------
+
+        // gather and scatter declarations--------------------------------------
+
+        //! Loads eight consecutive vectors into a packet
+        static VectorPacket8 Gather(const Vector* vectors);
+
+        //! Writes the packet out to eight consecutive vectors
+        void Scatter(Vector* vectors) const;
+
+        //! Returns the vector held in a single lane
+        Vector Extract(int lane) const;
+
+        //! Replaces the vector held in a single lane
+        void Insert(int lane, const Vector& vector);
+
+        // end gather and scatter declarations----------------------------------
+
+        // accessor declarations------------------------------------------------
+
+        //! Returns X components of wrapped vectors
+        const Float8& GetX() const;
+
+        //! Returns Y components of wrapped vectors
+        const Float8& GetY() const;
+
+        //! Returns Z components of wrapped vectors
+        const Float8& GetZ() const;
+
+        //! Sets X components of wrapped vectors
+        void SetX(const Float8& xCoords);
+
+        //! Sets Y components of wrapped vectors
+        void SetY(const Float8& yCoords);
+
+        //! Sets Z components of wrapped vectors
+        void SetZ(const Float8& zCoords);
+
+        // end accessor declarations--------------------------------------------
+
+        // maths methods--------------------------------------------------------
+
+        //! Returns the magnitude of each vector
+        Float8 GetMagnitude() const;
+
+        //! Returns the squared magnitude of each vector
+        Float8 GetSquaredMagnitude() const;
+
+        //! Normalizes each vector
+        void Normalize();
+
+        //! Displays the contents of the packet in the console.
+        void DisplayContents() const;
+
+        // begin operator overloads---------------------------------------------
+
+        //! Addition of two vector packets
+        VectorPacket8 operator+ (const VectorPacket8& otherVectors) const;
+
+        //! Unary addition of a second packet to this packet
+        VectorPacket8& operator+= (const VectorPacket8& otherVectors);
+
+        //! Subtraction of two vector packets
+        VectorPacket8 operator- (const VectorPacket8& otherVectors) const;
+
+        //! Unary subtraction of a second packet from this packet
+        VectorPacket8& operator-= (const VectorPacket8& otherVectors);
+
+        //! Per lane scalar multiplication with multiplier on right hand side
+        VectorPacket8 operator* (const Float8& scalars) const;
+
+        //! Per lane scalar division
+        VectorPacket8 operator/ (const Float8& scalars) const;
+
+        //! Per lane dot product
+        Float8 operator* (const VectorPacket8& secondVectors) const;
+
+        //! Per lane cross product
+        VectorPacket8 operator^ (const VectorPacket8& secondVectors) const;
+
+        //! Negation operator
+        VectorPacket8 operator- (void) const;
+
+        //! Per lane dot product with the normals on the right
+        Float8 operator* (const NormalPacket8& secondNormals) const;
+
+        //! Addition of a normal packet with the normals on the right
+        VectorPacket8 operator+ (const NormalPacket8& secondNormals) const;
+
+        // end operator overloads-----------------------------------------------
+
+    protected:
+        Float8 x; //!< X components
+        Float8 y; //!< Y components
+        Float8 z; //!< Z components
+    };
+
+    inline VectorPacket8::VectorPacket8() {
+
+    }
+
+    inline VectorPacket8::VectorPacket8(const Float8& xArg, const Float8& yArg, const Float8& zArg) :
+        x(xArg), y(yArg), z(zArg) {
+
+    }
+
+    inline VectorPacket8::VectorPacket8(const Vector& vector) :
+        x(vector.GetX()), y(vector.GetY()), z(vector.GetZ()) {
+
+    }
+
+    inline VectorPacket8 VectorPacket8::Gather(const Vector* vectors) {
+        const float* rowPointers[8];
+        for(int i = 0; i < 8; i++)
+            rowPointers[i] = vectors[i].Data();
+        VectorPacket8 packet;
+        TransposeRows(rowPointers, packet.x, packet.y, packet.z);
+        return packet;
+    }
+
+    inline void VectorPacket8::Scatter(Vector* vectors) const {
+        float* rowPointers[8];
+        for(int i = 0; i < 8; i++)
+            rowPointers[i] = vectors[i].Data();
+        TransposeColumns(x, y, z, rowPointers);
+    }
+
+    inline Vector VectorPacket8::Extract(int lane) const {
+        return Vector(x[lane], y[lane], z[lane]);
+    }
+
+    inline void VectorPacket8::Insert(int lane, const Vector& vector) {
+        x.SetLane(lane, vector.GetX());
+        y.SetLane(lane, vector.GetY());
+        z.SetLane(lane, vector.GetZ());
+    }
+
+    inline const Float8& VectorPacket8::GetX() const {
+        return x;
+    }
+
+    inline const Float8& VectorPacket8::GetY() const {
+        return y;
+    }
+
+    inline const Float8& VectorPacket8::GetZ() const {
+        return z;
+    }
+
+    inline void VectorPacket8::SetX(const Float8& xCoords) {
+        x = xCoords;
+    }
+
+    inline void VectorPacket8::SetY(const Float8& yCoords) {
+        y = yCoords;
+    }
+
+    inline void VectorPacket8::SetZ(const Float8& zCoords) {
+        z = zCoords;
+    }
+
+    inline Float8 VectorPacket8::GetSquaredMagnitude() const {
+        return (*this) * (*this);
+    }
+
+    inline Float8 VectorPacket8::GetMagnitude() const {
+        return Float8::Sqrt(GetSquaredMagnitude());
+    }
+
+    inline void VectorPacket8::Normalize() {
+        Float8 invMagnitude = Float8(1.0f) / GetMagnitude();
+        x *= invMagnitude;
+        y *= invMagnitude;
+        z *= invMagnitude;
+    }
+
+    inline VectorPacket8 VectorPacket8::operator+ (const VectorPacket8& otherVectors) const {
+        return VectorPacket8(x + otherVectors.x, y + otherVectors.y, z + otherVectors.z);
+    }
+
+    inline VectorPacket8& VectorPacket8::operator+= (const VectorPacket8& otherVectors) {
+        x += otherVectors.x;
+        y += otherVectors.y;
+        z += otherVectors.z;
+        return(*this);
+    }
+
+    inline VectorPacket8 VectorPacket8::operator- (const VectorPacket8& otherVectors) const {
+        return VectorPacket8(x - otherVectors.x, y - otherVectors.y, z - otherVectors.z);
+    }
+
+    inline VectorPacket8& VectorPacket8::operator-= (const VectorPacket8& otherVectors) {
+        x -= otherVectors.x;
+        y -= otherVectors.y;
+        z -= otherVectors.z;
+        return(*this);
+    }
+
+    inline VectorPacket8 VectorPacket8::operator* (const Float8& scalars) const {
+        return VectorPacket8(x * scalars, y * scalars, z * scalars);
+    }
+
+    inline VectorPacket8 VectorPacket8::operator/ (const Float8& scalars) const {
+        Float8 inverse = Float8(1.0f) / scalars;
+        return VectorPacket8(x * inverse, y * inverse, z * inverse);
+    }
+
+    inline Float8 VectorPacket8::operator* (const VectorPacket8& secondVectors) const {
+        return Float8::MultiplyAdd(x, secondVectors.x,
+               Float8::MultiplyAdd(y, secondVectors.y, z * secondVectors.z));
+    }
+
+    inline VectorPacket8 VectorPacket8::operator^ (const VectorPacket8& secondVectors) const {
+        return VectorPacket8(
+            Float8::MultiplySub(y, secondVectors.z, z * secondVectors.y),
+            Float8::MultiplySub(z, secondVectors.x, x * secondVectors.z),
+            Float8::MultiplySub(x, secondVectors.y, y * secondVectors.x));
+    }
+
+    inline VectorPacket8 VectorPacket8::operator- (void) const {
+        return VectorPacket8(-x, -y, -z);
+    }
+
+    //! Per lane multiplication of a vector packet by scalars on the left side
+    VectorPacket8 operator* (const Float8& scalars, const VectorPacket8& vectors);
+
+    inline VectorPacket8 operator* (const Float8& scalars, const VectorPacket8& vectors) {
+        return vectors * scalars;
+    }
+};
+
+#include "NormalPacket8.hpp"
+#include "PointPacket8.hpp"
+
+namespace SCPPR {
+
+    // operator overrides with circular dependencies
+
+    inline VectorPacket8::VectorPacket8(const NormalPacket8& normals) :
+        x(normals.GetX()), y(normals.GetY()), z(normals.GetZ()) {
+
+    }
+
+    inline VectorPacket8::VectorPacket8(const PointPacket8& points) :
+        x(points.GetX()), y(points.GetY()), z(points.GetZ()) {
+
+    }
+
+    inline Float8 VectorPacket8::operator* (const NormalPacket8& secondNormals) const {
+        return Float8::MultiplyAdd(x, secondNormals.GetX(),
+               Float8::MultiplyAdd(y, secondNormals.GetY(), z * secondNormals.GetZ()));
+    }
+
+    inline VectorPacket8 VectorPacket8::operator+ (const NormalPacket8& secondNormals) const {
+        return VectorPacket8(x + secondNormals.GetX(), y + secondNormals.GetY(),
+                             z + secondNormals.GetZ());
+    }
+};
+
+#endif	/* VECTORPACKET8_HPP */